@@ -0,0 +1,98 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the FWindowsMessageFrameArena class.
+ */
+
+#include "WindowsMessageArena.h"
+
+FWindowsMessageFrameArena::FWindowsMessageFrameArena(int32 InBlockBytes)
+    : BlockBytes(static_cast<SIZE_T>(FMath::Max(InBlockBytes, 1024)))
+{
+    FBlock& Block = Blocks.AddDefaulted_GetRef();
+    Block.Data = static_cast<uint8*>(FMemory::Malloc(BlockBytes, DefaultAlignment));
+    Block.Size = BlockBytes;
+    Cursor = Block.Data;
+    End = Block.Data + Block.Size;
+    ++HeapAllocations;
+}
+
+FWindowsMessageFrameArena::~FWindowsMessageFrameArena()
+{
+    for (const FBlock& Block : Blocks)
+    {
+        FMemory::Free(Block.Data);
+    }
+}
+
+void* FWindowsMessageFrameArena::AllocateSlow(SIZE_T Size, SIZE_T Alignment)
+{
+    // The tail of the current block is skipped; counting it keeps FrameBytes a measure of the space the frame really needs
+    FrameBytes += End - Cursor;
+
+    // Blocks kept from earlier frames are reused before the heap is asked for a new one
+    while (CurrentBlock + 1 < Blocks.Num())
+    {
+        const FBlock& Block = Blocks[++CurrentBlock];
+        Cursor = Block.Data;
+        End = Block.Data + Block.Size;
+        uint8* Aligned = Align(Cursor, Alignment);
+        if (Aligned + Size <= End)
+        {
+            FrameBytes += (Aligned + Size) - Cursor;
+            ++FrameAllocations;
+            Cursor = Aligned + Size;
+            return Aligned;
+        }
+        FrameBytes += Block.Size;
+    }
+
+    FBlock& Block = Blocks.AddDefaulted_GetRef();
+    Block.Size = FMath::Max(BlockBytes, Size + Alignment);
+    Block.Data = static_cast<uint8*>(FMemory::Malloc(Block.Size, FMath::Max(Alignment, DefaultAlignment)));
+    ++HeapAllocations;
+    CurrentBlock = Blocks.Num() - 1;
+
+    Cursor = Align(Block.Data, Alignment);
+    End = Block.Data + Block.Size;
+    FrameBytes += (Cursor + Size) - Block.Data;
+    ++FrameAllocations;
+    uint8* Result = Cursor;
+    Cursor += Size;
+    return Result;
+}
+
+FStringView FWindowsMessageFrameArena::CopyString(FStringView Source)
+{
+    TCHAR* Chars = static_cast<TCHAR*>(Allocate((Source.Len() + 1) * sizeof(TCHAR), alignof(TCHAR)));
+    FMemory::Memcpy(Chars, Source.GetData(), Source.Len() * sizeof(TCHAR));
+    Chars[Source.Len()] = TEXT('\0');
+    return FStringView(Chars, Source.Len());
+}
+
+void FWindowsMessageFrameArena::Reset()
+{
+    PeakFrameBytes = FMath::Max(PeakFrameBytes, FrameBytes);
+    FrameBytes = 0;
+    FrameAllocations = 0;
+    ++Resets;
+
+    CurrentBlock = 0;
+    Cursor = Blocks[0].Data;
+    End = Blocks[0].Data + Blocks[0].Size;
+}
+
+FWindowsMessageArenaCounters FWindowsMessageFrameArena::GetCounters() const
+{
+    FWindowsMessageArenaCounters Counters;
+    Counters.FrameBytes = FrameBytes;
+    Counters.PeakFrameBytes = FMath::Max(PeakFrameBytes, FrameBytes);
+    for (const FBlock& Block : Blocks)
+    {
+        Counters.ReservedBytes += Block.Size;
+    }
+    Counters.FrameAllocations = FrameAllocations;
+    Counters.HeapAllocations = HeapAllocations;
+    Counters.Resets = Resets;
+    return Counters;
+}
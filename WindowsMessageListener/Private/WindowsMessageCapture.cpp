@@ -0,0 +1,245 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the capture writer and reader for message streams.
+ */
+
+#include "WindowsMessageCapture.h"
+#include "WindowsMessageListenerLog.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+
+FWindowsMessageCaptureWriter::FWindowsMessageCaptureWriter()
+{
+}
+
+FWindowsMessageCaptureWriter::~FWindowsMessageCaptureWriter()
+{
+    Close();
+}
+
+bool FWindowsMessageCaptureWriter::Open(const TCHAR* Filename, int32 BufferRecords)
+{
+    Close();
+
+    FileHandle = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(Filename);
+    if (!FileHandle)
+    {
+        UE_LOG(LogWindowsMessageListener, Error, TEXT("Failed to create message capture file: %s"), Filename);
+        return false;
+    }
+
+    FWindowsMessageCaptureHeader Header;
+    Header.SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+    FileHandle->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+
+    // Everything the producer touches is allocated here, so Append never allocates for known windows
+    for (TArray<FWindowsMessageCaptureRecord>& Buffer : Buffers)
+    {
+        Buffer.SetNumUninitialized(FMath::Max(BufferRecords, 1));
+    }
+    ActiveBuffer = 0;
+    ActiveCount = 0;
+    KnownHwnds.Reset(64);
+    LastHwnd = 0;
+    LastHwndId = 0;
+    bFlushPending.store(false);
+    bStopping.store(false);
+    RecordsCaptured.store(0, std::memory_order_relaxed);
+    RecordsDropped.store(0, std::memory_order_relaxed);
+    BytesWritten.store(sizeof(Header), std::memory_order_relaxed);
+
+    FlushEvent = FPlatformProcess::GetSynchEventFromPool();
+    FlushThread = FRunnableThread::Create(this, TEXT("WindowsMessageCaptureFlush"), 0, TPri_BelowNormal);
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Message capture started: %s"), Filename);
+    return true;
+}
+
+void FWindowsMessageCaptureWriter::Close()
+{
+    if (!FileHandle)
+    {
+        return;
+    }
+
+    // Closing may block; wait for the previous flush so the partial buffer is not dropped
+    while (ActiveCount > 0 && !SubmitActiveBuffer())
+    {
+        FPlatformProcess::Sleep(0.001f);
+    }
+
+    bStopping.store(true);
+    FlushEvent->Trigger();
+    FlushThread->WaitForCompletion();
+    delete FlushThread;
+    FlushThread = nullptr;
+    FPlatformProcess::ReturnSynchEventToPool(FlushEvent);
+    FlushEvent = nullptr;
+
+    delete FileHandle;
+    FileHandle = nullptr;
+    for (TArray<FWindowsMessageCaptureRecord>& Buffer : Buffers)
+    {
+        Buffer.Empty();
+    }
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Message capture stopped: %llu records, %llu dropped."), RecordsCaptured.load(), RecordsDropped.load());
+}
+
+void FWindowsMessageCaptureWriter::Append(const FWindowsMessageRecord& Record)
+{
+    if (ActiveCount == Buffers[ActiveBuffer].Num() && !SubmitActiveBuffer())
+    {
+        RecordsDropped.fetch_add(1, std::memory_order_relaxed); // The disk is behind; never block the producer
+        return;
+    }
+
+    FWindowsMessageCaptureRecord& Captured = Buffers[ActiveBuffer][ActiveCount++];
+    Captured.Timestamp = Record.Timestamp;
+    Captured.HwndId = GetHwndId(Record.Hwnd);
+    Captured.Msg = Record.Msg;
+    Captured.WParam = Record.WParam;
+    Captured.LParam = Record.LParam;
+}
+
+bool FWindowsMessageCaptureWriter::SubmitActiveBuffer()
+{
+    if (bFlushPending.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    SubmittedBuffer = ActiveBuffer;
+    SubmittedCount = ActiveCount;
+    bFlushPending.store(true, std::memory_order_release);
+    FlushEvent->Trigger();
+
+    ActiveBuffer ^= 1;
+    ActiveCount = 0;
+    return true;
+}
+
+uint32 FWindowsMessageCaptureWriter::GetHwndId(uint64 Hwnd)
+{
+    if (Hwnd == 0)
+    {
+        return 0;
+    }
+    if (Hwnd != LastHwnd)
+    {
+        int32 Index = KnownHwnds.Find(Hwnd);
+        if (Index == INDEX_NONE)
+        {
+            Index = KnownHwnds.Add(Hwnd);
+        }
+        LastHwnd = Hwnd;
+        LastHwndId = static_cast<uint32>(Index + 1);
+    }
+    return LastHwndId;
+}
+
+uint32 FWindowsMessageCaptureWriter::Run()
+{
+    for (;;)
+    {
+        if (bFlushPending.load(std::memory_order_acquire))
+        {
+            const int64 NumBytes = static_cast<int64>(SubmittedCount) * sizeof(FWindowsMessageCaptureRecord);
+            FileHandle->Write(reinterpret_cast<const uint8*>(Buffers[SubmittedBuffer].GetData()), NumBytes);
+            RecordsCaptured.fetch_add(SubmittedCount, std::memory_order_relaxed);
+            BytesWritten.fetch_add(NumBytes, std::memory_order_relaxed);
+            bFlushPending.store(false, std::memory_order_release);
+        }
+        else if (bStopping.load())
+        {
+            break;
+        }
+        else
+        {
+            FlushEvent->Wait();
+        }
+    }
+    FileHandle->Flush();
+    return 0;
+}
+
+FWindowsMessageCaptureCounters FWindowsMessageCaptureWriter::GetCounters() const
+{
+    FWindowsMessageCaptureCounters Counters;
+    Counters.RecordsCaptured = RecordsCaptured.load(std::memory_order_relaxed);
+    Counters.RecordsDropped = RecordsDropped.load(std::memory_order_relaxed);
+    Counters.BytesWritten = BytesWritten.load(std::memory_order_relaxed);
+    return Counters;
+}
+
+FWindowsMessageCaptureReader::FWindowsMessageCaptureReader()
+{
+}
+
+FWindowsMessageCaptureReader::~FWindowsMessageCaptureReader()
+{
+    Close();
+}
+
+bool FWindowsMessageCaptureReader::Open(const TCHAR* Filename)
+{
+    Close();
+
+    MappedFile = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(Filename);
+    if (!MappedFile || MappedFile->GetFileSize() < static_cast<int64>(sizeof(FWindowsMessageCaptureHeader)))
+    {
+        UE_LOG(LogWindowsMessageListener, Error, TEXT("Failed to map message capture file: %s"), Filename);
+        Close();
+        return false;
+    }
+
+    MappedRegion = MappedFile->MapRegion();
+    const FWindowsMessageCaptureHeader* Header = MappedRegion ? reinterpret_cast<const FWindowsMessageCaptureHeader*>(MappedRegion->GetMappedPtr()) : nullptr;
+    if (!Header || Header->Magic != FWindowsMessageCaptureHeader::ExpectedMagic || Header->Version != FWindowsMessageCaptureHeader::CurrentVersion || Header->RecordSize != sizeof(FWindowsMessageCaptureRecord))
+    {
+        UE_LOG(LogWindowsMessageListener, Error, TEXT("Not a valid message capture file: %s"), Filename);
+        Close();
+        return false;
+    }
+
+    // A capture cut short by a crash can end in a partial record, which is ignored
+    const int64 RecordBytes = MappedRegion->GetMappedSize() - static_cast<int64>(sizeof(FWindowsMessageCaptureHeader));
+    Records = reinterpret_cast<const FWindowsMessageCaptureRecord*>(Header + 1);
+    NumRecords = static_cast<int32>(FMath::Min<int64>(RecordBytes / sizeof(FWindowsMessageCaptureRecord), MAX_int32));
+    SecondsPerCycle = Header->SecondsPerCycle;
+    return true;
+}
+
+void FWindowsMessageCaptureReader::Close()
+{
+    delete MappedRegion;
+    MappedRegion = nullptr;
+    delete MappedFile;
+    MappedFile = nullptr;
+    Records = nullptr;
+    NumRecords = 0;
+    SecondsPerCycle = 0.0;
+}
+
+void FWindowsMessageCaptureReader::WaitUntil(double TargetSeconds)
+{
+    for (;;)
+    {
+        const double Remaining = TargetSeconds - FPlatformTime::Seconds();
+        if (Remaining <= 0.0)
+        {
+            return;
+        }
+        // Sleep through long gaps, then spin for the last couple of milliseconds to keep the timing accurate
+        if (Remaining > 0.002)
+        {
+            FPlatformProcess::Sleep(static_cast<float>(Remaining - 0.002));
+        }
+        else
+        {
+            FPlatformProcess::YieldThread();
+        }
+    }
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2025, Michael Golembewski.  All rights reserved.
+
+/**
+ * This file implements the FWindowsMessageCoalescer class.
+ */
+
+#include "WindowsMessageCoalescer.h"
+
+namespace
+{
+    // Window creation and destruction (WM_CREATE, WM_DESTROY)
+    constexpr uint32 WindowMessageFirst = 0x0001;
+    constexpr uint32 WindowMessageLast = 0x0002;
+
+    // Key and mouse button messages (WM_KEYFIRST-WM_KEYLAST, WM_LBUTTONDOWN-WM_XBUTTONDBLCLK)
+    constexpr uint32 KeyMessageFirst = 0x0100;
+    constexpr uint32 KeyMessageLast = 0x0109;
+    constexpr uint32 ButtonMessageFirst = 0x0201;
+    constexpr uint32 ButtonMessageLast = 0x020D;
+}
+
+FWindowsMessageCoalescer::FWindowsMessageCoalescer()
+{
+    OrderingBarrierMessageTypes.AllowRange(WindowMessageFirst, WindowMessageLast);
+    OrderingBarrierMessageTypes.AllowRange(KeyMessageFirst, KeyMessageLast);
+    OrderingBarrierMessageTypes.AllowRange(ButtonMessageFirst, ButtonMessageLast);
+}
+
+void FWindowsMessageCoalescer::SetCoalescedMessageType(uint32 MsgCode, bool bCoalesce)
+{
+    if (bCoalesce)
+    {
+        CoalescedMessageTypes.Allow(MsgCode);
+    }
+    else
+    {
+        CoalescedMessageTypes.Disallow(MsgCode);
+    }
+}
+
+void FWindowsMessageCoalescer::SetCoalescedMessageTypes(const FWindowsMessageFilter& MessageTypes)
+{
+    CoalescedMessageTypes = MessageTypes;
+}
+
+void FWindowsMessageCoalescer::SetOrderingBarrierMessageType(uint32 MsgCode, bool bBarrier)
+{
+    if (bBarrier)
+    {
+        OrderingBarrierMessageTypes.Allow(MsgCode);
+    }
+    else
+    {
+        OrderingBarrierMessageTypes.Disallow(MsgCode);
+    }
+}
+
+void FWindowsMessageCoalescer::Absorb(const FWindowsMessageRecord& Record)
+{
+    MessagesIn.fetch_add(1, std::memory_order_relaxed);
+
+    for (FWindowsMessageRecord& Pending : PendingMessages)
+    {
+        if (AreWindowsMessagesCoalescable(Pending, Record))
+        {
+            Pending = Record;
+            MessagesCoalesced.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    PendingMessages.Add(Record);
+}
+
+void FWindowsMessageCoalescer::DiscardPendingMessages()
+{
+    PendingMessages.Reset();
+}
+
+FWindowsMessageCoalescerCounters FWindowsMessageCoalescer::GetCounters() const
+{
+    FWindowsMessageCoalescerCounters Counters;
+    Counters.MessagesIn = MessagesIn.load(std::memory_order_relaxed);
+    Counters.MessagesDelivered = MessagesDelivered.load(std::memory_order_relaxed);
+    Counters.MessagesCoalesced = MessagesCoalesced.load(std::memory_order_relaxed);
+    return Counters;
+}
@@ -5,6 +5,8 @@
  */
 
 #include "WindowsMessageCodeHelper.h"
+#include "WindowsMessageCodeTable.h"
+#include "WindowsMessageArena.h"
 
 namespace {
     constexpr uint32 WM_USER_START = 0x0400;
@@ -18,82 +20,89 @@ namespace {
             Description
         );
     }
-}
 
-// Define the static map at the global scope
-static const TMap<uint32, FWindowsMessageInfo> MessageInfoMap = {
-    {0x0000, {TEXT("WM_NULL"), TEXT("No operation.")}},
-    {0x0001, {TEXT("WM_CREATE"), TEXT("Sent when a window is being created.")}},
-    {0x0002, {TEXT("WM_DESTROY"), TEXT("Sent when a window is being destroyed.")}},
-    {0x0003, {TEXT("WM_MOVE"), TEXT("Sent after a window has been moved.")}},
-    {0x0005, {TEXT("WM_SIZE"), TEXT("Sent when the size of a window has changed.")}},
-    {0x0006, {TEXT("WM_ACTIVATE"), TEXT("Sent when a window is activated or deactivated.")}},
-    {0x0007, {TEXT("WM_SETFOCUS"), TEXT("Sent when a window receives keyboard focus.")}},
-    {0x0008, {TEXT("WM_KILLFOCUS"), TEXT("Sent when a window loses keyboard focus.")}},
-    {0x000A, {TEXT("WM_ENABLE"), TEXT("Sent when a window is enabled or disabled.")}},
-    {0x000B, {TEXT("WM_SETREDRAW"), TEXT("Sent to allow changes in a window to be redrawn or not.")}},
-    {0x000C, {TEXT("WM_SETTEXT"), TEXT("Sent to set the text of a window.")}},
-    {0x000D, {TEXT("WM_GETTEXT"), TEXT("Sent to retrieve the text of a window.")}},
-    {0x000E, {TEXT("WM_GETTEXTLENGTH"), TEXT("Sent to retrieve the length of the text in a window.")}},
-    {0x0010, {TEXT("WM_CLOSE"), TEXT("Sent as a signal that a window or application should terminate.")}},
-    {0x0011, {TEXT("WM_QUERYENDSESSION"), TEXT("Sent when the user chooses to end the session.")}},
-    {0x0012, {TEXT("WM_QUIT"), TEXT("Sent to indicate a request to terminate an application.")}},
-    {0x0013, {TEXT("WM_QUERYOPEN"), TEXT("Sent to determine whether a minimized window can be restored.")}},
-    {0x0014, {TEXT("WM_ERASEBKGND"), TEXT("Sent when the background of a window must be erased.")}},
-    {0x0015, {TEXT("WM_SYSCOLORCHANGE"), TEXT("Sent when the system colors change.")}},
-    {0x0016, {TEXT("WM_ENDSESSION"), TEXT("Sent when the user session is ending.")}},
-    {0x0100, {TEXT("WM_KEYDOWN"), TEXT("Sent when a key is pressed.")}},
-    {0x0101, {TEXT("WM_KEYUP"), TEXT("Sent when a key is released.")}},
-    {0x0102, {TEXT("WM_CHAR"), TEXT("Sent when a character is typed.")}},
-    {0x0103, {TEXT("WM_DEADCHAR"), TEXT("Sent when a dead key is typed.")}},
-    {0x0104, {TEXT("WM_SYSKEYDOWN"), TEXT("Sent when a system key is pressed.")}},
-    {0x0105, {TEXT("WM_SYSKEYUP"), TEXT("Sent when a system key is released.")}},
-    {0x0106, {TEXT("WM_SYSCHAR"), TEXT("Sent when a system character is typed.")}},
-    {0x0107, {TEXT("WM_SYSDEADCHAR"), TEXT("Sent when a system dead key is typed.")}},
-    {0x0200, {TEXT("WM_MOUSEMOVE"), TEXT("Sent when the mouse is moved.")}},
-    {0x0201, {TEXT("WM_LBUTTONDOWN"), TEXT("Sent when the left mouse button is pressed.")}},
-    {0x0202, {TEXT("WM_LBUTTONUP"), TEXT("Sent when the left mouse button is released.")}},
-    {0x0203, {TEXT("WM_LBUTTONDBLCLK"), TEXT("Sent when the left mouse button is double-clicked.")}},
-    {0x0204, {TEXT("WM_RBUTTONDOWN"), TEXT("Sent when the right mouse button is pressed.")}},
-    {0x0205, {TEXT("WM_RBUTTONUP"), TEXT("Sent when the right mouse button is released.")}},
-    {0x0206, {TEXT("WM_RBUTTONDBLCLK"), TEXT("Sent when the right mouse button is double-clicked.")}},
-    {0x0207, {TEXT("WM_MBUTTONDOWN"), TEXT("Sent when the middle mouse button is pressed.")}},
-    {0x0208, {TEXT("WM_MBUTTONUP"), TEXT("Sent when the middle mouse button is released.")}},
-    {0x0209, {TEXT("WM_MBUTTONDBLCLK"), TEXT("Sent when the middle mouse button is double-clicked.")}},
-    {0x020A, {TEXT("WM_MOUSEWHEEL"), TEXT("Sent when the mouse wheel is rotated.")}},
-    {0x020B, {TEXT("WM_XBUTTONDOWN"), TEXT("Sent when an X button is pressed.")}},
-    {0x020C, {TEXT("WM_XBUTTONUP"), TEXT("Sent when an X button is released.")}},
-    {0x020D, {TEXT("WM_XBUTTONDBLCLK"), TEXT("Sent when an X button is double-clicked.")}},
-    {0x0210, {TEXT("WM_PARENTNOTIFY"), TEXT("Sent to a parent window when a child window is created or destroyed.")}},
-    {0x0211, {TEXT("WM_ENTERMENULOOP"), TEXT("Sent when a menu modal loop is entered.")}},
-    {0x0212, {TEXT("WM_EXITMENULOOP"), TEXT("Sent when a menu modal loop is exited.")}},
-    {0x0213, {TEXT("WM_NEXTMENU"), TEXT("Sent when the user navigates to the next menu.")}},
-    {0x0214, {TEXT("WM_SIZING"), TEXT("Sent when the user is resizing a window.")}},
-    {0x0215, {TEXT("WM_CAPTURECHANGED"), TEXT("Sent when the mouse capture changes.")}},
-    {0x0216, {TEXT("WM_MOVING"), TEXT("Sent when the user is moving a window.")}},
-    {0x0218, {TEXT("WM_POWERBROADCAST"), TEXT("Sent to notify applications of power management events.")}},
-    {0x0219, {TEXT("WM_DEVICECHANGE"), TEXT("Sent when a device is added or removed.")}},
-    {0x0300, {TEXT("WM_CUT"), TEXT("Sent to cut the current selection to the clipboard.")}},
-    {0x0301, {TEXT("WM_COPY"), TEXT("Sent to copy the current selection to the clipboard.")}},
-    {0x0302, {TEXT("WM_PASTE"), TEXT("Sent to paste data from the clipboard.")}},
-    {0x0303, {TEXT("WM_CLEAR"), TEXT("Sent to clear the current selection.")}},
-    {0x0304, {TEXT("WM_UNDO"), TEXT("Sent to undo the last action.")}},
-    {0x0400, {TEXT("WM_USER"), TEXT("Base value for user-defined messages.")}},
-    {0x8000, {TEXT("WM_APP"), TEXT("Base value for application-defined messages.")}},
-};
+    constexpr uint32 CustomMessageNameCacheSize = 256; // Power of two, indexed by the low bits of the code
+    constexpr int32 CustomMessageNameLength = 24;      // Fits "WM_USER + 0x7BFF"
+
+    /**
+     * Formatted name of a WM_USER or WM_APP message. A zero code marks an empty entry, since
+     * zero is never a custom message, so the cache needs no dynamic initialization.
+     */
+    struct FCustomMessageNameCacheEntry
+    {
+        uint32 MsgCode;
+        TCHAR Name[CustomMessageNameLength];
+    };
+
+    thread_local FCustomMessageNameCacheEntry CustomMessageNameCache[CustomMessageNameCacheSize];
+
+    const TCHAR* const WMUserDescription = TEXT("Custom application-defined message (WM_USER).");
+    const TCHAR* const WMAppDescription = TEXT("Custom application-defined message (WM_APP).");
+    const TCHAR* const UnknownName = TEXT("Unknown");
+    const TCHAR* const UnknownDescription = TEXT("No description available.");
+
+    /**
+     * Parses a hexadecimal ("0x1F") or decimal ("31") message code.
+     * @return True if the whole string was a number that fits in 32 bits.
+     */
+    bool ParseMessageCodeNumber(FStringView Text, uint32& OutValue)
+    {
+        uint32 Base = 10;
+        if (Text.Len() > 2 && Text[0] == TEXT('0') && (Text[1] == TEXT('x') || Text[1] == TEXT('X')))
+        {
+            Base = 16;
+            Text.RightChopInline(2);
+        }
+        if (Text.IsEmpty())
+        {
+            return false;
+        }
+
+        uint64 Value = 0;
+        for (TCHAR Char : Text)
+        {
+            uint32 Digit = 0;
+            if (Char >= TEXT('0') && Char <= TEXT('9'))
+            {
+                Digit = Char - TEXT('0');
+            }
+            else if (Base == 16 && Char >= TEXT('a') && Char <= TEXT('f'))
+            {
+                Digit = Char - TEXT('a') + 10;
+            }
+            else if (Base == 16 && Char >= TEXT('A') && Char <= TEXT('F'))
+            {
+                Digit = Char - TEXT('A') + 10;
+            }
+            else
+            {
+                return false;
+            }
+
+            Value = Value * Base + Digit;
+            if (Value > MAX_uint32)
+            {
+                return false;
+            }
+        }
+
+        OutValue = static_cast<uint32>(Value);
+        return true;
+    }
+}
 
 FWindowsMessageInfo FWindowsMessageCodeHelper::GetMessageInfo(uint32 MsgCode)
 {
     if (MsgCode >= ::WM_USER_START && MsgCode < ::WM_USER_END) {
-        return CreateCustomMessageInfo(MsgCode, ::WM_USER_START, TEXT("WM_USER"), TEXT("Custom application-defined message (WM_USER)."));
+        return CreateCustomMessageInfo(MsgCode, ::WM_USER_START, TEXT("WM_USER"), WMUserDescription);
     }
 
     if (MsgCode >= ::WM_APP_START && MsgCode < ::WM_APP_END) {
-        return CreateCustomMessageInfo(MsgCode, ::WM_APP_START, TEXT("WM_APP"), TEXT("Custom application-defined message (WM_APP)."));
+        return CreateCustomMessageInfo(MsgCode, ::WM_APP_START, TEXT("WM_APP"), WMAppDescription);
     }
 
-    const FWindowsMessageInfo* Found = MessageInfoMap.Find(MsgCode);
-    return Found ? *Found : FWindowsMessageInfo(TEXT("Unknown"), TEXT("No description available."));
+    const FWindowsMessageCodeEntry* Found = FindWindowsMessageCodeEntry(MsgCode);
+    return Found ? FWindowsMessageInfo(Found->Name, Found->Description) : FWindowsMessageInfo(UnknownName, UnknownDescription);
 }
 
 FString FWindowsMessageCodeHelper::GetMessageName(uint32 MsgCode)
@@ -108,12 +117,118 @@ FString FWindowsMessageCodeHelper::GetMessageDescription(uint32 MsgCode)
 
 uint32 FWindowsMessageCodeHelper::GetMessageCodeByName(const FString& MessageName)
 {
-    for (const auto& Pair : MessageInfoMap)
+    uint32 MsgCode = 0;
+    TryGetMessageCodeByName(MessageName, MsgCode);
+    return MsgCode; // 0 if the message name is not found
+}
+
+bool FWindowsMessageCodeHelper::TryGetMessageCodeByName(FStringView MessageName, uint32& OutMsgCode)
+{
+    MessageName = MessageName.TrimStartAndEnd();
+
+    int32 PlusIndex = INDEX_NONE;
+    FStringView BaseName = MessageName;
+    uint32 Offset = 0;
+    if (MessageName.FindChar(TEXT('+'), PlusIndex))
     {
-        if (Pair.Value.Name.Equals(MessageName, ESearchCase::IgnoreCase))
+        BaseName = MessageName.Left(PlusIndex).TrimEnd();
+        if (!ParseMessageCodeNumber(MessageName.RightChop(PlusIndex + 1).TrimStart(), Offset))
         {
-            return Pair.Key;
+            return false;
         }
     }
-    return 0; // Return 0 if the message name is not found
+
+    uint32 BaseCode = 0;
+    if (const FWindowsMessageCodeEntry* Entry = WindowsMessageNameIndex.Find(BaseName.GetData(), BaseName.Len()))
+    {
+        BaseCode = Entry->Code;
+    }
+    else if (PlusIndex != INDEX_NONE || !ParseMessageCodeNumber(BaseName, BaseCode))
+    {
+        return false;
+    }
+
+    if (Offset > MAX_uint32 - BaseCode)
+    {
+        return false;
+    }
+
+    OutMsgCode = BaseCode + Offset;
+    return true;
+}
+
+const TCHAR* FWindowsMessageCodeHelper::GetMessageNameView(uint32 MsgCode)
+{
+    const TCHAR* BaseName = nullptr;
+    uint32 BaseCode = 0;
+    if (MsgCode >= ::WM_USER_START && MsgCode < ::WM_USER_END)
+    {
+        BaseName = TEXT("WM_USER");
+        BaseCode = ::WM_USER_START;
+    }
+    else if (MsgCode >= ::WM_APP_START && MsgCode < ::WM_APP_END)
+    {
+        BaseName = TEXT("WM_APP");
+        BaseCode = ::WM_APP_START;
+    }
+
+    if (BaseName)
+    {
+        FCustomMessageNameCacheEntry& Entry = CustomMessageNameCache[MsgCode & (CustomMessageNameCacheSize - 1)];
+        if (Entry.MsgCode != MsgCode)
+        {
+            FCString::Snprintf(Entry.Name, CustomMessageNameLength, TEXT("%s + 0x%X"), BaseName, MsgCode - BaseCode);
+            Entry.MsgCode = MsgCode;
+        }
+        return Entry.Name;
+    }
+
+    const FWindowsMessageCodeEntry* Found = FindWindowsMessageCodeEntry(MsgCode);
+    return Found ? Found->Name : UnknownName;
+}
+
+const TCHAR* FWindowsMessageCodeHelper::GetMessageDescriptionView(uint32 MsgCode)
+{
+    if (MsgCode >= ::WM_USER_START && MsgCode < ::WM_USER_END)
+    {
+        return WMUserDescription;
+    }
+
+    if (MsgCode >= ::WM_APP_START && MsgCode < ::WM_APP_END)
+    {
+        return WMAppDescription;
+    }
+
+    const FWindowsMessageCodeEntry* Found = FindWindowsMessageCodeEntry(MsgCode);
+    return Found ? Found->Description : UnknownDescription;
+}
+
+void FWindowsMessageCodeHelper::FormatMessageDetails(FStringBuilderBase& Builder, const TCHAR* Context, uint64 Hwnd, uint32 MsgCode)
+{
+    Builder.Appendf(TEXT("%s: hwnd=0x%llx, msg=%u, name=%s, description=%s"), Context, Hwnd, MsgCode, GetMessageNameView(MsgCode), GetMessageDescriptionView(MsgCode));
+}
+
+FWindowsMessageInfoView FWindowsMessageCodeHelper::GetMessageInfoView(uint32 MsgCode, FWindowsMessageFrameArena& Arena)
+{
+    FWindowsMessageInfoView Info;
+    Info.Name = GetMessageNameView(MsgCode);
+    Info.Description = GetMessageDescriptionView(MsgCode);
+    if (MsgCode >= ::WM_USER_START && MsgCode < ::WM_APP_END)
+    {
+        Info.Name = Arena.CopyString(Info.Name); // Formatted into the per-thread cache, which the next call overwrites
+    }
+    return Info;
+}
+
+FStringView FWindowsMessageCodeHelper::FormatMessageDetails(FWindowsMessageFrameArena& Arena, const TCHAR* Context, uint64 Hwnd, uint32 MsgCode)
+{
+    const TCHAR* Name = GetMessageNameView(MsgCode);
+    const TCHAR* Description = GetMessageDescriptionView(MsgCode);
+
+    // Sized up front from the variable parts, so the line is formatted straight into the arena whatever its length
+    constexpr int32 FixedChars = 64; // Literal text, 16 hex digits of hwnd, 10 digits of msg and the terminator
+    const int32 Capacity = FCString::Strlen(Context) + FCString::Strlen(Name) + FCString::Strlen(Description) + FixedChars;
+    TCHAR* Line = static_cast<TCHAR*>(Arena.Allocate(sizeof(TCHAR) * Capacity, alignof(TCHAR)));
+    const int32 Len = FCString::Snprintf(Line, Capacity, TEXT("%s: hwnd=0x%llx, msg=%u, name=%s, description=%s"), Context, Hwnd, MsgCode, Name, Description);
+    return FStringView(Line, FMath::Max(Len, 0));
 }
@@ -0,0 +1,423 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file defines the compile-time table of known Windows message codes.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Struct describing a known Windows message code. Every field is a compile-time constant.
+ */
+struct FWindowsMessageCodeEntry
+{
+    uint32 Code;              // The message code
+    const TCHAR* Name;        // Name of the message, as spelled in winuser.h
+    const TCHAR* Description; // Description of the message
+};
+
+/**
+ * Known Windows message codes, sorted by code with no duplicates.
+ * Aliases such as WM_KEYFIRST are not listed; the first name defined for a code wins.
+ */
+inline constexpr FWindowsMessageCodeEntry WindowsMessageCodeTable[] = {
+    {0x0000, TEXT("WM_NULL"), TEXT("No operation.")},
+    {0x0001, TEXT("WM_CREATE"), TEXT("Sent when a window is being created.")},
+    {0x0002, TEXT("WM_DESTROY"), TEXT("Sent when a window is being destroyed.")},
+    {0x0003, TEXT("WM_MOVE"), TEXT("Sent after a window has been moved.")},
+    {0x0005, TEXT("WM_SIZE"), TEXT("Sent when the size of a window has changed.")},
+    {0x0006, TEXT("WM_ACTIVATE"), TEXT("Sent when a window is activated or deactivated.")},
+    {0x0007, TEXT("WM_SETFOCUS"), TEXT("Sent when a window receives keyboard focus.")},
+    {0x0008, TEXT("WM_KILLFOCUS"), TEXT("Sent when a window loses keyboard focus.")},
+    {0x000A, TEXT("WM_ENABLE"), TEXT("Sent when a window is enabled or disabled.")},
+    {0x000B, TEXT("WM_SETREDRAW"), TEXT("Sent to allow changes in a window to be redrawn or not.")},
+    {0x000C, TEXT("WM_SETTEXT"), TEXT("Sent to set the text of a window.")},
+    {0x000D, TEXT("WM_GETTEXT"), TEXT("Sent to retrieve the text of a window.")},
+    {0x000E, TEXT("WM_GETTEXTLENGTH"), TEXT("Sent to retrieve the length of the text in a window.")},
+    {0x000F, TEXT("WM_PAINT"), TEXT("Sent when a window's client area must be painted.")},
+    {0x0010, TEXT("WM_CLOSE"), TEXT("Sent as a signal that a window or application should terminate.")},
+    {0x0011, TEXT("WM_QUERYENDSESSION"), TEXT("Sent when the user chooses to end the session.")},
+    {0x0012, TEXT("WM_QUIT"), TEXT("Sent to indicate a request to terminate an application.")},
+    {0x0013, TEXT("WM_QUERYOPEN"), TEXT("Sent to determine whether a minimized window can be restored.")},
+    {0x0014, TEXT("WM_ERASEBKGND"), TEXT("Sent when the background of a window must be erased.")},
+    {0x0015, TEXT("WM_SYSCOLORCHANGE"), TEXT("Sent when the system colors change.")},
+    {0x0016, TEXT("WM_ENDSESSION"), TEXT("Sent when the user session is ending.")},
+    {0x0018, TEXT("WM_SHOWWINDOW"), TEXT("Sent when a window is about to be hidden or shown.")},
+    {0x001A, TEXT("WM_SETTINGCHANGE"), TEXT("Sent when a system-wide setting or policy changes.")},
+    {0x001B, TEXT("WM_DEVMODECHANGE"), TEXT("Sent when the device-mode settings of a printer change.")},
+    {0x001C, TEXT("WM_ACTIVATEAPP"), TEXT("Sent when a window of another application is about to be activated.")},
+    {0x001D, TEXT("WM_FONTCHANGE"), TEXT("Sent when the pool of font resources changes.")},
+    {0x001E, TEXT("WM_TIMECHANGE"), TEXT("Sent when the system time changes.")},
+    {0x001F, TEXT("WM_CANCELMODE"), TEXT("Sent to cancel internal modes such as mouse capture.")},
+    {0x0020, TEXT("WM_SETCURSOR"), TEXT("Sent when the cursor moves within a window and input is not captured.")},
+    {0x0021, TEXT("WM_MOUSEACTIVATE"), TEXT("Sent when the cursor is in an inactive window and a mouse button is pressed.")},
+    {0x0022, TEXT("WM_CHILDACTIVATE"), TEXT("Sent to a child window when it is activated, moved or sized.")},
+    {0x0023, TEXT("WM_QUEUESYNC"), TEXT("Sent by a computer-based training application to separate user input messages.")},
+    {0x0024, TEXT("WM_GETMINMAXINFO"), TEXT("Sent when the size or position of a window is about to change.")},
+    {0x0026, TEXT("WM_PAINTICON"), TEXT("Sent to a minimized window when its icon must be painted.")},
+    {0x0027, TEXT("WM_ICONERASEBKGND"), TEXT("Sent to a minimized window when its icon background must be filled.")},
+    {0x0028, TEXT("WM_NEXTDLGCTL"), TEXT("Sent to a dialog box to move the keyboard focus to another control.")},
+    {0x002A, TEXT("WM_SPOOLERSTATUS"), TEXT("Sent when a job is added to or removed from the print queue.")},
+    {0x002B, TEXT("WM_DRAWITEM"), TEXT("Sent to the owner of an owner-drawn control when its visual aspect changes.")},
+    {0x002C, TEXT("WM_MEASUREITEM"), TEXT("Sent to the owner of an owner-drawn control when it is created.")},
+    {0x002D, TEXT("WM_DELETEITEM"), TEXT("Sent to the owner of a list box or combo box when an item is deleted.")},
+    {0x002E, TEXT("WM_VKEYTOITEM"), TEXT("Sent by a list box to its owner in response to WM_KEYDOWN.")},
+    {0x002F, TEXT("WM_CHARTOITEM"), TEXT("Sent by a list box to its owner in response to WM_CHAR.")},
+    {0x0030, TEXT("WM_SETFONT"), TEXT("Sent to set the font a control uses when drawing text.")},
+    {0x0031, TEXT("WM_GETFONT"), TEXT("Sent to retrieve the font a control uses when drawing text.")},
+    {0x0032, TEXT("WM_SETHOTKEY"), TEXT("Sent to associate a hot key with a window.")},
+    {0x0033, TEXT("WM_GETHOTKEY"), TEXT("Sent to retrieve the hot key associated with a window.")},
+    {0x0037, TEXT("WM_QUERYDRAGICON"), TEXT("Sent to a minimized window that is about to be dragged.")},
+    {0x0039, TEXT("WM_COMPAREITEM"), TEXT("Sent to determine the relative position of a new item in a sorted list.")},
+    {0x003D, TEXT("WM_GETOBJECT"), TEXT("Sent by accessibility clients to obtain information about an object.")},
+    {0x0041, TEXT("WM_COMPACTING"), TEXT("Sent when the system detects low memory.")},
+    {0x0044, TEXT("WM_COMMNOTIFY"), TEXT("Sent when a communication device event occurs (obsolete).")},
+    {0x0046, TEXT("WM_WINDOWPOSCHANGING"), TEXT("Sent when the size, position or Z order of a window is about to change.")},
+    {0x0047, TEXT("WM_WINDOWPOSCHANGED"), TEXT("Sent after the size, position or Z order of a window has changed.")},
+    {0x0048, TEXT("WM_POWER"), TEXT("Sent when the system is about to enter suspended mode (obsolete).")},
+    {0x004A, TEXT("WM_COPYDATA"), TEXT("Sent to pass data to another application.")},
+    {0x004B, TEXT("WM_CANCELJOURNAL"), TEXT("Posted when a user cancels journaling activities.")},
+    {0x004E, TEXT("WM_NOTIFY"), TEXT("Sent by a common control to its parent when an event occurs.")},
+    {0x0050, TEXT("WM_INPUTLANGCHANGEREQUEST"), TEXT("Posted when the user chooses a new input language.")},
+    {0x0051, TEXT("WM_INPUTLANGCHANGE"), TEXT("Sent after an application's input language has changed.")},
+    {0x0052, TEXT("WM_TCARD"), TEXT("Sent when the user clicks an authorable button in a Windows Help training card.")},
+    {0x0053, TEXT("WM_HELP"), TEXT("Sent when the user presses F1.")},
+    {0x0054, TEXT("WM_USERCHANGED"), TEXT("Sent to all windows after the user has logged on or off.")},
+    {0x0055, TEXT("WM_NOTIFYFORMAT"), TEXT("Sent to determine whether a control uses ANSI or Unicode structures.")},
+    {0x007B, TEXT("WM_CONTEXTMENU"), TEXT("Sent when the user right-clicks in a window.")},
+    {0x007C, TEXT("WM_STYLECHANGING"), TEXT("Sent when the styles of a window are about to change.")},
+    {0x007D, TEXT("WM_STYLECHANGED"), TEXT("Sent after the styles of a window have changed.")},
+    {0x007E, TEXT("WM_DISPLAYCHANGE"), TEXT("Sent when the display resolution has changed.")},
+    {0x007F, TEXT("WM_GETICON"), TEXT("Sent to retrieve the icon associated with a window.")},
+    {0x0080, TEXT("WM_SETICON"), TEXT("Sent to associate a new icon with a window.")},
+    {0x0081, TEXT("WM_NCCREATE"), TEXT("Sent before WM_CREATE when a window is first created.")},
+    {0x0082, TEXT("WM_NCDESTROY"), TEXT("Sent after WM_DESTROY when the non-client area is being destroyed.")},
+    {0x0083, TEXT("WM_NCCALCSIZE"), TEXT("Sent when the size and position of a window's client area must be calculated.")},
+    {0x0084, TEXT("WM_NCHITTEST"), TEXT("Sent to determine what part of a window corresponds to a screen coordinate.")},
+    {0x0085, TEXT("WM_NCPAINT"), TEXT("Sent when a window's frame must be painted.")},
+    {0x0086, TEXT("WM_NCACTIVATE"), TEXT("Sent when the non-client area must be changed to indicate an active or inactive state.")},
+    {0x0087, TEXT("WM_GETDLGCODE"), TEXT("Sent to determine which input a dialog control wants to handle.")},
+    {0x0088, TEXT("WM_SYNCPAINT"), TEXT("Sent to synchronize painting while avoiding cross-thread painting.")},
+    {0x00A0, TEXT("WM_NCMOUSEMOVE"), TEXT("Posted when the cursor moves within the non-client area of a window.")},
+    {0x00A1, TEXT("WM_NCLBUTTONDOWN"), TEXT("Posted when the left mouse button is pressed in the non-client area.")},
+    {0x00A2, TEXT("WM_NCLBUTTONUP"), TEXT("Posted when the left mouse button is released in the non-client area.")},
+    {0x00A3, TEXT("WM_NCLBUTTONDBLCLK"), TEXT("Posted when the left mouse button is double-clicked in the non-client area.")},
+    {0x00A4, TEXT("WM_NCRBUTTONDOWN"), TEXT("Posted when the right mouse button is pressed in the non-client area.")},
+    {0x00A5, TEXT("WM_NCRBUTTONUP"), TEXT("Posted when the right mouse button is released in the non-client area.")},
+    {0x00A6, TEXT("WM_NCRBUTTONDBLCLK"), TEXT("Posted when the right mouse button is double-clicked in the non-client area.")},
+    {0x00A7, TEXT("WM_NCMBUTTONDOWN"), TEXT("Posted when the middle mouse button is pressed in the non-client area.")},
+    {0x00A8, TEXT("WM_NCMBUTTONUP"), TEXT("Posted when the middle mouse button is released in the non-client area.")},
+    {0x00A9, TEXT("WM_NCMBUTTONDBLCLK"), TEXT("Posted when the middle mouse button is double-clicked in the non-client area.")},
+    {0x00AB, TEXT("WM_NCXBUTTONDOWN"), TEXT("Posted when an X button is pressed in the non-client area.")},
+    {0x00AC, TEXT("WM_NCXBUTTONUP"), TEXT("Posted when an X button is released in the non-client area.")},
+    {0x00AD, TEXT("WM_NCXBUTTONDBLCLK"), TEXT("Posted when an X button is double-clicked in the non-client area.")},
+    {0x00FE, TEXT("WM_INPUT_DEVICE_CHANGE"), TEXT("Sent when a raw input device is added or removed.")},
+    {0x00FF, TEXT("WM_INPUT"), TEXT("Sent when a window receives raw input.")},
+    {0x0100, TEXT("WM_KEYDOWN"), TEXT("Sent when a key is pressed.")},
+    {0x0101, TEXT("WM_KEYUP"), TEXT("Sent when a key is released.")},
+    {0x0102, TEXT("WM_CHAR"), TEXT("Sent when a character is typed.")},
+    {0x0103, TEXT("WM_DEADCHAR"), TEXT("Sent when a dead key is typed.")},
+    {0x0104, TEXT("WM_SYSKEYDOWN"), TEXT("Sent when a system key is pressed.")},
+    {0x0105, TEXT("WM_SYSKEYUP"), TEXT("Sent when a system key is released.")},
+    {0x0106, TEXT("WM_SYSCHAR"), TEXT("Sent when a system character is typed.")},
+    {0x0107, TEXT("WM_SYSDEADCHAR"), TEXT("Sent when a system dead key is typed.")},
+    {0x0109, TEXT("WM_UNICHAR"), TEXT("Sent when a UTF-32 character is typed.")},
+    {0x010D, TEXT("WM_IME_STARTCOMPOSITION"), TEXT("Sent immediately before the IME generates a composition string.")},
+    {0x010E, TEXT("WM_IME_ENDCOMPOSITION"), TEXT("Sent when the IME ends composition.")},
+    {0x010F, TEXT("WM_IME_COMPOSITION"), TEXT("Sent when the IME changes composition status in response to a keystroke.")},
+    {0x0110, TEXT("WM_INITDIALOG"), TEXT("Sent to a dialog box before it is displayed.")},
+    {0x0111, TEXT("WM_COMMAND"), TEXT("Sent when the user selects a command item or a control sends a notification.")},
+    {0x0112, TEXT("WM_SYSCOMMAND"), TEXT("Sent when the user chooses a command from the window menu.")},
+    {0x0113, TEXT("WM_TIMER"), TEXT("Posted when a timer expires.")},
+    {0x0114, TEXT("WM_HSCROLL"), TEXT("Sent when a horizontal scroll event occurs.")},
+    {0x0115, TEXT("WM_VSCROLL"), TEXT("Sent when a vertical scroll event occurs.")},
+    {0x0116, TEXT("WM_INITMENU"), TEXT("Sent when a menu is about to become active.")},
+    {0x0117, TEXT("WM_INITMENUPOPUP"), TEXT("Sent when a drop-down menu or submenu is about to become active.")},
+    {0x0119, TEXT("WM_GESTURE"), TEXT("Passes information about a gesture.")},
+    {0x011A, TEXT("WM_GESTURENOTIFY"), TEXT("Sent before a gesture starts.")},
+    {0x011F, TEXT("WM_MENUSELECT"), TEXT("Sent when the user selects a menu item.")},
+    {0x0120, TEXT("WM_MENUCHAR"), TEXT("Sent when a menu is active and the user presses a key that does not match a mnemonic.")},
+    {0x0121, TEXT("WM_ENTERIDLE"), TEXT("Sent when a modal dialog box or menu is entering an idle state.")},
+    {0x0122, TEXT("WM_MENURBUTTONUP"), TEXT("Sent when the user releases the right mouse button over a menu item.")},
+    {0x0123, TEXT("WM_MENUDRAG"), TEXT("Sent when the user drags a menu item.")},
+    {0x0124, TEXT("WM_MENUGETOBJECT"), TEXT("Sent when the cursor enters or leaves a menu item.")},
+    {0x0125, TEXT("WM_UNINITMENUPOPUP"), TEXT("Sent when a drop-down menu or submenu has been destroyed.")},
+    {0x0126, TEXT("WM_MENUCOMMAND"), TEXT("Sent when the user makes a selection from a menu.")},
+    {0x0127, TEXT("WM_CHANGEUISTATE"), TEXT("Sent to indicate that the UI state should be changed.")},
+    {0x0128, TEXT("WM_UPDATEUISTATE"), TEXT("Sent to change the UI state for a window and its children.")},
+    {0x0129, TEXT("WM_QUERYUISTATE"), TEXT("Sent to retrieve the UI state for a window.")},
+    {0x0132, TEXT("WM_CTLCOLORMSGBOX"), TEXT("Sent to the owner of a message box before it is drawn.")},
+    {0x0133, TEXT("WM_CTLCOLOREDIT"), TEXT("Sent by an edit control to its parent before it is drawn.")},
+    {0x0134, TEXT("WM_CTLCOLORLISTBOX"), TEXT("Sent by a list box to its parent before it is drawn.")},
+    {0x0135, TEXT("WM_CTLCOLORBTN"), TEXT("Sent by a button to its parent before it is drawn.")},
+    {0x0136, TEXT("WM_CTLCOLORDLG"), TEXT("Sent to a dialog box before it is drawn.")},
+    {0x0137, TEXT("WM_CTLCOLORSCROLLBAR"), TEXT("Sent by a scroll bar to its parent before it is drawn.")},
+    {0x0138, TEXT("WM_CTLCOLORSTATIC"), TEXT("Sent by a static control to its parent before it is drawn.")},
+    {0x01E1, TEXT("MN_GETHMENU"), TEXT("Sent to retrieve the menu handle of the current window.")},
+    {0x0200, TEXT("WM_MOUSEMOVE"), TEXT("Sent when the mouse is moved.")},
+    {0x0201, TEXT("WM_LBUTTONDOWN"), TEXT("Sent when the left mouse button is pressed.")},
+    {0x0202, TEXT("WM_LBUTTONUP"), TEXT("Sent when the left mouse button is released.")},
+    {0x0203, TEXT("WM_LBUTTONDBLCLK"), TEXT("Sent when the left mouse button is double-clicked.")},
+    {0x0204, TEXT("WM_RBUTTONDOWN"), TEXT("Sent when the right mouse button is pressed.")},
+    {0x0205, TEXT("WM_RBUTTONUP"), TEXT("Sent when the right mouse button is released.")},
+    {0x0206, TEXT("WM_RBUTTONDBLCLK"), TEXT("Sent when the right mouse button is double-clicked.")},
+    {0x0207, TEXT("WM_MBUTTONDOWN"), TEXT("Sent when the middle mouse button is pressed.")},
+    {0x0208, TEXT("WM_MBUTTONUP"), TEXT("Sent when the middle mouse button is released.")},
+    {0x0209, TEXT("WM_MBUTTONDBLCLK"), TEXT("Sent when the middle mouse button is double-clicked.")},
+    {0x020A, TEXT("WM_MOUSEWHEEL"), TEXT("Sent when the mouse wheel is rotated.")},
+    {0x020B, TEXT("WM_XBUTTONDOWN"), TEXT("Sent when an X button is pressed.")},
+    {0x020C, TEXT("WM_XBUTTONUP"), TEXT("Sent when an X button is released.")},
+    {0x020D, TEXT("WM_XBUTTONDBLCLK"), TEXT("Sent when an X button is double-clicked.")},
+    {0x020E, TEXT("WM_MOUSEHWHEEL"), TEXT("Sent when the mouse's horizontal scroll wheel is tilted or rotated.")},
+    {0x0210, TEXT("WM_PARENTNOTIFY"), TEXT("Sent to a parent window when a child window is created or destroyed.")},
+    {0x0211, TEXT("WM_ENTERMENULOOP"), TEXT("Sent when a menu modal loop is entered.")},
+    {0x0212, TEXT("WM_EXITMENULOOP"), TEXT("Sent when a menu modal loop is exited.")},
+    {0x0213, TEXT("WM_NEXTMENU"), TEXT("Sent when the user navigates to the next menu.")},
+    {0x0214, TEXT("WM_SIZING"), TEXT("Sent when the user is resizing a window.")},
+    {0x0215, TEXT("WM_CAPTURECHANGED"), TEXT("Sent when the mouse capture changes.")},
+    {0x0216, TEXT("WM_MOVING"), TEXT("Sent when the user is moving a window.")},
+    {0x0218, TEXT("WM_POWERBROADCAST"), TEXT("Sent to notify applications of power management events.")},
+    {0x0219, TEXT("WM_DEVICECHANGE"), TEXT("Sent when a device is added or removed.")},
+    {0x0220, TEXT("WM_MDICREATE"), TEXT("Sent to an MDI client window to create a child window.")},
+    {0x0221, TEXT("WM_MDIDESTROY"), TEXT("Sent to an MDI client window to close a child window.")},
+    {0x0222, TEXT("WM_MDIACTIVATE"), TEXT("Sent to an MDI client window to activate a child window.")},
+    {0x0223, TEXT("WM_MDIRESTORE"), TEXT("Sent to an MDI client window to restore a child window.")},
+    {0x0224, TEXT("WM_MDINEXT"), TEXT("Sent to an MDI client window to activate the next or previous child window.")},
+    {0x0225, TEXT("WM_MDIMAXIMIZE"), TEXT("Sent to an MDI client window to maximize a child window.")},
+    {0x0226, TEXT("WM_MDITILE"), TEXT("Sent to an MDI client window to tile its child windows.")},
+    {0x0227, TEXT("WM_MDICASCADE"), TEXT("Sent to an MDI client window to cascade its child windows.")},
+    {0x0228, TEXT("WM_MDIICONARRANGE"), TEXT("Sent to an MDI client window to arrange minimized child windows.")},
+    {0x0229, TEXT("WM_MDIGETACTIVE"), TEXT("Sent to an MDI client window to retrieve the active child window.")},
+    {0x0230, TEXT("WM_MDISETMENU"), TEXT("Sent to an MDI client window to replace the menu of its frame window.")},
+    {0x0231, TEXT("WM_ENTERSIZEMOVE"), TEXT("Sent once when a window enters the moving or sizing modal loop.")},
+    {0x0232, TEXT("WM_EXITSIZEMOVE"), TEXT("Sent once when a window exits the moving or sizing modal loop.")},
+    {0x0233, TEXT("WM_DROPFILES"), TEXT("Sent when the user drops a file on a window that accepts dropped files.")},
+    {0x0234, TEXT("WM_MDIREFRESHMENU"), TEXT("Sent to an MDI client window to refresh the frame window's menu.")},
+    {0x0238, TEXT("WM_POINTERDEVICECHANGE"), TEXT("Sent when the settings of a pointer device change.")},
+    {0x0239, TEXT("WM_POINTERDEVICEINRANGE"), TEXT("Sent when a pointer device is detected within range of an input digitizer.")},
+    {0x023A, TEXT("WM_POINTERDEVICEOUTOFRANGE"), TEXT("Sent when a pointer device has left the range of an input digitizer.")},
+    {0x0240, TEXT("WM_TOUCH"), TEXT("Sent when one or more touch points change.")},
+    {0x0241, TEXT("WM_NCPOINTERUPDATE"), TEXT("Posted when a pointer moves over the non-client area of a window.")},
+    {0x0242, TEXT("WM_NCPOINTERDOWN"), TEXT("Posted when a pointer makes contact over the non-client area of a window.")},
+    {0x0243, TEXT("WM_NCPOINTERUP"), TEXT("Posted when a pointer breaks contact over the non-client area of a window.")},
+    {0x0245, TEXT("WM_POINTERUPDATE"), TEXT("Posted when a pointer moves or changes state.")},
+    {0x0246, TEXT("WM_POINTERDOWN"), TEXT("Posted when a pointer makes contact over the client area of a window.")},
+    {0x0247, TEXT("WM_POINTERUP"), TEXT("Posted when a pointer breaks contact over the client area of a window.")},
+    {0x0249, TEXT("WM_POINTERENTER"), TEXT("Sent when a pointer enters the detection range of a window.")},
+    {0x024A, TEXT("WM_POINTERLEAVE"), TEXT("Sent when a pointer leaves the detection range of a window.")},
+    {0x024B, TEXT("WM_POINTERACTIVATE"), TEXT("Sent when a pointer activates an inactive window.")},
+    {0x024C, TEXT("WM_POINTERCAPTURECHANGED"), TEXT("Sent when a window loses capture of a pointer.")},
+    {0x024D, TEXT("WM_TOUCHHITTESTING"), TEXT("Sent to determine the most probable touch target.")},
+    {0x024E, TEXT("WM_POINTERWHEEL"), TEXT("Posted when a pointer wheel is rotated.")},
+    {0x024F, TEXT("WM_POINTERHWHEEL"), TEXT("Posted when a pointer horizontal wheel is rotated.")},
+    {0x0250, TEXT("DM_POINTERHITTEST"), TEXT("Sent to a window with a pointer hit test on a direct manipulation viewport.")},
+    {0x0251, TEXT("WM_POINTERROUTEDTO"), TEXT("Sent when a pointer is routed to a window in another process.")},
+    {0x0252, TEXT("WM_POINTERROUTEDAWAY"), TEXT("Sent when a pointer is routed away from a window.")},
+    {0x0253, TEXT("WM_POINTERROUTEDRELEASED"), TEXT("Sent when a routed pointer is released.")},
+    {0x0281, TEXT("WM_IME_SETCONTEXT"), TEXT("Sent when a window is activated, to let the IME update its context.")},
+    {0x0282, TEXT("WM_IME_NOTIFY"), TEXT("Sent to notify a window of changes to the IME window.")},
+    {0x0283, TEXT("WM_IME_CONTROL"), TEXT("Sent to direct the IME window to carry out a command.")},
+    {0x0284, TEXT("WM_IME_COMPOSITIONFULL"), TEXT("Sent when the IME window finds no space to extend the composition window.")},
+    {0x0285, TEXT("WM_IME_SELECT"), TEXT("Sent when the system is about to change the current IME.")},
+    {0x0286, TEXT("WM_IME_CHAR"), TEXT("Sent when the IME gets a character of the conversion result.")},
+    {0x0288, TEXT("WM_IME_REQUEST"), TEXT("Sent to provide commands and request information from the IME.")},
+    {0x0290, TEXT("WM_IME_KEYDOWN"), TEXT("Sent when a key is pressed while the IME is active.")},
+    {0x0291, TEXT("WM_IME_KEYUP"), TEXT("Sent when a key is released while the IME is active.")},
+    {0x02A0, TEXT("WM_NCMOUSEHOVER"), TEXT("Posted when the cursor hovers over the non-client area of a window.")},
+    {0x02A1, TEXT("WM_MOUSEHOVER"), TEXT("Posted when the cursor hovers over the client area of a window.")},
+    {0x02A2, TEXT("WM_NCMOUSELEAVE"), TEXT("Posted when the cursor leaves the non-client area of a window.")},
+    {0x02A3, TEXT("WM_MOUSELEAVE"), TEXT("Posted when the cursor leaves the client area of a window.")},
+    {0x02B1, TEXT("WM_WTSSESSION_CHANGE"), TEXT("Sent when a session is connected, disconnected, locked or unlocked.")},
+    {0x02C0, TEXT("WM_TABLET_FIRST"), TEXT("First message reserved for the Tablet PC platform.")},
+    {0x02DF, TEXT("WM_TABLET_LAST"), TEXT("Last message reserved for the Tablet PC platform.")},
+    {0x02E0, TEXT("WM_DPICHANGED"), TEXT("Sent when the effective DPI of a window has changed.")},
+    {0x02E2, TEXT("WM_DPICHANGED_BEFOREPARENT"), TEXT("Sent to child windows before the DPI of their parent changes.")},
+    {0x02E3, TEXT("WM_DPICHANGED_AFTERPARENT"), TEXT("Sent to child windows after the DPI of their parent has changed.")},
+    {0x02E4, TEXT("WM_GETDPISCALEDSIZE"), TEXT("Sent to let a window compute its size for a pending DPI change.")},
+    {0x0300, TEXT("WM_CUT"), TEXT("Sent to cut the current selection to the clipboard.")},
+    {0x0301, TEXT("WM_COPY"), TEXT("Sent to copy the current selection to the clipboard.")},
+    {0x0302, TEXT("WM_PASTE"), TEXT("Sent to paste data from the clipboard.")},
+    {0x0303, TEXT("WM_CLEAR"), TEXT("Sent to clear the current selection.")},
+    {0x0304, TEXT("WM_UNDO"), TEXT("Sent to undo the last action.")},
+    {0x0305, TEXT("WM_RENDERFORMAT"), TEXT("Sent to the clipboard owner when a delayed-rendered format must be rendered.")},
+    {0x0306, TEXT("WM_RENDERALLFORMATS"), TEXT("Sent to the clipboard owner before it is destroyed.")},
+    {0x0307, TEXT("WM_DESTROYCLIPBOARD"), TEXT("Sent to the clipboard owner when the clipboard is emptied.")},
+    {0x0308, TEXT("WM_DRAWCLIPBOARD"), TEXT("Sent to the first window in the clipboard viewer chain when the clipboard changes.")},
+    {0x0309, TEXT("WM_PAINTCLIPBOARD"), TEXT("Sent when the clipboard viewer's client area needs repainting.")},
+    {0x030A, TEXT("WM_VSCROLLCLIPBOARD"), TEXT("Sent when an event occurs in the clipboard viewer's vertical scroll bar.")},
+    {0x030B, TEXT("WM_SIZECLIPBOARD"), TEXT("Sent when the clipboard viewer's client area has changed size.")},
+    {0x030C, TEXT("WM_ASKCBFORMATNAME"), TEXT("Sent to request the name of a CF_OWNERDISPLAY clipboard format.")},
+    {0x030D, TEXT("WM_CHANGECBCHAIN"), TEXT("Sent when a window is being removed from the clipboard viewer chain.")},
+    {0x030E, TEXT("WM_HSCROLLCLIPBOARD"), TEXT("Sent when an event occurs in the clipboard viewer's horizontal scroll bar.")},
+    {0x030F, TEXT("WM_QUERYNEWPALETTE"), TEXT("Sent when a window is about to receive keyboard focus, to realize its palette.")},
+    {0x0310, TEXT("WM_PALETTEISCHANGING"), TEXT("Sent when an application is going to realize its logical palette.")},
+    {0x0311, TEXT("WM_PALETTECHANGED"), TEXT("Sent after the focus window has realized its logical palette.")},
+    {0x0312, TEXT("WM_HOTKEY"), TEXT("Posted when the user presses a registered hot key.")},
+    {0x0317, TEXT("WM_PRINT"), TEXT("Sent to request that a window draw itself in a device context.")},
+    {0x0318, TEXT("WM_PRINTCLIENT"), TEXT("Sent to request that a window draw its client area in a device context.")},
+    {0x0319, TEXT("WM_APPCOMMAND"), TEXT("Sent when the user generates an application command event.")},
+    {0x031A, TEXT("WM_THEMECHANGED"), TEXT("Broadcast after a theme change event.")},
+    {0x031D, TEXT("WM_CLIPBOARDUPDATE"), TEXT("Sent when the contents of the clipboard have changed.")},
+    {0x031E, TEXT("WM_DWMCOMPOSITIONCHANGED"), TEXT("Sent when Desktop Window Manager composition is enabled or disabled.")},
+    {0x031F, TEXT("WM_DWMNCRENDERINGCHANGED"), TEXT("Sent when non-client area rendering policy has changed.")},
+    {0x0320, TEXT("WM_DWMCOLORIZATIONCOLORCHANGED"), TEXT("Sent when the colorization color has changed.")},
+    {0x0321, TEXT("WM_DWMWINDOWMAXIMIZEDCHANGE"), TEXT("Sent when a Desktop Window Manager composed window is maximized.")},
+    {0x0323, TEXT("WM_DWMSENDICONICTHUMBNAIL"), TEXT("Sent to request a static bitmap for a window's thumbnail.")},
+    {0x0326, TEXT("WM_DWMSENDICONICLIVEPREVIEWBITMAP"), TEXT("Sent to request a static bitmap for a window's live preview.")},
+    {0x033F, TEXT("WM_GETTITLEBARINFOEX"), TEXT("Sent to request information about a window's title bar.")},
+    {0x0358, TEXT("WM_HANDHELDFIRST"), TEXT("First message reserved for handheld devices.")},
+    {0x035F, TEXT("WM_HANDHELDLAST"), TEXT("Last message reserved for handheld devices.")},
+    {0x0360, TEXT("WM_AFXFIRST"), TEXT("First message reserved for MFC.")},
+    {0x037F, TEXT("WM_AFXLAST"), TEXT("Last message reserved for MFC.")},
+    {0x0380, TEXT("WM_PENWINFIRST"), TEXT("First message reserved for Pen Windows.")},
+    {0x038F, TEXT("WM_PENWINLAST"), TEXT("Last message reserved for Pen Windows.")},
+    {0x0400, TEXT("WM_USER"), TEXT("Base value for user-defined messages.")},
+    {0x8000, TEXT("WM_APP"), TEXT("Base value for application-defined messages.")},
+};
+
+inline constexpr int32 NumWindowsMessageCodes = UE_ARRAY_COUNT(WindowsMessageCodeTable);
+
+/**
+ * Checks that the table is strictly ascending, which binary search relies on.
+ * @return True if every code is greater than the one before it.
+ */
+constexpr bool IsWindowsMessageCodeTableSortedAndUnique()
+{
+    for (int32 Index = 1; Index < NumWindowsMessageCodes; ++Index)
+    {
+        if (WindowsMessageCodeTable[Index - 1].Code >= WindowsMessageCodeTable[Index].Code)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Finds a message code in the table with a binary search.
+ * @param MsgCode - The message code.
+ * @return The table entry, or nullptr if the code is unknown.
+ */
+constexpr const FWindowsMessageCodeEntry* FindWindowsMessageCodeEntry(uint32 MsgCode)
+{
+    int32 First = 0;
+    int32 Count = NumWindowsMessageCodes;
+    while (Count > 0)
+    {
+        const int32 Step = Count / 2;
+        if (WindowsMessageCodeTable[First + Step].Code < MsgCode)
+        {
+            First += Step + 1;
+            Count -= Step + 1;
+        }
+        else
+        {
+            Count = Step;
+        }
+    }
+    return (First < NumWindowsMessageCodes && WindowsMessageCodeTable[First].Code == MsgCode) ? &WindowsMessageCodeTable[First] : nullptr;
+}
+
+/**
+ * Case-insensitive FNV-1a hash of a message name. Message names are ASCII, so only ASCII letters are folded.
+ * @param Name - The characters of the name; need not be null-terminated.
+ * @param Length - The number of characters.
+ * @return The hash of the upper-cased name.
+ */
+constexpr uint32 HashWindowsMessageName(const TCHAR* Name, int32 Length)
+{
+    uint32 Hash = 2166136261u;
+    for (int32 Index = 0; Index < Length; ++Index)
+    {
+        TCHAR Char = Name[Index];
+        if (Char >= TEXT('a') && Char <= TEXT('z'))
+        {
+            Char = static_cast<TCHAR>(Char - TEXT('a') + TEXT('A'));
+        }
+        Hash = (Hash ^ static_cast<uint32>(Char)) * 16777619u;
+    }
+    return Hash;
+}
+
+/**
+ * @return The length of a null-terminated name, usable in constant expressions.
+ */
+constexpr int32 GetWindowsMessageNameLength(const TCHAR* Name)
+{
+    int32 Length = 0;
+    while (Name[Length] != 0)
+    {
+        ++Length;
+    }
+    return Length;
+}
+
+/**
+ * Open-addressing hash index from message name to table entry, built entirely at compile time.
+ */
+struct FWindowsMessageNameIndex
+{
+    static constexpr int32 NumSlots = 1024; // Power of two, at least four times the number of entries to keep probes short
+
+    int16 Slots[NumSlots] = {}; // Table index + 1 of the entry in each slot; 0 marks an empty slot
+
+    constexpr FWindowsMessageNameIndex()
+    {
+        for (int32 EntryIndex = 0; EntryIndex < NumWindowsMessageCodes; ++EntryIndex)
+        {
+            const TCHAR* Name = WindowsMessageCodeTable[EntryIndex].Name;
+            uint32 Slot = HashWindowsMessageName(Name, GetWindowsMessageNameLength(Name)) & (NumSlots - 1);
+            while (Slots[Slot] != 0)
+            {
+                Slot = (Slot + 1) & (NumSlots - 1);
+            }
+            Slots[Slot] = static_cast<int16>(EntryIndex + 1);
+        }
+    }
+
+    /**
+     * Finds the entry whose name matches, ignoring case.
+     * @param Name - The characters of the name; need not be null-terminated.
+     * @param Length - The number of characters.
+     * @return The table entry, or nullptr if no entry has this name.
+     */
+    constexpr const FWindowsMessageCodeEntry* Find(const TCHAR* Name, int32 Length) const
+    {
+        uint32 Slot = HashWindowsMessageName(Name, Length) & (NumSlots - 1);
+        while (Slots[Slot] != 0)
+        {
+            const FWindowsMessageCodeEntry& Entry = WindowsMessageCodeTable[Slots[Slot] - 1];
+            if (EqualsIgnoreCase(Entry.Name, Name, Length))
+            {
+                return &Entry;
+            }
+            Slot = (Slot + 1) & (NumSlots - 1);
+        }
+        return nullptr;
+    }
+
+private:
+
+    static constexpr bool EqualsIgnoreCase(const TCHAR* EntryName, const TCHAR* Name, int32 Length)
+    {
+        for (int32 Index = 0; Index < Length; ++Index)
+        {
+            TCHAR Char = Name[Index];
+            if (Char >= TEXT('a') && Char <= TEXT('z'))
+            {
+                Char = static_cast<TCHAR>(Char - TEXT('a') + TEXT('A'));
+            }
+            if (EntryName[Index] == 0 || EntryName[Index] != Char) // Table names are upper case
+            {
+                return false;
+            }
+        }
+        return EntryName[Length] == 0;
+    }
+};
+
+static_assert(FWindowsMessageNameIndex::NumSlots >= NumWindowsMessageCodes * 4, "FWindowsMessageNameIndex needs more slots for the table.");
+
+inline constexpr FWindowsMessageNameIndex WindowsMessageNameIndex;
@@ -0,0 +1,1506 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the FWindowsMessageDispatcher class.
+ */
+
+#include "WindowsMessageDispatcher.h"
+#include "WindowsMessageListenerState.h"
+#include "WindowsMessageCodeHelper.h"
+#include "WindowsMessageListenerLog.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/ScopeLock.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DEFINE_LOG_CATEGORY(LogWindowsMessageListener);
+
+#if WINDOWS_MESSAGE_LISTENER_STATS
+DECLARE_STATS_GROUP(TEXT("WindowsMessageListener"), STATGROUP_WindowsMessageListener, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Dispatch Message"), STAT_WindowsMessageListener_Dispatch, STATGROUP_WindowsMessageListener);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages Received"), STAT_WindowsMessageListener_Received, STATGROUP_WindowsMessageListener);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages Dispatched"), STAT_WindowsMessageListener_Dispatched, STATGROUP_WindowsMessageListener);
+
+// Enable with -trace=WindowsMessageListener to see every dispatch in Insights
+UE_TRACE_CHANNEL_DEFINE(WindowsMessageListenerChannel);
+#endif
+
+struct FWindowsMessageDispatcher::FHandlerRegistration
+{
+    FWindowsMessageHandlerRef Handler;         // The registered handler
+    FWindowsMessageBatchHandlerRef BatchHandler; // The registered batch handler; set instead of Handler
+    std::atomic<bool> bRemoved{false};         // Set on removal so dispatches still holding an older table skip it
+#if WINDOWS_MESSAGE_LISTENER_STATS
+    FWindowsMessageHandlerCounters Counters;   // Call count and timings of this handler
+#endif
+};
+
+namespace
+{
+    // Window handles are aligned pointers, so mix the high bits down before masking
+    FORCEINLINE uint32 HashWindowHandle(uint64 Hwnd)
+    {
+        return static_cast<uint32>((Hwnd * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+    constexpr uint8 NoHandlerRule = MAX_uint8; // HandlerRules entry of a handler without a rule
+
+    /** Intersects two sorted lists of disjoint inclusive code ranges. */
+    TArray<TPair<uint32, uint32>> IntersectCodeRanges(const TArray<TPair<uint32, uint32>>& A, const TArray<TPair<uint32, uint32>>& B)
+    {
+        TArray<TPair<uint32, uint32>> Result;
+        int32 IndexA = 0;
+        int32 IndexB = 0;
+        while (IndexA < A.Num() && IndexB < B.Num())
+        {
+            const uint32 First = FMath::Max(A[IndexA].Key, B[IndexB].Key);
+            const uint32 Last = FMath::Min(A[IndexA].Value, B[IndexB].Value);
+            if (First <= Last)
+            {
+                Result.Emplace(First, Last);
+            }
+            if (A[IndexA].Value < B[IndexB].Value)
+            {
+                ++IndexA;
+            }
+            else
+            {
+                ++IndexB;
+            }
+        }
+        return Result;
+    }
+}
+
+struct FWindowsMessageDispatcher::FDispatchTable
+{
+    TArray<uint32> RangeStarts;              // Sorted first code of each dispatch range; the first entry is always 0
+    TArray<int32> RangeOffsets;              // Offset of each range's handlers in Handlers, plus a trailing end offset
+    TArray<FHandlerRegistration*> Handlers;  // Handlers of every dispatch range, stored contiguously
+    TArray<uint8> HandlerRules;              // Rule index of each entry of Handlers, or NoHandlerRule
+};
+
+struct FWindowsMessageDispatcher::FDispatchSnapshot
+{
+    int32 NumLanes = 1;                          // Tables per window: the dispatching thread's, then one per worker
+    bool bHasWorkerHandlers = false;             // Whether any worker lane has handlers, so messages are only published when needed
+    TArray<FDispatchTable> GlobalTables;         // Handlers of every window, for windows without bound handlers, per lane
+    TArray<FDispatchTable> WindowTables;         // Handlers of every window merged with the bound handlers, NumLanes per window with bound handlers
+    TArray<uint64> WindowKeys;                   // Open-addressing hash of window handles, power-of-two sized; 0 marks an empty slot
+    TArray<int32> WindowTableIndices;            // Index of the window of each occupied slot of WindowKeys
+    TArray<FHandlerRegistration*> BatchHandlers; // Batch handlers, which receive every code
+    TSharedPtr<const FWindowsMessageRuleSet> Rules; // Rules referenced by HandlerRules, kept alive until the snapshot is freed
+
+    /**
+     * Finds the table of a lane for a window, or the lane's global table if no handler is bound to the window.
+     */
+    FORCEINLINE const FDispatchTable& FindTable(uint64 Hwnd, int32 Lane = 0) const
+    {
+        if (WindowKeys.Num() > 0 && Hwnd != 0)
+        {
+            const uint32 SlotMask = static_cast<uint32>(WindowKeys.Num() - 1);
+            for (uint32 Slot = HashWindowHandle(Hwnd) & SlotMask; WindowKeys[Slot] != 0; Slot = (Slot + 1) & SlotMask)
+            {
+                if (WindowKeys[Slot] == Hwnd)
+                {
+                    return WindowTables[WindowTableIndices[Slot] * NumLanes + Lane];
+                }
+            }
+        }
+        return GlobalTables[Lane];
+    }
+};
+
+FWindowsMessageDispatcher::FWindowsMessageDispatcher()
+{
+}
+
+FORCEINLINE const FWindowsMessageDispatcher::FDispatchSnapshot* FWindowsMessageDispatcher::EnterDispatch(int32 Lane)
+{
+    FDispatchEpochSlot& Slot = EpochSlots[Lane];
+    if (Slot.Depth++ == 0)
+    {
+        // Sequentially consistent, so a reclaim that misses this store can only have retired tables this load no longer sees
+        Slot.Epoch.store(ReclaimEpoch.load(std::memory_order_acquire));
+    }
+    return DispatchSnapshot.load();
+}
+
+FORCEINLINE void FWindowsMessageDispatcher::ExitDispatch(int32 Lane)
+{
+    FDispatchEpochSlot& Slot = EpochSlots[Lane];
+    if (--Slot.Depth == 0)
+    {
+        Slot.Epoch.store(0, std::memory_order_release);
+        if (bHasRetiredState.load(std::memory_order_relaxed))
+        {
+            TryReclaimRetiredState();
+        }
+    }
+}
+
+FWindowsMessageDispatcher::~FWindowsMessageDispatcher()
+{
+    StopCapture();
+    FlushCoalescedMessages(); // Forward anything still held back
+    DisableDeferredProcessing(); // Dispatch anything still queued
+    DisableMessageBatching(); // Deliver anything still collected
+    DisableParallelDispatch(); // Let the workers finish, before their handlers are freed
+    if (TickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+    }
+    RemoveAllHandlers();
+
+    FScopeLock Lock(&RegistrationLock);
+    ReclaimRetiredState(); // No dispatch can be running once the dispatcher is being destroyed
+}
+
+bool FWindowsMessageDispatcher::ProcessMessage(const FWindowsMessageRecord& Record, int32& OutResult)
+{
+    CaptureMessage(Record);
+    bool bHandled = false;
+    if (IsMessageAllowed(Record.Msg))
+    {
+        bHandled = AcceptMessage(Record, OutResult);
+    }
+    else
+    {
+        RejectMessage(Record);
+        TrackWindowLifetime(Record); // Accepted messages are tracked when they are dispatched
+    }
+    return bHandled;
+}
+
+bool FWindowsMessageDispatcher::ReplayMessage(const FWindowsMessageRecord& Record, int32& OutResult)
+{
+    if (IsMessageAllowed(Record.Msg))
+    {
+        return AcceptMessage(Record, OutResult);
+    }
+    RejectMessage(Record);
+    return false;
+}
+
+bool FWindowsMessageDispatcher::AcceptMessage(const FWindowsMessageRecord& Record, int32& OutResult)
+{
+#if WINDOWS_MESSAGE_LISTENER_STATS
+    MessageCodeCounters.AddReceived(Record.Msg);
+    INC_DWORD_STAT(STAT_WindowsMessageListener_Received);
+#endif
+
+    if (MessageLogger)
+    {
+        MessageLogger->Log(EWindowsMessageLogEvent::Accepted, Record);
+    }
+
+    if (Coalescer.IsCoalescedMessageType(Record.Msg))
+    {
+        // Held until the next flush; a newer message for the same window replaces it
+        Coalescer.Absorb(Record);
+        return false;
+    }
+
+    if (Coalescer.HasPendingMessages() && Coalescer.IsOrderingBarrier(Record.Msg))
+    {
+        FlushCoalescedMessages(); // Handlers must see the latest state before a key or button message
+    }
+
+    if (DeferredMessages)
+    {
+        // Only copy the message here; handlers run when the ring is drained
+        DeferredMessages->Push(Record);
+        return false;
+    }
+
+    const bool bConsumed = DispatchMessage(Record, OutResult);
+    return bConsumed && ConsumptionPolicy == EWindowsMessageConsumptionPolicy::Consume;
+}
+
+void FWindowsMessageDispatcher::RejectMessage(const FWindowsMessageRecord& Record)
+{
+#if WINDOWS_MESSAGE_LISTENER_STATS
+    MessageCodeCounters.AddReceived(Record.Msg);
+    MessageCodeCounters.AddFiltered(Record.Msg);
+    INC_DWORD_STAT(STAT_WindowsMessageListener_Received);
+#endif
+
+    if (MessageLogger)
+    {
+        MessageLogger->Log(EWindowsMessageLogEvent::Rejected, Record);
+    }
+}
+
+void FWindowsMessageDispatcher::TrackRejectedWindowLifetime(const FWindowsMessageRecord& Record)
+{
+    if (Coalescer.HasPendingMessages())
+    {
+        FlushCoalescedMessages(); // The window's handlers see its held messages first
+    }
+
+    if (DeferredMessages)
+    {
+        // Tracked when the ring is drained up to here, so the window's queued messages still reach its handlers
+        FWindowsMessageRecord Marker = Record;
+        Marker.Msg |= LifetimeOnlyMsgFlag;
+        if (DeferredMessages->Push(Marker))
+        {
+            return;
+        }
+    }
+    UnbindWindow(Record.Hwnd);
+}
+
+void FWindowsMessageDispatcher::UnbindWindow(uint64 Hwnd)
+{
+    if (FanOut)
+    {
+        FanOut->WaitUntilConsumed(); // Worker handlers bound to the window see its last messages first
+    }
+    RemoveWindowHandlers(Hwnd);
+}
+
+void FWindowsMessageDispatcher::ForwardMessage(const FWindowsMessageRecord& Record)
+{
+    if (DeferredMessages)
+    {
+        DeferredMessages->Push(Record);
+    }
+    else
+    {
+        int32 Result = 0;
+        DispatchMessage(Record, Result);
+    }
+}
+
+bool FWindowsMessageDispatcher::DispatchMessage(const FWindowsMessageRecord& Record, int32& OutResult)
+{
+#if WINDOWS_MESSAGE_LISTENER_STATS
+    SCOPE_CYCLE_COUNTER(STAT_WindowsMessageListener_Dispatch);
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("WindowsMessageListener::DispatchMessage", WindowsMessageListenerChannel);
+    MessageCodeCounters.AddDispatched(Record.Msg);
+    INC_DWORD_STAT(STAT_WindowsMessageListener_Dispatched);
+#endif
+
+    if (Record.Msg == WindowCreateMsg && NumBoundWindows.load(std::memory_order_relaxed) > 0)
+    {
+        RemoveWindowHandlers(Record.Hwnd); // Drop bindings left over from a reused handle, before handlers can bind to the new window
+    }
+
+    const uint64 DispatchCycles = LatencyTracker ? FPlatformTime::Cycles64() : 0;
+    const bool bStopOnConsumed = ConsumptionPolicy != EWindowsMessageConsumptionPolicy::Ignore;
+    bool bConsumed = false;
+
+    // Record the epoch before loading the table, so a concurrent change cannot free it underneath us
+    const FDispatchSnapshot* Snapshot = EnterDispatch(0);
+
+    // The filter has already been applied, so only the handlers subscribed to this code and window are visited
+    if (Snapshot)
+    {
+        bConsumed = InvokeHandlers(*Snapshot, Snapshot->FindTable(Record.Hwnd), Record, OutResult, bStopOnConsumed, FrameArena.Get());
+    }
+
+    if (!bConsumed && FanOut && Snapshot && Snapshot->bHasWorkerHandlers)
+    {
+        // One copy into the broadcast ring, however many handlers run on the workers
+        FanOut->Write(Record);
+        PublishToWorkers();
+    }
+
+    if (!bConsumed && Snapshot && Snapshot->BatchHandlers.Num() > 0)
+    {
+        BatchMessage(*Snapshot, Record);
+    }
+
+    if (LatencyTracker)
+    {
+        LatencyTracker->Add(Record, DispatchCycles, FPlatformTime::Cycles64());
+    }
+
+    ExitDispatch(0);
+
+    if (Record.Msg == WindowDestroyMsg && NumBoundWindows.load(std::memory_order_relaxed) > 0)
+    {
+        UnbindWindow(Record.Hwnd); // After dispatch, so a window's own handlers still see its WM_DESTROY
+    }
+    return bConsumed;
+}
+
+bool FWindowsMessageDispatcher::InvokeHandlers(const FDispatchSnapshot& Snapshot, const FDispatchTable& Table, const FWindowsMessageRecord& Record, int32& OutResult, bool bStopOnConsumed, FWindowsMessageFrameArena* Arena)
+{
+    const int32 RangeIndex = Algo::UpperBound(Table.RangeStarts, Record.Msg) - 1;
+    if (RangeIndex < 0)
+    {
+        return false;
+    }
+
+    // Each rule runs at most once per message, however many handlers are bound to it
+    uint64 EvaluatedRules = 0;
+    uint64 MatchedRules = 0;
+    const int32 EndOffset = Table.RangeOffsets[RangeIndex + 1];
+    for (int32 Offset = Table.RangeOffsets[RangeIndex]; Offset < EndOffset; ++Offset)
+    {
+        const uint8 RuleIndex = Table.HandlerRules[Offset];
+        if (RuleIndex != NoHandlerRule)
+        {
+            const uint64 RuleBit = uint64(1) << RuleIndex;
+            if (!(EvaluatedRules & RuleBit))
+            {
+                EvaluatedRules |= RuleBit;
+                MatchedRules |= Snapshot.Rules->Evaluate(RuleIndex, Record) ? RuleBit : 0;
+            }
+            if (!(MatchedRules & RuleBit))
+            {
+                continue;
+            }
+        }
+
+        FHandlerRegistration* Registration = Table.Handlers[Offset];
+        if (!Registration->bRemoved.load(std::memory_order_acquire))
+        {
+            if (bEnableVerboseLogging)
+            {
+                // Formatted into the frame arena when there is one, otherwise on the stack, so logging never touches the heap
+                if (Arena)
+                {
+                    const FStringView Line = FWindowsMessageCodeHelper::FormatMessageDetails(*Arena, TEXT("Forwarding message to handler"), Record.Hwnd, Record.Msg);
+                    UE_LOG(LogWindowsMessageListener, VeryVerbose, TEXT("%s"), Line.GetData());
+                }
+                else
+                {
+                    TStringBuilder<256> Line;
+                    FWindowsMessageCodeHelper::FormatMessageDetails(Line, TEXT("Forwarding message to handler"), Record.Hwnd, Record.Msg);
+                    UE_LOG(LogWindowsMessageListener, VeryVerbose, TEXT("%s"), Line.ToString());
+                }
+            }
+#if WINDOWS_MESSAGE_LISTENER_STATS
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            const bool bHandled = Registration->Handler.Invoke(Registration->Handler.Object, Record, OutResult);
+            Registration->Counters.AddCall(FPlatformTime::Cycles64() - StartCycles);
+#else
+            const bool bHandled = Registration->Handler.Invoke(Registration->Handler.Object, Record, OutResult);
+#endif
+            if (bHandled && bStopOnConsumed)
+            {
+                return true; // Lower priority handlers never see a consumed message
+            }
+        }
+    }
+    return false;
+}
+
+void FWindowsMessageDispatcher::DispatchWorkerMessages(int32 WorkerIndex, TArrayView<const FWindowsMessageRecord> Records)
+{
+    const int32 Lane = WorkerIndex + 1;
+    EpochSlots[Lane].ThreadId.store(FPlatformTLS::GetCurrentThreadId(), std::memory_order_relaxed);
+
+    // One snapshot for the whole run; handlers removed meanwhile are still skipped
+    const FDispatchSnapshot* Snapshot = EnterDispatch(Lane);
+    if (Snapshot && Lane < Snapshot->NumLanes)
+    {
+        for (const FWindowsMessageRecord& Record : Records)
+        {
+            int32 Result = 0;
+            InvokeHandlers(*Snapshot, Snapshot->FindTable(Record.Hwnd, Lane), Record, Result, false, nullptr); // Worker handlers cannot consume; the arena belongs to the pump thread
+        }
+    }
+    ExitDispatch(Lane);
+}
+
+void FWindowsMessageDispatcher::BatchMessage(const FDispatchSnapshot& Snapshot, const FWindowsMessageRecord& Record)
+{
+    if (!PendingBatch)
+    {
+        DeliverBatch(Snapshot, FWindowsMessageBatchView::FromRecord(Record));
+        return;
+    }
+
+    PendingBatch->Add(Record);
+    if (PendingBatch->Num() >= MaxBatchMessages)
+    {
+        DeliverBatch(Snapshot, PendingBatch->GetView());
+        PendingBatch->Reset();
+    }
+}
+
+void FWindowsMessageDispatcher::DeliverBatch(const FDispatchSnapshot& Snapshot, const FWindowsMessageBatchView& Batch)
+{
+    for (FHandlerRegistration* Registration : Snapshot.BatchHandlers)
+    {
+        if (!Registration->bRemoved.load(std::memory_order_acquire))
+        {
+#if WINDOWS_MESSAGE_LISTENER_STATS
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            Registration->BatchHandler.Invoke(Registration->BatchHandler.Object, Batch);
+            Registration->Counters.AddCall(FPlatformTime::Cycles64() - StartCycles);
+#else
+            Registration->BatchHandler.Invoke(Registration->BatchHandler.Object, Batch);
+#endif
+        }
+    }
+}
+
+void FWindowsMessageDispatcher::AddHandler(const FWindowsMessageHandlerRef& Handler, TArray<TPair<uint32, uint32>>&& Ranges, uint64 Hwnd)
+{
+    if (!Handler.Object || !Handler.Invoke)
+    {
+        return;
+    }
+
+    FScopeLock Lock(&RegistrationLock);
+
+    FHandlerSubscription* Subscription = Subscriptions.FindByPredicate([&Handler, Hwnd](const FHandlerSubscription& Existing) { return Existing.Registration->Handler.Object == Handler.Object && Existing.Hwnd == Hwnd; });
+    if (!Subscription)
+    {
+        // A handler already subscribed to another window keeps its priority, rule and thread
+        const FHandlerSubscription* Sibling = Subscriptions.FindByPredicate([&Handler](const FHandlerSubscription& Existing) { return Existing.Registration->Handler.Object == Handler.Object; });
+        const int32 Priority = Sibling ? Sibling->Priority : 0;
+        const FName Rule = Sibling ? Sibling->Rule : NAME_None;
+        const EWindowsMessageHandlerThread Thread = Sibling ? Sibling->Thread : EWindowsMessageHandlerThread::Pump;
+        const int32 Worker = Sibling ? Sibling->Worker : 0;
+
+        Subscription = &Subscriptions.InsertDefaulted_GetRef(FindSubscriptionInsertIndex(Priority));
+        Subscription->Registration = new FHandlerRegistration();
+        Subscription->Registration->Handler = Handler;
+        Subscription->Priority = Priority;
+        Subscription->Hwnd = Hwnd;
+        Subscription->Ranges = MoveTemp(Ranges);
+        Subscription->Rule = Rule;
+        Subscription->Thread = Thread;
+        Subscription->Worker = Worker;
+    }
+    else if (Subscription->Ranges.Num() > 0)
+    {
+        if (Ranges.Num() == 0)
+        {
+            Subscription->Ranges.Empty(); // Subscribing to all codes supersedes any specific codes
+        }
+        else
+        {
+            Subscription->Ranges.Append(MoveTemp(Ranges));
+        }
+    }
+
+    // Keep the ranges sorted and merged so the table rebuild only sees disjoint runs
+    TArray<TPair<uint32, uint32>>& SubscribedRanges = Subscription->Ranges;
+    if (SubscribedRanges.Num() > 1)
+    {
+        SubscribedRanges.Sort([](const TPair<uint32, uint32>& A, const TPair<uint32, uint32>& B) { return A.Key < B.Key; });
+        int32 WriteIndex = 0;
+        for (int32 ReadIndex = 1; ReadIndex < SubscribedRanges.Num(); ++ReadIndex)
+        {
+            TPair<uint32, uint32>& Current = SubscribedRanges[WriteIndex];
+            const TPair<uint32, uint32>& Next = SubscribedRanges[ReadIndex];
+            if (Current.Value == MAX_uint32 || Next.Key <= Current.Value + 1)
+            {
+                Current.Value = FMath::Max(Current.Value, Next.Value);
+            }
+            else
+            {
+                SubscribedRanges[++WriteIndex] = Next;
+            }
+        }
+        SubscribedRanges.SetNum(WriteIndex + 1);
+    }
+
+    PublishDispatchSnapshot();
+}
+
+void FWindowsMessageDispatcher::AddBatchHandler(const FWindowsMessageBatchHandlerRef& Handler)
+{
+    if (!Handler.Object || !Handler.Invoke)
+    {
+        return;
+    }
+
+    FScopeLock Lock(&RegistrationLock);
+    if (BatchSubscriptions.ContainsByPredicate([&Handler](const FHandlerRegistration* Existing) { return Existing->BatchHandler.Object == Handler.Object; }))
+    {
+        return;
+    }
+
+    FHandlerRegistration* Registration = new FHandlerRegistration();
+    Registration->BatchHandler = Handler;
+    BatchSubscriptions.Add(Registration);
+    PublishDispatchSnapshot();
+}
+
+bool FWindowsMessageDispatcher::RemoveHandler(const void* Object)
+{
+    uint32 WorkerLanes = 0;
+    uint64 RetiredEpoch = 0;
+    {
+        FScopeLock Lock(&RegistrationLock);
+        RetiredEpoch = ReclaimEpoch.load(std::memory_order_relaxed);
+        const int32 NumRemoved = Subscriptions.RemoveAll([this, Object, &WorkerLanes](const FHandlerSubscription& Subscription)
+        {
+            if (Subscription.Registration->Handler.Object == Object)
+            {
+                WorkerLanes |= (1u << GetSubscriptionLane(Subscription)) & ~1u;
+                RetireRegistration(Subscription.Registration);
+                return true;
+            }
+            return false;
+        });
+
+        const int32 BatchIndex = BatchSubscriptions.IndexOfByPredicate([Object](const FHandlerRegistration* Existing) { return Existing->BatchHandler.Object == Object; });
+        if (BatchIndex != INDEX_NONE)
+        {
+            RetireRegistration(BatchSubscriptions[BatchIndex]);
+            BatchSubscriptions.RemoveAt(BatchIndex);
+        }
+
+        if (NumRemoved == 0 && BatchIndex == INDEX_NONE)
+        {
+            return false;
+        }
+        PublishDispatchSnapshot();
+    }
+
+    // Outside the lock, so a worker handler that changes registrations can still finish its run
+    WaitForWorkerLanes(WorkerLanes, RetiredEpoch);
+    return true;
+}
+
+int32 FWindowsMessageDispatcher::RemoveWindowHandlers(uint64 Hwnd)
+{
+    if (Hwnd == 0)
+    {
+        return 0;
+    }
+
+    uint32 WorkerLanes = 0;
+    uint64 RetiredEpoch = 0;
+    int32 NumRemoved = 0;
+    {
+        FScopeLock Lock(&RegistrationLock);
+        RetiredEpoch = ReclaimEpoch.load(std::memory_order_relaxed);
+        NumRemoved = Subscriptions.RemoveAll([this, Hwnd, &WorkerLanes](const FHandlerSubscription& Subscription)
+        {
+            if (Subscription.Hwnd == Hwnd)
+            {
+                WorkerLanes |= (1u << GetSubscriptionLane(Subscription)) & ~1u;
+                RetireRegistration(Subscription.Registration);
+                return true;
+            }
+            return false;
+        });
+
+        if (NumRemoved > 0)
+        {
+            PublishDispatchSnapshot();
+        }
+    }
+
+    WaitForWorkerLanes(WorkerLanes, RetiredEpoch);
+    return NumRemoved;
+}
+
+void FWindowsMessageDispatcher::RemoveAllHandlers()
+{
+    uint32 WorkerLanes = 0;
+    uint64 RetiredEpoch = 0;
+    {
+        FScopeLock Lock(&RegistrationLock);
+        RetiredEpoch = ReclaimEpoch.load(std::memory_order_relaxed);
+        for (const FHandlerSubscription& Subscription : Subscriptions)
+        {
+            WorkerLanes |= (1u << GetSubscriptionLane(Subscription)) & ~1u;
+            RetireRegistration(Subscription.Registration);
+        }
+        for (FHandlerRegistration* Registration : BatchSubscriptions)
+        {
+            RetireRegistration(Registration);
+        }
+        Subscriptions.Empty();
+        BatchSubscriptions.Empty();
+        PublishDispatchSnapshot();
+    }
+
+    WaitForWorkerLanes(WorkerLanes, RetiredEpoch);
+}
+
+void FWindowsMessageDispatcher::WaitForWorkerLanes(uint32 WorkerLanes, uint64 RetiredEpoch) const
+{
+    const uint32 ThreadId = FPlatformTLS::GetCurrentThreadId();
+    for (int32 Lane = 1; Lane <= FWindowsMessageFanOut::MaxWorkers; ++Lane)
+    {
+        const FDispatchEpochSlot& Slot = EpochSlots[Lane];
+        if (!(WorkerLanes & (1u << Lane)) || Slot.ThreadId.load(std::memory_order_relaxed) == ThreadId)
+        {
+            continue; // A worker removing handlers is between two handler calls, and skips removed handlers from here on
+        }
+
+        // A run that started after the removal was published uses a table without the removed handlers
+        for (uint64 Epoch = Slot.Epoch.load(); Epoch != 0 && Epoch <= RetiredEpoch; Epoch = Slot.Epoch.load())
+        {
+            FPlatformProcess::YieldThread();
+        }
+    }
+}
+
+void FWindowsMessageDispatcher::RetireRegistration(FHandlerRegistration* Registration)
+{
+    Registration->bRemoved.store(true, std::memory_order_release);
+    RetiredRegistrations.Emplace(Registration, ReclaimEpoch.load(std::memory_order_relaxed));
+}
+
+bool FWindowsMessageDispatcher::SetHandlerPriority(const void* Object, int32 Priority)
+{
+    FScopeLock Lock(&RegistrationLock);
+    TArray<FHandlerSubscription, TInlineAllocator<4>> Moved;
+    for (int32 Index = Subscriptions.Num() - 1; Index >= 0; --Index)
+    {
+        if (Subscriptions[Index].Registration->Handler.Object == Object)
+        {
+            Moved.Insert(MoveTemp(Subscriptions[Index]), 0);
+            Subscriptions.RemoveAt(Index);
+        }
+    }
+    if (Moved.Num() == 0)
+    {
+        return false;
+    }
+
+    // Move the subscriptions behind every other subscription of the same priority
+    for (FHandlerSubscription& Subscription : Moved)
+    {
+        Subscription.Priority = Priority;
+        Subscriptions.Insert(MoveTemp(Subscription), FindSubscriptionInsertIndex(Priority));
+    }
+    PublishDispatchSnapshot();
+    return true;
+}
+
+void FWindowsMessageDispatcher::SetMessageRules(TSharedPtr<const FWindowsMessageRuleSet> Rules)
+{
+    FScopeLock Lock(&RegistrationLock);
+    MessageRules = MoveTemp(Rules);
+
+    TArray<FName, TInlineAllocator<8>> MissingRules;
+    for (const FHandlerSubscription& Subscription : Subscriptions)
+    {
+        if (!Subscription.Rule.IsNone() && (!MessageRules || MessageRules->FindRule(Subscription.Rule) == INDEX_NONE))
+        {
+            MissingRules.AddUnique(Subscription.Rule);
+        }
+    }
+    for (const FName RuleName : MissingRules)
+    {
+        UE_LOG(LogWindowsMessageListener, Warning, TEXT("Message rule %s is not defined; handlers bound to it receive no messages."), *RuleName.ToString());
+    }
+    PublishDispatchSnapshot();
+}
+
+TSharedPtr<const FWindowsMessageRuleSet> FWindowsMessageDispatcher::GetMessageRules() const
+{
+    FScopeLock Lock(&RegistrationLock);
+    return MessageRules;
+}
+
+bool FWindowsMessageDispatcher::SetHandlerRule(const void* Object, FName RuleName)
+{
+    FScopeLock Lock(&RegistrationLock);
+    bool bFound = false;
+    for (FHandlerSubscription& Subscription : Subscriptions)
+    {
+        if (Subscription.Registration->Handler.Object == Object)
+        {
+            Subscription.Rule = RuleName;
+            bFound = true;
+        }
+    }
+    if (!bFound)
+    {
+        return false;
+    }
+
+    if (!RuleName.IsNone() && (!MessageRules || MessageRules->FindRule(RuleName) == INDEX_NONE))
+    {
+        UE_LOG(LogWindowsMessageListener, Warning, TEXT("Message rule %s is not defined; the handler receives no messages until it is."), *RuleName.ToString());
+    }
+    PublishDispatchSnapshot();
+    return true;
+}
+
+bool FWindowsMessageDispatcher::SetHandlerThread(const void* Object, EWindowsMessageHandlerThread Thread, int32 PreferredWorker)
+{
+    // Messages already queued reach the handler on its old thread before it moves
+    if (FanOut)
+    {
+        FanOut->WaitUntilConsumed();
+    }
+
+    FScopeLock Lock(&RegistrationLock);
+    const int32 Worker = PreferredWorker >= 0 ? PreferredWorker : NextWorker;
+    bool bFound = false;
+    for (FHandlerSubscription& Subscription : Subscriptions)
+    {
+        if (Subscription.Registration->Handler.Object == Object)
+        {
+            Subscription.Thread = Thread;
+            Subscription.Worker = Worker;
+            bFound = true;
+        }
+    }
+    if (!bFound)
+    {
+        return false;
+    }
+
+    if (Thread == EWindowsMessageHandlerThread::Worker && PreferredWorker < 0)
+    {
+        ++NextWorker;
+    }
+    PublishDispatchSnapshot();
+    return true;
+}
+
+void FWindowsMessageDispatcher::SetConsumptionPolicy(EWindowsMessageConsumptionPolicy Policy)
+{
+    ConsumptionPolicy = Policy;
+}
+
+EWindowsMessageConsumptionPolicy FWindowsMessageDispatcher::GetConsumptionPolicy() const
+{
+    return ConsumptionPolicy;
+}
+
+int32 FWindowsMessageDispatcher::FindSubscriptionInsertIndex(int32 Priority) const
+{
+    return Algo::UpperBoundBy(Subscriptions, Priority, &FHandlerSubscription::Priority, TGreater<int32>());
+}
+
+void FWindowsMessageDispatcher::PublishDispatchSnapshot()
+{
+    FDispatchSnapshot* NewSnapshot = nullptr;
+    int32 NumWindows = 0;
+    if (Subscriptions.Num() > 0 || BatchSubscriptions.Num() > 0)
+    {
+        NewSnapshot = new FDispatchSnapshot();
+        NewSnapshot->NumLanes = NumDispatchLanes;
+        NewSnapshot->BatchHandlers = BatchSubscriptions;
+        NewSnapshot->Rules = MessageRules;
+        NewSnapshot->GlobalTables.SetNum(NumDispatchLanes);
+        for (int32 Lane = 0; Lane < NumDispatchLanes; ++Lane)
+        {
+            BuildDispatchTable(NewSnapshot->GlobalTables[Lane], 0, Lane);
+        }
+
+        TArray<uint64> BoundWindows;
+        for (const FHandlerSubscription& Subscription : Subscriptions)
+        {
+            if (Subscription.Hwnd != 0)
+            {
+                BoundWindows.AddUnique(Subscription.Hwnd);
+            }
+            NewSnapshot->bHasWorkerHandlers |= GetSubscriptionLane(Subscription) != 0;
+        }
+
+        // Each window with bound handlers gets its own table, found by linear probing in a half-empty hash
+        NumWindows = BoundWindows.Num();
+        if (NumWindows > 0)
+        {
+            const uint32 NumSlots = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(NumWindows) * 2);
+            NewSnapshot->WindowKeys.SetNumZeroed(NumSlots);
+            NewSnapshot->WindowTableIndices.SetNumZeroed(NumSlots);
+            NewSnapshot->WindowTables.SetNum(NumWindows * NumDispatchLanes);
+            for (int32 WindowIndex = 0; WindowIndex < NumWindows; ++WindowIndex)
+            {
+                const uint64 Hwnd = BoundWindows[WindowIndex];
+                for (int32 Lane = 0; Lane < NumDispatchLanes; ++Lane)
+                {
+                    BuildDispatchTable(NewSnapshot->WindowTables[WindowIndex * NumDispatchLanes + Lane], Hwnd, Lane);
+                }
+
+                uint32 Slot = HashWindowHandle(Hwnd) & (NumSlots - 1);
+                while (NewSnapshot->WindowKeys[Slot] != 0)
+                {
+                    Slot = (Slot + 1) & (NumSlots - 1);
+                }
+                NewSnapshot->WindowKeys[Slot] = Hwnd;
+                NewSnapshot->WindowTableIndices[Slot] = WindowIndex;
+            }
+        }
+    }
+    NumBoundWindows.store(NumWindows, std::memory_order_relaxed);
+
+    // Dispatches that already loaded the old table keep using it until they finish; those entering the next epoch see the new one
+    if (FDispatchSnapshot* OldSnapshot = DispatchSnapshot.exchange(NewSnapshot))
+    {
+        RetiredSnapshots.Emplace(OldSnapshot, ReclaimEpoch.load(std::memory_order_relaxed));
+    }
+    ReclaimEpoch.fetch_add(1);
+    bHasRetiredState.store(RetiredSnapshots.Num() > 0 || RetiredRegistrations.Num() > 0, std::memory_order_relaxed);
+    ReclaimRetiredState();
+}
+
+int32 FWindowsMessageDispatcher::GetSubscriptionLane(const FHandlerSubscription& Subscription) const
+{
+    if (Subscription.Thread != EWindowsMessageHandlerThread::Worker || NumDispatchLanes == 1)
+    {
+        return 0;
+    }
+    return 1 + Subscription.Worker % (NumDispatchLanes - 1);
+}
+
+void FWindowsMessageDispatcher::BuildDispatchTable(FDispatchTable& OutTable, uint64 Hwnd, int32 Lane) const
+{
+    // The codes each subscription receives in this table: its subscribed codes, narrowed to those its rule can accept
+    struct FTableCodes
+    {
+        bool bAllCodes = false;               // Receives every code
+        uint8 Rule = NoHandlerRule;           // Index of its rule in MessageRules
+        TArray<TPair<uint32, uint32>> Ranges; // Inclusive code ranges, when bAllCodes is false
+    };
+    TArray<FTableCodes> Codes;
+    Codes.SetNum(Subscriptions.Num());
+    for (int32 Index = 0; Index < Subscriptions.Num(); ++Index)
+    {
+        const FHandlerSubscription& Subscription = Subscriptions[Index];
+        if ((Subscription.Hwnd != 0 && Subscription.Hwnd != Hwnd) || GetSubscriptionLane(Subscription) != Lane)
+        {
+            continue;
+        }
+
+        FTableCodes& SubscriptionCodes = Codes[Index];
+        SubscriptionCodes.bAllCodes = Subscription.Ranges.Num() == 0;
+        SubscriptionCodes.Ranges = Subscription.Ranges;
+        if (Subscription.Rule.IsNone())
+        {
+            continue;
+        }
+
+        const int32 RuleIndex = MessageRules ? MessageRules->FindRule(Subscription.Rule) : INDEX_NONE;
+        if (RuleIndex == INDEX_NONE)
+        {
+            SubscriptionCodes.bAllCodes = false; // A missing rule accepts nothing
+            SubscriptionCodes.Ranges.Reset();
+            continue;
+        }
+        SubscriptionCodes.Rule = static_cast<uint8>(RuleIndex);
+
+        TArray<TPair<uint32, uint32>> RuleRanges;
+        if (MessageRules->GetRuleCodeRanges(RuleIndex, RuleRanges))
+        {
+            SubscriptionCodes.Ranges = SubscriptionCodes.bAllCodes ? MoveTemp(RuleRanges) : IntersectCodeRanges(SubscriptionCodes.Ranges, RuleRanges);
+            SubscriptionCodes.bAllCodes = false;
+        }
+    }
+
+    // Every range boundary starts a run of codes whose handler list is constant
+    TArray<uint32> Boundaries;
+    Boundaries.Add(0);
+    for (const FTableCodes& SubscriptionCodes : Codes)
+    {
+        for (const TPair<uint32, uint32>& Range : SubscriptionCodes.Ranges)
+        {
+            Boundaries.Add(Range.Key);
+            if (Range.Value != MAX_uint32)
+            {
+                Boundaries.Add(Range.Value + 1);
+            }
+        }
+    }
+    Boundaries.Sort();
+
+    TArray<FHandlerRegistration*> RunHandlers;
+    TArray<uint8> RunRules;
+    uint32 PreviousBoundary = 0;
+    for (int32 BoundaryIndex = 0; BoundaryIndex < Boundaries.Num(); ++BoundaryIndex)
+    {
+        const uint32 RunStart = Boundaries[BoundaryIndex];
+        if (BoundaryIndex > 0 && RunStart == PreviousBoundary)
+        {
+            continue;
+        }
+        PreviousBoundary = RunStart;
+
+        RunHandlers.Reset();
+        RunRules.Reset();
+        for (int32 Index = 0; Index < Subscriptions.Num(); ++Index)
+        {
+            const FTableCodes& SubscriptionCodes = Codes[Index];
+            const bool bSubscribed = SubscriptionCodes.bAllCodes || SubscriptionCodes.Ranges.ContainsByPredicate(
+                [RunStart](const TPair<uint32, uint32>& Range) { return RunStart >= Range.Key && RunStart <= Range.Value; });
+            if (bSubscribed)
+            {
+                RunHandlers.Add(Subscriptions[Index].Registration);
+                RunRules.Add(SubscriptionCodes.Rule);
+            }
+        }
+
+        // Merge runs that dispatch to the same handlers to keep the table small; a handler's rule is the same in every run
+        const int32 LastRange = OutTable.RangeStarts.Num() - 1;
+        if (LastRange >= 0)
+        {
+            const int32 LastOffset = OutTable.RangeOffsets[LastRange];
+            if (OutTable.Handlers.Num() - LastOffset == RunHandlers.Num() &&
+                FMemory::Memcmp(OutTable.Handlers.GetData() + LastOffset, RunHandlers.GetData(), RunHandlers.Num() * sizeof(FHandlerRegistration*)) == 0)
+            {
+                continue;
+            }
+        }
+
+        OutTable.RangeStarts.Add(RunStart);
+        OutTable.RangeOffsets.Add(OutTable.Handlers.Num());
+        OutTable.Handlers.Append(RunHandlers);
+        OutTable.HandlerRules.Append(RunRules);
+    }
+    OutTable.RangeOffsets.Add(OutTable.Handlers.Num());
+}
+
+void FWindowsMessageDispatcher::ReclaimRetiredState()
+{
+    // A dispatch that started in an epoch can only reach state retired in that epoch or later
+    uint64 OldestActiveEpoch = MAX_uint64;
+    for (const FDispatchEpochSlot& Slot : EpochSlots)
+    {
+        const uint64 Epoch = Slot.Epoch.load();
+        if (Epoch != 0)
+        {
+            OldestActiveEpoch = FMath::Min(OldestActiveEpoch, Epoch);
+        }
+    }
+
+    RetiredSnapshots.RemoveAllSwap([OldestActiveEpoch](const TPair<FDispatchSnapshot*, uint64>& Retired)
+    {
+        if (Retired.Value < OldestActiveEpoch)
+        {
+            delete Retired.Key;
+            return true;
+        }
+        return false;
+    });
+    RetiredRegistrations.RemoveAllSwap([OldestActiveEpoch](const TPair<FHandlerRegistration*, uint64>& Retired)
+    {
+        if (Retired.Value < OldestActiveEpoch)
+        {
+            delete Retired.Key;
+            return true;
+        }
+        return false;
+    });
+    bHasRetiredState.store(RetiredSnapshots.Num() > 0 || RetiredRegistrations.Num() > 0, std::memory_order_relaxed);
+}
+
+void FWindowsMessageDispatcher::TryReclaimRetiredState()
+{
+    if (RegistrationLock.TryLock())
+    {
+        ReclaimRetiredState();
+        RegistrationLock.Unlock();
+    }
+}
+
+void FWindowsMessageDispatcher::AllowMessageType(uint32 MsgCode)
+{
+    AllowedMessageTypes.Allow(MsgCode);
+}
+
+void FWindowsMessageDispatcher::DisallowMessageType(uint32 MsgCode)
+{
+    AllowedMessageTypes.Disallow(MsgCode);
+}
+
+void FWindowsMessageDispatcher::AllowMessageRange(uint32 FirstMsgCode, uint32 LastMsgCode)
+{
+    AllowedMessageTypes.AllowRange(FirstMsgCode, LastMsgCode);
+}
+
+void FWindowsMessageDispatcher::DisallowMessageRange(uint32 FirstMsgCode, uint32 LastMsgCode)
+{
+    AllowedMessageTypes.DisallowRange(FirstMsgCode, LastMsgCode);
+}
+
+void FWindowsMessageDispatcher::AllowMessageTypes(TArrayView<const uint32> MsgCodes)
+{
+    for (uint32 MsgCode : MsgCodes)
+    {
+        AllowedMessageTypes.Allow(MsgCode);
+    }
+}
+
+void FWindowsMessageDispatcher::DisallowMessageTypes(TArrayView<const uint32> MsgCodes)
+{
+    for (uint32 MsgCode : MsgCodes)
+    {
+        AllowedMessageTypes.Disallow(MsgCode);
+    }
+}
+
+void FWindowsMessageDispatcher::ClearAllowedMessageTypes()
+{
+    AllowedMessageTypes.Reset();
+}
+
+int32 FWindowsMessageDispatcher::SaveState(FWindowsMessageListenerState& OutState, TFunctionRef<FName(const void* Object)> GetHandlerName) const
+{
+    OutState.AllowedMessageTypes = AllowedMessageTypes;
+    OutState.CoalescedMessageTypes = Coalescer.GetCoalescedMessageTypes();
+    OutState.ConsumptionPolicy = ConsumptionPolicy;
+    OutState.Subscriptions.Reset();
+
+    FScopeLock Lock(&RegistrationLock);
+    for (const FHandlerSubscription& Subscription : Subscriptions)
+    {
+        const FName HandlerName = Subscription.Hwnd == 0 ? GetHandlerName(Subscription.Registration->Handler.Object) : NAME_None;
+        if (HandlerName.IsNone())
+        {
+            continue;
+        }
+
+        FWindowsMessageSubscriptionState& Saved = OutState.Subscriptions.AddDefaulted_GetRef();
+        Saved.Handler = HandlerName;
+        Saved.Priority = Subscription.Priority;
+        Saved.Ranges = Subscription.Ranges;
+        Saved.Rule = Subscription.Rule;
+        Saved.Thread = Subscription.Thread;
+        Saved.Worker = Subscription.Worker;
+    }
+    return OutState.Subscriptions.Num();
+}
+
+int32 FWindowsMessageDispatcher::RestoreState(const FWindowsMessageListenerState& State, TFunctionRef<FWindowsMessageHandlerRef(FName HandlerName)> FindHandler)
+{
+    AllowedMessageTypes = State.AllowedMessageTypes;
+    ConsumptionPolicy = State.ConsumptionPolicy;
+
+    FlushCoalescedMessages(); // Don't strand a pending message of a type that is no longer coalesced
+    Coalescer.SetCoalescedMessageTypes(State.CoalescedMessageTypes);
+    NumCoalescedMessageTypes = State.CoalescedMessageTypes.Num();
+    UpdateTicker();
+
+    // Messages already queued reach restored handlers on their old threads before they move
+    if (FanOut)
+    {
+        FanOut->WaitUntilConsumed();
+    }
+
+    FScopeLock Lock(&RegistrationLock);
+    TMap<const void*, const FWindowsMessageSubscriptionState*> Restored;
+    Restored.Reserve(State.Subscriptions.Num());
+    for (const FWindowsMessageSubscriptionState& Saved : State.Subscriptions)
+    {
+        const FWindowsMessageHandlerRef Handler = FindHandler(Saved.Handler);
+        if (!Handler.Object || !Handler.Invoke)
+        {
+            continue;
+        }
+
+        FHandlerSubscription* Subscription = Subscriptions.FindByPredicate([&Handler](const FHandlerSubscription& Existing) { return Existing.Registration->Handler.Object == Handler.Object && Existing.Hwnd == 0; });
+        if (!Subscription)
+        {
+            Subscription = &Subscriptions.AddDefaulted_GetRef();
+            Subscription->Registration = new FHandlerRegistration();
+            Subscription->Registration->Handler = Handler;
+        }
+        Subscription->Ranges = Saved.Ranges;
+        Restored.Add(Handler.Object, &Saved);
+    }
+
+    for (FHandlerSubscription& Subscription : Subscriptions)
+    {
+        if (const FWindowsMessageSubscriptionState* const* Saved = Restored.Find(Subscription.Registration->Handler.Object))
+        {
+            Subscription.Priority = (*Saved)->Priority;
+            Subscription.Rule = (*Saved)->Rule;
+            Subscription.Thread = (*Saved)->Thread;
+            Subscription.Worker = (*Saved)->Worker;
+        }
+    }
+
+    // New subscriptions were appended in their saved dispatch order, so a stable sort restores that order
+    Subscriptions.StableSort([](const FHandlerSubscription& A, const FHandlerSubscription& B) { return A.Priority > B.Priority; });
+    PublishDispatchSnapshot();
+    return Restored.Num();
+}
+
+void FWindowsMessageDispatcher::EnableDeferredProcessing(uint32 Capacity, EWindowsMessageOverflowPolicy OverflowPolicy, bool bDrainOnTick)
+{
+    DisableDeferredProcessing();
+
+    DeferredMessages = MakeUnique<FWindowsMessageRing>(Capacity, OverflowPolicy);
+    bDrainDeferredOnTick = bDrainOnTick;
+    UpdateTicker();
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Deferred processing enabled: capacity=%u, drain on tick=%s"), DeferredMessages->GetCapacity(), bDrainOnTick ? TEXT("true") : TEXT("false"));
+}
+
+void FWindowsMessageDispatcher::DisableDeferredProcessing()
+{
+    if (DeferredMessages)
+    {
+        DrainDeferredMessages();
+        DeferredMessages.Reset();
+        bDrainDeferredOnTick = false;
+        UpdateTicker();
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Deferred processing disabled."));
+    }
+}
+
+bool FWindowsMessageDispatcher::IsDeferredProcessingEnabled() const
+{
+    return DeferredMessages.IsValid();
+}
+
+int32 FWindowsMessageDispatcher::DrainDeferredMessages(int32 MaxMessages)
+{
+    if (!DeferredMessages)
+    {
+        return 0;
+    }
+
+    int32 NumDrained = 0;
+    {
+        // The workers get the whole drained run in one publish
+        TGuardValue<bool> HoldPublish(bHoldFanOutPublish, true);
+        NumDrained = DeferredMessages->Drain([this](const FWindowsMessageRecord& Record)
+        {
+            if (Record.Msg & LifetimeOnlyMsgFlag)
+            {
+                UnbindWindow(Record.Hwnd); // A rejected WM_CREATE or WM_DESTROY, queued behind the window's last messages
+                return;
+            }
+            int32 Result = 0;
+            DispatchMessage(Record, Result);
+        }, MaxMessages);
+    }
+    PublishToWorkers();
+    return NumDrained;
+}
+
+FWindowsMessageRingCounters FWindowsMessageDispatcher::GetDeferredMessageCounters() const
+{
+    return DeferredMessages ? DeferredMessages->GetCounters() : FWindowsMessageRingCounters();
+}
+
+void FWindowsMessageDispatcher::EnableMessageBatching(int32 MaxMessages, bool bFlushOnTick)
+{
+    DisableMessageBatching();
+
+    MaxBatchMessages = FMath::Max(MaxMessages, 1);
+    PendingBatch = MakeUnique<FWindowsMessageBatch>();
+    PendingBatch->Reserve(MaxBatchMessages);
+    bFlushBatchOnTick = bFlushOnTick;
+    UpdateTicker();
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Message batching enabled: max messages=%d, flush on tick=%s"), MaxBatchMessages, bFlushOnTick ? TEXT("true") : TEXT("false"));
+}
+
+void FWindowsMessageDispatcher::DisableMessageBatching()
+{
+    if (PendingBatch)
+    {
+        FlushMessageBatch();
+        PendingBatch.Reset();
+        bFlushBatchOnTick = false;
+        UpdateTicker();
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Message batching disabled."));
+    }
+}
+
+bool FWindowsMessageDispatcher::IsMessageBatchingEnabled() const
+{
+    return PendingBatch.IsValid();
+}
+
+int32 FWindowsMessageDispatcher::FlushMessageBatch()
+{
+    if (!PendingBatch || PendingBatch->Num() == 0)
+    {
+        return 0;
+    }
+
+    const int32 NumMessages = PendingBatch->Num();
+    if (const FDispatchSnapshot* Snapshot = EnterDispatch(0))
+    {
+        DeliverBatch(*Snapshot, PendingBatch->GetView());
+    }
+    PendingBatch->Reset();
+    ExitDispatch(0);
+    return NumMessages;
+}
+
+void FWindowsMessageDispatcher::EnableFrameArena(int32 BlockBytes)
+{
+    FrameArena = MakeUnique<FWindowsMessageFrameArena>(BlockBytes);
+    UpdateTicker();
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Frame arena enabled: block size=%d"), BlockBytes);
+}
+
+void FWindowsMessageDispatcher::DisableFrameArena()
+{
+    if (FrameArena)
+    {
+        FrameArena.Reset();
+        UpdateTicker();
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Frame arena disabled."));
+    }
+}
+
+void FWindowsMessageDispatcher::ResetFrameArena()
+{
+    if (FrameArena)
+    {
+        FrameArena->Reset();
+    }
+}
+
+FWindowsMessageArenaCounters FWindowsMessageDispatcher::GetFrameArenaCounters() const
+{
+    return FrameArena ? FrameArena->GetCounters() : FWindowsMessageArenaCounters();
+}
+
+void FWindowsMessageDispatcher::EnableMessageLogging(int32 Capacity, bool bBackgroundThread)
+{
+    if (!MessageLogger)
+    {
+        MessageLogger = MakeUnique<FWindowsMessageLogger>();
+    }
+    MessageLogger->Start(Capacity, bBackgroundThread);
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Message logging enabled: capacity=%d, background thread=%s"), Capacity, bBackgroundThread ? TEXT("true") : TEXT("false"));
+}
+
+void FWindowsMessageDispatcher::DisableMessageLogging()
+{
+    if (MessageLogger)
+    {
+        MessageLogger.Reset(); // Stops the writer thread and writes what is left
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Message logging disabled."));
+    }
+}
+
+FWindowsMessageLogCounters FWindowsMessageDispatcher::GetMessageLogCounters() const
+{
+    return MessageLogger ? MessageLogger->GetCounters() : FWindowsMessageLogCounters();
+}
+
+void FWindowsMessageDispatcher::EnableLatencyTracking(int32 MaxTrackedCodes, int32 TimelineCapacity)
+{
+    LatencyTracker = MakeUnique<FWindowsMessageLatencyTracker>(MaxTrackedCodes, TimelineCapacity);
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Latency tracking enabled: tracked codes=%d, timelines=%d"), MaxTrackedCodes, TimelineCapacity);
+}
+
+void FWindowsMessageDispatcher::DisableLatencyTracking()
+{
+    if (LatencyTracker)
+    {
+        LatencyTracker.Reset();
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Latency tracking disabled."));
+    }
+}
+
+FWindowsMessageLatencyStats FWindowsMessageDispatcher::GetLatencyStats() const
+{
+    return LatencyTracker ? LatencyTracker->GetStats() : FWindowsMessageLatencyStats();
+}
+
+void FWindowsMessageDispatcher::EnableParallelDispatch(int32 NumWorkers, uint32 Capacity, bool bWaitWhenFull)
+{
+    DisableParallelDispatch();
+
+    FanOut = MakeUnique<FWindowsMessageFanOut>(NumWorkers, Capacity, bWaitWhenFull, [this](int32 WorkerIndex, TArrayView<const FWindowsMessageRecord> Records)
+    {
+        DispatchWorkerMessages(WorkerIndex, Records);
+    });
+
+    FScopeLock Lock(&RegistrationLock);
+    NumDispatchLanes = 1 + FanOut->GetNumWorkers();
+    PublishDispatchSnapshot();
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Parallel dispatch enabled: workers=%d, capacity=%u, wait when full=%s"), FanOut->GetNumWorkers(), Capacity, bWaitWhenFull ? TEXT("true") : TEXT("false"));
+}
+
+void FWindowsMessageDispatcher::DisableParallelDispatch()
+{
+    if (!FanOut)
+    {
+        return;
+    }
+
+    // The workers finish every queued message before their handlers move back to this thread
+    FanOut->Stop();
+    FanOut.Reset();
+
+    FScopeLock Lock(&RegistrationLock);
+    NumDispatchLanes = 1;
+    PublishDispatchSnapshot();
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Parallel dispatch disabled."));
+}
+
+void FWindowsMessageDispatcher::WaitForParallelDispatch()
+{
+    if (FanOut)
+    {
+        FanOut->WaitUntilConsumed();
+    }
+}
+
+FWindowsMessageFanOutCounters FWindowsMessageDispatcher::GetParallelDispatchCounters() const
+{
+    return FanOut ? FanOut->GetCounters() : FWindowsMessageFanOutCounters();
+}
+
+void FWindowsMessageDispatcher::AddCoalescedMessageType(uint32 MsgCode)
+{
+    if (!Coalescer.IsCoalescedMessageType(MsgCode))
+    {
+        Coalescer.SetCoalescedMessageType(MsgCode, true);
+        ++NumCoalescedMessageTypes;
+        UpdateTicker();
+    }
+}
+
+void FWindowsMessageDispatcher::RemoveCoalescedMessageType(uint32 MsgCode)
+{
+    if (Coalescer.IsCoalescedMessageType(MsgCode))
+    {
+        FlushCoalescedMessages(); // Don't strand a pending message of this type
+        Coalescer.SetCoalescedMessageType(MsgCode, false);
+        --NumCoalescedMessageTypes;
+        UpdateTicker();
+    }
+}
+
+int32 FWindowsMessageDispatcher::FlushCoalescedMessages()
+{
+    int32 NumFlushed = 0;
+    {
+        TGuardValue<bool> HoldPublish(bHoldFanOutPublish, true);
+        NumFlushed = Coalescer.Flush([this](const FWindowsMessageRecord& Record) { ForwardMessage(Record); });
+    }
+    PublishToWorkers();
+    return NumFlushed;
+}
+
+FWindowsMessageCoalescerCounters FWindowsMessageDispatcher::GetCoalescerCounters() const
+{
+    return Coalescer.GetCounters();
+}
+
+FWindowsMessageStatsSnapshot FWindowsMessageDispatcher::GetMessageStats() const
+{
+    FWindowsMessageStatsSnapshot Snapshot;
+#if WINDOWS_MESSAGE_LISTENER_STATS
+    MessageCodeCounters.Gather(Snapshot.MessageCodes);
+
+    FScopeLock Lock(&RegistrationLock);
+    Snapshot.Handlers.Reserve(Subscriptions.Num());
+    for (const FHandlerSubscription& Subscription : Subscriptions)
+    {
+        FWindowsMessageHandlerStats& HandlerStats = Snapshot.Handlers.AddDefaulted_GetRef();
+        HandlerStats.Handler = Subscription.Registration->Handler.Object;
+        Subscription.Registration->Counters.Gather(HandlerStats);
+    }
+    for (const FHandlerRegistration* Registration : BatchSubscriptions)
+    {
+        FWindowsMessageHandlerStats& HandlerStats = Snapshot.Handlers.AddDefaulted_GetRef();
+        HandlerStats.Handler = Registration->BatchHandler.Object;
+        Registration->Counters.Gather(HandlerStats);
+    }
+#endif
+    return Snapshot;
+}
+
+int32 FWindowsMessageDispatcher::GetNumRetiredEntries() const
+{
+    FScopeLock Lock(&RegistrationLock);
+    return RetiredSnapshots.Num() + RetiredRegistrations.Num();
+}
+
+void FWindowsMessageDispatcher::ResetMessageStats()
+{
+#if WINDOWS_MESSAGE_LISTENER_STATS
+    MessageCodeCounters.Reset();
+
+    FScopeLock Lock(&RegistrationLock);
+    for (const FHandlerSubscription& Subscription : Subscriptions)
+    {
+        Subscription.Registration->Counters.Reset();
+    }
+    for (FHandlerRegistration* Registration : BatchSubscriptions)
+    {
+        Registration->Counters.Reset();
+    }
+#endif
+}
+
+bool FWindowsMessageDispatcher::StartCapture(const FString& Filename, int32 BufferRecords)
+{
+    StopCapture();
+
+    TUniquePtr<FWindowsMessageCaptureWriter> Writer = MakeUnique<FWindowsMessageCaptureWriter>();
+    if (!Writer->Open(*Filename, BufferRecords))
+    {
+        return false;
+    }
+    CaptureWriter = MoveTemp(Writer);
+    return true;
+}
+
+void FWindowsMessageDispatcher::StopCapture()
+{
+    if (CaptureWriter)
+    {
+        CaptureWriter->Close();
+        CaptureWriter.Reset();
+    }
+}
+
+FWindowsMessageCaptureCounters FWindowsMessageDispatcher::GetCaptureCounters() const
+{
+    return CaptureWriter ? CaptureWriter->GetCounters() : FWindowsMessageCaptureCounters();
+}
+
+int32 FWindowsMessageDispatcher::ReplayCapture(const FString& Filename, EWindowsMessageReplayTiming Timing)
+{
+    FWindowsMessageCaptureReader Reader;
+    if (!Reader.Open(*Filename))
+    {
+        return INDEX_NONE;
+    }
+
+    return Reader.Replay(Timing, [this](const FWindowsMessageRecord& Record)
+    {
+        int32 Result = 0;
+        ReplayMessage(Record, Result);
+    });
+}
+
+void FWindowsMessageDispatcher::SetVerboseLoggingEnabled(bool bEnabled)
+{
+    bEnableVerboseLogging = bEnabled;
+}
+
+bool FWindowsMessageDispatcher::Tick(float DeltaTime)
+{
+    if (bHasRetiredState.load(std::memory_order_relaxed))
+    {
+        TryReclaimRetiredState();
+    }
+    FlushCoalescedMessages();
+    if (bDrainDeferredOnTick)
+    {
+        DrainDeferredMessages();
+    }
+    if (bFlushBatchOnTick)
+    {
+        FlushMessageBatch();
+    }
+    ResetFrameArena(); // Last, so everything delivered this tick could still use the arena
+    return true;
+}
+
+void FWindowsMessageDispatcher::UpdateTicker()
+{
+    const bool bNeedsTicker = bDrainDeferredOnTick || bFlushBatchOnTick || FrameArena.IsValid() || NumCoalescedMessageTypes > 0;
+    if (bNeedsTicker && !TickerHandle.IsValid())
+    {
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FWindowsMessageDispatcher::Tick));
+    }
+    else if (!bNeedsTicker && TickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+}
@@ -0,0 +1,405 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the typed input event decoders and the FWindowsInputEventRouter class.
+ */
+
+#include "WindowsMessageEvents.h"
+#include "WindowsMessageArena.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+    /**
+     * How one message code decodes. Codes without an entry decode to nothing.
+     */
+    struct FInputDecodeEntry
+    {
+        EWindowsInputEventTypes Type = EWindowsInputEventTypes::None;
+        EWindowsMouseButton Button = EWindowsMouseButton::None; // Button of mouse button messages; X buttons read it from wParam
+        bool bDown = false;                                     // Press, double click or key down
+        bool bDoubleClick = false;                              // WM_*BUTTONDBLCLK
+        bool bSystem = false;                                   // WM_SYS* key and character messages
+        bool bHorizontal = false;                               // WM_MOUSEHWHEEL
+    };
+
+    constexpr uint32 InputKeyTableFirst = 0x0100; // WM_KEYFIRST
+    constexpr uint32 InputMouseTableFirst = 0x0200; // WM_MOUSEFIRST
+    constexpr uint32 InputTableSize = 16;
+
+    // WM_KEYDOWN through WM_KEYLAST
+    constexpr FInputDecodeEntry InputKeyTable[InputTableSize] =
+    {
+        { EWindowsInputEventTypes::Key, EWindowsMouseButton::None, true, false, false, false },           // WM_KEYDOWN
+        { EWindowsInputEventTypes::Key, EWindowsMouseButton::None, false, false, false, false },          // WM_KEYUP
+        { EWindowsInputEventTypes::Char, EWindowsMouseButton::None, false, false, false, false },         // WM_CHAR
+        {},                                                                                               // WM_DEADCHAR
+        { EWindowsInputEventTypes::Key, EWindowsMouseButton::None, true, false, true, false },            // WM_SYSKEYDOWN
+        { EWindowsInputEventTypes::Key, EWindowsMouseButton::None, false, false, true, false },           // WM_SYSKEYUP
+        { EWindowsInputEventTypes::Char, EWindowsMouseButton::None, false, false, true, false },          // WM_SYSCHAR
+    };
+
+    // WM_MOUSEMOVE through WM_MOUSEHWHEEL
+    constexpr FInputDecodeEntry InputMouseTable[InputTableSize] =
+    {
+        { EWindowsInputEventTypes::MouseMove },                                                           // WM_MOUSEMOVE
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::Left, true, false },                 // WM_LBUTTONDOWN
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::Left, false, false },                // WM_LBUTTONUP
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::Left, true, true },                  // WM_LBUTTONDBLCLK
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::Right, true, false },                // WM_RBUTTONDOWN
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::Right, false, false },               // WM_RBUTTONUP
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::Right, true, true },                 // WM_RBUTTONDBLCLK
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::Middle, true, false },               // WM_MBUTTONDOWN
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::Middle, false, false },              // WM_MBUTTONUP
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::Middle, true, true },                // WM_MBUTTONDBLCLK
+        { EWindowsInputEventTypes::MouseWheel },                                                          // WM_MOUSEWHEEL
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::X1, true, false },                   // WM_XBUTTONDOWN
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::X1, false, false },                  // WM_XBUTTONUP
+        { EWindowsInputEventTypes::MouseButton, EWindowsMouseButton::X1, true, true },                    // WM_XBUTTONDBLCLK
+        { EWindowsInputEventTypes::MouseWheel, EWindowsMouseButton::None, false, false, false, true },    // WM_MOUSEHWHEEL
+    };
+
+    const FInputDecodeEntry EmptyInputDecodeEntry;
+
+    FORCEINLINE const FInputDecodeEntry& FindInputDecodeEntry(uint32 MsgCode)
+    {
+        if (MsgCode - InputKeyTableFirst < InputTableSize)
+        {
+            return InputKeyTable[MsgCode - InputKeyTableFirst];
+        }
+        if (MsgCode - InputMouseTableFirst < InputTableSize)
+        {
+            return InputMouseTable[MsgCode - InputMouseTableFirst];
+        }
+        return EmptyInputDecodeEntry;
+    }
+
+    // Equivalents of LOWORD, HIWORD, GET_X_LPARAM and GET_Y_LPARAM, which are not available off Windows
+    FORCEINLINE uint16 InputLowWord(uint64 Value) { return static_cast<uint16>(Value & 0xFFFF); }
+    FORCEINLINE uint16 InputHighWord(uint64 Value) { return static_cast<uint16>((Value >> 16) & 0xFFFF); }
+    FORCEINLINE int16 InputSignedLowWord(int64 Value) { return static_cast<int16>(InputLowWord(static_cast<uint64>(Value))); }
+    FORCEINLINE int16 InputSignedHighWord(int64 Value) { return static_cast<int16>(InputHighWord(static_cast<uint64>(Value))); }
+}
+
+EWindowsInputEventTypes FWindowsInputEventDecoder::GetEventType(uint32 MsgCode)
+{
+    return FindInputDecodeEntry(MsgCode).Type;
+}
+
+bool FWindowsInputEventDecoder::DecodeMouseMove(const FWindowsMessageRecord& Record, FWindowsMouseMoveEvent& OutEvent)
+{
+    if (FindInputDecodeEntry(Record.Msg).Type != EWindowsInputEventTypes::MouseMove)
+    {
+        return false;
+    }
+
+    OutEvent.Hwnd = Record.Hwnd;
+    OutEvent.Timestamp = Record.Timestamp;
+    OutEvent.X = InputSignedLowWord(Record.LParam);
+    OutEvent.Y = InputSignedHighWord(Record.LParam);
+    OutEvent.Modifiers = InputLowWord(Record.WParam);
+    return true;
+}
+
+bool FWindowsInputEventDecoder::DecodeMouseButton(const FWindowsMessageRecord& Record, FWindowsMouseButtonEvent& OutEvent)
+{
+    const FInputDecodeEntry& Entry = FindInputDecodeEntry(Record.Msg);
+    if (Entry.Type != EWindowsInputEventTypes::MouseButton)
+    {
+        return false;
+    }
+
+    OutEvent.Hwnd = Record.Hwnd;
+    OutEvent.Timestamp = Record.Timestamp;
+    OutEvent.X = InputSignedLowWord(Record.LParam);
+    OutEvent.Y = InputSignedHighWord(Record.LParam);
+    OutEvent.Modifiers = InputLowWord(Record.WParam);
+    OutEvent.Button = Entry.Button;
+    if (Entry.Button == EWindowsMouseButton::X1 && InputHighWord(Record.WParam) == 2) // XBUTTON2
+    {
+        OutEvent.Button = EWindowsMouseButton::X2;
+    }
+    OutEvent.bDown = Entry.bDown;
+    OutEvent.bDoubleClick = Entry.bDoubleClick;
+    return true;
+}
+
+bool FWindowsInputEventDecoder::DecodeWheel(const FWindowsMessageRecord& Record, FWindowsWheelEvent& OutEvent)
+{
+    const FInputDecodeEntry& Entry = FindInputDecodeEntry(Record.Msg);
+    if (Entry.Type != EWindowsInputEventTypes::MouseWheel)
+    {
+        return false;
+    }
+
+    OutEvent.Hwnd = Record.Hwnd;
+    OutEvent.Timestamp = Record.Timestamp;
+    OutEvent.X = InputSignedLowWord(Record.LParam);
+    OutEvent.Y = InputSignedHighWord(Record.LParam);
+    OutEvent.Delta = static_cast<int16>(InputHighWord(Record.WParam)); // GET_WHEEL_DELTA_WPARAM
+    OutEvent.Modifiers = InputLowWord(Record.WParam);
+    OutEvent.bHorizontal = Entry.bHorizontal;
+    return true;
+}
+
+bool FWindowsInputEventDecoder::DecodeKey(const FWindowsMessageRecord& Record, FWindowsKeyEvent& OutEvent)
+{
+    const FInputDecodeEntry& Entry = FindInputDecodeEntry(Record.Msg);
+    if (Entry.Type != EWindowsInputEventTypes::Key)
+    {
+        return false;
+    }
+
+    // lParam: bits 0-15 repeat count, 16-23 scan code, 24 extended key, 30 previous key state
+    const uint64 KeyData = static_cast<uint64>(Record.LParam);
+    OutEvent.Hwnd = Record.Hwnd;
+    OutEvent.Timestamp = Record.Timestamp;
+    OutEvent.VirtualKey = InputLowWord(Record.WParam);
+    OutEvent.RepeatCount = InputLowWord(KeyData);
+    OutEvent.ScanCode = static_cast<uint8>((KeyData >> 16) & 0xFF);
+    OutEvent.bExtended = (KeyData & (1ull << 24)) != 0;
+    OutEvent.bDown = Entry.bDown;
+    OutEvent.bRepeat = Entry.bDown && (KeyData & (1ull << 30)) != 0;
+    OutEvent.bSystem = Entry.bSystem;
+    return true;
+}
+
+bool FWindowsInputEventDecoder::DecodeChar(const FWindowsMessageRecord& Record, FWindowsCharEvent& OutEvent)
+{
+    const FInputDecodeEntry& Entry = FindInputDecodeEntry(Record.Msg);
+    if (Entry.Type != EWindowsInputEventTypes::Char)
+    {
+        return false;
+    }
+
+    OutEvent.Hwnd = Record.Hwnd;
+    OutEvent.Timestamp = Record.Timestamp;
+    OutEvent.Character = static_cast<uint32>(Record.WParam & 0xFFFFFFFF);
+    OutEvent.RepeatCount = InputLowWord(static_cast<uint64>(Record.LParam));
+    OutEvent.bSystem = Entry.bSystem;
+    return true;
+}
+
+EWindowsInputEventTypes FWindowsInputEventDecoder::Decode(const FWindowsMessageRecord& Record, EWindowsInputEventTypes Types, FWindowsInputEventFrame& Frame)
+{
+    const EWindowsInputEventTypes Type = FindInputDecodeEntry(Record.Msg).Type;
+    if (!EnumHasAnyFlags(Types, Type))
+    {
+        return EWindowsInputEventTypes::None;
+    }
+
+    switch (Type)
+    {
+    case EWindowsInputEventTypes::MouseMove:
+        DecodeMouseMove(Record, Frame.MouseMoves.AddDefaulted_GetRef());
+        break;
+    case EWindowsInputEventTypes::MouseButton:
+        DecodeMouseButton(Record, Frame.MouseButtons.AddDefaulted_GetRef());
+        break;
+    case EWindowsInputEventTypes::MouseWheel:
+        DecodeWheel(Record, Frame.Wheels.AddDefaulted_GetRef());
+        break;
+    case EWindowsInputEventTypes::Key:
+        DecodeKey(Record, Frame.Keys.AddDefaulted_GetRef());
+        break;
+    case EWindowsInputEventTypes::Char:
+        DecodeChar(Record, Frame.Chars.AddDefaulted_GetRef());
+        break;
+    default:
+        return EWindowsInputEventTypes::None;
+    }
+    return Type;
+}
+
+void FWindowsInputEventRouter::AddHandler(IWindowsInputEventHandler* Handler, EWindowsInputEventTypes Types)
+{
+    if (!Handler)
+    {
+        return;
+    }
+
+    FScopeLock ScopeLock(&Lock);
+    FSubscriber* Subscriber = Subscribers.FindByPredicate([Handler](const FSubscriber& Existing) { return Existing.Handler == Handler; });
+    if (!Subscriber)
+    {
+        Subscriber = &Subscribers.AddDefaulted_GetRef();
+        Subscriber->Handler = Handler;
+    }
+    Subscriber->Types = Types;
+    UpdateSubscriptions();
+}
+
+bool FWindowsInputEventRouter::RemoveHandler(IWindowsInputEventHandler* Handler)
+{
+    FScopeLock ScopeLock(&Lock);
+    FSubscriber* Subscriber = Subscribers.FindByPredicate([Handler](const FSubscriber& Existing) { return Existing.Handler == Handler; });
+    if (!Handler || !Subscriber)
+    {
+        return false;
+    }
+
+    // A handler removed from inside a delivery keeps its entry until the delivery ends
+    Subscriber->Handler = nullptr;
+    Subscriber->Types = EWindowsInputEventTypes::None;
+    UpdateSubscriptions();
+    return true;
+}
+
+void FWindowsInputEventRouter::RemoveAllHandlers()
+{
+    FScopeLock ScopeLock(&Lock);
+    for (FSubscriber& Subscriber : Subscribers)
+    {
+        Subscriber.Handler = nullptr;
+        Subscriber.Types = EWindowsInputEventTypes::None;
+    }
+    UpdateSubscriptions();
+}
+
+void FWindowsInputEventRouter::UpdateSubscriptions()
+{
+    if (!bDelivering)
+    {
+        Subscribers.RemoveAll([](const FSubscriber& Subscriber) { return Subscriber.Handler == nullptr; });
+    }
+
+    SubscribedTypes = EWindowsInputEventTypes::None;
+    for (const FSubscriber& Subscriber : Subscribers)
+    {
+        SubscribedTypes |= Subscriber.Types;
+    }
+}
+
+void FWindowsInputEventRouter::SetFrameArena(FWindowsMessageFrameArena* InFrameArena)
+{
+    FScopeLock ScopeLock(&Lock);
+    FrameArena = InFrameArena;
+    EventViews = FWindowsInputEventViews(); // May point into the previous arena
+}
+
+void FWindowsInputEventRouter::DecodeIntoArena(const FWindowsMessageBatchView& Batch)
+{
+    // Counted from the message column first, so each type gets one array of its exact size and nothing is regrown
+    int32 NumMouseMoves = 0;
+    int32 NumMouseButtons = 0;
+    int32 NumWheels = 0;
+    int32 NumKeys = 0;
+    int32 NumChars = 0;
+    for (int32 Index = 0; Index < Batch.Num(); ++Index)
+    {
+        switch (FindInputDecodeEntry(Batch.Msgs[Index]).Type & SubscribedTypes)
+        {
+        case EWindowsInputEventTypes::MouseMove: ++NumMouseMoves; break;
+        case EWindowsInputEventTypes::MouseButton: ++NumMouseButtons; break;
+        case EWindowsInputEventTypes::MouseWheel: ++NumWheels; break;
+        case EWindowsInputEventTypes::Key: ++NumKeys; break;
+        case EWindowsInputEventTypes::Char: ++NumChars; break;
+        default: break;
+        }
+    }
+
+    TArrayView<FWindowsMouseMoveEvent> MouseMoves = FrameArena->NewArray<FWindowsMouseMoveEvent>(NumMouseMoves);
+    TArrayView<FWindowsMouseButtonEvent> MouseButtons = FrameArena->NewArray<FWindowsMouseButtonEvent>(NumMouseButtons);
+    TArrayView<FWindowsWheelEvent> Wheels = FrameArena->NewArray<FWindowsWheelEvent>(NumWheels);
+    TArrayView<FWindowsKeyEvent> Keys = FrameArena->NewArray<FWindowsKeyEvent>(NumKeys);
+    TArrayView<FWindowsCharEvent> Chars = FrameArena->NewArray<FWindowsCharEvent>(NumChars);
+
+    NumMouseMoves = NumMouseButtons = NumWheels = NumKeys = NumChars = 0;
+    for (int32 Index = 0; Index < Batch.Num(); ++Index)
+    {
+        switch (FindInputDecodeEntry(Batch.Msgs[Index]).Type & SubscribedTypes)
+        {
+        case EWindowsInputEventTypes::MouseMove:
+            FWindowsInputEventDecoder::DecodeMouseMove(Batch.GetRecord(Index), MouseMoves[NumMouseMoves++]);
+            break;
+        case EWindowsInputEventTypes::MouseButton:
+            FWindowsInputEventDecoder::DecodeMouseButton(Batch.GetRecord(Index), MouseButtons[NumMouseButtons++]);
+            break;
+        case EWindowsInputEventTypes::MouseWheel:
+            FWindowsInputEventDecoder::DecodeWheel(Batch.GetRecord(Index), Wheels[NumWheels++]);
+            break;
+        case EWindowsInputEventTypes::Key:
+            FWindowsInputEventDecoder::DecodeKey(Batch.GetRecord(Index), Keys[NumKeys++]);
+            break;
+        case EWindowsInputEventTypes::Char:
+            FWindowsInputEventDecoder::DecodeChar(Batch.GetRecord(Index), Chars[NumChars++]);
+            break;
+        default:
+            break;
+        }
+    }
+
+    EventViews.MouseMoves = MouseMoves;
+    EventViews.MouseButtons = MouseButtons;
+    EventViews.Wheels = Wheels;
+    EventViews.Keys = Keys;
+    EventViews.Chars = Chars;
+}
+
+void FWindowsInputEventRouter::ProcessMessages(const FWindowsMessageBatchView& Batch)
+{
+    FScopeLock ScopeLock(&Lock);
+
+    // Decode every wanted message once, whatever the number of handlers
+    if (FrameArena)
+    {
+        DecodeIntoArena(Batch);
+    }
+    else
+    {
+        Events.Reset();
+        for (int32 Index = 0; Index < Batch.Num(); ++Index)
+        {
+            // Only the message column is scanned for messages nobody decodes
+            if (EnumHasAnyFlags(SubscribedTypes, FindInputDecodeEntry(Batch.Msgs[Index]).Type))
+            {
+                FWindowsInputEventDecoder::Decode(Batch.GetRecord(Index), SubscribedTypes, Events);
+            }
+        }
+        EventViews.MouseMoves = Events.MouseMoves;
+        EventViews.MouseButtons = Events.MouseButtons;
+        EventViews.Wheels = Events.Wheels;
+        EventViews.Keys = Events.Keys;
+        EventViews.Chars = Events.Chars;
+    }
+    if (EventViews.Num() == 0)
+    {
+        return;
+    }
+
+    bDelivering = true;
+    for (int32 SubscriberIndex = 0; SubscriberIndex < Subscribers.Num(); ++SubscriberIndex)
+    {
+        // Re-read on every call, since a handler may remove itself or others
+        auto Deliver = [this, SubscriberIndex](EWindowsInputEventTypes Type, auto&& Call)
+        {
+            const FSubscriber& Subscriber = Subscribers[SubscriberIndex];
+            if (Subscriber.Handler && EnumHasAnyFlags(Subscriber.Types, Type))
+            {
+                Call(*Subscriber.Handler);
+            }
+        };
+        if (EventViews.MouseMoves.Num() > 0)
+        {
+            Deliver(EWindowsInputEventTypes::MouseMove, [this](IWindowsInputEventHandler& Handler) { Handler.OnMouseMoveEvents(EventViews.MouseMoves); });
+        }
+        if (EventViews.MouseButtons.Num() > 0)
+        {
+            Deliver(EWindowsInputEventTypes::MouseButton, [this](IWindowsInputEventHandler& Handler) { Handler.OnMouseButtonEvents(EventViews.MouseButtons); });
+        }
+        if (EventViews.Wheels.Num() > 0)
+        {
+            Deliver(EWindowsInputEventTypes::MouseWheel, [this](IWindowsInputEventHandler& Handler) { Handler.OnWheelEvents(EventViews.Wheels); });
+        }
+        if (EventViews.Keys.Num() > 0)
+        {
+            Deliver(EWindowsInputEventTypes::Key, [this](IWindowsInputEventHandler& Handler) { Handler.OnKeyEvents(EventViews.Keys); });
+        }
+        if (EventViews.Chars.Num() > 0)
+        {
+            Deliver(EWindowsInputEventTypes::Char, [this](IWindowsInputEventHandler& Handler) { Handler.OnCharEvents(EventViews.Chars); });
+        }
+    }
+    bDelivering = false;
+    UpdateSubscriptions();
+}
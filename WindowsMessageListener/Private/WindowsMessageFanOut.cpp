@@ -0,0 +1,188 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the FWindowsMessageFanOut class.
+ */
+
+#include "WindowsMessageFanOut.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+
+namespace
+{
+    constexpr int32 IdleSpins = 64; // Yields before an idle worker sleeps, so bursts are picked up without a wake-up
+}
+
+FWindowsMessageFanOut::FWindowsMessageFanOut(int32 NumWorkers, uint32 Capacity, bool bInWaitWhenFull, FWindowsMessageFanOutConsumer InConsumer)
+    : bWaitWhenFull(bInWaitWhenFull)
+    , Consumer(MoveTemp(InConsumer))
+{
+    const uint32 RingCapacity = FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(Capacity, 2));
+    Slots.SetNum(RingCapacity);
+    IndexMask = RingCapacity - 1;
+
+    NumWorkers = FMath::Clamp(NumWorkers, 1, MaxWorkers);
+    Workers.Reserve(NumWorkers);
+    for (int32 Index = 0; Index < NumWorkers; ++Index)
+    {
+        FWorker& Worker = *Workers.Add_GetRef(MakeUnique<FWorker>(*this, Index));
+        Worker.WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+        Worker.Thread = FRunnableThread::Create(&Worker, *FString::Printf(TEXT("WindowsMessageFanOut%d"), Index), 0, TPri_Normal);
+    }
+}
+
+FWindowsMessageFanOut::~FWindowsMessageFanOut()
+{
+    Stop();
+}
+
+void FWindowsMessageFanOut::Publish()
+{
+    if (NextSequence == PublishedSequence)
+    {
+        return;
+    }
+
+    PublishedSequence = NextSequence;
+    const uint32 Backlog = static_cast<uint32>(NextSequence - CachedGatingSequence);
+    if (Backlog > HighWaterMark.load(std::memory_order_relaxed))
+    {
+        HighWaterMark.store(Backlog, std::memory_order_relaxed);
+    }
+
+    // Sequentially consistent with bSleeping, so a worker either sees the new cursor or is seen sleeping
+    Cursor.store(NextSequence);
+    for (const TUniquePtr<FWorker>& Worker : Workers)
+    {
+        if (Worker->bSleeping.load())
+        {
+            Worker->WakeEvent->Trigger();
+        }
+    }
+}
+
+bool FWindowsMessageFanOut::WaitForSlot()
+{
+    CachedGatingSequence = GetGatingSequence();
+    if (NextSequence - CachedGatingSequence <= IndexMask)
+    {
+        return true;
+    }
+
+    if (!bWaitWhenFull)
+    {
+        Dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // The slowest worker may be waiting for messages that were written but not yet published
+    Waits.fetch_add(1, std::memory_order_relaxed);
+    Publish();
+    while (NextSequence - CachedGatingSequence > IndexMask)
+    {
+        FPlatformProcess::YieldThread();
+        CachedGatingSequence = GetGatingSequence();
+    }
+    return true;
+}
+
+uint64 FWindowsMessageFanOut::GetGatingSequence() const
+{
+    uint64 Gating = NextSequence;
+    for (const TUniquePtr<FWorker>& Worker : Workers)
+    {
+        Gating = FMath::Min(Gating, Worker->Sequence.load(std::memory_order_acquire));
+    }
+    return Gating;
+}
+
+void FWindowsMessageFanOut::WaitUntilConsumed()
+{
+    Publish();
+    while (GetGatingSequence() != NextSequence)
+    {
+        FPlatformProcess::YieldThread();
+    }
+    CachedGatingSequence = NextSequence;
+}
+
+void FWindowsMessageFanOut::Stop()
+{
+    if (Workers.Num() == 0)
+    {
+        return;
+    }
+
+    Publish();
+    bStopping.store(true);
+    for (const TUniquePtr<FWorker>& Worker : Workers)
+    {
+        Worker->WakeEvent->Trigger();
+    }
+    for (const TUniquePtr<FWorker>& Worker : Workers)
+    {
+        Worker->Thread->WaitForCompletion();
+        delete Worker->Thread;
+        FPlatformProcess::ReturnSynchEventToPool(Worker->WakeEvent);
+    }
+    Workers.Reset();
+}
+
+FWindowsMessageFanOutCounters FWindowsMessageFanOut::GetCounters() const
+{
+    FWindowsMessageFanOutCounters Counters;
+    Counters.Published = Cursor.load(std::memory_order_relaxed);
+    Counters.Dropped = Dropped.load(std::memory_order_relaxed);
+    Counters.Waits = Waits.load(std::memory_order_relaxed);
+    Counters.HighWaterMark = HighWaterMark.load(std::memory_order_relaxed);
+    for (const TUniquePtr<FWorker>& Worker : Workers)
+    {
+        Counters.Consumed.Add(Worker->Sequence.load(std::memory_order_relaxed));
+    }
+    return Counters;
+}
+
+uint32 FWindowsMessageFanOut::FWorker::Run()
+{
+    const uint64 Mask = Owner.IndexMask;
+    uint64 Next = Sequence.load(std::memory_order_relaxed);
+    int32 Spins = 0;
+    for (;;)
+    {
+        const uint64 Available = Owner.Cursor.load(std::memory_order_acquire);
+        if (Available == Next)
+        {
+            // Only exit once caught up, so every message published before Stop is consumed
+            if (Owner.bStopping.load())
+            {
+                break;
+            }
+            if (++Spins < IdleSpins)
+            {
+                FPlatformProcess::YieldThread();
+                continue;
+            }
+
+            bSleeping.store(true);
+            if (Owner.Cursor.load() == Next && !Owner.bStopping.load())
+            {
+                WakeEvent->Wait();
+            }
+            bSleeping.store(false);
+            Spins = 0;
+            continue;
+        }
+
+        // Hand over contiguous runs, splitting where the ring wraps, and free each run's slots as soon as it is done
+        while (Next < Available)
+        {
+            const uint64 Start = Next & Mask;
+            const uint64 Count = FMath::Min(Available - Next, Mask + 1 - Start);
+            Owner.Consumer(Index, MakeArrayView(Owner.Slots.GetData() + Start, static_cast<int32>(Count)));
+            Next += Count;
+            Sequence.store(Next, std::memory_order_release);
+        }
+        Spins = 0;
+    }
+    return 0;
+}
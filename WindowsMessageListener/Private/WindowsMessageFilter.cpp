@@ -0,0 +1,180 @@
+// Copyright (c) 2025, Michael Golembewski.  All rights reserved.
+
+/**
+ * This file implements the FWindowsMessageFilter class.
+ */
+
+#include "WindowsMessageFilter.h"
+
+FWindowsMessageFilter::FWindowsMessageFilter()
+{
+    FMemory::Memzero(Words, sizeof(Words));
+}
+
+void FWindowsMessageFilter::Allow(uint32 MsgCode)
+{
+    if (MsgCode < NumBitmapCodes)
+    {
+        Words[MsgCode >> 6] |= uint64(1) << (MsgCode & 63);
+    }
+    else
+    {
+        OverflowCodes.Add(MsgCode);
+    }
+}
+
+void FWindowsMessageFilter::Disallow(uint32 MsgCode)
+{
+    if (MsgCode < NumBitmapCodes)
+    {
+        Words[MsgCode >> 6] &= ~(uint64(1) << (MsgCode & 63));
+    }
+    else
+    {
+        OverflowCodes.Remove(MsgCode);
+    }
+}
+
+void FWindowsMessageFilter::AllowRange(uint32 FirstMsgCode, uint32 LastMsgCode)
+{
+    SetRangeBits(FirstMsgCode, LastMsgCode, true);
+}
+
+void FWindowsMessageFilter::DisallowRange(uint32 FirstMsgCode, uint32 LastMsgCode)
+{
+    SetRangeBits(FirstMsgCode, LastMsgCode, false);
+}
+
+void FWindowsMessageFilter::Merge(const FWindowsMessageFilter& Other)
+{
+    for (uint32 Index = 0; Index < NumBitmapWords; ++Index)
+    {
+        Words[Index] |= Other.Words[Index];
+    }
+    OverflowCodes.Append(Other.OverflowCodes);
+}
+
+void FWindowsMessageFilter::Reset()
+{
+    FMemory::Memzero(Words, sizeof(Words));
+    OverflowCodes.Empty();
+}
+
+bool FWindowsMessageFilter::IsEmpty() const
+{
+    if (OverflowCodes.Num() > 0)
+    {
+        return false;
+    }
+
+    uint64 AnyBits = 0;
+    for (uint64 Word : Words)
+    {
+        AnyBits |= Word;
+    }
+    return AnyBits == 0;
+}
+
+int32 FWindowsMessageFilter::Num() const
+{
+    int32 Count = OverflowCodes.Num();
+    for (uint64 Word : Words)
+    {
+        Count += static_cast<int32>(FMath::CountBits(Word));
+    }
+    return Count;
+}
+
+void FWindowsMessageFilter::Serialize(FArchive& Ar)
+{
+    if (Ar.IsLoading())
+    {
+        Reset();
+
+        uint16 NumWords = 0;
+        Ar << NumWords;
+        if (NumWords > NumBitmapWords)
+        {
+            Ar.SetError();
+            return;
+        }
+        for (uint16 Index = 0; Index < NumWords && !Ar.IsError(); ++Index)
+        {
+            uint16 WordIndex = 0;
+            uint64 Word = 0;
+            Ar << WordIndex << Word;
+            if (WordIndex >= NumBitmapWords)
+            {
+                Ar.SetError();
+                return;
+            }
+            Words[WordIndex] = Word;
+        }
+
+        int32 NumOverflowCodes = 0;
+        Ar << NumOverflowCodes;
+        if (NumOverflowCodes < 0)
+        {
+            Ar.SetError();
+            return;
+        }
+        for (int32 Index = 0; Index < NumOverflowCodes && !Ar.IsError(); ++Index)
+        {
+            uint32 MsgCode = 0;
+            Ar << MsgCode;
+            OverflowCodes.Add(MsgCode);
+        }
+        return;
+    }
+
+    uint16 NumWords = 0;
+    for (uint64 Word : Words)
+    {
+        NumWords += Word != 0;
+    }
+    Ar << NumWords;
+    for (uint16 Index = 0; Index < NumBitmapWords; ++Index)
+    {
+        uint64 Word = Words[Index];
+        if (Word != 0)
+        {
+            uint16 WordIndex = Index;
+            Ar << WordIndex << Word;
+        }
+    }
+
+    int32 NumOverflowCodes = OverflowCodes.Num();
+    Ar << NumOverflowCodes;
+    for (uint32 MsgCode : OverflowCodes)
+    {
+        Ar << MsgCode;
+    }
+}
+
+void FWindowsMessageFilter::SetRangeBits(uint32 FirstMsgCode, uint32 LastMsgCode, bool bAllowed)
+{
+    LastMsgCode = FMath::Min(LastMsgCode, NumBitmapCodes - 1);
+    if (FirstMsgCode > LastMsgCode)
+    {
+        return;
+    }
+
+    const uint32 FirstWord = FirstMsgCode >> 6;
+    const uint32 LastWord = LastMsgCode >> 6;
+    const uint64 FirstMask = ~uint64(0) << (FirstMsgCode & 63);
+    const uint64 LastMask = ~uint64(0) >> (63 - (LastMsgCode & 63));
+
+    if (FirstWord == LastWord)
+    {
+        const uint64 Mask = FirstMask & LastMask;
+        Words[FirstWord] = bAllowed ? (Words[FirstWord] | Mask) : (Words[FirstWord] & ~Mask);
+        return;
+    }
+
+    Words[FirstWord] = bAllowed ? (Words[FirstWord] | FirstMask) : (Words[FirstWord] & ~FirstMask);
+    if (LastWord > FirstWord + 1)
+    {
+        FMemory::Memset(&Words[FirstWord + 1], bAllowed ? 0xFF : 0x00, (LastWord - FirstWord - 1) * sizeof(uint64));
+    }
+    Words[LastWord] = bAllowed ? (Words[LastWord] | LastMask) : (Words[LastWord] & ~LastMask);
+}
@@ -0,0 +1,286 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the FWindowsMessageLatencyTracker class.
+ */
+
+#include "WindowsMessageLatency.h"
+#include "WindowsMessageCodeHelper.h"
+#include "WindowsMessageListenerLog.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+    FWindowsMessageLatencyPercentiles GetLatencyPercentiles(const FWindowsMessageLatencyHistogram& Histogram)
+    {
+        const double SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+        FWindowsMessageLatencyPercentiles Percentiles;
+        Percentiles.Count = Histogram.GetCount();
+        Percentiles.P50 = Histogram.GetValueAtPercentile(50.0) * SecondsPerCycle;
+        Percentiles.P99 = Histogram.GetValueAtPercentile(99.0) * SecondsPerCycle;
+        Percentiles.P999 = Histogram.GetValueAtPercentile(99.9) * SecondsPerCycle;
+        Percentiles.Max = Histogram.GetMax() * SecondsPerCycle;
+        return Percentiles;
+    }
+}
+
+void FWindowsMessageLatencyHistogram::Merge(const FWindowsMessageLatencyHistogram& Other)
+{
+    for (int32 BucketIndex = 0; BucketIndex < NumBuckets; ++BucketIndex)
+    {
+        if (const uint64 BucketCount = Other.Buckets[BucketIndex].load(std::memory_order_relaxed))
+        {
+            Buckets[BucketIndex].fetch_add(BucketCount, std::memory_order_relaxed);
+        }
+    }
+    Count.fetch_add(Other.GetCount(), std::memory_order_relaxed);
+
+    const uint64 OtherMax = Other.GetMax();
+    uint64 Previous = Max.load(std::memory_order_relaxed);
+    while (OtherMax > Previous && !Max.compare_exchange_weak(Previous, OtherMax, std::memory_order_relaxed))
+    {
+    }
+}
+
+uint64 FWindowsMessageLatencyHistogram::GetValueAtPercentile(double Percentile) const
+{
+    // Buckets are read one by one while writers may be adding, so rank against their sum rather than Count
+    uint64 Total = 0;
+    for (const std::atomic<uint64>& Bucket : Buckets)
+    {
+        Total += Bucket.load(std::memory_order_relaxed);
+    }
+    if (Total == 0)
+    {
+        return 0;
+    }
+
+    const uint64 Rank = FMath::Max<uint64>(1, static_cast<uint64>(FMath::CeilToDouble(FMath::Clamp(Percentile, 0.0, 100.0) / 100.0 * Total)));
+    uint64 Seen = 0;
+    for (int32 BucketIndex = 0; BucketIndex < NumBuckets; ++BucketIndex)
+    {
+        Seen += Buckets[BucketIndex].load(std::memory_order_relaxed);
+        if (Seen >= Rank)
+        {
+            return FMath::Min(GetBucketUpperBound(BucketIndex), GetMax());
+        }
+    }
+    return GetMax();
+}
+
+void FWindowsMessageLatencyHistogram::Reset()
+{
+    for (std::atomic<uint64>& Bucket : Buckets)
+    {
+        Bucket.store(0, std::memory_order_relaxed);
+    }
+    Count.store(0, std::memory_order_relaxed);
+    Max.store(0, std::memory_order_relaxed);
+}
+
+uint64 FWindowsMessageLatencyHistogram::GetBucketUpperBound(int32 BucketIndex)
+{
+    if (BucketIndex < NumSubBuckets)
+    {
+        return static_cast<uint64>(BucketIndex);
+    }
+    if (BucketIndex >= NumBuckets - 1)
+    {
+        return MAX_uint64;
+    }
+    const int32 Shift = (BucketIndex - NumSubBuckets) / NumSubBuckets;
+    const uint64 SubBucket = (BucketIndex - NumSubBuckets) % NumSubBuckets;
+    return ((NumSubBuckets + SubBucket + 1) << Shift) - 1;
+}
+
+FWindowsMessageLatencyTracker::FWindowsMessageLatencyTracker(int32 MaxTrackedCodes, int32 TimelineCapacity)
+{
+    MaxTrackedCodes = FMath::Clamp(MaxTrackedCodes, 0, MaxTrackedCodesLimit);
+    CodeSlots.SetNumZeroed(NumCodeSlots);
+    Histograms.Reserve(MaxTrackedCodes + 1);
+    for (int32 Index = 0; Index <= MaxTrackedCodes; ++Index)
+    {
+        Histograms.Add(MakeUnique<FCodeHistograms>());
+    }
+    Timelines.SetNum(FMath::Max(TimelineCapacity, 1));
+    Report.Reserve(Timelines.Num());
+    CyclesPerMillisecond = 0.001 / FPlatformTime::GetSecondsPerCycle64();
+}
+
+FWindowsMessageLatencyTracker::~FWindowsMessageLatencyTracker()
+{
+}
+
+void FWindowsMessageLatencyTracker::Add(const FWindowsMessageRecord& Record, uint64 DispatchCycles, uint64 CompleteCycles)
+{
+    if (Record.Timestamp == 0 || Record.Timestamp > DispatchCycles)
+    {
+        return; // Synthetic messages carry no arrival time
+    }
+
+    FCodeHistograms& Code = FindHistograms(Record.Msg);
+    const uint64 TotalCycles = CompleteCycles - Record.Timestamp;
+    Code.Stages[static_cast<int32>(EWindowsMessageLatencyStage::Queue)].Add(DispatchCycles - Record.Timestamp);
+    Code.Stages[static_cast<int32>(EWindowsMessageLatencyStage::Handlers)].Add(CompleteCycles - DispatchCycles);
+    Code.Stages[static_cast<int32>(EWindowsMessageLatencyStage::Total)].Add(TotalCycles);
+
+    uint32 SystemAgeMs = 0;
+    if (SystemClock && Record.MessageTime != 0)
+    {
+        // The system clock ticks at 10-16 ms on most machines, so this stage only catches the coarse stalls
+        SystemAgeMs = SystemClock() - Record.MessageTime;
+        Code.Stages[static_cast<int32>(EWindowsMessageLatencyStage::System)].Add(static_cast<uint64>(SystemAgeMs * CyclesPerMillisecond));
+    }
+
+    FWindowsMessageLatencyTimeline& Timeline = Timelines[NumTimelines++ % Timelines.Num()];
+    Timeline.Hwnd = Record.Hwnd;
+    Timeline.Msg = Record.Msg;
+    Timeline.MessageTime = Record.MessageTime;
+    Timeline.ArrivalCycles = Record.Timestamp;
+    Timeline.DispatchCycles = DispatchCycles;
+    Timeline.CompleteCycles = CompleteCycles;
+    Timeline.SystemAgeMs = SystemAgeMs;
+
+    if (SpikeThresholdCycles != 0 && TotalCycles >= SpikeThresholdCycles)
+    {
+        NumSpikes.fetch_add(1, std::memory_order_relaxed);
+        if (NumReported.load(std::memory_order_relaxed) == 0 || CompleteCycles - LastReportCycles >= MinCyclesBetweenReports)
+        {
+            LastReportCycles = CompleteCycles;
+            ReportSpike();
+        }
+    }
+}
+
+void FWindowsMessageLatencyTracker::SetSpikeThreshold(double Seconds, double MinSecondsBetweenReports)
+{
+    const double CyclesPerSecond = 1.0 / FPlatformTime::GetSecondsPerCycle64();
+    SpikeThresholdCycles = Seconds > 0.0 ? FMath::Max<uint64>(1, static_cast<uint64>(Seconds * CyclesPerSecond)) : 0;
+    MinCyclesBetweenReports = static_cast<uint64>(FMath::Max(MinSecondsBetweenReports, 0.0) * CyclesPerSecond);
+}
+
+void FWindowsMessageLatencyTracker::SetSpikeSink(FWindowsMessageLatencySpikeSink InSink)
+{
+    Sink = MoveTemp(InSink);
+}
+
+void FWindowsMessageLatencyTracker::SetSystemClock(uint32 (*InClock)())
+{
+    SystemClock = InClock;
+}
+
+FWindowsMessageLatencyStats FWindowsMessageLatencyTracker::GetStats() const
+{
+    FWindowsMessageLatencyStats Stats;
+    Stats.Spikes = NumSpikes.load(std::memory_order_relaxed);
+    Stats.Reports = NumReported.load(std::memory_order_relaxed);
+
+    TUniquePtr<FCodeHistograms> AllCodes = MakeUnique<FCodeHistograms>(); // Too large for the stack
+
+    // Claimed slots in arrival order, then the shared slot; sorted by code below
+    const int32 NumClaimed = NumClaimedCodes.load(std::memory_order_acquire);
+    for (int32 Index = 1; Index <= NumClaimed + 1; ++Index)
+    {
+        const FCodeHistograms& Code = *Histograms[Index <= NumClaimed ? Index : 0];
+        if (Code.Stages[static_cast<int32>(EWindowsMessageLatencyStage::Total)].GetCount() == 0)
+        {
+            continue;
+        }
+
+        FWindowsMessageLatencyCodeStats& CodeStats = Stats.MessageCodes.AddDefaulted_GetRef();
+        CodeStats.MsgCode = Code.MsgCode.load(std::memory_order_relaxed);
+        CodeStats.bOther = Index > NumClaimed;
+        for (int32 Stage = 0; Stage < NumStages; ++Stage)
+        {
+            CodeStats.Stages[Stage] = GetLatencyPercentiles(Code.Stages[Stage]);
+            AllCodes->Stages[Stage].Merge(Code.Stages[Stage]);
+        }
+    }
+    Stats.MessageCodes.Sort([](const FWindowsMessageLatencyCodeStats& A, const FWindowsMessageLatencyCodeStats& B)
+    {
+        return A.bOther != B.bOther ? B.bOther : A.MsgCode < B.MsgCode;
+    });
+
+    Stats.AllCodes.bOther = true;
+    for (int32 Stage = 0; Stage < NumStages; ++Stage)
+    {
+        Stats.AllCodes.Stages[Stage] = GetLatencyPercentiles(AllCodes->Stages[Stage]);
+    }
+    return Stats;
+}
+
+void FWindowsMessageLatencyTracker::Reset()
+{
+    FMemory::Memzero(CodeSlots.GetData(), CodeSlots.Num());
+    for (const TUniquePtr<FCodeHistograms>& Code : Histograms)
+    {
+        Code->MsgCode.store(0, std::memory_order_relaxed);
+        for (FWindowsMessageLatencyHistogram& Histogram : Code->Stages)
+        {
+            Histogram.Reset();
+        }
+    }
+    NumClaimedCodes.store(0, std::memory_order_release);
+    NumTimelines = 0;
+    NumSpikes.store(0, std::memory_order_relaxed);
+    NumReported.store(0, std::memory_order_relaxed);
+}
+
+FString FWindowsMessageLatencyTracker::FormatTimeline(const FWindowsMessageLatencyTimeline& Timeline)
+{
+    const double MicrosecondsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000000.0;
+    return FString::Printf(TEXT("%s (0x%04X) hwnd=0x%llX queue=%.1fus handlers=%.1fus total=%.1fus system=%ums"),
+        FWindowsMessageCodeHelper::GetMessageNameView(Timeline.Msg), Timeline.Msg, Timeline.Hwnd,
+        (Timeline.DispatchCycles - Timeline.ArrivalCycles) * MicrosecondsPerCycle,
+        (Timeline.CompleteCycles - Timeline.DispatchCycles) * MicrosecondsPerCycle,
+        (Timeline.CompleteCycles - Timeline.ArrivalCycles) * MicrosecondsPerCycle,
+        Timeline.SystemAgeMs);
+}
+
+FWindowsMessageLatencyTracker::FCodeHistograms& FWindowsMessageLatencyTracker::FindHistograms(uint32 MsgCode)
+{
+    if (MsgCode >= NumCodeSlots)
+    {
+        return *Histograms[0];
+    }
+
+    uint8& Slot = CodeSlots[MsgCode];
+    if (Slot == 0)
+    {
+        const int32 NumClaimed = NumClaimedCodes.load(std::memory_order_relaxed);
+        if (NumClaimed + 1 >= Histograms.Num())
+        {
+            return *Histograms[0]; // Every slot is taken; later codes share the Other slot
+        }
+        Histograms[NumClaimed + 1]->MsgCode.store(MsgCode, std::memory_order_relaxed);
+        NumClaimedCodes.store(NumClaimed + 1, std::memory_order_release);
+        Slot = static_cast<uint8>(NumClaimed + 1);
+    }
+    return *Histograms[Slot];
+}
+
+void FWindowsMessageLatencyTracker::ReportSpike()
+{
+    NumReported.fetch_add(1, std::memory_order_relaxed);
+
+    // Oldest first; Report was reserved up front, so this copy does not allocate
+    Report.Reset();
+    const int32 Capacity = Timelines.Num();
+    const int32 NumKept = static_cast<int32>(FMath::Min<uint64>(NumTimelines, Capacity));
+    for (int32 Index = 0; Index < NumKept; ++Index)
+    {
+        Report.Add(Timelines[(NumTimelines - NumKept + Index) % Capacity]);
+    }
+
+    if (Sink)
+    {
+        Sink(Report);
+        return;
+    }
+
+    UE_LOG(LogWindowsMessageListener, Warning, TEXT("Message latency spike: %s. The last %d messages, oldest first:"), *FormatTimeline(Report.Last()), Report.Num());
+    for (const FWindowsMessageLatencyTimeline& Timeline : Report)
+    {
+        UE_LOG(LogWindowsMessageListener, Warning, TEXT("    %s"), *FormatTimeline(Timeline));
+    }
+}
@@ -5,10 +5,32 @@
  */
 
 #include "WindowsMessageListener.h"
+
+#if PLATFORM_WINDOWS
+
+#include "WindowsMessageListenerHub.h"
 #include "WindowsMessageCodeHelper.h"
-#include "Logging/LogMacros.h"
+#include "WindowsMessageListenerLog.h"
+#include "HAL/PlatformTime.h"
+
+#include <atomic>
+
+namespace
+{
+    // The listener reading buffered raw input; GetRawInputBuffer drains the thread's queue, so only one listener may
+    std::atomic<const FWindowsMessageListener*> BufferedRawInputOwner{nullptr};
+
+    FORCEINLINE uint32 MakeRawInputDeviceKey(uint16 UsagePage, uint16 Usage)
+    {
+        return (static_cast<uint32>(UsagePage) << 16) | Usage;
+    }
 
-DEFINE_LOG_CATEGORY_STATIC(LogWindowsMessageListener, Log, All);
+    // Forwards a copied message to an IWindowsMessageHandler registered with the dispatcher
+    bool InvokeWindowsMessageHandler(void* Object, const FWindowsMessageRecord& Record, int32& OutResult)
+    {
+        return static_cast<IWindowsMessageHandler*>(Object)->ProcessMessage(reinterpret_cast<HWND>(Record.Hwnd), Record.Msg, static_cast<WPARAM>(Record.WParam), static_cast<LPARAM>(Record.LParam), OutResult);
+    }
+}
 
 FWindowsMessageListener::FWindowsMessageListener()
 {
@@ -19,53 +41,118 @@ FWindowsMessageListener::FWindowsMessageListener()
 FWindowsMessageListener::~FWindowsMessageListener()
 {
     StopListening(); // Ensure the listener is stopped
+    StopCapture(); // Write out anything still buffered
+    FlushCoalescedMessages(); // Forward anything still held back
+    DisableDeferredProcessing(); // Dispatch anything still queued
+    DisableMessageBatching(); // Deliver anything still collected
+    DisableRawInput(); // Release the raw input arena and queue
+    DisableFrameArena(); // Release the frame arena
+    DisableMessageLogging(); // Write out anything still buffered
     RemoveAllMessageHandlers(); // Clear all handlers
     ClearAllowedMessageTypes(); // Clear allowed message types
     UE_LOG(LogWindowsMessageListener, Log, TEXT("FWindowsMessageListener destructed and cleaned up."));
 }
 
 // Helper function for verbose logging
-void FWindowsMessageListener::LogMessageDetails(HWND hwnd, uint32 msg, const TCHAR* Context) const
+void FWindowsMessageListener::LogMessageDetails(HWND hwnd, uint32 msg, const TCHAR* Context)
 {
-    if (bEnableVerboseLogging)
+    if (Dispatcher.IsVerboseLoggingEnabled())
     {
-        FString MessageName = FWindowsMessageCodeHelper::GetMessageName(msg);
-        FString MessageDescription = FWindowsMessageCodeHelper::GetMessageDescription(msg);
-        UE_LOG(LogWindowsMessageListener, VeryVerbose, TEXT("%s: hwnd=%p, msg=%u, name=%s, description=%s"), Context, hwnd, msg, *MessageName, *MessageDescription);
+        // Formatted into the frame arena when there is one, otherwise on the stack, so logging never touches the heap
+        if (FWindowsMessageFrameArena* Arena = Dispatcher.GetFrameArena())
+        {
+            const FStringView Line = FWindowsMessageCodeHelper::FormatMessageDetails(*Arena, Context, reinterpret_cast<uint64>(hwnd), msg);
+            UE_LOG(LogWindowsMessageListener, VeryVerbose, TEXT("%s"), Line.GetData());
+        }
+        else
+        {
+            TStringBuilder<256> Line;
+            FWindowsMessageCodeHelper::FormatMessageDetails(Line, Context, reinterpret_cast<uint64>(hwnd), msg);
+            UE_LOG(LogWindowsMessageListener, VeryVerbose, TEXT("%s"), Line.ToString());
+        }
     }
 }
 
 WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::ProcessMessage(HWND hwnd, uint32 msg, WPARAM wParam, LPARAM lParam, int32 &outResult)
 {
-    if (bEnableVerboseLogging)
+    FWindowsMessageRecord Record(reinterpret_cast<uint64>(hwnd), msg, static_cast<uint64>(wParam), static_cast<int64>(lParam), FPlatformTime::Cycles64());
+    Record.MessageTime = static_cast<uint32>(::GetMessageTime());
+    return ProcessRecord(Record, outResult);
+}
+
+void FWindowsMessageListener::ObserveRecord(const FWindowsMessageRecord& Record)
+{
+    const uint32 msg = Record.Msg;
+    if (Dispatcher.IsVerboseLoggingEnabled())
     {
-        LogMessageDetails(hwnd, msg, TEXT("Processing message"));
+        LogMessageDetails(reinterpret_cast<HWND>(Record.Hwnd), msg, TEXT("Processing message"));
     }
 
+    Dispatcher.CaptureMessage(Record); // Captured before filtering, so a replay sees exactly what the listener saw
+
+    if (msg == WM_INPUT && RawInput)
+    {
+        RawInput->ReadRawInput(Record.LParam, Record.Timestamp);
+        if (bReadBufferedRawInput && !OwnsAllRawInputDevices())
+        {
+            UpdateBufferedRawInput(); // Rechecked before every read, since the engine may register devices of its own at any time
+        }
+        if (bReadBufferedRawInput)
+        {
+            RawInput->ReadBufferedRawInput(Record.Timestamp); // Payloads that queued up behind this one
+        }
+    }
+}
+
+bool FWindowsMessageListener::ProcessRecord(const FWindowsMessageRecord& Record, int32& OutResult)
+{
+    const HWND hwnd = reinterpret_cast<HWND>(Record.Hwnd);
+    const uint32 msg = Record.Msg;
+    ObserveRecord(Record);
+
     if (!ShouldProcessMessage(hwnd, msg))
     {
-        if (bEnableVerboseLogging)
+        if (Dispatcher.IsVerboseLoggingEnabled())
         {
             UE_LOG(LogWindowsMessageListener, VeryVerbose, TEXT("Message ignored: hwnd=%p, msg=%u"), hwnd, msg);
         }
+        Dispatcher.RejectMessage(Record);
+        Dispatcher.TrackWindowLifetime(Record);
         return false;
     }
 
-    for (IWindowsMessageHandler *handler : MessageHandlers)
+    return Dispatcher.AcceptMessage(Record, OutResult); // Tracks window lifetime when the message is dispatched
+}
+
+bool FWindowsMessageListener::AcceptSharedRecord(const FWindowsMessageRecord& Record, int32& OutResult)
+{
+    ObserveRecord(Record);
+
+    if (Record.Msg == WM_INPUT && !IsMessageAllowed(WM_INPUT))
+    {
+        return false; // Only forwarded for the raw input reader, so it is neither dispatched nor counted as rejected
+    }
+    return Dispatcher.AcceptMessage(Record, OutResult); // Tracks window lifetime when the message is dispatched
+}
+
+bool FWindowsMessageListener::ReplayRecord(const FWindowsMessageRecord& Record, int32& OutResult)
+{
+    if (!ShouldProcessMessage(reinterpret_cast<HWND>(Record.Hwnd), Record.Msg))
     {
-        if (handler && handler != this && ShouldProcessMessage(hwnd, msg))
-        {
-            LogMessageDetails(hwnd, msg, TEXT("Forwarding message to handler"));
-            handler->ProcessMessage(hwnd, msg, wParam, lParam, outResult);
-        }
+        Dispatcher.RejectMessage(Record);
+        return false;
     }
+    return Dispatcher.AcceptMessage(Record, OutResult);
+}
 
-    return false;
+void FWindowsMessageListener::TrackWindowLifetime(const FWindowsMessageRecord& Record)
+{
+    Dispatcher.TrackWindowLifetime(Record);
 }
 
 WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::ShouldProcessMessage(HWND hwnd, uint32 msg) const
 {
-    if (bEnableVerboseLogging)
+    if (Dispatcher.IsVerboseLoggingEnabled())
     {
         UE_LOG(LogWindowsMessageListener, Verbose, TEXT("Checking if message should be processed: hwnd=%p, msg=%u"), hwnd, msg);
     }
@@ -76,29 +163,209 @@ WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddMessageHandler(IWind
 {
     if (handler)
     {
-        MessageHandlers.Add(handler);
+        AddMessageHandlerSubscription(handler, TArray<TPair<uint32, uint32>>());
         UE_LOG(LogWindowsMessageListener, Log, TEXT("Message handler added: %p"), handler);
     }
 }
 
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddMessageHandler(IWindowsMessageHandler *handler, std::initializer_list<uint32> MsgCodes)
+{
+    AddMessageHandler(handler, MakeArrayView(MsgCodes.begin(), static_cast<int32>(MsgCodes.size())));
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddMessageHandler(IWindowsMessageHandler *handler, TArrayView<const uint32> MsgCodes)
+{
+    if (handler && MsgCodes.Num() > 0)
+    {
+        TArray<TPair<uint32, uint32>> Ranges;
+        Ranges.Reserve(MsgCodes.Num());
+        for (uint32 MsgCode : MsgCodes)
+        {
+            Ranges.Emplace(MsgCode, MsgCode);
+        }
+        AddMessageHandlerSubscription(handler, MoveTemp(Ranges));
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Message handler added: %p (%d message codes)"), handler, MsgCodes.Num());
+    }
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddMessageHandlerForRange(IWindowsMessageHandler *handler, uint32 FirstMsgCode, uint32 LastMsgCode)
+{
+    if (handler && FirstMsgCode <= LastMsgCode)
+    {
+        TArray<TPair<uint32, uint32>> Ranges;
+        Ranges.Emplace(FirstMsgCode, LastMsgCode);
+        AddMessageHandlerSubscription(handler, MoveTemp(Ranges));
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Message handler added: %p (messages %u-%u)"), handler, FirstMsgCode, LastMsgCode);
+    }
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddWindowMessageHandler(IWindowsMessageHandler *handler, HWND hwnd)
+{
+    if (handler && hwnd)
+    {
+        AddMessageHandlerSubscription(handler, TArray<TPair<uint32, uint32>>(), hwnd);
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Message handler added: %p (window %p)"), handler, hwnd);
+    }
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddWindowMessageHandler(IWindowsMessageHandler *handler, HWND hwnd, std::initializer_list<uint32> MsgCodes)
+{
+    if (handler && hwnd && MsgCodes.size() > 0)
+    {
+        TArray<TPair<uint32, uint32>> Ranges;
+        Ranges.Reserve(static_cast<int32>(MsgCodes.size()));
+        for (uint32 MsgCode : MsgCodes)
+        {
+            Ranges.Emplace(MsgCode, MsgCode);
+        }
+        AddMessageHandlerSubscription(handler, MoveTemp(Ranges), hwnd);
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Message handler added: %p (window %p, %d message codes)"), handler, hwnd, static_cast<int32>(MsgCodes.size()));
+    }
+}
+
+WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::AddWindowMessageHandler(IWindowsMessageHandler *handler, const TSharedRef<SWindow>& Window)
+{
+    const TSharedPtr<FGenericWindow> NativeWindow = Window->GetNativeWindow();
+    HWND hwnd = NativeWindow.IsValid() ? static_cast<HWND>(NativeWindow->GetOSWindowHandle()) : nullptr;
+    if (!hwnd)
+    {
+        UE_LOG(LogWindowsMessageListener, Warning, TEXT("Cannot bind message handler %p: the window has no native window yet."), handler);
+        return false;
+    }
+
+    AddWindowMessageHandler(handler, hwnd);
+    return true;
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::RemoveWindowMessageHandlers(HWND hwnd)
+{
+    const int32 NumRemoved = Dispatcher.RemoveWindowHandlers(reinterpret_cast<uint64>(hwnd));
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Removed %d message handlers bound to window %p"), NumRemoved, hwnd);
+}
+
+WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::SetMessageHandlerPriority(IWindowsMessageHandler *handler, int32 Priority)
+{
+    return Dispatcher.SetHandlerPriority(handler, Priority);
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::SetMessageRules(TSharedPtr<const FWindowsMessageRuleSet> Rules)
+{
+    Dispatcher.SetMessageRules(MoveTemp(Rules));
+}
+
+WINDOWSMESSAGELISTENER_API int32 FWindowsMessageListener::LoadMessageRules(const TCHAR* Section, const FString& Filename)
+{
+    TSharedPtr<FWindowsMessageRuleSet> Rules = MakeShared<FWindowsMessageRuleSet>();
+    const int32 NumCompiled = Rules->AddRulesFromConfig(Section, Filename);
+    Dispatcher.SetMessageRules(MoveTemp(Rules));
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Loaded %d message rules from [%s]"), NumCompiled, Section);
+    return NumCompiled;
+}
+
+WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::SetMessageHandlerRule(IWindowsMessageHandler *handler, FName RuleName)
+{
+    return Dispatcher.SetHandlerRule(handler, RuleName);
+}
+
+WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::SetMessageHandlerThread(IWindowsMessageHandler *handler, EWindowsMessageHandlerThread Thread, int32 PreferredWorker)
+{
+    return Dispatcher.SetHandlerThread(handler, Thread, PreferredWorker);
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::SetConsumptionPolicy(EWindowsMessageConsumptionPolicy Policy)
+{
+    Dispatcher.SetConsumptionPolicy(Policy);
+}
+
+WINDOWSMESSAGELISTENER_API EWindowsMessageConsumptionPolicy FWindowsMessageListener::GetConsumptionPolicy() const
+{
+    return Dispatcher.GetConsumptionPolicy();
+}
+
 WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::RemoveMessageHandler(IWindowsMessageHandler *handler)
 {
     if (handler)
     {
-        MessageHandlers.Remove(handler);
+        Dispatcher.RemoveHandler(handler);
         UE_LOG(LogWindowsMessageListener, Log, TEXT("Message handler removed: %p"), handler);
     }
 }
 
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddBatchMessageHandler(IWindowsMessageBatchHandler *handler)
+{
+    if (handler)
+    {
+        Dispatcher.AddBatchHandler(FWindowsMessageBatchHandlerRef::Create(handler));
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Batch message handler added: %p"), handler);
+    }
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::RemoveBatchMessageHandler(IWindowsMessageBatchHandler *handler)
+{
+    if (handler)
+    {
+        Dispatcher.RemoveHandler(handler);
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Batch message handler removed: %p"), handler);
+    }
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddInputEventHandler(IWindowsInputEventHandler *handler, EWindowsInputEventTypes EventTypes)
+{
+    if (handler)
+    {
+        InputEvents.AddHandler(handler, EventTypes);
+        Dispatcher.AddBatchHandler(FWindowsMessageBatchHandlerRef::Create(&InputEvents)); // No-op if the router is already registered
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Input event handler added: %p (types 0x%02x)"), handler, static_cast<uint32>(EventTypes));
+    }
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::RemoveInputEventHandler(IWindowsInputEventHandler *handler)
+{
+    if (handler)
+    {
+        InputEvents.RemoveHandler(handler);
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Input event handler removed: %p"), handler);
+    }
+}
+
 WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::RemoveAllMessageHandlers()
 {
-    MessageHandlers.Empty();
+    Dispatcher.RemoveAllHandlers();
+    InputEvents.RemoveAllHandlers();
     UE_LOG(LogWindowsMessageListener, Log, TEXT("All message handlers removed."));
 }
 
-WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::StartListening()
+void FWindowsMessageListener::AddMessageHandlerSubscription(IWindowsMessageHandler *handler, TArray<TPair<uint32, uint32>>&& Ranges, HWND hwnd)
 {
-    if (!bIsListening)
+    if (handler == this)
+    {
+        return; // The listener never forwards messages to itself
+    }
+
+    FWindowsMessageHandlerRef HandlerRef;
+    HandlerRef.Object = handler;
+    HandlerRef.Invoke = &InvokeWindowsMessageHandler;
+    Dispatcher.AddHandler(HandlerRef, MoveTemp(Ranges), reinterpret_cast<uint64>(hwnd));
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::StartListening(EWindowsMessageListenerRegistration Registration)
+{
+    if (!bIsListening && Registration == EWindowsMessageListenerRegistration::Shared)
+    {
+        FWindowsMessageListenerHub* SharedHub = FWindowsMessageListenerHub::Get();
+        if (SharedHub && SharedHub->AddSubscriber(this))
+        {
+            Hub = SharedHub;
+            bIsListening = true;
+            UE_LOG(LogWindowsMessageListener, Log, TEXT("Message listener started and attached to the shared hub (%d listeners)."), SharedHub->NumSubscribers());
+        }
+        else if (!SharedHub)
+        {
+            UE_LOG(LogWindowsMessageListener, Warning, TEXT("Shared listener hub unavailable; registering directly."));
+            StartListening(EWindowsMessageListenerRegistration::Direct);
+        }
+    }
+    else if (!bIsListening)
     {
         FWindowsApplication *WindowsApplication = GetApplication();
         if (WindowsApplication)
@@ -122,8 +389,12 @@ WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::StopListening()
 {
     if (bIsListening)
     {
-        FWindowsApplication *WindowsApplication = GetApplication();
-        if (WindowsApplication)
+        if (Hub)
+        {
+            Hub->RemoveSubscriber(this);
+            Hub = nullptr;
+        }
+        else if (FWindowsApplication *WindowsApplication = GetApplication())
         {
             WindowsApplication->RemoveMessageHandler(*this);
         }
@@ -143,42 +414,439 @@ WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::IsListening() const
 
 WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddAllowedMessageType(uint32 MsgCode)
 {
-    AllowedMessageTypes.Add(MsgCode);
+    Dispatcher.AllowMessageType(MsgCode);
+    RefreshSharedFilter();
     UE_LOG(LogWindowsMessageListener, Log, TEXT("Added allowed message type: %u"), MsgCode);
 }
 
 WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::RemoveAllowedMessageType(uint32 MsgCode)
 {
-    AllowedMessageTypes.Remove(MsgCode);
+    Dispatcher.DisallowMessageType(MsgCode);
+    RefreshSharedFilter();
     UE_LOG(LogWindowsMessageListener, Log, TEXT("Removed allowed message type: %u"), MsgCode);
 }
 
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddAllowedMessageRange(uint32 FirstMsgCode, uint32 LastMsgCode)
+{
+    Dispatcher.AllowMessageRange(FirstMsgCode, LastMsgCode);
+    RefreshSharedFilter();
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Added allowed message range: %u-%u"), FirstMsgCode, LastMsgCode);
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::RemoveAllowedMessageRange(uint32 FirstMsgCode, uint32 LastMsgCode)
+{
+    Dispatcher.DisallowMessageRange(FirstMsgCode, LastMsgCode);
+    RefreshSharedFilter();
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Removed allowed message range: %u-%u"), FirstMsgCode, LastMsgCode);
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddAllowedMessageTypes(TArrayView<const uint32> MsgCodes)
+{
+    Dispatcher.AllowMessageTypes(MsgCodes);
+    RefreshSharedFilter();
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Added %d allowed message types."), MsgCodes.Num());
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::RemoveAllowedMessageTypes(TArrayView<const uint32> MsgCodes)
+{
+    Dispatcher.DisallowMessageTypes(MsgCodes);
+    RefreshSharedFilter();
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Removed %d allowed message types."), MsgCodes.Num());
+}
+
 WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::ClearAllowedMessageTypes()
 {
-    AllowedMessageTypes.Empty();
+    Dispatcher.ClearAllowedMessageTypes();
+    RefreshSharedFilter();
     UE_LOG(LogWindowsMessageListener, Log, TEXT("Cleared all allowed message types."));
 }
 
-// Clarify default behavior when AllowedMessageTypes is empty
+// An empty allow-list has no bits set, so it blocks all messages without a separate check
 WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::IsMessageAllowed(uint32 MsgCode) const
 {
-    if (AllowedMessageTypes.Num() == 0) // If no messages are allowed, block all
-    {
-        // Default behavior: Block all messages if no allowed types are specified.
-        return false;
-    }
-    return AllowedMessageTypes.Contains(MsgCode);
+    return Dispatcher.IsMessageAllowed(MsgCode);
 }
 
 void FWindowsMessageListener::SetVerboseLoggingEnabled(bool bEnabled)
 {
-    bEnableVerboseLogging = bEnabled;
+    Dispatcher.SetVerboseLoggingEnabled(bEnabled);
     UE_LOG(LogWindowsMessageListener, Log, TEXT("Verbose logging %s"), bEnabled ? TEXT("enabled") : TEXT("disabled"));
 }
 
 WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::IsVerboseLoggingEnabled() const
 {
-    return bEnableVerboseLogging;
+    return Dispatcher.IsVerboseLoggingEnabled();
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::EnableDeferredProcessing(uint32 Capacity, EWindowsMessageOverflowPolicy OverflowPolicy, bool bDrainOnTick)
+{
+    Dispatcher.EnableDeferredProcessing(Capacity, OverflowPolicy, bDrainOnTick);
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::DisableDeferredProcessing()
+{
+    Dispatcher.DisableDeferredProcessing();
+}
+
+WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::IsDeferredProcessingEnabled() const
+{
+    return Dispatcher.IsDeferredProcessingEnabled();
+}
+
+WINDOWSMESSAGELISTENER_API int32 FWindowsMessageListener::DrainDeferredMessages(int32 MaxMessages)
+{
+    return Dispatcher.DrainDeferredMessages(MaxMessages);
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsMessageRingCounters FWindowsMessageListener::GetDeferredMessageCounters() const
+{
+    return Dispatcher.GetDeferredMessageCounters();
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::AddCoalescedMessageType(uint32 MsgCode)
+{
+    Dispatcher.AddCoalescedMessageType(MsgCode);
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Added coalesced message type: %u"), MsgCode);
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::RemoveCoalescedMessageType(uint32 MsgCode)
+{
+    Dispatcher.RemoveCoalescedMessageType(MsgCode);
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Removed coalesced message type: %u"), MsgCode);
+}
+
+WINDOWSMESSAGELISTENER_API int32 FWindowsMessageListener::FlushCoalescedMessages()
+{
+    return Dispatcher.FlushCoalescedMessages();
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsMessageCoalescerCounters FWindowsMessageListener::GetCoalescerCounters() const
+{
+    return Dispatcher.GetCoalescerCounters();
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::EnableMessageBatching(int32 MaxMessages, bool bFlushOnTick)
+{
+    Dispatcher.EnableMessageBatching(MaxMessages, bFlushOnTick);
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::DisableMessageBatching()
+{
+    Dispatcher.DisableMessageBatching();
+}
+
+WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::IsMessageBatchingEnabled() const
+{
+    return Dispatcher.IsMessageBatchingEnabled();
+}
+
+WINDOWSMESSAGELISTENER_API int32 FWindowsMessageListener::FlushMessageBatch()
+{
+    return Dispatcher.FlushMessageBatch();
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::EnableFrameArena(int32 BlockBytes)
+{
+    Dispatcher.EnableFrameArena(BlockBytes);
+    InputEvents.SetFrameArena(Dispatcher.GetFrameArena()); // Decoded input events come from the arena too
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::DisableFrameArena()
+{
+    InputEvents.SetFrameArena(nullptr); // Before the arena is freed
+    Dispatcher.DisableFrameArena();
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsMessageFrameArena* FWindowsMessageListener::GetFrameArena()
+{
+    return Dispatcher.GetFrameArena();
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsMessageArenaCounters FWindowsMessageListener::GetFrameArenaCounters() const
+{
+    return Dispatcher.GetFrameArenaCounters();
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::EnableMessageLogging(int32 Capacity)
+{
+    Dispatcher.EnableMessageLogging(Capacity);
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::DisableMessageLogging()
+{
+    Dispatcher.DisableMessageLogging();
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsMessageLogger* FWindowsMessageListener::GetMessageLogger()
+{
+    return Dispatcher.GetMessageLogger();
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsMessageLogCounters FWindowsMessageListener::GetMessageLogCounters() const
+{
+    return Dispatcher.GetMessageLogCounters();
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::EnableLatencyTracking(int32 MaxTrackedCodes, int32 TimelineCapacity)
+{
+    Dispatcher.EnableLatencyTracking(MaxTrackedCodes, TimelineCapacity);
+
+    // GetMessageTime() counts on the same clock as GetTickCount()
+    Dispatcher.GetLatencyTracker()->SetSystemClock([]() { return static_cast<uint32>(::GetTickCount()); });
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::DisableLatencyTracking()
+{
+    Dispatcher.DisableLatencyTracking();
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsMessageLatencyTracker* FWindowsMessageListener::GetLatencyTracker()
+{
+    return Dispatcher.GetLatencyTracker();
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsMessageLatencyStats FWindowsMessageListener::GetLatencyStats() const
+{
+    return Dispatcher.GetLatencyStats();
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::EnableParallelDispatch(int32 NumWorkers, uint32 Capacity, bool bWaitWhenFull)
+{
+    Dispatcher.EnableParallelDispatch(NumWorkers, Capacity, bWaitWhenFull);
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::DisableParallelDispatch()
+{
+    Dispatcher.DisableParallelDispatch();
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsMessageFanOutCounters FWindowsMessageListener::GetParallelDispatchCounters() const
+{
+    return Dispatcher.GetParallelDispatchCounters();
+}
+
+WINDOWSMESSAGELISTENER_API TArray<uint8> FWindowsMessageListener::SaveState(const TMap<IWindowsMessageHandler*, FName>& HandlerNames) const
+{
+    FWindowsMessageListenerState State;
+    Dispatcher.SaveState(State, [&HandlerNames](const void* Object)
+    {
+        return HandlerNames.FindRef(static_cast<IWindowsMessageHandler*>(const_cast<void*>(Object)));
+    });
+    return State.SaveToBytes();
+}
+
+WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::RestoreState(TArrayView<const uint8> Bytes, const TMap<FName, IWindowsMessageHandler*>& Handlers)
+{
+    FWindowsMessageListenerState State;
+    if (!State.LoadFromBytes(Bytes))
+    {
+        UE_LOG(LogWindowsMessageListener, Warning, TEXT("Listener state not restored: %d bytes are not a valid saved state."), Bytes.Num());
+        return false;
+    }
+
+    const int32 NumRestored = Dispatcher.RestoreState(State, [this, &Handlers](FName HandlerName)
+    {
+        FWindowsMessageHandlerRef HandlerRef;
+        IWindowsMessageHandler* Handler = Handlers.FindRef(HandlerName);
+        if (Handler && Handler != this)
+        {
+            HandlerRef.Object = Handler;
+            HandlerRef.Invoke = &InvokeWindowsMessageHandler;
+        }
+        return HandlerRef;
+    });
+    RefreshSharedFilter();
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Listener state restored: %d allowed message types, %d of %d subscriptions."), State.AllowedMessageTypes.Num(), NumRestored, State.Subscriptions.Num());
+    return true;
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::EnableRawInput(uint32 QueueCapacity, int32 ArenaBytes, EWindowsRawInputReadMode ReadMode, EWindowsMessageOverflowPolicy OverflowPolicy)
+{
+    RawInput = MakeUnique<FWindowsRawInputReader>(QueueCapacity, ArenaBytes, OverflowPolicy);
+    RawInputReadMode = ReadMode;
+    RefreshSharedFilter(); // WM_INPUT must reach this listener even if it is not on the allow-list
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Raw input enabled: %u records, %d byte arena, %s reads"), QueueCapacity, RawInput->GetArenaSize(),
+        ReadMode == EWindowsRawInputReadMode::Buffered ? TEXT("buffered") : TEXT("per-message"));
+
+    UpdateBufferedRawInput();
+    if (ReadMode == EWindowsRawInputReadMode::Buffered && !bReadBufferedRawInput)
+    {
+        UE_LOG(LogWindowsMessageListener, Warning, TEXT("Buffered raw input needs this listener to be the only buffered reader and to have registered every raw input device class itself; reading per message until it does."));
+    }
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::DisableRawInput()
+{
+    if (RawInput)
+    {
+        RawInput.Reset();
+        UpdateBufferedRawInput();
+        RefreshSharedFilter();
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Raw input disabled."));
+    }
+}
+
+WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::IsRawInputEnabled() const
+{
+    return RawInput.IsValid();
+}
+
+WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::RegisterRawInputDevice(uint16 UsagePage, uint16 Usage, uint32 Flags, HWND hwndTarget)
+{
+    RAWINPUTDEVICE Device;
+    Device.usUsagePage = UsagePage;
+    Device.usUsage = Usage;
+    Device.dwFlags = Flags;
+    Device.hwndTarget = hwndTarget;
+    if (!::RegisterRawInputDevices(&Device, 1, sizeof(RAWINPUTDEVICE)))
+    {
+        UE_LOG(LogWindowsMessageListener, Warning, TEXT("Failed to register raw input device %04x:%04x (error %u)"), UsagePage, Usage, ::GetLastError());
+        return false;
+    }
+
+    const uint32 DeviceKey = MakeRawInputDeviceKey(UsagePage, Usage);
+    if (Flags & RIDEV_REMOVE)
+    {
+        OwnedRawInputDevices.Remove(DeviceKey);
+    }
+    else
+    {
+        OwnedRawInputDevices.AddUnique(DeviceKey);
+    }
+    UpdateBufferedRawInput();
+
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Raw input device registered: %04x:%04x"), UsagePage, Usage);
+    return true;
+}
+
+bool FWindowsMessageListener::OwnsAllRawInputDevices() const
+{
+    if (OwnedRawInputDevices.Num() == 0)
+    {
+        return false;
+    }
+
+    // More device classes than fit here cannot all be this listener's, so a failed call means they are not
+    RAWINPUTDEVICE Devices[16];
+    UINT NumDevices = UE_ARRAY_COUNT(Devices);
+    const UINT NumRegistered = ::GetRegisteredRawInputDevices(Devices, &NumDevices, sizeof(RAWINPUTDEVICE));
+    if (NumRegistered == static_cast<UINT>(-1))
+    {
+        return false;
+    }
+    for (UINT Index = 0; Index < NumRegistered; ++Index)
+    {
+        if (!OwnedRawInputDevices.Contains(MakeRawInputDeviceKey(Devices[Index].usUsagePage, Devices[Index].usUsage)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FWindowsMessageListener::UpdateBufferedRawInput()
+{
+    const bool bWasReading = bReadBufferedRawInput;
+    bReadBufferedRawInput = false;
+    if (RawInput && RawInputReadMode == EWindowsRawInputReadMode::Buffered)
+    {
+        const FWindowsMessageListener* Owner = nullptr;
+        const bool bClaimed = BufferedRawInputOwner.compare_exchange_strong(Owner, this) || Owner == this;
+        bReadBufferedRawInput = bClaimed && OwnsAllRawInputDevices();
+    }
+    if (!bReadBufferedRawInput)
+    {
+        const FWindowsMessageListener* Owner = this;
+        BufferedRawInputOwner.compare_exchange_strong(Owner, nullptr);
+    }
+
+    if (bReadBufferedRawInput && !bWasReading)
+    {
+        UE_LOG(LogWindowsMessageListener, Warning, TEXT("Buffered raw input reads enabled: queued WM_INPUT messages are drained by this listener and no longer reach FWindowsApplication or other listeners."));
+    }
+    else if (!bReadBufferedRawInput && bWasReading && RawInput)
+    {
+        UE_LOG(LogWindowsMessageListener, Warning, TEXT("Raw input devices were registered outside this listener; buffered raw input reads would take their WM_INPUT messages, so payloads are read per message from now on."));
+    }
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsRawInputCounters FWindowsMessageListener::GetRawInputCounters() const
+{
+    return RawInput ? RawInput->GetCounters() : FWindowsRawInputCounters();
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsMessageStatsSnapshot FWindowsMessageListener::GetMessageStats() const
+{
+    return Dispatcher.GetMessageStats();
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::ResetMessageStats()
+{
+    Dispatcher.ResetMessageStats();
+}
+
+WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::StartCapture(const FString& Filename, int32 BufferRecords)
+{
+    return Dispatcher.StartCapture(Filename, BufferRecords);
+}
+
+WINDOWSMESSAGELISTENER_API void FWindowsMessageListener::StopCapture()
+{
+    Dispatcher.StopCapture();
+}
+
+WINDOWSMESSAGELISTENER_API bool FWindowsMessageListener::IsCapturing() const
+{
+    return Dispatcher.IsCapturing();
+}
+
+WINDOWSMESSAGELISTENER_API FWindowsMessageCaptureCounters FWindowsMessageListener::GetCaptureCounters() const
+{
+    return Dispatcher.GetCaptureCounters();
+}
+
+WINDOWSMESSAGELISTENER_API int32 FWindowsMessageListener::ReplayCapture(const FString& Filename, EWindowsMessageReplayTiming Timing)
+{
+    FWindowsMessageCaptureReader Reader;
+    if (!Reader.Open(*Filename))
+    {
+        return INDEX_NONE;
+    }
+
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Replaying %d captured messages from %s"), Reader.GetRecords().Num(), *Filename);
+    return Reader.Replay(Timing, [this](const FWindowsMessageRecord& Record)
+    {
+        int32 Result = 0;
+        ReplayRecord(Record, Result);
+    });
+}
+
+void FWindowsMessageListener::MergeSharedFilter(FWindowsMessageFilter& Combined) const
+{
+    Combined.Merge(Dispatcher.GetAllowedMessageTypes());
+    if (RawInput)
+    {
+        Combined.Allow(WM_INPUT);
+    }
+}
+
+bool FWindowsMessageListener::NeedsSharedMessage(uint32 MsgCode) const
+{
+    return IsMessageAllowed(MsgCode) || (MsgCode == WM_INPUT && RawInput);
+}
+
+void FWindowsMessageListener::RefreshSharedFilter()
+{
+    if (Hub)
+    {
+        Hub->RefreshFilter();
+    }
+}
+
+void FWindowsMessageListener::DetachFromHub()
+{
+    Hub = nullptr;
+    bIsListening = false;
 }
 
 FWindowsApplication *FWindowsMessageListener::GetApplication() const
@@ -188,4 +856,6 @@ FWindowsApplication *FWindowsMessageListener::GetApplication() const
         return (FWindowsApplication *)FSlateApplication::Get().GetPlatformApplication().Get();
     }
     return nullptr;
-}
\ No newline at end of file
+}
+
+#endif // PLATFORM_WINDOWS
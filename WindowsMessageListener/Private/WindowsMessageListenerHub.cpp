@@ -0,0 +1,221 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the FWindowsMessageListenerHub class.
+ */
+
+#include "WindowsMessageListenerHub.h"
+
+#if PLATFORM_WINDOWS
+
+#include "WindowsMessageListener.h"
+#include "WindowsMessageListenerModule.h"
+#include "WindowsMessageListenerLog.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/PlatformTime.h"
+
+FWindowsMessageListenerHub::FWindowsMessageListenerHub()
+{
+    RefreshFilter();
+}
+
+FWindowsMessageListenerHub::~FWindowsMessageListenerHub()
+{
+    // Listeners that outlive the module fall back to not listening rather than keeping a dangling hub
+    for (FWindowsMessageListener* Listener : Subscribers)
+    {
+        if (Listener)
+        {
+            Listener->DetachFromHub();
+        }
+    }
+    if (NumLiveSubscribers > 0)
+    {
+        UE_LOG(LogWindowsMessageListener, Warning, TEXT("Message listener hub destroyed with %d listeners still attached."), NumLiveSubscribers);
+    }
+
+    if (bIsRegistered)
+    {
+        if (FWindowsApplication* WindowsApplication = GetApplication())
+        {
+            WindowsApplication->RemoveMessageHandler(*this);
+        }
+        bIsRegistered = false;
+    }
+}
+
+FWindowsMessageListenerHub* FWindowsMessageListenerHub::Get()
+{
+    FWindowsMessageListenerModule* Module = FModuleManager::GetModulePtr<FWindowsMessageListenerModule>(TEXT("WindowsMessageListener"));
+    return Module ? Module->GetHub() : nullptr;
+}
+
+bool FWindowsMessageListenerHub::ProcessMessage(HWND hwnd, uint32 msg, WPARAM wParam, LPARAM lParam, int32& outResult)
+{
+    if (!ForwardedMessageTypes.IsAllowed(msg))
+    {
+        return false;
+    }
+
+    // Timestamped once, so every subscriber sees the same arrival time
+    FWindowsMessageRecord Record(reinterpret_cast<uint64>(hwnd), msg, static_cast<uint64>(wParam), static_cast<int64>(lParam), FPlatformTime::Cycles64());
+    Record.MessageTime = static_cast<uint32>(::GetMessageTime());
+
+    // Lifetime messages reach every subscriber, but only those that want them process them
+    const bool bIsLifetimeMessage = msg == FWindowsMessageDispatcher::WindowCreateMsg || msg == FWindowsMessageDispatcher::WindowDestroyMsg;
+    const uint64 Mask = GetSubscriberMask(msg);
+
+    bool bHandled = false;
+    ++ForwardDepth;
+    const int32 NumToForward = Subscribers.Num(); // Listeners attached by a handler start with the next message
+    for (int32 Index = 0; Index < NumToForward; ++Index)
+    {
+        FWindowsMessageListener* Listener = Subscribers[Index];
+        if (!Listener)
+        {
+            continue;
+        }
+        const bool bWanted = Index < MaxMaskedSubscribers ? ((Mask >> Index) & 1) != 0 : Listener->NeedsSharedMessage(msg);
+        if (!bWanted)
+        {
+            if (bIsLifetimeMessage)
+            {
+                Listener->TrackWindowLifetime(Record); // Releases its window bindings without counting or logging a rejection
+            }
+            continue;
+        }
+
+        int32 Result = 0;
+        if (Listener->AcceptSharedRecord(Record, Result) && !bHandled)
+        {
+            // Same rule as FWindowsApplication: every handler sees the message, the first one to handle it sets the result
+            bHandled = true;
+            outResult = Result;
+        }
+    }
+    if (--ForwardDepth == 0 && bHasRemovedSubscribers)
+    {
+        Subscribers.Remove(nullptr);
+        bHasRemovedSubscribers = false;
+        RefreshFilter(); // Compaction moved subscribers to other mask bits
+    }
+    return bHandled;
+}
+
+bool FWindowsMessageListenerHub::AddSubscriber(FWindowsMessageListener* Listener)
+{
+    if (!Listener || Subscribers.Contains(Listener))
+    {
+        return Listener != nullptr;
+    }
+
+    if (!bIsRegistered)
+    {
+        FWindowsApplication* WindowsApplication = GetApplication();
+        if (!WindowsApplication)
+        {
+            UE_LOG(LogWindowsMessageListener, Error, TEXT("Failed to get FWindowsApplication instance."));
+            return false;
+        }
+        WindowsApplication->AddMessageHandler(*this);
+        bIsRegistered = true;
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Message listener hub registered with FWindowsApplication."));
+    }
+
+    Subscribers.Add(Listener);
+    ++NumLiveSubscribers;
+    RefreshFilter();
+    return true;
+}
+
+void FWindowsMessageListenerHub::RemoveSubscriber(FWindowsMessageListener* Listener)
+{
+    const int32 Index = Subscribers.Find(Listener);
+    if (!Listener || Index == INDEX_NONE)
+    {
+        return;
+    }
+
+    if (ForwardDepth > 0)
+    {
+        Subscribers[Index] = nullptr; // Compacted once the forward ends, so its loop indices stay valid
+        bHasRemovedSubscribers = true;
+    }
+    else
+    {
+        Subscribers.RemoveAt(Index);
+    }
+    --NumLiveSubscribers;
+    RefreshFilter();
+
+    if (NumLiveSubscribers == 0 && bIsRegistered)
+    {
+        if (FWindowsApplication* WindowsApplication = GetApplication())
+        {
+            WindowsApplication->RemoveMessageHandler(*this);
+        }
+        bIsRegistered = false;
+        UE_LOG(LogWindowsMessageListener, Log, TEXT("Message listener hub unregistered from FWindowsApplication."));
+    }
+}
+
+void FWindowsMessageListenerHub::RefreshFilter()
+{
+    ForwardedMessageTypes.Reset();
+    for (int32& PageOffset : MaskPageOffsets)
+    {
+        PageOffset = INDEX_NONE;
+    }
+    SubscriberMasks.Reset();
+    OverflowSubscriberMasks.Reset();
+
+    // Window lifetime messages always reach subscribers, so handlers bound to a destroyed window are released
+    ForwardedMessageTypes.Allow(FWindowsMessageDispatcher::WindowCreateMsg);
+    ForwardedMessageTypes.Allow(FWindowsMessageDispatcher::WindowDestroyMsg);
+
+    FWindowsMessageFilter SubscriberTypes;
+    for (int32 Index = 0; Index < Subscribers.Num(); ++Index)
+    {
+        const FWindowsMessageListener* Listener = Subscribers[Index];
+        if (!Listener)
+        {
+            continue;
+        }
+
+        SubscriberTypes.Reset();
+        Listener->MergeSharedFilter(SubscriberTypes);
+        ForwardedMessageTypes.Merge(SubscriberTypes);
+        if (Index < MaxMaskedSubscribers)
+        {
+            SubscriberTypes.ForEachAllowed([this, Index](uint32 MsgCode) { AddSubscriberMaskBit(MsgCode, Index); });
+        }
+    }
+}
+
+void FWindowsMessageListenerHub::AddSubscriberMaskBit(uint32 MsgCode, int32 SubscriberIndex)
+{
+    const uint64 Bit = uint64(1) << SubscriberIndex;
+    if (MsgCode >= FWindowsMessageFilter::NumBitmapCodes)
+    {
+        OverflowSubscriberMasks.FindOrAdd(MsgCode) |= Bit;
+        return;
+    }
+
+    int32& PageOffset = MaskPageOffsets[MsgCode / MaskPageCodes];
+    if (PageOffset == INDEX_NONE)
+    {
+        PageOffset = SubscriberMasks.AddZeroed(MaskPageCodes);
+    }
+    SubscriberMasks[PageOffset + MsgCode % MaskPageCodes] |= Bit;
+}
+
+FWindowsApplication* FWindowsMessageListenerHub::GetApplication() const
+{
+    if (FSlateApplication::IsInitialized())
+    {
+        return (FWindowsApplication*)FSlateApplication::Get().GetPlatformApplication().Get();
+    }
+    return nullptr;
+}
+
+#endif // PLATFORM_WINDOWS
@@ -0,0 +1,12 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares the log category shared by the listener and its dispatch core.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logging/LogMacros.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogWindowsMessageListener, Log, All);
@@ -5,24 +5,42 @@
  * It handles the startup and shutdown of the module.
  */
 
-#include "WindowsMessageListener.h"
-#include "Modules/ModuleManager.h"
-#include "Logging/LogMacros.h"
+#include "WindowsMessageListenerModule.h"
+#include "WindowsMessageListenerHub.h"
+#include "WindowsMessageListenerLog.h"
 
-DEFINE_LOG_CATEGORY_STATIC(LogWindowsMessageListener, Log, All);
+FWindowsMessageListenerModule::FWindowsMessageListenerModule()
+{
+}
+
+// Defined here, where FWindowsMessageListenerHub is complete
+FWindowsMessageListenerModule::~FWindowsMessageListenerModule()
+{
+}
+
+void FWindowsMessageListenerModule::StartupModule()
+{
+#if PLATFORM_WINDOWS
+    Hub = MakeUnique<FWindowsMessageListenerHub>();
+#endif
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("WindowsMessageListener module started."));
+}
+
+void FWindowsMessageListenerModule::ShutdownModule()
+{
+#if PLATFORM_WINDOWS
+    Hub.Reset();
+#endif
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("WindowsMessageListener module shut down."));
+}
 
-class WINDOWSMESSAGELISTENER_API FWindowsMessageListenerModule : public IModuleInterface
+FWindowsMessageListenerHub* FWindowsMessageListenerModule::GetHub() const
 {
-public:
-    virtual void StartupModule() override
-    {
-        UE_LOG(LogWindowsMessageListener, Log, TEXT("WindowsMessageListener module started."));
-    }
-
-    virtual void ShutdownModule() override
-    {
-        UE_LOG(LogWindowsMessageListener, Log, TEXT("WindowsMessageListener module shut down."));
-    }
-};
-
-IMPLEMENT_MODULE(FWindowsMessageListenerModule, WindowsMessageListener);
\ No newline at end of file
+#if PLATFORM_WINDOWS
+    return Hub.Get();
+#else
+    return nullptr;
+#endif
+}
+
+IMPLEMENT_MODULE(FWindowsMessageListenerModule, WindowsMessageListener);
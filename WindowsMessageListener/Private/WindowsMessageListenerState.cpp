@@ -0,0 +1,115 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements FWindowsMessageListenerState serialization.
+ */
+
+#include "WindowsMessageListenerState.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+    /** Checks that code ranges are sorted, disjoint and well formed, as the dispatch table rebuild expects. */
+    bool AreCodeRangesValid(const TArray<TPair<uint32, uint32>>& Ranges)
+    {
+        for (int32 Index = 0; Index < Ranges.Num(); ++Index)
+        {
+            if (Ranges[Index].Key > Ranges[Index].Value || (Index > 0 && Ranges[Index].Key <= Ranges[Index - 1].Value))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void SerializeSubscription(FArchive& Ar, FWindowsMessageSubscriptionState& Subscription)
+    {
+        uint8 Thread = static_cast<uint8>(Subscription.Thread);
+        Ar << Subscription.Handler << Subscription.Priority << Subscription.Rule << Thread << Subscription.Worker;
+        Subscription.Thread = static_cast<EWindowsMessageHandlerThread>(Thread);
+
+        int32 NumRanges = Subscription.Ranges.Num();
+        Ar << NumRanges;
+        if (Ar.IsLoading())
+        {
+            if (NumRanges < 0 || Thread > static_cast<uint8>(EWindowsMessageHandlerThread::Worker) || Subscription.Worker < 0)
+            {
+                Ar.SetError();
+                return;
+            }
+            Subscription.Ranges.Reset();
+        }
+        for (int32 Index = 0; Index < NumRanges && !Ar.IsError(); ++Index)
+        {
+            if (Ar.IsLoading())
+            {
+                Subscription.Ranges.AddDefaulted();
+            }
+            Ar << Subscription.Ranges[Index].Key << Subscription.Ranges[Index].Value;
+        }
+        if (Ar.IsLoading() && !AreCodeRangesValid(Subscription.Ranges))
+        {
+            Ar.SetError();
+        }
+    }
+}
+
+void FWindowsMessageListenerState::Serialize(FArchive& Ar)
+{
+    uint32 Magic = ExpectedMagic;
+    uint16 Version = CurrentVersion;
+    Ar << Magic << Version;
+    if (Ar.IsLoading() && (Magic != ExpectedMagic || Version != CurrentVersion))
+    {
+        Ar.SetError();
+        return;
+    }
+
+    AllowedMessageTypes.Serialize(Ar);
+    CoalescedMessageTypes.Serialize(Ar);
+
+    uint8 Policy = static_cast<uint8>(ConsumptionPolicy);
+    Ar << Policy;
+    ConsumptionPolicy = static_cast<EWindowsMessageConsumptionPolicy>(Policy);
+
+    int32 NumSubscriptions = Subscriptions.Num();
+    Ar << NumSubscriptions;
+    if (Ar.IsLoading())
+    {
+        if (Policy > static_cast<uint8>(EWindowsMessageConsumptionPolicy::Consume) || NumSubscriptions < 0)
+        {
+            Ar.SetError();
+            return;
+        }
+        Subscriptions.Reset();
+    }
+    for (int32 Index = 0; Index < NumSubscriptions && !Ar.IsError(); ++Index)
+    {
+        if (Ar.IsLoading())
+        {
+            Subscriptions.AddDefaulted();
+        }
+        SerializeSubscription(Ar, Subscriptions[Index]);
+    }
+}
+
+TArray<uint8> FWindowsMessageListenerState::SaveToBytes() const
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    const_cast<FWindowsMessageListenerState*>(this)->Serialize(Writer);
+    return Bytes;
+}
+
+bool FWindowsMessageListenerState::LoadFromBytes(TArrayView<const uint8> Bytes)
+{
+    FMemoryReaderView Reader(Bytes);
+    Serialize(Reader);
+    if (Reader.IsError())
+    {
+        *this = FWindowsMessageListenerState();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,263 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the FWindowsMessageLogger class.
+ */
+
+#include "WindowsMessageLogger.h"
+#include "WindowsMessageCodeHelper.h"
+#include "WindowsMessageListenerLog.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+
+namespace
+{
+    constexpr uint32 NumRuleCodes = 0x10000; // Codes that can have their own rule
+
+    const TCHAR* GetLogEventName(EWindowsMessageLogEvent Event)
+    {
+        return Event == EWindowsMessageLogEvent::Rejected ? TEXT("Rejected") : TEXT("Accepted");
+    }
+}
+
+FWindowsMessageLogger::FWindowsMessageLogger()
+{
+    LoggedMessageTypes.AllowRange(0, NumRuleCodes - 1);
+    Rules.AddDefaulted();
+    SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+}
+
+FWindowsMessageLogger::~FWindowsMessageLogger()
+{
+    Stop();
+}
+
+void FWindowsMessageLogger::Start(int32 Capacity, bool bBackgroundThread, float FlushIntervalSeconds)
+{
+    Stop();
+
+    Records = MakeUnique<TWindowsMessageRing<FWindowsMessageLogRecord>>(static_cast<uint32>(FMath::Max(Capacity, 1)));
+    FlushInterval = FMath::Max(FlushIntervalSeconds, 0.001f);
+    bStopping.store(false);
+    if (bBackgroundThread)
+    {
+        WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+        WriterThread = FRunnableThread::Create(this, TEXT("WindowsMessageLogWriter"), 0, TPri_Lowest);
+    }
+}
+
+void FWindowsMessageLogger::Stop()
+{
+    if (!Records)
+    {
+        return;
+    }
+
+    if (WriterThread)
+    {
+        bStopping.store(true);
+        WakeEvent->Trigger();
+        WriterThread->WaitForCompletion();
+        delete WriterThread;
+        WriterThread = nullptr;
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+
+    // The writer thread has exited, so this thread is now the only consumer
+    WriteBufferedRecords();
+    Records.Reset();
+}
+
+void FWindowsMessageLogger::SetSink(FWindowsMessageLogSink InSink)
+{
+    if (!ensureMsgf(!WriterThread, TEXT("The log sink cannot change while the writer thread is running.")))
+    {
+        return;
+    }
+    Sink = MoveTemp(InSink);
+}
+
+void FWindowsMessageLogger::SetMessageTypeLogged(uint32 MsgCode, bool bLogged)
+{
+    if (bLogged)
+    {
+        LoggedMessageTypes.Allow(MsgCode);
+    }
+    else
+    {
+        LoggedMessageTypes.Disallow(MsgCode);
+    }
+}
+
+void FWindowsMessageLogger::SetMessageRangeLogged(uint32 FirstMsgCode, uint32 LastMsgCode, bool bLogged)
+{
+    if (bLogged)
+    {
+        LoggedMessageTypes.AllowRange(FirstMsgCode, LastMsgCode);
+    }
+    else
+    {
+        LoggedMessageTypes.DisallowRange(FirstMsgCode, LastMsgCode);
+    }
+}
+
+void FWindowsMessageLogger::SetDefaultRule(const FWindowsMessageLogRule& Rule)
+{
+    Rules[0] = FRuleState();
+    Rules[0].Rule = Rule;
+    Rules[0].Tokens = Rule.Burst;
+}
+
+bool FWindowsMessageLogger::SetRule(uint32 MsgCode, const FWindowsMessageLogRule& Rule)
+{
+    if (MsgCode >= NumRuleCodes)
+    {
+        return false;
+    }
+    if (RuleIndices.IsEmpty())
+    {
+        RuleIndices.SetNumZeroed(NumRuleCodes);
+    }
+
+    uint8& Index = RuleIndices[MsgCode];
+    if (Index == 0)
+    {
+        if (Rules.Num() > MaxRules)
+        {
+            UE_LOG(LogWindowsMessageListener, Warning, TEXT("No room for a log rule for message %u; it keeps the default rule."), MsgCode);
+            return false;
+        }
+        Index = static_cast<uint8>(Rules.Num());
+        Rules.AddDefaulted();
+    }
+
+    FRuleState& State = Rules[Index];
+    State = FRuleState();
+    State.Rule = Rule;
+    State.Tokens = Rule.Burst;
+    return true;
+}
+
+void FWindowsMessageLogger::ClearRules()
+{
+    Rules.SetNum(1);
+    RuleIndices.Empty();
+}
+
+void FWindowsMessageLogger::LogAllowed(EWindowsMessageLogEvent Event, const FWindowsMessageRecord& Record)
+{
+    if (!Records)
+    {
+        return;
+    }
+    Considered.fetch_add(1, std::memory_order_relaxed);
+
+    FRuleState& State = Rules[Record.Msg < static_cast<uint32>(RuleIndices.Num()) ? RuleIndices[Record.Msg] : 0];
+    const FWindowsMessageLogRule& Rule = State.Rule;
+
+    if (Rule.SampleRate > 1 && State.SampleCounter++ % Rule.SampleRate != 0)
+    {
+        ++State.Suppressed;
+        SampledOut.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (Rule.MaxPerSecond > 0.0)
+    {
+        // Buckets are refilled from message timestamps, so replayed and synthetic streams are limited by their own clock
+        const uint64 Now = Record.Timestamp != 0 ? Record.Timestamp : FPlatformTime::Cycles64();
+        if (State.LastRefill != 0 && Now > State.LastRefill)
+        {
+            const double Elapsed = static_cast<double>(Now - State.LastRefill) * SecondsPerCycle;
+            State.Tokens = FMath::Min(Rule.Burst, State.Tokens + Elapsed * Rule.MaxPerSecond);
+        }
+        if (State.LastRefill == 0 || Now > State.LastRefill)
+        {
+            State.LastRefill = Now;
+        }
+        if (State.Tokens < 1.0)
+        {
+            ++State.Suppressed;
+            RateLimited.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        State.Tokens -= 1.0;
+    }
+
+    FWindowsMessageLogRecord LogRecord;
+    LogRecord.Timestamp = Record.Timestamp;
+    LogRecord.Hwnd = Record.Hwnd;
+    LogRecord.WParam = Record.WParam;
+    LogRecord.LParam = Record.LParam;
+    LogRecord.Msg = Record.Msg;
+    LogRecord.Suppressed = State.Suppressed;
+    LogRecord.Event = Event;
+    State.Suppressed = 0;
+
+    // A full buffer drops the record and counts it; the message path never waits for the writer
+    Records->Push(LogRecord);
+}
+
+int32 FWindowsMessageLogger::Flush()
+{
+    if (!ensureMsgf(!WriterThread, TEXT("Flush must not be called while the writer thread is running.")))
+    {
+        return 0;
+    }
+    return Records ? WriteBufferedRecords() : 0;
+}
+
+int32 FWindowsMessageLogger::WriteBufferedRecords()
+{
+    TStringBuilder<256> Builder;
+    const int32 Count = Records->Drain([this, &Builder](const FWindowsMessageLogRecord& Record)
+    {
+        Builder.Reset();
+        FormatRecord(Builder, Record);
+        if (Sink)
+        {
+            Sink(Record, Builder.ToView());
+        }
+        else
+        {
+            UE_LOG(LogWindowsMessageListener, Log, TEXT("%s"), Builder.ToString());
+        }
+    });
+    Written.fetch_add(Count, std::memory_order_relaxed);
+    return Count;
+}
+
+uint32 FWindowsMessageLogger::Run()
+{
+    while (!bStopping.load())
+    {
+        WriteBufferedRecords();
+        WakeEvent->Wait(FMath::CeilToInt(FlushInterval * 1000.0f));
+    }
+    return 0;
+}
+
+void FWindowsMessageLogger::FormatRecord(FStringBuilderBase& Builder, const FWindowsMessageLogRecord& Record)
+{
+    FWindowsMessageCodeHelper::FormatMessageDetails(Builder, GetLogEventName(Record.Event), Record.Hwnd, Record.Msg);
+    Builder.Appendf(TEXT(", wParam=0x%llx, lParam=0x%llx, time=%.6f"), Record.WParam, static_cast<uint64>(Record.LParam), FPlatformTime::ToSeconds64(Record.Timestamp));
+    if (Record.Suppressed > 0)
+    {
+        Builder.Appendf(TEXT(", suppressed=%u"), Record.Suppressed);
+    }
+}
+
+FWindowsMessageLogCounters FWindowsMessageLogger::GetCounters() const
+{
+    FWindowsMessageLogCounters Counters;
+    Counters.Considered = Considered.load(std::memory_order_relaxed);
+    Counters.SampledOut = SampledOut.load(std::memory_order_relaxed);
+    Counters.RateLimited = RateLimited.load(std::memory_order_relaxed);
+    Counters.Written = Written.load(std::memory_order_relaxed);
+    if (Records)
+    {
+        Counters.Buffer = Records->GetCounters();
+    }
+    return Counters;
+}
@@ -0,0 +1,747 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the rule compiler of FWindowsMessageRuleSet.
+ */
+
+#include "WindowsMessageRules.h"
+#include "WindowsMessageCodeHelper.h"
+#include "WindowsMessageListenerLog.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+    struct FRuleConstant
+    {
+        const TCHAR* Name;
+        uint64 Value;
+    };
+
+    // Constants from winuser.h and dbt.h that rules commonly compare against; VK_F1 to VK_F24 are generated
+    constexpr FRuleConstant BuiltInRuleConstants[] = {
+        {TEXT("VK_LBUTTON"), 0x01}, {TEXT("VK_RBUTTON"), 0x02}, {TEXT("VK_MBUTTON"), 0x04}, {TEXT("VK_XBUTTON1"), 0x05}, {TEXT("VK_XBUTTON2"), 0x06},
+        {TEXT("VK_BACK"), 0x08}, {TEXT("VK_TAB"), 0x09}, {TEXT("VK_RETURN"), 0x0D}, {TEXT("VK_SHIFT"), 0x10}, {TEXT("VK_CONTROL"), 0x11},
+        {TEXT("VK_MENU"), 0x12}, {TEXT("VK_PAUSE"), 0x13}, {TEXT("VK_CAPITAL"), 0x14}, {TEXT("VK_ESCAPE"), 0x1B}, {TEXT("VK_SPACE"), 0x20},
+        {TEXT("VK_PRIOR"), 0x21}, {TEXT("VK_NEXT"), 0x22}, {TEXT("VK_END"), 0x23}, {TEXT("VK_HOME"), 0x24}, {TEXT("VK_LEFT"), 0x25},
+        {TEXT("VK_UP"), 0x26}, {TEXT("VK_RIGHT"), 0x27}, {TEXT("VK_DOWN"), 0x28}, {TEXT("VK_SNAPSHOT"), 0x2C}, {TEXT("VK_INSERT"), 0x2D},
+        {TEXT("VK_DELETE"), 0x2E}, {TEXT("VK_LWIN"), 0x5B}, {TEXT("VK_RWIN"), 0x5C}, {TEXT("VK_APPS"), 0x5D}, {TEXT("VK_NUMPAD0"), 0x60},
+        {TEXT("VK_NUMPAD9"), 0x69}, {TEXT("VK_MULTIPLY"), 0x6A}, {TEXT("VK_ADD"), 0x6B}, {TEXT("VK_SUBTRACT"), 0x6D}, {TEXT("VK_DECIMAL"), 0x6E},
+        {TEXT("VK_DIVIDE"), 0x6F}, {TEXT("VK_NUMLOCK"), 0x90}, {TEXT("VK_SCROLL"), 0x91}, {TEXT("VK_LSHIFT"), 0xA0}, {TEXT("VK_RSHIFT"), 0xA1},
+        {TEXT("VK_LCONTROL"), 0xA2}, {TEXT("VK_RCONTROL"), 0xA3}, {TEXT("VK_LMENU"), 0xA4}, {TEXT("VK_RMENU"), 0xA5},
+        {TEXT("MK_LBUTTON"), 0x0001}, {TEXT("MK_RBUTTON"), 0x0002}, {TEXT("MK_SHIFT"), 0x0004}, {TEXT("MK_CONTROL"), 0x0008},
+        {TEXT("MK_MBUTTON"), 0x0010}, {TEXT("MK_XBUTTON1"), 0x0020}, {TEXT("MK_XBUTTON2"), 0x0040},
+        {TEXT("DBT_DEVNODES_CHANGED"), 0x0007}, {TEXT("DBT_DEVICEARRIVAL"), 0x8000}, {TEXT("DBT_DEVICEQUERYREMOVE"), 0x8001},
+        {TEXT("DBT_DEVICEREMOVEPENDING"), 0x8003}, {TEXT("DBT_DEVICEREMOVECOMPLETE"), 0x8004}, {TEXT("DBT_CUSTOMEVENT"), 0x8006},
+        {TEXT("SC_SIZE"), 0xF000}, {TEXT("SC_MOVE"), 0xF010}, {TEXT("SC_MINIMIZE"), 0xF020}, {TEXT("SC_MAXIMIZE"), 0xF030},
+        {TEXT("SC_CLOSE"), 0xF060}, {TEXT("SC_KEYMENU"), 0xF100}, {TEXT("SC_RESTORE"), 0xF120}, {TEXT("SC_SCREENSAVE"), 0xF140},
+        {TEXT("SIZE_RESTORED"), 0}, {TEXT("SIZE_MINIMIZED"), 1}, {TEXT("SIZE_MAXIMIZED"), 2},
+        {TEXT("WA_INACTIVE"), 0}, {TEXT("WA_ACTIVE"), 1}, {TEXT("WA_CLICKACTIVE"), 2},
+    };
+
+    constexpr uint64 FirstFunctionKey = 0x70; // VK_F1
+
+    bool FindBuiltInRuleConstant(FStringView Name, uint64& OutValue)
+    {
+        for (const FRuleConstant& Constant : BuiltInRuleConstants)
+        {
+            if (Name.Equals(Constant.Name, ESearchCase::IgnoreCase))
+            {
+                OutValue = Constant.Value;
+                return true;
+            }
+        }
+
+        // VK_F1 to VK_F24
+        if (Name.Len() >= 5 && Name.Len() <= 6 && Name.StartsWith(TEXT("VK_F"), ESearchCase::IgnoreCase) && FChar::IsDigit(Name[4]) && (Name.Len() == 5 || FChar::IsDigit(Name[5])))
+        {
+            const int32 Number = FCString::Atoi(*FString(Name.RightChop(4)));
+            if (Number >= 1 && Number <= 24)
+            {
+                OutValue = FirstFunctionKey + Number - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    enum class ERuleToken : uint8
+    {
+        End, Identifier, Number, LParen, RParen, LBrace, RBrace, Comma, DotDot,
+        AndAnd, OrOr, Not, Amp, Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual
+    };
+
+    struct FRuleToken
+    {
+        ERuleToken Type = ERuleToken::End;
+        FStringView Text;   // Source text of the token
+        uint64 Number = 0;  // Value of a number or character literal
+        int32 Column = 0;   // 1-based column of the token
+    };
+
+    enum class ERuleNode : uint8
+    {
+        Test, And, Or, Not
+    };
+
+    /** A node of a parsed rule expression. */
+    struct FRuleNode
+    {
+        ERuleNode Kind = ERuleNode::Test;
+        int32 Left = INDEX_NONE;                  // Operand of Not, or left operand of And and Or
+        int32 Right = INDEX_NONE;                 // Right operand of And and Or
+        EWindowsMessageRuleField Field = EWindowsMessageRuleField::Msg;
+        EWindowsMessageRuleOp Op = EWindowsMessageRuleOp::Equal;
+        uint64 Value = 0;                         // Operand of comparisons
+        TArray<TPair<uint64, uint64>> Set;        // Sorted, merged ranges of an InSet test
+    };
+
+    /** The codes a subexpression can match. */
+    struct FRuleCodeSet
+    {
+        bool bAll = true;                         // Any code can match
+        TArray<TPair<uint32, uint32>> Ranges;     // Sorted, disjoint ranges, when bAll is false
+
+        static FRuleCodeSet Range(uint64 First, uint64 Last)
+        {
+            FRuleCodeSet Result;
+            Result.bAll = false;
+            if (First <= Last && First <= MAX_uint32)
+            {
+                Result.Ranges.Emplace(static_cast<uint32>(First), static_cast<uint32>(FMath::Min<uint64>(Last, MAX_uint32)));
+            }
+            return Result;
+        }
+    };
+
+    /** Sorts and merges inclusive ranges in place. */
+    template<typename ValueType>
+    void MergeRuleRanges(TArray<TPair<ValueType, ValueType>>& Ranges)
+    {
+        Ranges.Sort([](const TPair<ValueType, ValueType>& A, const TPair<ValueType, ValueType>& B) { return A.Key < B.Key; });
+        int32 WriteIndex = 0;
+        for (int32 ReadIndex = 1; ReadIndex < Ranges.Num(); ++ReadIndex)
+        {
+            TPair<ValueType, ValueType>& Current = Ranges[WriteIndex];
+            const TPair<ValueType, ValueType>& Next = Ranges[ReadIndex];
+            if (Current.Value == TNumericLimits<ValueType>::Max() || Next.Key <= Current.Value + 1)
+            {
+                Current.Value = FMath::Max(Current.Value, Next.Value);
+            }
+            else
+            {
+                Ranges[++WriteIndex] = Next;
+            }
+        }
+        Ranges.SetNum(FMath::Min(WriteIndex + 1, Ranges.Num()));
+    }
+
+    FRuleCodeSet IntersectRuleCodes(FRuleCodeSet&& A, FRuleCodeSet&& B)
+    {
+        if (A.bAll)
+        {
+            return MoveTemp(B);
+        }
+        if (B.bAll)
+        {
+            return MoveTemp(A);
+        }
+
+        FRuleCodeSet Result;
+        Result.bAll = false;
+        int32 IndexA = 0;
+        int32 IndexB = 0;
+        while (IndexA < A.Ranges.Num() && IndexB < B.Ranges.Num())
+        {
+            const uint32 First = FMath::Max(A.Ranges[IndexA].Key, B.Ranges[IndexB].Key);
+            const uint32 Last = FMath::Min(A.Ranges[IndexA].Value, B.Ranges[IndexB].Value);
+            if (First <= Last)
+            {
+                Result.Ranges.Emplace(First, Last);
+            }
+            if (A.Ranges[IndexA].Value < B.Ranges[IndexB].Value)
+            {
+                ++IndexA;
+            }
+            else
+            {
+                ++IndexB;
+            }
+        }
+        return Result;
+    }
+
+    FRuleCodeSet UniteRuleCodes(FRuleCodeSet&& A, FRuleCodeSet&& B)
+    {
+        if (A.bAll || B.bAll)
+        {
+            return FRuleCodeSet();
+        }
+        A.Ranges.Append(MoveTemp(B.Ranges));
+        MergeRuleRanges(A.Ranges);
+        return MoveTemp(A);
+    }
+
+    /**
+     * Recursive-descent parser for one rule expression:
+     *     or         := and ('||' and)*
+     *     and        := unary ('&&' unary)*
+     *     unary      := '!' unary | '(' or ')' | comparison
+     *     comparison := field ('==' | '!=' | '<' | '<=' | '>' | '>=' | '&') value | field 'in' set
+     *     field      := 'msg' | 'wParam' | 'lParam' | 'hwnd' | ('loword' | 'hiword') '(' ('wParam' | 'lParam') ')'
+     *     set        := '{' value ('..' value)? (',' value ('..' value)?)* '}'
+     */
+    class FRuleParser
+    {
+    public:
+        FRuleParser(FStringView InSource, const TMap<FString, uint64>& InConstants)
+            : Source(InSource), Constants(InConstants)
+        {
+            Advance();
+        }
+
+        /** Parses the whole expression. @return The root node, or INDEX_NONE on error. */
+        int32 Parse()
+        {
+            const int32 Root = ParseOr();
+            if (Root != INDEX_NONE && Current.Type != ERuleToken::End)
+            {
+                return Fail(TEXT("unexpected text after the expression"));
+            }
+            return Error.IsEmpty() ? Root : INDEX_NONE; // The tokenizer can fail after the last node was built
+        }
+
+        TArray<FRuleNode> Nodes; // Parsed nodes; children precede their parents
+        FString Error;           // The first error, if any
+
+    private:
+
+        int32 ParseOr()
+        {
+            int32 Left = ParseAnd();
+            while (Left != INDEX_NONE && Current.Type == ERuleToken::OrOr)
+            {
+                Advance();
+                const int32 Right = ParseAnd();
+                Left = Right == INDEX_NONE ? INDEX_NONE : AddBinary(ERuleNode::Or, Left, Right);
+            }
+            return Left;
+        }
+
+        int32 ParseAnd()
+        {
+            int32 Left = ParseUnary();
+            while (Left != INDEX_NONE && Current.Type == ERuleToken::AndAnd)
+            {
+                Advance();
+                const int32 Right = ParseUnary();
+                Left = Right == INDEX_NONE ? INDEX_NONE : AddBinary(ERuleNode::And, Left, Right);
+            }
+            return Left;
+        }
+
+        int32 ParseUnary()
+        {
+            if (Current.Type == ERuleToken::Not)
+            {
+                Advance();
+                const int32 Operand = ParseUnary();
+                if (Operand == INDEX_NONE)
+                {
+                    return INDEX_NONE;
+                }
+                FRuleNode& Node = Nodes.AddDefaulted_GetRef();
+                Node.Kind = ERuleNode::Not;
+                Node.Left = Operand;
+                return Nodes.Num() - 1;
+            }
+            if (Current.Type == ERuleToken::LParen)
+            {
+                Advance();
+                const int32 Inner = ParseOr();
+                if (Inner != INDEX_NONE && !Expect(ERuleToken::RParen, TEXT("')'")))
+                {
+                    return INDEX_NONE;
+                }
+                return Inner;
+            }
+            return ParseComparison();
+        }
+
+        int32 ParseComparison()
+        {
+            EWindowsMessageRuleField Field;
+            if (!ParseField(Field))
+            {
+                return INDEX_NONE;
+            }
+
+            FRuleNode Node;
+            Node.Field = Field;
+            if (Current.Type == ERuleToken::Identifier && Current.Text.Equals(TEXT("in"), ESearchCase::IgnoreCase))
+            {
+                Advance();
+                Node.Op = EWindowsMessageRuleOp::InSet;
+                if (!ParseSet(Node.Set))
+                {
+                    return INDEX_NONE;
+                }
+            }
+            else
+            {
+                switch (Current.Type)
+                {
+                case ERuleToken::Equal:        Node.Op = EWindowsMessageRuleOp::Equal; break;
+                case ERuleToken::NotEqual:     Node.Op = EWindowsMessageRuleOp::NotEqual; break;
+                case ERuleToken::Less:         Node.Op = EWindowsMessageRuleOp::Less; break;
+                case ERuleToken::LessEqual:    Node.Op = EWindowsMessageRuleOp::LessEqual; break;
+                case ERuleToken::Greater:      Node.Op = EWindowsMessageRuleOp::Greater; break;
+                case ERuleToken::GreaterEqual: Node.Op = EWindowsMessageRuleOp::GreaterEqual; break;
+                case ERuleToken::Amp:          Node.Op = EWindowsMessageRuleOp::AnyBits; break;
+                default:                       return Fail(TEXT("expected a comparison operator or 'in'"));
+                }
+                Advance();
+                if (!ParseValue(Node.Value))
+                {
+                    return INDEX_NONE;
+                }
+            }
+
+            Nodes.Add(MoveTemp(Node));
+            return Nodes.Num() - 1;
+        }
+
+        bool ParseField(EWindowsMessageRuleField& OutField)
+        {
+            if (Current.Type != ERuleToken::Identifier)
+            {
+                Fail(TEXT("expected msg, wParam, lParam, hwnd, loword() or hiword()"));
+                return false;
+            }
+
+            const FStringView Name = Current.Text;
+            const bool bLowWord = Name.Equals(TEXT("loword"), ESearchCase::IgnoreCase);
+            if (bLowWord || Name.Equals(TEXT("hiword"), ESearchCase::IgnoreCase))
+            {
+                Advance();
+                if (!Expect(ERuleToken::LParen, TEXT("'('")))
+                {
+                    return false;
+                }
+                const bool bWParam = Current.Type == ERuleToken::Identifier && Current.Text.Equals(TEXT("wParam"), ESearchCase::IgnoreCase);
+                if (!bWParam && !(Current.Type == ERuleToken::Identifier && Current.Text.Equals(TEXT("lParam"), ESearchCase::IgnoreCase)))
+                {
+                    Fail(TEXT("loword() and hiword() take wParam or lParam"));
+                    return false;
+                }
+                Advance();
+                OutField = bWParam ? (bLowWord ? EWindowsMessageRuleField::LowWParam : EWindowsMessageRuleField::HighWParam)
+                    : (bLowWord ? EWindowsMessageRuleField::LowLParam : EWindowsMessageRuleField::HighLParam);
+                return Expect(ERuleToken::RParen, TEXT("')'"));
+            }
+
+            if (Name.Equals(TEXT("msg"), ESearchCase::IgnoreCase))
+            {
+                OutField = EWindowsMessageRuleField::Msg;
+            }
+            else if (Name.Equals(TEXT("wParam"), ESearchCase::IgnoreCase))
+            {
+                OutField = EWindowsMessageRuleField::WParam;
+            }
+            else if (Name.Equals(TEXT("lParam"), ESearchCase::IgnoreCase))
+            {
+                OutField = EWindowsMessageRuleField::LParam;
+            }
+            else if (Name.Equals(TEXT("hwnd"), ESearchCase::IgnoreCase))
+            {
+                OutField = EWindowsMessageRuleField::Hwnd;
+            }
+            else
+            {
+                Fail(TEXT("unknown field"));
+                return false;
+            }
+            Advance();
+            return true;
+        }
+
+        bool ParseSet(TArray<TPair<uint64, uint64>>& OutSet)
+        {
+            if (!Expect(ERuleToken::LBrace, TEXT("'{'")))
+            {
+                return false;
+            }
+            for (;;)
+            {
+                uint64 First = 0;
+                if (!ParseValue(First))
+                {
+                    return false;
+                }
+                uint64 Last = First;
+                if (Current.Type == ERuleToken::DotDot)
+                {
+                    Advance();
+                    if (!ParseValue(Last))
+                    {
+                        return false;
+                    }
+                    if (Last < First)
+                    {
+                        Fail(TEXT("range ends before it starts"));
+                        return false;
+                    }
+                }
+                OutSet.Emplace(First, Last);
+
+                if (Current.Type != ERuleToken::Comma)
+                {
+                    break;
+                }
+                Advance();
+            }
+
+            MergeRuleRanges(OutSet);
+            return Expect(ERuleToken::RBrace, TEXT("'}'"));
+        }
+
+        bool ParseValue(uint64& OutValue)
+        {
+            if (Current.Type == ERuleToken::Number)
+            {
+                OutValue = Current.Number;
+                Advance();
+                return true;
+            }
+            if (Current.Type == ERuleToken::Identifier)
+            {
+                const FString Name(Current.Text);
+                uint32 MsgCode = 0;
+                if (const uint64* Defined = Constants.Find(Name.ToUpper()))
+                {
+                    OutValue = *Defined;
+                }
+                else if (FindBuiltInRuleConstant(Current.Text, OutValue))
+                {
+                }
+                else if (FWindowsMessageCodeHelper::TryGetMessageCodeByName(Current.Text, MsgCode))
+                {
+                    OutValue = MsgCode;
+                }
+                else
+                {
+                    Fail(TEXT("unknown name"));
+                    return false;
+                }
+                Advance();
+                return true;
+            }
+            Fail(TEXT("expected a number or a name"));
+            return false;
+        }
+
+        int32 AddBinary(ERuleNode Kind, int32 Left, int32 Right)
+        {
+            FRuleNode& Node = Nodes.AddDefaulted_GetRef();
+            Node.Kind = Kind;
+            Node.Left = Left;
+            Node.Right = Right;
+            return Nodes.Num() - 1;
+        }
+
+        bool Expect(ERuleToken Type, const TCHAR* What)
+        {
+            if (Current.Type != Type)
+            {
+                Fail(*FString::Printf(TEXT("expected %s"), What));
+                return false;
+            }
+            Advance();
+            return true;
+        }
+
+        int32 Fail(const TCHAR* Message)
+        {
+            if (Error.IsEmpty())
+            {
+                Error = FString::Printf(TEXT("%s at column %d"), Message, Current.Column);
+            }
+            Current.Type = ERuleToken::End; // Stop consuming input
+            return INDEX_NONE;
+        }
+
+        void Advance()
+        {
+            while (Position < Source.Len() && FChar::IsWhitespace(Source[Position]))
+            {
+                ++Position;
+            }
+
+            Current = FRuleToken();
+            Current.Column = Position + 1;
+            if (Position >= Source.Len())
+            {
+                return;
+            }
+
+            const int32 Start = Position;
+            const TCHAR Char = Source[Position];
+            const TCHAR Next = Position + 1 < Source.Len() ? Source[Position + 1] : TEXT('\0');
+            if (FChar::IsAlpha(Char) || Char == TEXT('_'))
+            {
+                while (Position < Source.Len() && (FChar::IsAlnum(Source[Position]) || Source[Position] == TEXT('_')))
+                {
+                    ++Position;
+                }
+                Current.Type = ERuleToken::Identifier;
+            }
+            else if (FChar::IsDigit(Char))
+            {
+                const bool bHex = Char == TEXT('0') && (Next == TEXT('x') || Next == TEXT('X'));
+                Position += bHex ? 2 : 0;
+                const int32 DigitsStart = Position;
+                while (Position < Source.Len() && (bHex ? FChar::IsHexDigit(Source[Position]) : FChar::IsDigit(Source[Position])))
+                {
+                    Current.Number = Current.Number * (bHex ? 16 : 10) + FParse::HexDigit(Source[Position]);
+                    ++Position;
+                }
+                Current.Type = Position > DigitsStart ? ERuleToken::Number : ERuleToken::End;
+                if (Current.Type == ERuleToken::End)
+                {
+                    Fail(TEXT("malformed number"));
+                    return;
+                }
+            }
+            else if (Char == TEXT('\'') && Position + 2 < Source.Len() && Source[Position + 2] == TEXT('\''))
+            {
+                Current.Type = ERuleToken::Number;
+                Current.Number = static_cast<uint64>(Next);
+                Position += 3;
+            }
+            else
+            {
+                struct FPunctuation { const TCHAR* Text; ERuleToken Type; };
+                static const FPunctuation Punctuation[] = {
+                    {TEXT("&&"), ERuleToken::AndAnd}, {TEXT("||"), ERuleToken::OrOr}, {TEXT("=="), ERuleToken::Equal}, {TEXT("!="), ERuleToken::NotEqual},
+                    {TEXT("<="), ERuleToken::LessEqual}, {TEXT(">="), ERuleToken::GreaterEqual}, {TEXT(".."), ERuleToken::DotDot},
+                    {TEXT("<"), ERuleToken::Less}, {TEXT(">"), ERuleToken::Greater}, {TEXT("!"), ERuleToken::Not}, {TEXT("&"), ERuleToken::Amp},
+                    {TEXT("("), ERuleToken::LParen}, {TEXT(")"), ERuleToken::RParen}, {TEXT("{"), ERuleToken::LBrace}, {TEXT("}"), ERuleToken::RBrace},
+                    {TEXT(","), ERuleToken::Comma},
+                };
+                for (const FPunctuation& Candidate : Punctuation)
+                {
+                    if (Source.RightChop(Position).StartsWith(Candidate.Text))
+                    {
+                        Current.Type = Candidate.Type;
+                        Position += FCString::Strlen(Candidate.Text);
+                        break;
+                    }
+                }
+                if (Position == Start)
+                {
+                    Fail(TEXT("unexpected character"));
+                    return;
+                }
+            }
+            Current.Text = Source.Mid(Start, Position - Start);
+        }
+
+        FStringView Source;
+        const TMap<FString, uint64>& Constants;
+        int32 Position = 0;
+        FRuleToken Current;
+    };
+
+    /** Computes the codes a parsed subexpression can match. */
+    FRuleCodeSet AnalyzeRuleCodes(const TArray<FRuleNode>& Nodes, int32 NodeIndex)
+    {
+        const FRuleNode& Node = Nodes[NodeIndex];
+        switch (Node.Kind)
+        {
+        case ERuleNode::And:
+            return IntersectRuleCodes(AnalyzeRuleCodes(Nodes, Node.Left), AnalyzeRuleCodes(Nodes, Node.Right));
+        case ERuleNode::Or:
+            return UniteRuleCodes(AnalyzeRuleCodes(Nodes, Node.Left), AnalyzeRuleCodes(Nodes, Node.Right));
+        case ERuleNode::Not:
+            return FRuleCodeSet(); // Negations are not analyzed; any code may match
+        default:
+            break;
+        }
+
+        if (Node.Field != EWindowsMessageRuleField::Msg)
+        {
+            return FRuleCodeSet();
+        }
+        switch (Node.Op)
+        {
+        case EWindowsMessageRuleOp::Equal:        return FRuleCodeSet::Range(Node.Value, Node.Value);
+        case EWindowsMessageRuleOp::Less:         return Node.Value == 0 ? FRuleCodeSet::Range(1, 0) : FRuleCodeSet::Range(0, Node.Value - 1);
+        case EWindowsMessageRuleOp::LessEqual:    return FRuleCodeSet::Range(0, Node.Value);
+        case EWindowsMessageRuleOp::Greater:      return Node.Value == MAX_uint64 ? FRuleCodeSet::Range(1, 0) : FRuleCodeSet::Range(Node.Value + 1, MAX_uint32);
+        case EWindowsMessageRuleOp::GreaterEqual: return FRuleCodeSet::Range(Node.Value, MAX_uint32);
+        case EWindowsMessageRuleOp::InSet:
+        {
+            FRuleCodeSet Result;
+            Result.bAll = false;
+            for (const TPair<uint64, uint64>& Range : Node.Set)
+            {
+                Result.Ranges.Append(FRuleCodeSet::Range(Range.Key, Range.Value).Ranges);
+            }
+            return Result;
+        }
+        default:
+            return FRuleCodeSet();
+        }
+    }
+}
+
+void FWindowsMessageRuleSet::DefineConstant(FStringView Name, uint64 Value)
+{
+    Constants.Add(FString(Name).ToUpper(), Value);
+}
+
+bool FWindowsMessageRuleSet::AddRule(FName Name, FStringView Expression, FString* OutError)
+{
+    auto Reject = [&Name, OutError](const FString& Message)
+    {
+        if (OutError)
+        {
+            *OutError = FString::Printf(TEXT("Rule %s: %s"), *Name.ToString(), *Message);
+        }
+        return false;
+    };
+
+    if (Name.IsNone() || FindRule(Name) != INDEX_NONE)
+    {
+        return Reject(TEXT("rule names must be unique and not None"));
+    }
+    if (Rules.Num() >= MaxRules)
+    {
+        return Reject(FString::Printf(TEXT("a rule set holds at most %d rules"), MaxRules));
+    }
+
+    FRuleParser Parser(Expression, Constants);
+    const int32 Root = Parser.Parse();
+    if (Root == INDEX_NONE)
+    {
+        return Reject(Parser.Error);
+    }
+    const TArray<FRuleNode>& Nodes = Parser.Nodes;
+
+    // Emitted back to front: each test already knows where its outcomes lead, so && and || need no stack
+    TArray<FWindowsMessageRuleInstruction> Code;
+    TArray<TPair<uint64, uint64>> Sets;
+    bool bSetTooLarge = false;
+    TFunction<int32(int32, int32, int32)> Emit = [&](int32 NodeIndex, int32 OnTrue, int32 OnFalse) -> int32
+    {
+        const FRuleNode& Node = Nodes[NodeIndex];
+        switch (Node.Kind)
+        {
+        case ERuleNode::And:
+            return Emit(Node.Left, Emit(Node.Right, OnTrue, OnFalse), OnFalse);
+        case ERuleNode::Or:
+            return Emit(Node.Left, OnTrue, Emit(Node.Right, OnTrue, OnFalse));
+        case ERuleNode::Not:
+            return Emit(Node.Left, OnFalse, OnTrue);
+        default:
+            break;
+        }
+
+        FWindowsMessageRuleInstruction& Instruction = Code.AddDefaulted_GetRef();
+        Instruction.Field = Node.Field;
+        Instruction.Op = Node.Op;
+        Instruction.OnTrue = OnTrue;
+        Instruction.OnFalse = OnFalse;
+        Instruction.Value = Node.Value;
+        if (Node.Op == EWindowsMessageRuleOp::InSet)
+        {
+            bSetTooLarge |= Node.Set.Num() > MAX_uint16;
+            Instruction.Value = SetRanges.Num() + Sets.Num();
+            Instruction.SetCount = static_cast<uint16>(FMath::Min(Node.Set.Num(), static_cast<int32>(MAX_uint16)));
+            Sets.Append(Node.Set);
+        }
+        return Code.Num() - 1;
+    };
+    const int32 LocalEntry = Emit(Root, FWindowsMessageRuleInstruction::Accept, FWindowsMessageRuleInstruction::Reject);
+    if (bSetTooLarge)
+    {
+        return Reject(FString::Printf(TEXT("a set holds at most %d ranges"), MAX_uint16));
+    }
+
+    // Relocate the rule's targets into the shared program
+    const int32 Base = Program.Num();
+    for (FWindowsMessageRuleInstruction& Instruction : Code)
+    {
+        Instruction.OnTrue += Instruction.OnTrue >= 0 ? Base : 0;
+        Instruction.OnFalse += Instruction.OnFalse >= 0 ? Base : 0;
+    }
+    Program.Append(Code);
+    SetRanges.Append(Sets);
+
+    FRule& Rule = Rules.AddDefaulted_GetRef();
+    Rule.Name = Name;
+    Rule.Entry = LocalEntry + Base;
+    FRuleCodeSet Codes = AnalyzeRuleCodes(Nodes, Root);
+    Rule.bAnyCode = Codes.bAll;
+    Rule.CodeRanges = MoveTemp(Codes.Ranges);
+    return true;
+}
+
+int32 FWindowsMessageRuleSet::AddRulesFromConfig(const TCHAR* Section, const FString& Filename, TArray<FString>* OutErrors)
+{
+    TArray<FString> Lines;
+    if (GConfig)
+    {
+        GConfig->GetArray(Section, TEXT("Rule"), Lines, Filename);
+    }
+
+    int32 NumCompiled = 0;
+    for (const FString& Line : Lines)
+    {
+        FString Name;
+        FString Expression;
+        FString Error;
+        if (!Line.Split(TEXT(":"), &Name, &Expression))
+        {
+            Error = FString::Printf(TEXT("Rule entry '%s' is not written as 'Name: expression'"), *Line);
+        }
+        else if (AddRule(FName(*Name.TrimStartAndEnd()), Expression, &Error))
+        {
+            ++NumCompiled;
+            continue;
+        }
+
+        UE_LOG(LogWindowsMessageListener, Warning, TEXT("[%s] %s"), Section, *Error);
+        if (OutErrors)
+        {
+            OutErrors->Add(MoveTemp(Error));
+        }
+    }
+    return NumCompiled;
+}
+
+int32 FWindowsMessageRuleSet::FindRule(FName Name) const
+{
+    return Rules.IndexOfByPredicate([Name](const FRule& Rule) { return Rule.Name == Name; });
+}
+
+bool FWindowsMessageRuleSet::GetRuleCodeRanges(int32 RuleIndex, TArray<TPair<uint32, uint32>>& OutRanges) const
+{
+    const FRule& Rule = Rules[RuleIndex];
+    if (Rule.bAnyCode)
+    {
+        return false;
+    }
+    OutRanges = Rule.CodeRanges;
+    return true;
+}
+
+uint64 FWindowsMessageRuleSet::EvaluateAll(const FWindowsMessageRecord& Record) const
+{
+    uint64 Matched = 0;
+    for (int32 RuleIndex = 0; RuleIndex < Rules.Num(); ++RuleIndex)
+    {
+        Matched |= Evaluate(RuleIndex, Record) ? uint64(1) << RuleIndex : 0;
+    }
+    return Matched;
+}
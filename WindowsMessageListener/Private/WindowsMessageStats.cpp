@@ -0,0 +1,76 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the FWindowsMessageListener stats counters.
+ */
+
+#include "WindowsMessageStats.h"
+
+#if WINDOWS_MESSAGE_LISTENER_STATS
+
+void FWindowsMessageCodeCounters::Gather(TArray<FWindowsMessageCodeStats>& OutStats) const
+{
+    static constexpr uint32 RangeBounds[NumRangeSlots][2] =
+    {
+        { NumSystemCodes, 0x7FFF },
+        { 0x8000, 0xBFFF },
+        { 0xC000, 0xFFFF },
+        { 0x10000, MAX_uint32 },
+    };
+
+    for (int32 SlotIndex = 0; SlotIndex < UE_ARRAY_COUNT(Slots); ++SlotIndex)
+    {
+        const FSlot& Slot = Slots[SlotIndex];
+        FWindowsMessageCodeStats Stats;
+        Stats.Received = Slot.Received.load(std::memory_order_relaxed);
+        Stats.Filtered = Slot.Filtered.load(std::memory_order_relaxed);
+        Stats.Dispatched = Slot.Dispatched.load(std::memory_order_relaxed);
+        if (Stats.Received == 0 && Stats.Filtered == 0 && Stats.Dispatched == 0)
+        {
+            continue;
+        }
+
+        if (SlotIndex < static_cast<int32>(NumSystemCodes))
+        {
+            Stats.FirstMsgCode = Stats.LastMsgCode = static_cast<uint32>(SlotIndex);
+        }
+        else
+        {
+            Stats.FirstMsgCode = RangeBounds[SlotIndex - NumSystemCodes][0];
+            Stats.LastMsgCode = RangeBounds[SlotIndex - NumSystemCodes][1];
+        }
+        OutStats.Add(Stats);
+    }
+}
+
+void FWindowsMessageCodeCounters::Reset()
+{
+    for (FSlot& Slot : Slots)
+    {
+        Slot.Received.store(0, std::memory_order_relaxed);
+        Slot.Filtered.store(0, std::memory_order_relaxed);
+        Slot.Dispatched.store(0, std::memory_order_relaxed);
+    }
+}
+
+void FWindowsMessageHandlerCounters::Gather(FWindowsMessageHandlerStats& OutStats) const
+{
+    OutStats.Calls = Calls.load(std::memory_order_relaxed);
+    OutStats.TotalCycles = TotalCycles.load(std::memory_order_relaxed);
+    for (int32 Bucket = 0; Bucket < FWindowsMessageHandlerStats::NumCycleBuckets; ++Bucket)
+    {
+        OutStats.CycleHistogram[Bucket] = CycleHistogram[Bucket].load(std::memory_order_relaxed);
+    }
+}
+
+void FWindowsMessageHandlerCounters::Reset()
+{
+    Calls.store(0, std::memory_order_relaxed);
+    TotalCycles.store(0, std::memory_order_relaxed);
+    for (std::atomic<uint64>& Bucket : CycleHistogram)
+    {
+        Bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+#endif // WINDOWS_MESSAGE_LISTENER_STATS
@@ -0,0 +1,302 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements UWindowsMessageSubsystem, the game-thread delegate bridge.
+ */
+
+#include "WindowsMessageSubsystem.h"
+#include "WindowsMessageCodeHelper.h"
+#include "WindowsMessageListenerLog.h"
+
+#if PLATFORM_WINDOWS
+#include "WindowsMessageListener.h"
+
+/**
+ * The shared listener that feeds a subsystem, and the batch handler that forwards its messages.
+ */
+class FWindowsMessageSubsystemListener : public IWindowsMessageBatchHandler
+{
+public:
+    explicit FWindowsMessageSubsystemListener(UWindowsMessageSubsystem& InOwner)
+        : Owner(InOwner)
+    {
+        Listener.AddBatchMessageHandler(this);
+        Listener.StartListening();
+    }
+
+    virtual ~FWindowsMessageSubsystemListener()
+    {
+        Listener.StopListening();
+        Listener.RemoveBatchMessageHandler(this);
+    }
+
+    virtual void ProcessMessages(const FWindowsMessageBatchView& Batch) override
+    {
+        Owner.GatherMessages(Batch);
+    }
+
+    FWindowsMessageListener Listener; // Attached to the module's hub
+
+private:
+    UWindowsMessageSubsystem& Owner;
+};
+#else
+class FWindowsMessageSubsystemListener
+{
+};
+#endif
+
+namespace
+{
+    constexpr int32 InitialBatchCapacity = 256; // Messages reserved per batch, so a typical frame never allocates
+}
+
+UWindowsMessageSubsystem::UWindowsMessageSubsystem()
+{
+}
+
+// Defined here, where FWindowsMessageSubsystemListener is complete
+UWindowsMessageSubsystem::~UWindowsMessageSubsystem()
+{
+}
+
+void UWindowsMessageSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    PendingMessages.Reserve(InitialBatchCapacity);
+    BroadcastingMessages.Reserve(InitialBatchCapacity);
+    FilteredMessages.Reserve(InitialBatchCapacity);
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UWindowsMessageSubsystem::Tick));
+
+#if PLATFORM_WINDOWS
+    if (!IsRunningCommandlet())
+    {
+        Listener = MakeUnique<FWindowsMessageSubsystemListener>(*this);
+        RefreshAllowedMessageCodes();
+    }
+#endif
+    UE_LOG(LogWindowsMessageListener, Log, TEXT("Windows message subsystem initialized%s."), Listener ? TEXT("") : TEXT(" without a listener"));
+}
+
+void UWindowsMessageSubsystem::Deinitialize()
+{
+    FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+    TickerHandle.Reset();
+    Listener.Reset();
+    PendingMessages.Reset();
+    Bindings.Reset();
+    OnMessagesReceived.Clear();
+    OnMessagesReceivedNative.Clear();
+
+    Super::Deinitialize();
+}
+
+void UWindowsMessageSubsystem::AddAllowedMessageCodes(const TArray<int32>& MessageCodes)
+{
+    for (int32 MessageCode : MessageCodes)
+    {
+        AllowedMessageCodes.AddUnique(static_cast<uint32>(MessageCode));
+    }
+    RefreshAllowedMessageCodes();
+}
+
+void UWindowsMessageSubsystem::RemoveAllowedMessageCodes(const TArray<int32>& MessageCodes)
+{
+    for (int32 MessageCode : MessageCodes)
+    {
+        AllowedMessageCodes.Remove(static_cast<uint32>(MessageCode));
+    }
+    RefreshAllowedMessageCodes();
+}
+
+int32 UWindowsMessageSubsystem::BindMessages(FWindowsMessagesDelegate Delegate, const TArray<int32>& MessageCodes)
+{
+    if (!Delegate.IsBound())
+    {
+        return INDEX_NONE;
+    }
+
+    FMessageBinding Binding;
+    Binding.Delegate = MoveTemp(Delegate);
+    for (int32 MessageCode : MessageCodes)
+    {
+        Binding.MessageCodes.AddUnique(static_cast<uint32>(MessageCode));
+    }
+    return AddBinding(MoveTemp(Binding));
+}
+
+int32 UWindowsMessageSubsystem::BindNativeMessages(FWindowsMessagesNativeDelegate Delegate, TArrayView<const uint32> MessageCodes)
+{
+    if (!Delegate.IsBound())
+    {
+        return INDEX_NONE;
+    }
+
+    FMessageBinding Binding;
+    Binding.NativeDelegate = MoveTemp(Delegate);
+    for (uint32 MessageCode : MessageCodes)
+    {
+        Binding.MessageCodes.AddUnique(MessageCode);
+    }
+    return AddBinding(MoveTemp(Binding));
+}
+
+int32 UWindowsMessageSubsystem::AddBinding(FMessageBinding&& Binding)
+{
+    for (uint32 MessageCode : Binding.MessageCodes)
+    {
+        Binding.CodeMask.Allow(MessageCode);
+    }
+    Binding.Id = NextBindingId++;
+
+    const int32 Id = Binding.Id;
+    Bindings.Add(MoveTemp(Binding));
+    RefreshAllowedMessageCodes();
+    return Id;
+}
+
+void UWindowsMessageSubsystem::UnbindMessages(int32 BindingId)
+{
+    if (Bindings.RemoveAll([BindingId](const FMessageBinding& Binding) { return Binding.Id == BindingId; }) > 0)
+    {
+        RefreshAllowedMessageCodes();
+    }
+}
+
+void UWindowsMessageSubsystem::UnbindAllMessages(const UObject* Object)
+{
+    if (!Object)
+    {
+        return;
+    }
+
+    OnMessagesReceived.RemoveAll(Object);
+    OnMessagesReceivedNative.RemoveAll(Object);
+    const int32 NumRemoved = Bindings.RemoveAll([Object](const FMessageBinding& Binding)
+    {
+        return Binding.Delegate.GetUObject() == Object || Binding.NativeDelegate.GetUObject() == Object;
+    });
+    if (NumRemoved > 0)
+    {
+        RefreshAllowedMessageCodes();
+    }
+}
+
+FString UWindowsMessageSubsystem::GetMessageName(int32 MessageCode)
+{
+    return FWindowsMessageCodeHelper::GetMessageName(static_cast<uint32>(MessageCode));
+}
+
+int32 UWindowsMessageSubsystem::GetMessageCode(const FString& MessageName)
+{
+    uint32 MsgCode = 0;
+    return FWindowsMessageCodeHelper::TryGetMessageCodeByName(MessageName, MsgCode) ? static_cast<int32>(MsgCode) : 0;
+}
+
+void UWindowsMessageSubsystem::GatherMessages(const FWindowsMessageBatchView& Batch)
+{
+    const int32 NumMessages = Batch.Num();
+    for (int32 Index = 0; Index < NumMessages; ++Index)
+    {
+        FWindowsMessageEntry& Entry = PendingMessages.AddDefaulted_GetRef();
+        Entry.Window = static_cast<int64>(Batch.Hwnds[Index]);
+        Entry.Message = static_cast<int32>(Batch.Msgs[Index]);
+        Entry.WParam = static_cast<int64>(Batch.WParams[Index]);
+        Entry.LParam = Batch.LParams[Index];
+    }
+}
+
+int32 UWindowsMessageSubsystem::BroadcastMessages()
+{
+    if (PendingMessages.Num() == 0)
+    {
+        return 0;
+    }
+
+    // Delegates may feed new messages or change bindings; those land in the next frame's batch
+    Swap(PendingMessages, BroadcastingMessages);
+    OnMessagesReceived.Broadcast(BroadcastingMessages);
+    OnMessagesReceivedNative.Broadcast(BroadcastingMessages);
+
+    TArray<int32, TInlineAllocator<16>> BindingIds;
+    for (const FMessageBinding& Binding : Bindings)
+    {
+        BindingIds.Add(Binding.Id);
+    }
+
+    bool bRemovedBindings = false;
+    for (const int32 BindingId : BindingIds)
+    {
+        const int32 BindingIndex = Bindings.IndexOfByPredicate([BindingId](const FMessageBinding& Binding) { return Binding.Id == BindingId; });
+        if (BindingIndex == INDEX_NONE)
+        {
+            continue; // Unbound by an earlier delegate
+        }
+
+        const FMessageBinding& Binding = Bindings[BindingIndex];
+        if (!Binding.Delegate.IsBound() && !Binding.NativeDelegate.IsBound())
+        {
+            Bindings.RemoveAt(BindingIndex); // Its object was destroyed
+            bRemovedBindings = true;
+            continue;
+        }
+
+        const TArray<FWindowsMessageEntry>* Messages = &BroadcastingMessages;
+        if (Binding.MessageCodes.Num() > 0)
+        {
+            FilteredMessages.Reset();
+            for (const FWindowsMessageEntry& Entry : BroadcastingMessages)
+            {
+                if (Binding.CodeMask.IsAllowed(static_cast<uint32>(Entry.Message)))
+                {
+                    FilteredMessages.Add(Entry);
+                }
+            }
+            Messages = &FilteredMessages;
+        }
+        if (Messages->Num() == 0)
+        {
+            continue;
+        }
+
+        // Copies, since the delegate may unbind itself and reallocate Bindings
+        const FWindowsMessagesDelegate Delegate = Binding.Delegate;
+        const FWindowsMessagesNativeDelegate NativeDelegate = Binding.NativeDelegate;
+        Delegate.ExecuteIfBound(*Messages);
+        NativeDelegate.ExecuteIfBound(*Messages);
+    }
+
+    if (bRemovedBindings)
+    {
+        RefreshAllowedMessageCodes();
+    }
+
+    const int32 NumBroadcast = BroadcastingMessages.Num();
+    BroadcastingMessages.Reset();
+    return NumBroadcast;
+}
+
+void UWindowsMessageSubsystem::RefreshAllowedMessageCodes()
+{
+#if PLATFORM_WINDOWS
+    if (!Listener)
+    {
+        return;
+    }
+
+    TArray<uint32> MessageCodes = AllowedMessageCodes;
+    for (const FMessageBinding& Binding : Bindings)
+    {
+        MessageCodes.Append(Binding.MessageCodes);
+    }
+    Listener->Listener.ClearAllowedMessageTypes();
+    Listener->Listener.AddAllowedMessageTypes(MessageCodes);
+#endif
+}
+
+bool UWindowsMessageSubsystem::Tick(float DeltaTime)
+{
+    BroadcastMessages();
+    return true;
+}
@@ -0,0 +1,287 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the raw input decoders and the FWindowsRawInputReader class.
+ */
+
+#include "WindowsRawInput.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+
+// The portable decoders read the native layout, so it must match the Windows structures exactly
+static_assert(sizeof(RAWINPUTHEADER) == FWindowsRawInputDecoder::HeaderSize, "RAWINPUTHEADER layout changed.");
+static_assert(sizeof(RAWMOUSE) == FWindowsRawInputDecoder::MouseSize, "RAWMOUSE layout changed.");
+static_assert(sizeof(RAWKEYBOARD) == FWindowsRawInputDecoder::KeyboardSize, "RAWKEYBOARD layout changed.");
+static_assert(offsetof(RAWHID, bRawData) == FWindowsRawInputDecoder::HidHeaderSize, "RAWHID layout changed.");
+static_assert(offsetof(RAWMOUSE, lLastX) == 12 && offsetof(RAWKEYBOARD, Message) == 8, "Raw input field offsets changed.");
+#endif
+
+namespace
+{
+    // Field offsets from the start of a payload, for the 64-bit layout of the Windows structures
+    constexpr int32 RawHeaderTypeOffset = 0;   // RAWINPUTHEADER::dwType
+    constexpr int32 RawHeaderSizeOffset = 4;   // RAWINPUTHEADER::dwSize
+    constexpr int32 RawHeaderDeviceOffset = 8; // RAWINPUTHEADER::hDevice
+
+    constexpr int32 RawData = FWindowsRawInputDecoder::HeaderSize;
+    constexpr int32 RawMouseFlagsOffset = RawData + 0;        // RAWMOUSE::usFlags
+    constexpr int32 RawMouseButtonFlagsOffset = RawData + 4;  // RAWMOUSE::usButtonFlags
+    constexpr int32 RawMouseButtonDataOffset = RawData + 6;   // RAWMOUSE::usButtonData
+    constexpr int32 RawMouseLastXOffset = RawData + 12;       // RAWMOUSE::lLastX
+    constexpr int32 RawMouseLastYOffset = RawData + 16;       // RAWMOUSE::lLastY
+    constexpr int32 RawKeyboardMakeCodeOffset = RawData + 0;  // RAWKEYBOARD::MakeCode
+    constexpr int32 RawKeyboardFlagsOffset = RawData + 2;     // RAWKEYBOARD::Flags
+    constexpr int32 RawKeyboardVKeyOffset = RawData + 6;      // RAWKEYBOARD::VKey
+    constexpr int32 RawKeyboardMessageOffset = RawData + 8;   // RAWKEYBOARD::Message
+    constexpr int32 RawHidSizeOffset = RawData + 0;           // RAWHID::dwSizeHid
+    constexpr int32 RawHidCountOffset = RawData + 4;          // RAWHID::dwCount
+
+    /** Reads a field that may not be aligned. */
+    template<typename ValueType>
+    ValueType ReadRawInputField(const uint8* Data, int32 Offset)
+    {
+        ValueType Value;
+        FMemory::Memcpy(&Value, Data + Offset, sizeof(ValueType));
+        return Value;
+    }
+
+    /** Reads the header and checks the payload has the given type and at least MinSize bytes. */
+    bool DecodeRawInputPayload(const uint8* Data, int32 Size, EWindowsRawInputDeviceType ExpectedType, int32 MinSize, uint64 Timestamp, FWindowsRawInputRecord& OutRecord)
+    {
+        EWindowsRawInputDeviceType Type = EWindowsRawInputDeviceType::Mouse;
+        int32 PayloadSize = 0;
+        uint64 Device = 0;
+        if (!FWindowsRawInputDecoder::DecodeHeader(Data, Size, Type, PayloadSize, Device) || Type != ExpectedType || PayloadSize < MinSize)
+        {
+            return false;
+        }
+
+        OutRecord = FWindowsRawInputRecord();
+        OutRecord.Device = Device;
+        OutRecord.Timestamp = Timestamp;
+        OutRecord.Type = Type;
+        return true;
+    }
+}
+
+bool FWindowsRawInputDecoder::DecodeHeader(const uint8* Data, int32 Size, EWindowsRawInputDeviceType& OutType, int32& OutPayloadSize, uint64& OutDevice)
+{
+    if (!Data || Size < HeaderSize)
+    {
+        return false;
+    }
+
+    const uint32 Type = ReadRawInputField<uint32>(Data, RawHeaderTypeOffset);
+    const uint32 PayloadSize = ReadRawInputField<uint32>(Data, RawHeaderSizeOffset);
+    if (Type > static_cast<uint32>(EWindowsRawInputDeviceType::Hid) || PayloadSize < static_cast<uint32>(HeaderSize) || PayloadSize > static_cast<uint32>(Size))
+    {
+        return false;
+    }
+
+    OutType = static_cast<EWindowsRawInputDeviceType>(Type);
+    OutPayloadSize = static_cast<int32>(PayloadSize);
+    OutDevice = ReadRawInputField<uint64>(Data, RawHeaderDeviceOffset);
+    return true;
+}
+
+bool FWindowsRawInputDecoder::DecodeMouse(const uint8* Data, int32 Size, uint64 Timestamp, FWindowsRawInputRecord& OutRecord)
+{
+    if (!DecodeRawInputPayload(Data, Size, EWindowsRawInputDeviceType::Mouse, HeaderSize + MouseSize, Timestamp, OutRecord))
+    {
+        return false;
+    }
+
+    OutRecord.Flags = ReadRawInputField<uint16>(Data, RawMouseFlagsOffset);
+    OutRecord.ButtonFlags = ReadRawInputField<uint16>(Data, RawMouseButtonFlagsOffset);
+    OutRecord.ButtonData = ReadRawInputField<int16>(Data, RawMouseButtonDataOffset);
+    OutRecord.LastX = ReadRawInputField<int32>(Data, RawMouseLastXOffset);
+    OutRecord.LastY = ReadRawInputField<int32>(Data, RawMouseLastYOffset);
+    return true;
+}
+
+bool FWindowsRawInputDecoder::DecodeKeyboard(const uint8* Data, int32 Size, uint64 Timestamp, FWindowsRawInputRecord& OutRecord)
+{
+    if (!DecodeRawInputPayload(Data, Size, EWindowsRawInputDeviceType::Keyboard, HeaderSize + KeyboardSize, Timestamp, OutRecord))
+    {
+        return false;
+    }
+
+    OutRecord.MakeCode = ReadRawInputField<uint16>(Data, RawKeyboardMakeCodeOffset);
+    OutRecord.Flags = ReadRawInputField<uint16>(Data, RawKeyboardFlagsOffset);
+    OutRecord.VirtualKey = ReadRawInputField<uint16>(Data, RawKeyboardVKeyOffset);
+    OutRecord.Message = ReadRawInputField<uint32>(Data, RawKeyboardMessageOffset);
+    return true;
+}
+
+bool FWindowsRawInputDecoder::DecodeHidLayout(const uint8* Data, int32 Size, int32& OutReportSize, int32& OutReportCount)
+{
+    EWindowsRawInputDeviceType Type = EWindowsRawInputDeviceType::Mouse;
+    int32 PayloadSize = 0;
+    uint64 Device = 0;
+    if (!DecodeHeader(Data, Size, Type, PayloadSize, Device) || Type != EWindowsRawInputDeviceType::Hid || PayloadSize < HeaderSize + HidHeaderSize)
+    {
+        return false;
+    }
+
+    // Multiplied in 64 bits, so a hostile size and count cannot wrap around the bounds check
+    const uint64 ReportSize = ReadRawInputField<uint32>(Data, RawHidSizeOffset);
+    const uint64 ReportCount = ReadRawInputField<uint32>(Data, RawHidCountOffset);
+    if (ReportSize * ReportCount > static_cast<uint64>(PayloadSize - HeaderSize - HidHeaderSize))
+    {
+        return false;
+    }
+
+    OutReportSize = static_cast<int32>(ReportSize);
+    OutReportCount = ReportSize > 0 ? static_cast<int32>(ReportCount) : 0;
+    return true;
+}
+
+bool FWindowsRawInputDecoder::DecodeHidReport(const uint8* Data, int32 Size, int32 ReportIndex, uint64 Timestamp, FWindowsRawInputRecord& OutRecord)
+{
+    int32 ReportSize = 0;
+    int32 ReportCount = 0;
+    if (!DecodeHidLayout(Data, Size, ReportSize, ReportCount) || ReportIndex < 0 || ReportIndex >= ReportCount
+        || !DecodeRawInputPayload(Data, Size, EWindowsRawInputDeviceType::Hid, HeaderSize + HidHeaderSize, Timestamp, OutRecord))
+    {
+        return false;
+    }
+
+    const int32 CopySize = FMath::Min(ReportSize, FWindowsRawInputRecord::MaxHidReportBytes);
+    FMemory::Memcpy(OutRecord.HidReport, Data + HeaderSize + HidHeaderSize + ReportIndex * ReportSize, CopySize);
+    OutRecord.HidReportSize = static_cast<uint8>(CopySize);
+    return true;
+}
+
+FWindowsRawInputReader::FWindowsRawInputReader(uint32 QueueCapacity, int32 ArenaBytes, EWindowsMessageOverflowPolicy OverflowPolicy)
+    : Records(QueueCapacity, OverflowPolicy)
+{
+    const int32 MinArenaBytes = FWindowsRawInputDecoder::HeaderSize + FWindowsRawInputDecoder::MouseSize;
+    Arena.SetNumZeroed(Align(FMath::Max(ArenaBytes, MinArenaBytes), sizeof(uint64)) / sizeof(uint64));
+}
+
+int32 FWindowsRawInputReader::IngestRawInput(const uint8* Data, int32 Size, uint64 Timestamp)
+{
+    EWindowsRawInputDeviceType Type = EWindowsRawInputDeviceType::Mouse;
+    int32 PayloadSize = 0;
+    uint64 Device = 0;
+    FWindowsRawInputRecord Record;
+    int32 NumQueued = 0;
+    bool bValid = FWindowsRawInputDecoder::DecodeHeader(Data, Size, Type, PayloadSize, Device);
+    if (bValid)
+    {
+        switch (Type)
+        {
+        case EWindowsRawInputDeviceType::Mouse:
+            bValid = FWindowsRawInputDecoder::DecodeMouse(Data, PayloadSize, Timestamp, Record);
+            NumQueued = bValid ? QueueRecord(Record) : 0;
+            break;
+
+        case EWindowsRawInputDeviceType::Keyboard:
+            bValid = FWindowsRawInputDecoder::DecodeKeyboard(Data, PayloadSize, Timestamp, Record);
+            NumQueued = bValid ? QueueRecord(Record) : 0;
+            break;
+
+        case EWindowsRawInputDeviceType::Hid:
+        {
+            int32 ReportSize = 0;
+            int32 ReportCount = 0;
+            bValid = FWindowsRawInputDecoder::DecodeHidLayout(Data, PayloadSize, ReportSize, ReportCount);
+            if (bValid && ReportSize > FWindowsRawInputRecord::MaxHidReportBytes)
+            {
+                TruncatedReports.fetch_add(ReportCount, std::memory_order_relaxed);
+            }
+            for (int32 ReportIndex = 0; bValid && ReportIndex < ReportCount; ++ReportIndex)
+            {
+                FWindowsRawInputDecoder::DecodeHidReport(Data, PayloadSize, ReportIndex, Timestamp, Record);
+                NumQueued += QueueRecord(Record);
+            }
+            break;
+        }
+        }
+    }
+
+    (bValid ? PayloadsRead : Malformed).fetch_add(1, std::memory_order_relaxed);
+    return NumQueued;
+}
+
+int32 FWindowsRawInputReader::IngestRawInputBuffer(const uint8* Data, int32 Size, int32 Count, uint64 Timestamp)
+{
+    int32 NumQueued = 0;
+    int32 Offset = 0;
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        EWindowsRawInputDeviceType Type = EWindowsRawInputDeviceType::Mouse;
+        int32 PayloadSize = 0;
+        uint64 Device = 0;
+        if (Offset >= Size || !FWindowsRawInputDecoder::DecodeHeader(Data + Offset, Size - Offset, Type, PayloadSize, Device))
+        {
+            // Without a valid size the next payload cannot be found, so the rest of the buffer is lost
+            Malformed.fetch_add(Count - Index, std::memory_order_relaxed);
+            break;
+        }
+
+        NumQueued += IngestRawInput(Data + Offset, PayloadSize, Timestamp);
+        Offset += Align(PayloadSize, FWindowsRawInputDecoder::BlockAlignment); // NEXTRAWINPUTBLOCK
+    }
+    return NumQueued;
+}
+
+#if PLATFORM_WINDOWS
+int32 FWindowsRawInputReader::ReadRawInput(int64 RawInputHandle, uint64 Timestamp)
+{
+    UINT Size = static_cast<UINT>(GetArenaSize());
+    const UINT Copied = ::GetRawInputData(reinterpret_cast<HRAWINPUT>(RawInputHandle), RID_INPUT, Arena.GetData(), &Size, sizeof(RAWINPUTHEADER));
+    if (Copied == static_cast<UINT>(-1))
+    {
+        if (::GetLastError() == ERROR_INSUFFICIENT_BUFFER)
+        {
+            Oversized.fetch_add(1, std::memory_order_relaxed);
+        }
+        return 0;
+    }
+
+    return IngestRawInput(reinterpret_cast<const uint8*>(Arena.GetData()), static_cast<int32>(Copied), Timestamp);
+}
+
+int32 FWindowsRawInputReader::ReadBufferedRawInput(uint64 Timestamp)
+{
+    int32 NumQueued = 0;
+    for (;;)
+    {
+        UINT Size = static_cast<UINT>(GetArenaSize());
+        const UINT Count = ::GetRawInputBuffer(reinterpret_cast<PRAWINPUT>(Arena.GetData()), &Size, sizeof(RAWINPUTHEADER));
+        if (Count == static_cast<UINT>(-1))
+        {
+            if (::GetLastError() == ERROR_INSUFFICIENT_BUFFER)
+            {
+                Oversized.fetch_add(1, std::memory_order_relaxed); // The payload stays queued and is read through its own WM_INPUT
+            }
+            break;
+        }
+        if (Count == 0)
+        {
+            break;
+        }
+
+        NumQueued += IngestRawInputBuffer(reinterpret_cast<const uint8*>(Arena.GetData()), GetArenaSize(), static_cast<int32>(Count), Timestamp);
+    }
+    return NumQueued;
+}
+#endif
+
+FWindowsRawInputCounters FWindowsRawInputReader::GetCounters() const
+{
+    FWindowsRawInputCounters Counters;
+    Counters.PayloadsRead = PayloadsRead.load(std::memory_order_relaxed);
+    Counters.Malformed = Malformed.load(std::memory_order_relaxed);
+    Counters.Oversized = Oversized.load(std::memory_order_relaxed);
+    Counters.TruncatedReports = TruncatedReports.load(std::memory_order_relaxed);
+    Counters.Queue = Records.GetCounters();
+    return Counters;
+}
+
+int32 FWindowsRawInputReader::QueueRecord(const FWindowsRawInputRecord& Record)
+{
+    return Records.Push(Record) ? 1 : 0;
+}
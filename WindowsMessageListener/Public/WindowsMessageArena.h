@@ -0,0 +1,274 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares FWindowsMessageFrameArena, a per-frame bump allocator, and TWindowsMessageSlabPool, a fixed-size object pool.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageRecord.h"
+#include "Containers/StringView.h"
+
+#include <type_traits>
+
+/**
+ * Snapshot of a frame arena's counters.
+ */
+struct FWindowsMessageArenaCounters
+{
+    uint64 FrameBytes = 0;       // Bytes handed out since the last reset, including alignment padding
+    uint64 PeakFrameBytes = 0;   // Largest number of bytes handed out in one frame
+    uint64 ReservedBytes = 0;    // Bytes held in blocks, kept across resets
+    uint64 FrameAllocations = 0; // Allocations since the last reset
+    uint64 HeapAllocations = 0;  // Blocks requested from the heap since construction; constant in steady state
+    uint64 Resets = 0;           // Number of resets
+};
+
+/**
+ * FWindowsMessageFrameArena
+ * A bump allocator for data that lives until the end of the frame: copies of message records, decoded
+ * events, scratch buffers and formatted debug strings. Allocating is a pointer increment; Reset rewinds
+ * every block at once and keeps them, so once the arena has grown to the largest frame it never touches
+ * the heap again.
+ *
+ * Only trivially destructible types can be allocated, since nothing is destroyed on reset.
+ * An arena must only be used from one thread.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageFrameArena
+{
+public:
+    static constexpr SIZE_T DefaultAlignment = 16;
+
+    /**
+     * @param InBlockBytes - Size of each block; the first block is allocated immediately.
+     */
+    explicit FWindowsMessageFrameArena(int32 InBlockBytes = 65536);
+    ~FWindowsMessageFrameArena();
+
+    FWindowsMessageFrameArena(const FWindowsMessageFrameArena&) = delete;
+    FWindowsMessageFrameArena& operator=(const FWindowsMessageFrameArena&) = delete;
+
+    /**
+     * Allocates uninitialized memory that stays valid until the next reset.
+     * @param Size - Number of bytes.
+     * @param Alignment - Required alignment, a power of two.
+     * @return The memory.
+     */
+    FORCEINLINE void* Allocate(SIZE_T Size, SIZE_T Alignment = DefaultAlignment)
+    {
+        uint8* Aligned = Align(Cursor, Alignment);
+        if (Aligned + Size <= End)
+        {
+            FrameBytes += (Aligned + Size) - Cursor;
+            ++FrameAllocations;
+            Cursor = Aligned + Size;
+            return Aligned;
+        }
+        return AllocateSlow(Size, Alignment);
+    }
+
+    /**
+     * Constructs an object that stays valid until the next reset.
+     * @return The object.
+     */
+    template<typename ObjectType, typename... ArgTypes>
+    ObjectType* New(ArgTypes&&... Args)
+    {
+        static_assert(std::is_trivially_destructible_v<ObjectType>, "Frame arena objects are never destroyed.");
+        return new (Allocate(sizeof(ObjectType), alignof(ObjectType))) ObjectType(Forward<ArgTypes>(Args)...);
+    }
+
+    /**
+     * Allocates an array of value-initialized elements that stays valid until the next reset.
+     * @param Num - Number of elements.
+     * @return The elements.
+     */
+    template<typename ElementType>
+    TArrayView<ElementType> NewArray(int32 Num)
+    {
+        static_assert(std::is_trivially_destructible_v<ElementType>, "Frame arena objects are never destroyed.");
+        if (Num <= 0)
+        {
+            return TArrayView<ElementType>();
+        }
+        ElementType* Elements = static_cast<ElementType*>(Allocate(sizeof(ElementType) * Num, alignof(ElementType)));
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            new (Elements + Index) ElementType();
+        }
+        return TArrayView<ElementType>(Elements, Num);
+    }
+
+    /**
+     * Copies elements into the arena.
+     * @param Source - The elements to copy.
+     * @return The copies, valid until the next reset.
+     */
+    template<typename ElementType>
+    TArrayView<ElementType> CopyArray(TArrayView<const ElementType> Source)
+    {
+        static_assert(std::is_trivially_copyable_v<ElementType>, "Frame arena copies are made with memcpy.");
+        if (Source.Num() == 0)
+        {
+            return TArrayView<ElementType>();
+        }
+        ElementType* Elements = static_cast<ElementType*>(Allocate(sizeof(ElementType) * Source.Num(), alignof(ElementType)));
+        FMemory::Memcpy(Elements, Source.GetData(), sizeof(ElementType) * Source.Num());
+        return TArrayView<ElementType>(Elements, Source.Num());
+    }
+
+    /**
+     * Copies a string into the arena, null-terminated.
+     * @param Source - The string to copy.
+     * @return The copy, valid until the next reset.
+     */
+    FStringView CopyString(FStringView Source);
+
+    /**
+     * Rewinds every block. Memory handed out since the last reset must no longer be used.
+     */
+    void Reset();
+
+    /**
+     * @return A snapshot of the counters.
+     */
+    FWindowsMessageArenaCounters GetCounters() const;
+
+private:
+
+    struct FBlock
+    {
+        uint8* Data = nullptr; // Block storage
+        SIZE_T Size = 0;       // Bytes in the block
+    };
+
+    /**
+     * Moves to the next block that can hold an allocation, allocating a new block if none can.
+     */
+    void* AllocateSlow(SIZE_T Size, SIZE_T Alignment);
+
+    uint8* Cursor = nullptr;        // Next free byte of the current block
+    uint8* End = nullptr;           // End of the current block
+    int32 CurrentBlock = 0;         // Index of the current block in Blocks
+    TArray<FBlock> Blocks;          // Blocks in allocation order, kept across resets
+    SIZE_T BlockBytes = 0;          // Size of new blocks
+    uint64 FrameBytes = 0;
+    uint64 PeakFrameBytes = 0;
+    uint64 FrameAllocations = 0;
+    uint64 HeapAllocations = 0;
+    uint64 Resets = 0;
+};
+
+/**
+ * TWindowsMessageSlabPool
+ * Fixed-size pool for objects that must outlive the frame, such as records kept until a later event.
+ * Objects are carved from slabs holding ObjectsPerSlab objects each, and released objects are reused
+ * before a new slab is allocated, so a steady number of live objects never touches the heap.
+ *
+ * A pool must only be used from one thread. Every object must be released before the pool is destroyed.
+ */
+template<typename ObjectType, int32 ObjectsPerSlab = 256>
+class TWindowsMessageSlabPool
+{
+public:
+    TWindowsMessageSlabPool() = default;
+
+    TWindowsMessageSlabPool(const TWindowsMessageSlabPool&) = delete;
+    TWindowsMessageSlabPool& operator=(const TWindowsMessageSlabPool&) = delete;
+
+    ~TWindowsMessageSlabPool()
+    {
+        ensureMsgf(NumLive == 0, TEXT("%d pooled objects were never released."), NumLive);
+        for (FSlot* Slab : Slabs)
+        {
+            FMemory::Free(Slab);
+        }
+    }
+
+    /**
+     * Constructs an object in the pool.
+     * @return The object, valid until it is released.
+     */
+    template<typename... ArgTypes>
+    ObjectType* Acquire(ArgTypes&&... Args)
+    {
+        if (!FreeList)
+        {
+            AddSlab();
+        }
+        FSlot* Slot = FreeList;
+        FreeList = Slot->Next;
+        ++NumLive;
+        return new (Slot->Storage) ObjectType(Forward<ArgTypes>(Args)...);
+    }
+
+    /**
+     * Destroys an object and returns its slot to the pool.
+     * @param Object - An object acquired from this pool, or nullptr.
+     */
+    void Release(ObjectType* Object)
+    {
+        if (Object)
+        {
+            Object->~ObjectType();
+            FSlot* Slot = reinterpret_cast<FSlot*>(Object);
+            Slot->Next = FreeList;
+            FreeList = Slot;
+            --NumLive;
+        }
+    }
+
+    /**
+     * Allocates slabs until at least NumObjects objects can be live without further allocation.
+     */
+    void Reserve(int32 NumObjects)
+    {
+        while (Slabs.Num() * ObjectsPerSlab < NumObjects)
+        {
+            AddSlab();
+        }
+    }
+
+    /**
+     * @return The number of objects acquired and not yet released.
+     */
+    int32 NumLiveObjects() const
+    {
+        return NumLive;
+    }
+
+    /**
+     * @return The number of slabs allocated.
+     */
+    int32 NumSlabs() const
+    {
+        return Slabs.Num();
+    }
+
+private:
+
+    union FSlot
+    {
+        FSlot* Next;                                       // Next free slot, while the slot is free
+        alignas(ObjectType) uint8 Storage[sizeof(ObjectType)]; // The object, while the slot is in use
+    };
+
+    void AddSlab()
+    {
+        FSlot* Slab = static_cast<FSlot*>(FMemory::Malloc(sizeof(FSlot) * ObjectsPerSlab, alignof(FSlot)));
+        for (int32 Index = ObjectsPerSlab - 1; Index >= 0; --Index)
+        {
+            Slab[Index].Next = FreeList;
+            FreeList = &Slab[Index];
+        }
+        Slabs.Add(Slab);
+    }
+
+    TArray<FSlot*> Slabs;      // Every slab, freed with the pool
+    FSlot* FreeList = nullptr; // Free slots, most recently released first
+    int32 NumLive = 0;         // Objects acquired and not yet released
+};
+
+/** Pool of message records kept beyond the frame. */
+using FWindowsMessageRecordPool = TWindowsMessageSlabPool<FWindowsMessageRecord>;
@@ -0,0 +1,170 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares the structure-of-arrays message batch delivered to batch handlers.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageRecord.h"
+
+/**
+ * A read-only batch of messages, one contiguous column per field, so handlers can scan or decode
+ * a single field across every message without striding over the others.
+ */
+struct FWindowsMessageBatchView
+{
+    TArrayView<const uint64> Hwnds;      // Handle to the window of each message, stored as an integer
+    TArrayView<const uint32> Msgs;       // The message identifiers
+    TArrayView<const uint64> WParams;    // Additional message information
+    TArrayView<const int64> LParams;     // Additional message information
+    TArrayView<const uint64> Timestamps; // FPlatformTime::Cycles64() when each message arrived
+
+    /**
+     * Creates a view of a single message.
+     * @param Record - The message; must outlive the view.
+     */
+    static FWindowsMessageBatchView FromRecord(const FWindowsMessageRecord& Record)
+    {
+        FWindowsMessageBatchView View;
+        View.Hwnds = MakeArrayView(&Record.Hwnd, 1);
+        View.Msgs = MakeArrayView(&Record.Msg, 1);
+        View.WParams = MakeArrayView(&Record.WParam, 1);
+        View.LParams = MakeArrayView(&Record.LParam, 1);
+        View.Timestamps = MakeArrayView(&Record.Timestamp, 1);
+        return View;
+    }
+
+    /** @return The number of messages in the batch. */
+    FORCEINLINE int32 Num() const
+    {
+        return Msgs.Num();
+    }
+
+    /**
+     * Gathers one message of the batch back into a record.
+     * @param Index - Index of the message.
+     */
+    FORCEINLINE FWindowsMessageRecord GetRecord(int32 Index) const
+    {
+        return FWindowsMessageRecord(Hwnds[Index], Msgs[Index], WParams[Index], LParams[Index], Timestamps[Index]);
+    }
+};
+
+/**
+ * FWindowsMessageBatch
+ * Collects messages into preallocated structure-of-arrays storage. Adding messages never allocates
+ * until the reserved capacity is exceeded.
+ */
+class FWindowsMessageBatch
+{
+public:
+    /**
+     * Preallocates every column.
+     * @param Capacity - Number of messages to reserve space for.
+     */
+    void Reserve(int32 Capacity)
+    {
+        Hwnds.Reserve(Capacity);
+        Msgs.Reserve(Capacity);
+        WParams.Reserve(Capacity);
+        LParams.Reserve(Capacity);
+        Timestamps.Reserve(Capacity);
+    }
+
+    /**
+     * Appends a message, splitting it across the columns.
+     * @param Record - The message.
+     */
+    FORCEINLINE void Add(const FWindowsMessageRecord& Record)
+    {
+        Hwnds.Add(Record.Hwnd);
+        Msgs.Add(Record.Msg);
+        WParams.Add(Record.WParam);
+        LParams.Add(Record.LParam);
+        Timestamps.Add(Record.Timestamp);
+    }
+
+    /** Removes every message, keeping the storage. */
+    void Reset()
+    {
+        Hwnds.Reset();
+        Msgs.Reset();
+        WParams.Reset();
+        LParams.Reset();
+        Timestamps.Reset();
+    }
+
+    /** @return The number of messages in the batch. */
+    FORCEINLINE int32 Num() const
+    {
+        return Msgs.Num();
+    }
+
+    /** @return A view of the batch, valid until the batch is next modified. */
+    FWindowsMessageBatchView GetView() const
+    {
+        FWindowsMessageBatchView View;
+        View.Hwnds = Hwnds;
+        View.Msgs = Msgs;
+        View.WParams = WParams;
+        View.LParams = LParams;
+        View.Timestamps = Timestamps;
+        return View;
+    }
+
+private:
+
+    TArray<uint64> Hwnds;
+    TArray<uint32> Msgs;
+    TArray<uint64> WParams;
+    TArray<int64> LParams;
+    TArray<uint64> Timestamps;
+};
+
+/**
+ * IWindowsMessageBatchHandler
+ * Interface for handlers that receive dispatched messages in batches rather than one call per message.
+ * Batch handlers cannot consume messages; they see every dispatched message that no handler consumed.
+ */
+class IWindowsMessageBatchHandler
+{
+public:
+    virtual ~IWindowsMessageBatchHandler() {}
+
+    /**
+     * Processes a batch of messages, in the order they were dispatched.
+     * @param Batch - The messages; only valid for the duration of the call.
+     */
+    virtual void ProcessMessages(const FWindowsMessageBatchView& Batch) = 0;
+};
+
+/**
+ * A type-erased batch handler: an object pointer and the function that forwards a batch to it.
+ */
+struct FWindowsMessageBatchHandlerRef
+{
+    using FInvokeFunction = void (*)(void* Object, const FWindowsMessageBatchView& Batch);
+
+    void* Object = nullptr;           // The handler object
+    FInvokeFunction Invoke = nullptr; // Forwards a batch to Object
+
+    /**
+     * Creates a reference to an object with a void ProcessMessages(const FWindowsMessageBatchView&) member,
+     * such as an IWindowsMessageBatchHandler.
+     * @param Handler - The handler object.
+     * @return The handler reference.
+     */
+    template<typename HandlerType>
+    static FWindowsMessageBatchHandlerRef Create(HandlerType* Handler)
+    {
+        FWindowsMessageBatchHandlerRef Ref;
+        Ref.Object = Handler;
+        Ref.Invoke = [](void* Object, const FWindowsMessageBatchView& Batch)
+        {
+            static_cast<HandlerType*>(Object)->ProcessMessages(Batch);
+        };
+        return Ref;
+    }
+};
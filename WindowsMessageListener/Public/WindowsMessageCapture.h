@@ -0,0 +1,218 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares the binary capture format for message streams, with its writer and reader.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageRecord.h"
+#include "HAL/Runnable.h"
+#include "HAL/PlatformTime.h"
+
+#include <atomic>
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+class FRunnableThread;
+class FEvent;
+
+/**
+ * A captured message as stored on disk. Window handles are replaced by small ids assigned in order of first appearance.
+ */
+struct FWindowsMessageCaptureRecord
+{
+    uint64 Timestamp = 0; // FPlatformTime::Cycles64() when the message arrived
+    uint32 HwndId = 0;    // 1-based id of the window; 0 for messages without a window
+    uint32 Msg = 0;       // The message identifier
+    uint64 WParam = 0;    // Additional message information
+    int64 LParam = 0;     // Additional message information
+};
+static_assert(sizeof(FWindowsMessageCaptureRecord) == 32, "Capture records are written to disk as-is.");
+
+/**
+ * Header at the start of a capture file, followed by packed FWindowsMessageCaptureRecords.
+ */
+struct FWindowsMessageCaptureHeader
+{
+    static constexpr uint32 ExpectedMagic = 0x50434D57; // "WMCP"
+    static constexpr uint16 CurrentVersion = 1;
+
+    uint32 Magic = ExpectedMagic;
+    uint16 Version = CurrentVersion;
+    uint16 RecordSize = sizeof(FWindowsMessageCaptureRecord);
+    double SecondsPerCycle = 0.0; // Converts record timestamps to seconds
+    uint64 Reserved[2] = {};
+};
+static_assert(sizeof(FWindowsMessageCaptureHeader) == 32, "Capture headers are written to disk as-is.");
+
+/**
+ * Snapshot of a capture writer's counters.
+ */
+struct FWindowsMessageCaptureCounters
+{
+    uint64 RecordsCaptured = 0; // Records handed to the background flush
+    uint64 RecordsDropped = 0;  // Records lost because both buffers were full
+    uint64 BytesWritten = 0;    // Bytes written to the capture file, including the header
+};
+
+/**
+ * How a capture is fed back.
+ */
+enum class EWindowsMessageReplayTiming : uint8
+{
+    AsFastAsPossible, // Feed every record back to back
+    Recorded          // Wait between records to reproduce the captured timing
+};
+
+/**
+ * FWindowsMessageCaptureWriter
+ * Appends messages to a capture file through two preallocated buffers. The producer fills one buffer while
+ * a background thread writes the other to disk; if the disk falls behind, records are dropped and counted
+ * rather than blocking the producer. Append must only be called from one thread.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageCaptureWriter : private FRunnable
+{
+public:
+    FWindowsMessageCaptureWriter();
+    virtual ~FWindowsMessageCaptureWriter();
+
+    /**
+     * Creates the capture file and starts the background flush thread.
+     * @param Filename - The file to write; replaced if it exists.
+     * @param BufferRecords - Number of records in each of the two buffers.
+     * @return True if the file was created.
+     */
+    bool Open(const TCHAR* Filename, int32 BufferRecords);
+
+    /**
+     * Writes any buffered records, stops the flush thread and closes the file. Blocks until the data is written.
+     */
+    void Close();
+
+    /**
+     * Checks if the writer has an open capture file.
+     */
+    bool IsOpen() const { return FileHandle != nullptr; }
+
+    /**
+     * Appends a message to the active buffer, handing the buffer to the flush thread once it is full.
+     * @param Record - The message to capture.
+     */
+    void Append(const FWindowsMessageRecord& Record);
+
+    /**
+     * @return A snapshot of the writer's counters.
+     */
+    FWindowsMessageCaptureCounters GetCounters() const;
+
+private:
+
+    virtual uint32 Run() override;
+
+    /**
+     * Hands the active buffer to the flush thread and switches to the other one.
+     * @return False if the other buffer is still being written.
+     */
+    bool SubmitActiveBuffer();
+
+    /**
+     * Maps a window handle to its capture id, assigning the next id to new windows.
+     */
+    uint32 GetHwndId(uint64 Hwnd);
+
+    TArray<FWindowsMessageCaptureRecord> Buffers[2]; // Preallocated buffers; the producer owns Buffers[ActiveBuffer]
+    int32 ActiveBuffer = 0;                          // Buffer being filled by the producer
+    int32 ActiveCount = 0;                           // Records in the active buffer
+    int32 SubmittedBuffer = 0;                       // Buffer handed to the flush thread; valid while bFlushPending is set
+    int32 SubmittedCount = 0;                        // Records in the submitted buffer
+    std::atomic<bool> bFlushPending{false};          // Set by the producer, cleared by the flush thread once the buffer is written
+    std::atomic<bool> bStopping{false};              // Asks the flush thread to exit once nothing is pending
+
+    TArray<uint64> KnownHwnds;                       // Window handles in order of first appearance; index + 1 is the id
+    uint64 LastHwnd = 0;                             // Most recent window handle, checked before scanning KnownHwnds
+    uint32 LastHwndId = 0;                           // Id of LastHwnd
+
+    IFileHandle* FileHandle = nullptr;               // The open capture file
+    FRunnableThread* FlushThread = nullptr;          // Writes submitted buffers to FileHandle
+    FEvent* FlushEvent = nullptr;                    // Wakes the flush thread
+
+    std::atomic<uint64> RecordsCaptured{0};
+    std::atomic<uint64> RecordsDropped{0};
+    std::atomic<uint64> BytesWritten{0};
+};
+
+/**
+ * FWindowsMessageCaptureReader
+ * Memory-maps a capture file and feeds its records back, either back to back or at the recorded timing.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageCaptureReader
+{
+public:
+    FWindowsMessageCaptureReader();
+    ~FWindowsMessageCaptureReader();
+
+    /**
+     * Maps a capture file and validates its header.
+     * @param Filename - The capture file.
+     * @return True if the file is a valid capture.
+     */
+    bool Open(const TCHAR* Filename);
+
+    /**
+     * Unmaps the capture file.
+     */
+    void Close();
+
+    /**
+     * @return The captured records, valid until the reader is closed.
+     */
+    TArrayView<const FWindowsMessageCaptureRecord> GetRecords() const
+    {
+        return MakeArrayView(Records, NumRecords);
+    }
+
+    /**
+     * Feeds every captured record to a function as an FWindowsMessageRecord whose Hwnd is the window id
+     * and whose Timestamp is the time it was fed.
+     * @param Timing - Whether to reproduce the recorded gaps between messages.
+     * @param Feed - Callable taking a const FWindowsMessageRecord&.
+     * @return The number of records fed.
+     */
+    template<typename FuncType>
+    int32 Replay(EWindowsMessageReplayTiming Timing, FuncType&& Feed) const
+    {
+        if (NumRecords == 0)
+        {
+            return 0;
+        }
+
+        const uint64 FirstTimestamp = Records[0].Timestamp;
+        const double StartSeconds = FPlatformTime::Seconds();
+        for (int32 Index = 0; Index < NumRecords; ++Index)
+        {
+            const FWindowsMessageCaptureRecord& Captured = Records[Index];
+            if (Timing == EWindowsMessageReplayTiming::Recorded)
+            {
+                WaitUntil(StartSeconds + static_cast<double>(Captured.Timestamp - FirstTimestamp) * SecondsPerCycle);
+            }
+            Feed(FWindowsMessageRecord(Captured.HwndId, Captured.Msg, Captured.WParam, Captured.LParam, FPlatformTime::Cycles64()));
+        }
+        return NumRecords;
+    }
+
+private:
+
+    /**
+     * Sleeps, then spins, until FPlatformTime::Seconds() reaches a target.
+     */
+    static void WaitUntil(double TargetSeconds);
+
+    IMappedFileHandle* MappedFile = nullptr;           // The mapped capture file
+    IMappedFileRegion* MappedRegion = nullptr;         // The whole file, mapped read-only
+    const FWindowsMessageCaptureRecord* Records = nullptr; // Records following the header in MappedRegion
+    int32 NumRecords = 0;                              // Number of complete records
+    double SecondsPerCycle = 0.0;                      // Timestamp scale of the machine that made the capture
+};
@@ -0,0 +1,137 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares the FWindowsMessageCoalescer class, which merges high-frequency messages.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageFilter.h"
+#include "WindowsMessageRecord.h"
+
+#include <atomic>
+
+/**
+ * Snapshot of a coalescer's counters.
+ */
+struct FWindowsMessageCoalescerCounters
+{
+    uint64 MessagesIn = 0;        // Messages of coalesced types received
+    uint64 MessagesDelivered = 0; // Messages of coalesced types flushed to handlers
+    uint64 MessagesCoalesced = 0; // Messages replaced by a newer message with the same key
+};
+
+/**
+ * FWindowsMessageCoalescer
+ * Keeps only the newest message per (hwnd, msg) key for configured message types until it is flushed.
+ * Ordering barrier types (window creation and destruction, key and mouse button messages by default) are never
+ * held back, but callers should flush pending messages before forwarding one so handlers see the state that preceded it.
+ * Must only be used from one thread; the counters can be read from any thread.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageCoalescer
+{
+public:
+    FWindowsMessageCoalescer();
+
+    /**
+     * Adds or removes a message type from the set of coalesced types.
+     * @param MsgCode - The message code.
+     * @param bCoalesce - True to coalesce messages of this type.
+     */
+    void SetCoalescedMessageType(uint32 MsgCode, bool bCoalesce);
+
+    /**
+     * Adds or removes a message type from the set of ordering barriers.
+     * @param MsgCode - The message code.
+     * @param bBarrier - True to flush pending messages before messages of this type.
+     */
+    void SetOrderingBarrierMessageType(uint32 MsgCode, bool bBarrier);
+
+    /**
+     * Replaces the set of coalesced types. Pending messages should be flushed first.
+     * @param MessageTypes - The message types to coalesce.
+     */
+    void SetCoalescedMessageTypes(const FWindowsMessageFilter& MessageTypes);
+
+    /**
+     * Retrieves the set of coalesced types.
+     */
+    const FWindowsMessageFilter& GetCoalescedMessageTypes() const { return CoalescedMessageTypes; }
+
+    /**
+     * Checks if messages of a type are coalesced.
+     */
+    FORCEINLINE bool IsCoalescedMessageType(uint32 MsgCode) const
+    {
+        return CoalescedMessageTypes.IsAllowed(MsgCode);
+    }
+
+    /**
+     * Checks if messages of a type must see pending coalesced messages flushed first.
+     */
+    FORCEINLINE bool IsOrderingBarrier(uint32 MsgCode) const
+    {
+        return OrderingBarrierMessageTypes.IsAllowed(MsgCode);
+    }
+
+    /**
+     * Checks if any message is waiting to be flushed.
+     */
+    FORCEINLINE bool HasPendingMessages() const
+    {
+        return PendingMessages.Num() > 0;
+    }
+
+    /**
+     * Holds a message of a coalesced type, replacing any pending message with the same key.
+     * @param Record - The message to hold.
+     */
+    void Absorb(const FWindowsMessageRecord& Record);
+
+    /**
+     * Delivers pending messages in the order their keys were first seen, then clears them.
+     * Reentrant: messages absorbed or flushed by Deliver are held for, or delivered by, that call instead.
+     * @param Deliver - Callable taking a const FWindowsMessageRecord&.
+     * @return The number of messages delivered.
+     */
+    template<typename FuncType>
+    int32 Flush(FuncType&& Deliver)
+    {
+        TArray<FWindowsMessageRecord> FlushingMessages = MoveTemp(PendingMessages);
+        const int32 NumPending = FlushingMessages.Num();
+        for (int32 Index = 0; Index < NumPending; ++Index)
+        {
+            Deliver(static_cast<const FWindowsMessageRecord&>(FlushingMessages[Index]));
+        }
+        MessagesDelivered.fetch_add(NumPending, std::memory_order_relaxed);
+
+        // Hand the storage back unless Deliver absorbed new messages, so steady-state flushes never allocate
+        if (PendingMessages.Num() == 0)
+        {
+            FlushingMessages.Reset();
+            PendingMessages = MoveTemp(FlushingMessages);
+        }
+        return NumPending;
+    }
+
+    /**
+     * Discards pending messages without delivering them.
+     */
+    void DiscardPendingMessages();
+
+    /**
+     * @return A snapshot of the coalescer's counters.
+     */
+    FWindowsMessageCoalescerCounters GetCounters() const;
+
+private:
+
+    FWindowsMessageFilter CoalescedMessageTypes;       // Types whose messages are merged per key
+    FWindowsMessageFilter OrderingBarrierMessageTypes; // Types that must not overtake pending messages
+    TArray<FWindowsMessageRecord> PendingMessages;     // Newest message per key; a handful of keys per frame, so a linear scan beats hashing
+
+    std::atomic<uint64> MessagesIn{0};
+    std::atomic<uint64> MessagesDelivered{0};
+    std::atomic<uint64> MessagesCoalesced{0};
+};
@@ -7,6 +7,10 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Misc/StringBuilder.h"
+#include "Containers/StringView.h"
+
+class FWindowsMessageFrameArena;
 
 constexpr uint32 WM_USER_START = 0x0400; // Start of user-defined messages
 constexpr uint32 WM_USER_END = 0x8000;   // End of user-defined messages
@@ -26,6 +30,15 @@ struct FWindowsMessageInfo
         : Name(InName), Description(InDesc) {}
 };
 
+/**
+ * Struct viewing the name and description of a Windows message without owning them.
+ */
+struct FWindowsMessageInfoView
+{
+    FStringView Name;        // Name of the message
+    FStringView Description; // Description of the message
+};
+
 /**
  * Helper class for working with Windows message codes.
  */
@@ -54,9 +67,65 @@ public:
     static FWindowsMessageInfo GetMessageInfo(uint32 MsgCode);
 
     /**
-     * Retrieves the message code by its name.
+     * Retrieves the message code by its name, ignoring case.
+     * Also accepts "WM_USER + 0x12" style offsets from a known name, as produced by GetMessageName.
      * @param MessageName - The name of the message.
      * @return The message code, or 0 if not found.
      */
     static uint32 GetMessageCodeByName(const FString& MessageName);
+
+    /**
+     * Retrieves the message code by its name, ignoring case, through a compile-time hash index.
+     * Accepts a known name ("WM_KEYDOWN"), a known name plus a hexadecimal or decimal offset
+     * ("WM_USER + 0x12", "WM_APP+3"), or a plain number ("0x0100").
+     * @param MessageName - The name of the message.
+     * @param OutMsgCode - Receives the message code if found.
+     * @return True if the name was resolved.
+     */
+    static bool TryGetMessageCodeByName(FStringView MessageName, uint32& OutMsgCode);
+
+    /**
+     * Retrieves the name of a Windows message without allocating.
+     * Names of WM_USER and WM_APP messages are formatted into a small per-thread cache, so the
+     * returned pointer is only guaranteed to stay valid until the next call on the same thread.
+     * @param MsgCode - The message code.
+     * @return The name of the message.
+     */
+    static const TCHAR* GetMessageNameView(uint32 MsgCode);
+
+    /**
+     * Retrieves the description of a Windows message without allocating.
+     * @param MsgCode - The message code.
+     * @return The description of the message, in static storage.
+     */
+    static const TCHAR* GetMessageDescriptionView(uint32 MsgCode);
+
+    /**
+     * Formats a one-line description of a message into a string builder without allocating,
+     * as long as the builder has enough inline capacity.
+     * @param Builder - The builder to append to.
+     * @param Context - Contextual information for the line.
+     * @param Hwnd - Handle to the window, as an integer.
+     * @param MsgCode - The message code.
+     */
+    static void FormatMessageDetails(FStringBuilderBase& Builder, const TCHAR* Context, uint64 Hwnd, uint32 MsgCode);
+
+    /**
+     * Retrieves the name and description of a Windows message without touching the heap.
+     * Names of WM_USER and WM_APP messages are copied into the arena; every other string is in static storage.
+     * @param MsgCode - The message code.
+     * @param Arena - The arena that holds formatted names.
+     * @return The name and description, valid until the arena is reset.
+     */
+    static FWindowsMessageInfoView GetMessageInfoView(uint32 MsgCode, FWindowsMessageFrameArena& Arena);
+
+    /**
+     * Formats a one-line description of a message directly into a frame arena, with no intermediate buffer.
+     * @param Arena - The arena that holds the line.
+     * @param Context - Contextual information for the line.
+     * @param Hwnd - Handle to the window, as an integer.
+     * @param MsgCode - The message code.
+     * @return The line, valid until the arena is reset.
+     */
+    static FStringView FormatMessageDetails(FWindowsMessageFrameArena& Arena, const TCHAR* Context, uint64 Hwnd, uint32 MsgCode);
 };
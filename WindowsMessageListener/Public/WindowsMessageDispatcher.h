@@ -0,0 +1,748 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares the FWindowsMessageDispatcher class, the platform-independent core of the message listener.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageRecord.h"
+#include "WindowsMessageFilter.h"
+#include "WindowsMessageRing.h"
+#include "WindowsMessageCoalescer.h"
+#include "WindowsMessageStats.h"
+#include "WindowsMessageCapture.h"
+#include "WindowsMessageBatch.h"
+#include "WindowsMessageArena.h"
+#include "WindowsMessageLogger.h"
+#include "WindowsMessageRules.h"
+#include "WindowsMessageLatency.h"
+#include "WindowsMessageFanOut.h"
+#include "Containers/Ticker.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+struct FWindowsMessageListenerState;
+
+/**
+ * What the dispatcher does when a handler returns true.
+ */
+enum class EWindowsMessageConsumptionPolicy : uint8
+{
+    Ignore,        // Every subscribed handler runs and the message is never reported as handled
+    StopFanOut,    // Later handlers are skipped, but the message still reaches FWindowsApplication
+    Consume        // Later handlers are skipped and true is returned to FWindowsApplication along with the handler's result
+};
+
+/**
+ * A type-erased handler: an object pointer and the function that forwards a message to it.
+ * The object pointer also identifies the handler for removal and priority changes.
+ */
+struct FWindowsMessageHandlerRef
+{
+    using FInvokeFunction = bool (*)(void* Object, const FWindowsMessageRecord& Record, int32& OutResult);
+
+    void* Object = nullptr;          // The handler object
+    FInvokeFunction Invoke = nullptr; // Forwards a message to Object; returns true if the message was handled
+
+    /**
+     * Creates a reference to an object with a bool HandleMessage(const FWindowsMessageRecord&, int32&) member.
+     * @param Handler - The handler object.
+     * @return The handler reference.
+     */
+    template<typename HandlerType>
+    static FWindowsMessageHandlerRef Create(HandlerType* Handler)
+    {
+        FWindowsMessageHandlerRef Ref;
+        Ref.Object = Handler;
+        Ref.Invoke = [](void* Object, const FWindowsMessageRecord& Record, int32& OutResult)
+        {
+            return static_cast<HandlerType*>(Object)->HandleMessage(Record, OutResult);
+        };
+        return Ref;
+    }
+};
+
+/**
+ * FWindowsMessageDispatcher
+ * Filters, coalesces, queues and fans out messages to handlers, using plain integer message types only.
+ * FWindowsMessageListener is a thin Win32 adapter around it; on its own it can be driven by synthetic
+ * message streams on any platform.
+ *
+ * Handlers subscribe to message codes and, optionally, to a single window. Each window with bound handlers
+ * gets its own dispatch table, found through a small hash keyed by window handle, so a message only visits
+ * the handlers of all windows plus the handlers bound to its own window.
+ *
+ * Handlers may be added or removed from any thread, including from inside a handler. Each change
+ * publishes a new immutable dispatch table; the dispatch loop reads it with a single atomic load and
+ * keeps using the table it started with, while removed handlers are skipped as soon as they are removed.
+ * Each dispatching thread records the epoch it started in in a slot of its own, and replaced tables are
+ * freed once every slot has moved past the epoch they were replaced in, so dispatches never share a counter.
+ * Removing a worker handler waits for its worker to finish the run it may be calling it from, so the handler
+ * can be deleted once the call returns; removing a pump handler does not wait for a call running on another thread.
+ *
+ * With parallel dispatch enabled, thread-safe handlers can move to worker threads. Each message that no
+ * pump handler consumed is copied once into a broadcast ring, and every worker runs its own handlers over
+ * the ring in order, so the dispatching thread's cost no longer grows with the number of such handlers.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageDispatcher
+{
+public:
+    static constexpr uint32 WindowCreateMsg = 0x0001;  // WM_CREATE; drops bindings left over from a reused window handle
+    static constexpr uint32 WindowDestroyMsg = 0x0002; // WM_DESTROY; drops the bindings of the destroyed window
+
+    FWindowsMessageDispatcher();
+    ~FWindowsMessageDispatcher();
+
+    FWindowsMessageDispatcher(const FWindowsMessageDispatcher&) = delete;
+    FWindowsMessageDispatcher& operator=(const FWindowsMessageDispatcher&) = delete;
+
+    /**
+     * Filters a message and, if it is allowed, coalesces, queues or dispatches it.
+     * @param Record - The message.
+     * @param OutResult - The result of the message processing.
+     * @return True if a handler consumed the message and the consumption policy is Consume.
+     */
+    bool ProcessMessage(const FWindowsMessageRecord& Record, int32& OutResult);
+
+    /**
+     * Coalesces, queues or dispatches a message that the caller has already filtered.
+     * @param Record - The message.
+     * @param OutResult - The result of the message processing.
+     * @return True if a handler consumed the message and the consumption policy is Consume.
+     */
+    bool AcceptMessage(const FWindowsMessageRecord& Record, int32& OutResult);
+
+    /**
+     * Counts, and logs if message logging is enabled, a message that the caller's filter rejected.
+     * @param Record - The message.
+     */
+    void RejectMessage(const FWindowsMessageRecord& Record);
+
+    /**
+     * Unbinds the handlers of a window when it is created or destroyed, for a message that was rejected rather than accepted.
+     * Called by ProcessMessage; for adapters that filter messages themselves. Accepted messages are tracked when they are
+     * dispatched: stale bindings are dropped before WM_CREATE reaches the handlers, so bindings made while handling it are
+     * kept, and the window's handlers are unbound after WM_DESTROY, once they have seen it and every message before it.
+     * With deferred processing, a rejected message is tracked when the ring is drained up to it, for the same reason.
+     * @param Record - The message, after RejectMessage.
+     */
+    FORCEINLINE void TrackWindowLifetime(const FWindowsMessageRecord& Record)
+    {
+        if ((Record.Msg == WindowCreateMsg || Record.Msg == WindowDestroyMsg) && NumBoundWindows.load(std::memory_order_relaxed) > 0)
+        {
+            TrackRejectedWindowLifetime(Record);
+        }
+    }
+
+    /**
+     * Adds a handler, or merges the ranges into its existing subscription for the same window.
+     * A handler subscribed to several windows keeps one priority across all of them.
+     * @param Handler - The handler to add.
+     * @param Ranges - Inclusive code ranges to subscribe to; empty subscribes to all codes.
+     * @param Hwnd - The window to bind the handler to; 0 for messages of every window.
+     */
+    void AddHandler(const FWindowsMessageHandlerRef& Handler, TArray<TPair<uint32, uint32>>&& Ranges, uint64 Hwnd = 0);
+
+    /**
+     * Adds a batch handler, which receives every dispatched message that no handler consumed,
+     * in batches while message batching is enabled and one message at a time otherwise.
+     * @param Handler - The batch handler to add.
+     */
+    void AddBatchHandler(const FWindowsMessageBatchHandlerRef& Handler);
+
+    /**
+     * Removes a handler from every window it is subscribed to, or removes a batch handler.
+     * If the handler ran on a worker, waits until that worker can no longer be inside it, unless called from that worker.
+     * @param Object - The object of the handler reference.
+     * @return True if the handler was registered.
+     */
+    bool RemoveHandler(const void* Object);
+
+    /**
+     * Removes every handler bound to a window. Handlers subscribed to all windows are kept.
+     * Waits for the workers of removed worker handlers, as RemoveHandler does.
+     * @param Hwnd - The window handle.
+     * @return The number of subscriptions removed.
+     */
+    int32 RemoveWindowHandlers(uint64 Hwnd);
+
+    /**
+     * Removes all handlers, waiting for the workers of removed worker handlers as RemoveHandler does.
+     */
+    void RemoveAllHandlers();
+
+    /**
+     * Sets the priority of a registered handler. Handlers with a higher priority receive messages first;
+     * handlers with equal priority keep their registration order. Handlers are registered with priority 0.
+     * @param Object - The object of the handler reference.
+     * @param Priority - The new priority.
+     * @return True if the handler is registered.
+     */
+    bool SetHandlerPriority(const void* Object, int32 Priority);
+
+    /**
+     * Replaces the rule set that handlers bind to with SetHandlerRule. The new rules take effect with the
+     * next message; dispatches already running finish with the old ones, so a reload never blocks the message path.
+     * @param Rules - The compiled rules, or nullptr to remove them. Must not be modified afterwards.
+     */
+    void SetMessageRules(TSharedPtr<const FWindowsMessageRuleSet> Rules);
+
+    /**
+     * Retrieves the current rule set, or nullptr if none is set.
+     */
+    TSharedPtr<const FWindowsMessageRuleSet> GetMessageRules() const;
+
+    /**
+     * Binds a registered handler to a rule: it then only receives messages the rule accepts, on top of its
+     * subscribed codes. The rule is looked up by name in the current rule set, and again whenever the rule
+     * set is replaced; while no rule of that name exists, the handler receives nothing. Batch handlers are unaffected.
+     * @param Object - The object of the handler reference.
+     * @param RuleName - The rule, or NAME_None to receive every subscribed message again.
+     * @return True if the handler is registered.
+     */
+    bool SetHandlerRule(const void* Object, FName RuleName);
+
+    /**
+     * Sets the thread that calls a registered handler. Worker handlers only run on a worker while parallel
+     * dispatch is enabled, and on the dispatching thread otherwise. They see every message that no pump handler
+     * consumed, in order, but cannot consume messages themselves. Handlers pinned to the same worker run one
+     * after another on it; the others run concurrently. Must be called from the thread that dispatches messages,
+     * never from a worker handler: it waits for the workers to finish queued messages, so a handler is never
+     * called from two threads at once.
+     * @param Object - The object of the handler reference.
+     * @param Thread - The thread that calls the handler.
+     * @param PreferredWorker - The worker to pin the handler to, modulo the number of workers; INDEX_NONE to give each handler the next worker in turn.
+     * @return True if the handler is registered.
+     */
+    bool SetHandlerThread(const void* Object, EWindowsMessageHandlerThread Thread, int32 PreferredWorker = INDEX_NONE);
+
+    /**
+     * Sets what happens when a handler returns true.
+     * Messages that are coalesced or deferred are never reported as handled.
+     * @param Policy - The consumption policy; Ignore by default.
+     */
+    void SetConsumptionPolicy(EWindowsMessageConsumptionPolicy Policy);
+
+    /**
+     * Retrieves the consumption policy.
+     */
+    EWindowsMessageConsumptionPolicy GetConsumptionPolicy() const;
+
+    /** Adds a message type to the allowed list. */
+    void AllowMessageType(uint32 MsgCode);
+
+    /** Removes a message type from the allowed list. */
+    void DisallowMessageType(uint32 MsgCode);
+
+    /** Adds an inclusive range of message types to the allowed list. */
+    void AllowMessageRange(uint32 FirstMsgCode, uint32 LastMsgCode);
+
+    /** Removes an inclusive range of message types from the allowed list. */
+    void DisallowMessageRange(uint32 FirstMsgCode, uint32 LastMsgCode);
+
+    /** Adds several message types to the allowed list. */
+    void AllowMessageTypes(TArrayView<const uint32> MsgCodes);
+
+    /** Removes several message types from the allowed list. */
+    void DisallowMessageTypes(TArrayView<const uint32> MsgCodes);
+
+    /** Clears all allowed message types. */
+    void ClearAllowedMessageTypes();
+
+    /**
+     * Checks if a message type is allowed. An empty allow-list blocks all messages.
+     */
+    FORCEINLINE bool IsMessageAllowed(uint32 MsgCode) const
+    {
+        return AllowedMessageTypes.IsAllowed(MsgCode);
+    }
+
+    /**
+     * Retrieves the allow-list, for callers that combine the filters of several dispatchers.
+     */
+    const FWindowsMessageFilter& GetAllowedMessageTypes() const { return AllowedMessageTypes; }
+
+    /**
+     * Enables deferred processing. Accepted messages are copied into a lock-free ring and dispatched when it is drained.
+     * Must be called from the thread that feeds messages.
+     * @param Capacity - Number of messages the ring can hold; rounded up to a power of two.
+     * @param OverflowPolicy - What to do with new messages while the ring is full.
+     * @param bDrainOnTick - True to drain the ring from the core ticker on every engine tick.
+     */
+    void EnableDeferredProcessing(uint32 Capacity, EWindowsMessageOverflowPolicy OverflowPolicy, bool bDrainOnTick = true);
+
+    /**
+     * Disables deferred processing, dispatching any messages still queued.
+     */
+    void DisableDeferredProcessing();
+
+    /**
+     * Checks if deferred processing is enabled.
+     */
+    bool IsDeferredProcessingEnabled() const;
+
+    /**
+     * Dispatches queued messages to handlers. Must only be called from one consumer thread at a time.
+     * @param MaxMessages - Maximum number of messages to dispatch.
+     * @return The number of messages dispatched.
+     */
+    int32 DrainDeferredMessages(int32 MaxMessages = MAX_int32);
+
+    /**
+     * Retrieves the counters of the deferred message ring, or zeroed counters if deferred processing is disabled.
+     */
+    FWindowsMessageRingCounters GetDeferredMessageCounters() const;
+
+    /**
+     * Enables message batching. Dispatched messages are collected into a structure-of-arrays batch and
+     * delivered to batch handlers in one call each, once the batch is full or when it is flushed.
+     * Must be called from the thread that dispatches messages.
+     * @param MaxMessages - Number of messages that triggers delivery; the batch storage is preallocated to this size.
+     * @param bFlushOnTick - True to also deliver a partial batch from the core ticker on every engine tick.
+     */
+    void EnableMessageBatching(int32 MaxMessages, bool bFlushOnTick = true);
+
+    /**
+     * Disables message batching, delivering any messages still collected.
+     */
+    void DisableMessageBatching();
+
+    /**
+     * Checks if message batching is enabled.
+     */
+    bool IsMessageBatchingEnabled() const;
+
+    /**
+     * Delivers the collected messages to batch handlers. Must be called from the thread that dispatches messages.
+     * @return The number of messages delivered.
+     */
+    int32 FlushMessageBatch();
+
+    /**
+     * Enables the frame arena, a bump allocator for records, decoded events, scratch data and debug strings that
+     * live until the end of the engine tick. The core ticker resets it once per tick, after coalesced, deferred and
+     * batched messages have been delivered. Must be called from the thread that dispatches messages.
+     * @param BlockBytes - Size of each arena block; the first block is allocated immediately.
+     */
+    void EnableFrameArena(int32 BlockBytes = 65536);
+
+    /**
+     * Disables the frame arena, freeing its blocks.
+     */
+    void DisableFrameArena();
+
+    /**
+     * Retrieves the frame arena. Only usable from the thread that dispatches messages.
+     * @return The frame arena, or nullptr if it is disabled.
+     */
+    FWindowsMessageFrameArena* GetFrameArena() { return FrameArena.Get(); }
+
+    /**
+     * Resets the frame arena, as the core ticker does once per tick. Memory allocated from it must no longer be used.
+     */
+    void ResetFrameArena();
+
+    /**
+     * Retrieves the counters of the frame arena, or zeroed counters if it is disabled.
+     */
+    FWindowsMessageArenaCounters GetFrameArenaCounters() const;
+
+    /**
+     * Coalesces a message type: only the newest message per window is kept until pending messages are flushed.
+     * @param MsgCode - The message code to coalesce.
+     */
+    void AddCoalescedMessageType(uint32 MsgCode);
+
+    /**
+     * Stops coalescing a message type, flushing pending messages first.
+     * @param MsgCode - The message code to forward immediately again.
+     */
+    void RemoveCoalescedMessageType(uint32 MsgCode);
+
+    /**
+     * Forwards pending coalesced messages to handlers, or to the deferred ring if deferred processing is enabled.
+     * @return The number of messages forwarded.
+     */
+    int32 FlushCoalescedMessages();
+
+    /**
+     * Retrieves the counters of the coalescing stage.
+     */
+    FWindowsMessageCoalescerCounters GetCoalescerCounters() const;
+
+    /**
+     * Retrieves per-code counters and per-handler timings; empty when stats are compiled out.
+     */
+    FWindowsMessageStatsSnapshot GetMessageStats() const;
+
+    /**
+     * Zeroes every per-code counter and per-handler timing.
+     */
+    void ResetMessageStats();
+
+    /**
+     * Retrieves the number of replaced dispatch tables and removed handlers still waiting to be freed.
+     */
+    int32 GetNumRetiredEntries() const;
+
+    /**
+     * Starts appending every message passed to ProcessMessage or CaptureMessage to a capture file.
+     * Must be called from the thread that feeds messages.
+     * @param Filename - The capture file; replaced if it exists.
+     * @param BufferRecords - Number of records in each of the two capture buffers.
+     * @return True if the capture file was created.
+     */
+    bool StartCapture(const FString& Filename, int32 BufferRecords = 16384);
+
+    /**
+     * Stops capturing, blocking until buffered records are written.
+     */
+    void StopCapture();
+
+    /**
+     * Checks if messages are being captured.
+     */
+    bool IsCapturing() const { return CaptureWriter.IsValid(); }
+
+    /**
+     * Appends a message to the capture file, if capturing. For adapters that filter messages themselves.
+     * @param Record - The message, before filtering.
+     */
+    FORCEINLINE void CaptureMessage(const FWindowsMessageRecord& Record)
+    {
+        if (CaptureWriter)
+        {
+            CaptureWriter->Append(Record);
+        }
+    }
+
+    /**
+     * Retrieves the capture counters, or zeroed counters if not capturing.
+     */
+    FWindowsMessageCaptureCounters GetCaptureCounters() const;
+
+    /**
+     * Feeds a capture file back through the filter and dispatch path of ProcessMessage. Replayed messages are not
+     * captured again and do not unbind window handlers, since their window ids are stale.
+     * @param Filename - The capture file.
+     * @param Timing - Whether to reproduce the recorded gaps between messages.
+     * @return The number of messages replayed, or INDEX_NONE if the file is not a valid capture.
+     */
+    int32 ReplayCapture(const FString& Filename, EWindowsMessageReplayTiming Timing);
+
+    /**
+     * Enables the message log: accepted and rejected messages are filtered, sampled and rate limited, then
+     * formatted and written on a background thread. Configure it through GetMessageLogger.
+     * Must be called from the thread that dispatches messages.
+     * @param Capacity - Number of records buffered for the writer thread; records beyond it are dropped and counted.
+     * @param bBackgroundThread - False to keep records until the logger's Flush is called, as tests do.
+     */
+    void EnableMessageLogging(int32 Capacity = 4096, bool bBackgroundThread = true);
+
+    /**
+     * Disables the message log, writing every record still buffered.
+     */
+    void DisableMessageLogging();
+
+    /**
+     * Checks if the message log is enabled.
+     */
+    bool IsMessageLoggingEnabled() const { return MessageLogger.IsValid(); }
+
+    /**
+     * Retrieves the message log, to set its filter, rules and sink. Only usable from the thread that dispatches messages.
+     * @return The message log, or nullptr if it is disabled.
+     */
+    FWindowsMessageLogger* GetMessageLogger() { return MessageLogger.Get(); }
+
+    /**
+     * Retrieves the counters of the message log, or zeroed counters if it is disabled.
+     */
+    FWindowsMessageLogCounters GetMessageLogCounters() const;
+
+    /**
+     * Enables latency tracking: every dispatched message is timed from its arrival Timestamp to the return of
+     * its last handler, into per-code histograms. Configure spike reports through GetLatencyTracker.
+     * Must be called from the thread that dispatches messages.
+     * @param MaxTrackedCodes - Codes that get their own histograms; later codes share one.
+     * @param TimelineCapacity - Number of recent message timelines reported when a spike occurs.
+     */
+    void EnableLatencyTracking(int32 MaxTrackedCodes = 32, int32 TimelineCapacity = 256);
+
+    /**
+     * Disables latency tracking and discards its histograms.
+     */
+    void DisableLatencyTracking();
+
+    /**
+     * Checks if latency tracking is enabled.
+     */
+    bool IsLatencyTrackingEnabled() const { return LatencyTracker.IsValid(); }
+
+    /**
+     * Retrieves the latency tracker, to set its spike threshold and sink. Only usable from the thread that dispatches messages.
+     * @return The latency tracker, or nullptr if it is disabled.
+     */
+    FWindowsMessageLatencyTracker* GetLatencyTracker() { return LatencyTracker.Get(); }
+
+    /**
+     * Retrieves latency percentiles per code and stage, or empty stats if tracking is disabled.
+     */
+    FWindowsMessageLatencyStats GetLatencyStats() const;
+
+    /**
+     * Enables parallel dispatch: handlers set to EWindowsMessageHandlerThread::Worker are called on worker threads,
+     * which read a broadcast ring of dispatched messages. Must be called from the thread that dispatches messages.
+     * @param NumWorkers - Number of worker threads, at most FWindowsMessageFanOut::MaxWorkers.
+     * @param Capacity - Number of messages the ring can hold; rounded up to a power of two.
+     * @param bWaitWhenFull - True to make the dispatching thread wait for the slowest worker when the ring is full; false to drop the message for every worker and count it.
+     */
+    void EnableParallelDispatch(int32 NumWorkers, uint32 Capacity = 4096, bool bWaitWhenFull = true);
+
+    /**
+     * Disables parallel dispatch once the workers have finished every queued message. Worker handlers are then called on the dispatching thread.
+     */
+    void DisableParallelDispatch();
+
+    /**
+     * Checks if parallel dispatch is enabled.
+     */
+    bool IsParallelDispatchEnabled() const { return FanOut.IsValid(); }
+
+    /**
+     * Blocks until the workers have finished every message dispatched so far. Must be called from the thread that dispatches messages.
+     */
+    void WaitForParallelDispatch();
+
+    /**
+     * Retrieves the counters of the broadcast ring, or zeroed counters if parallel dispatch is disabled.
+     */
+    FWindowsMessageFanOutCounters GetParallelDispatchCounters() const;
+
+    /**
+     * Saves the allow-list, coalesced types, consumption policy and the subscriptions of named handlers.
+     * Subscriptions bound to a window, and those of handlers without a name, are left out.
+     * @param OutState - Receives the state.
+     * @param GetHandlerName - Returns the name to save a handler under, given the object of its reference, or NAME_None to leave it out.
+     * @return The number of subscriptions saved.
+     */
+    int32 SaveState(FWindowsMessageListenerState& OutState, TFunctionRef<FName(const void* Object)> GetHandlerName) const;
+
+    /**
+     * Replaces the allow-list, coalesced types and consumption policy with saved ones, and installs the saved
+     * subscriptions in one step: the dispatch tables are rebuilt once, and nothing is logged per entry. A restored
+     * handler's subscription to every window is replaced; its window bindings keep their codes but take its saved
+     * priority, rule and thread. Other handlers are kept. Must be called from the thread that dispatches messages.
+     * @param State - The saved state.
+     * @param FindHandler - Returns the handler saved under a name, or a null reference to skip its subscription.
+     * @return The number of subscriptions restored.
+     */
+    int32 RestoreState(const FWindowsMessageListenerState& State, TFunctionRef<FWindowsMessageHandlerRef(FName HandlerName)> FindHandler);
+
+    /** Enables or disables verbose logging of every dispatched message. */
+    void SetVerboseLoggingEnabled(bool bEnabled);
+
+    /** Checks if verbose logging is enabled. */
+    FORCEINLINE bool IsVerboseLoggingEnabled() const
+    {
+        return bEnableVerboseLogging;
+    }
+
+private:
+
+    struct FHandlerRegistration; // A registered handler, kept alive until no dispatch can still reach it
+    struct FDispatchTable;       // Compiled code-to-handler table of one window, or of windows without bound handlers
+    struct FDispatchSnapshot;    // Immutable set of dispatch tables
+
+    /**
+     * The epoch the current dispatch of one lane started in. Each slot is only written by the thread dispatching on its lane.
+     */
+    struct FDispatchEpochSlot
+    {
+        alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> Epoch{0}; // ReclaimEpoch when the lane's outermost dispatch began; 0 while the lane is idle
+        std::atomic<uint32> ThreadId{0};                                 // The worker thread of a worker lane, so it never waits for itself
+        int32 Depth = 0;                                                 // Nested dispatches on the lane, so only the outermost one updates Epoch
+    };
+
+    /**
+     * A registered handler and the message code ranges it subscribed to.
+     */
+    struct FHandlerSubscription
+    {
+        FHandlerRegistration* Registration = nullptr; // The subscribed handler
+        int32 Priority = 0;                           // Higher priorities are dispatched first
+        uint64 Hwnd = 0;                              // The window the handler is bound to; 0 for every window
+        TArray<TPair<uint32, uint32>> Ranges;         // Inclusive code ranges, sorted and merged; empty means all codes
+        FName Rule;                                   // The rule that must accept a message before the handler sees it; None for no rule
+        EWindowsMessageHandlerThread Thread = EWindowsMessageHandlerThread::Pump; // The thread that calls the handler
+        int32 Worker = 0;                             // The worker the handler is pinned to, when Thread is Worker
+    };
+
+    TArray<FHandlerSubscription> Subscriptions;               // Registered handlers, by descending priority then registration order; guarded by RegistrationLock
+    TArray<FHandlerRegistration*> BatchSubscriptions;         // Registered batch handlers, in registration order; guarded by RegistrationLock
+    std::atomic<FDispatchSnapshot*> DispatchSnapshot{nullptr}; // Current dispatch table, or nullptr if there are no handlers
+    std::atomic<uint64> ReclaimEpoch{1};                      // Advanced whenever a table is replaced; retired state is tagged with the epoch it was retired in
+    std::atomic<bool> bHasRetiredState{false};                // Whether retired snapshots or registrations are waiting to be freed
+    std::atomic<int32> NumBoundWindows{0};                    // Number of windows with bound handlers, so lifetime messages are only tracked when needed
+    FDispatchEpochSlot EpochSlots[1 + FWindowsMessageFanOut::MaxWorkers]; // One per lane: the dispatching thread's, then one per worker
+    mutable FCriticalSection RegistrationLock;                // Serializes registration changes; only taken on the message path when a window with bound handlers is created or destroyed
+    TArray<TPair<FDispatchSnapshot*, uint64>> RetiredSnapshots;        // Replaced tables that a dispatch may still be reading, and the epoch they were retired in
+    TArray<TPair<FHandlerRegistration*, uint64>> RetiredRegistrations; // Removed handlers that a dispatch may still be reading, and the epoch they were retired in
+    TSharedPtr<const FWindowsMessageRuleSet> MessageRules;    // Rules handlers bind to; guarded by RegistrationLock, and referenced by each snapshot
+    int32 NumDispatchLanes = 1;                               // Dispatch tables per window: the dispatching thread's, then one per worker; guarded by RegistrationLock
+    int32 NextWorker = 0;                                     // Worker given to the next handler without a preferred one; guarded by RegistrationLock
+    FWindowsMessageFilter AllowedMessageTypes;                // Bitmap of allowed message types
+    bool bEnableVerboseLogging = false;                       // Debug flag to control verbose logging
+    EWindowsMessageConsumptionPolicy ConsumptionPolicy = EWindowsMessageConsumptionPolicy::Ignore; // What a handler returning true does
+    TUniquePtr<FWindowsMessageRing> DeferredMessages;         // Queue of messages awaiting dispatch, when deferred processing is enabled
+    bool bDrainDeferredOnTick = false;                        // Whether the ticker drains DeferredMessages
+    FWindowsMessageCoalescer Coalescer;                       // Holds the newest message per window for coalesced types
+    int32 NumCoalescedMessageTypes = 0;                       // Number of coalesced types, so the ticker only runs when needed
+    TUniquePtr<FWindowsMessageBatch> PendingBatch;            // Messages awaiting delivery to batch handlers, when batching is enabled
+    int32 MaxBatchMessages = 0;                               // Number of messages that triggers delivery of PendingBatch
+    bool bFlushBatchOnTick = false;                           // Whether the ticker delivers PendingBatch
+    TUniquePtr<FWindowsMessageFrameArena> FrameArena;         // Per-tick allocator reset by the ticker, when enabled
+    TUniquePtr<FWindowsMessageCaptureWriter> CaptureWriter;   // Capture file writer, while capturing
+    TUniquePtr<FWindowsMessageLogger> MessageLogger;          // Sampled, rate-limited message log, when enabled
+    TUniquePtr<FWindowsMessageLatencyTracker> LatencyTracker; // Arrival-to-handler latency histograms, when enabled
+    TUniquePtr<FWindowsMessageFanOut> FanOut;                 // Broadcast ring read by the worker threads, when parallel dispatch is enabled
+    bool bHoldFanOutPublish = false;                          // Set while draining, so a whole run of messages is published to the workers at once
+    FTSTicker::FDelegateHandle TickerHandle;                  // Ticker flushing coalesced messages and draining DeferredMessages once per engine tick
+#if WINDOWS_MESSAGE_LISTENER_STATS
+    FWindowsMessageCodeCounters MessageCodeCounters;          // Received, filtered and dispatched counts per message code
+#endif
+
+    static constexpr uint32 LifetimeOnlyMsgFlag = 0x80000000; // Marks a queued WM_CREATE or WM_DESTROY that was rejected, so it is only tracked when drained
+
+    /**
+     * Unbinds a window's handlers in order with the messages before a rejected WM_CREATE or WM_DESTROY.
+     */
+    void TrackRejectedWindowLifetime(const FWindowsMessageRecord& Record);
+
+    /**
+     * Unbinds the handlers of a window once the worker threads have finished with its messages.
+     * Must be called from the thread that dispatches messages.
+     */
+    void UnbindWindow(uint64 Hwnd);
+
+    /**
+     * Filters and accepts a replayed message, skipping the capture and window lifetime tracking of ProcessMessage.
+     */
+    bool ReplayMessage(const FWindowsMessageRecord& Record, int32& OutResult);
+
+    /**
+     * Records the epoch a lane's dispatch starts in, then loads the dispatch table. Called on the lane's thread.
+     * @return The current dispatch table, or nullptr if there are no handlers.
+     */
+    const FDispatchSnapshot* EnterDispatch(int32 Lane);
+
+    /**
+     * Marks a lane idle once its outermost dispatch ends, freeing retired state if there is any.
+     */
+    void ExitDispatch(int32 Lane);
+
+    /**
+     * Forwards a message to the handlers subscribed to its code, in priority order.
+     * @return True if a handler consumed the message and the consumption policy stopped the fan-out.
+     */
+    bool DispatchMessage(const FWindowsMessageRecord& Record, int32& OutResult);
+
+    /**
+     * Calls the handlers of a table subscribed to a message's code, in priority order, skipping removed handlers and those whose rule rejects it.
+     * @param Arena - The frame arena verbose lines are formatted into, or nullptr to format them on the stack, as workers do.
+     * @return True if a handler consumed the message and bStopOnConsumed stopped the fan-out.
+     */
+    bool InvokeHandlers(const FDispatchSnapshot& Snapshot, const FDispatchTable& Table, const FWindowsMessageRecord& Record, int32& OutResult, bool bStopOnConsumed, FWindowsMessageFrameArena* Arena);
+
+    /**
+     * Calls the handlers of one worker for a run of messages. Called on the worker's thread.
+     */
+    void DispatchWorkerMessages(int32 WorkerIndex, TArrayView<const FWindowsMessageRecord> Records);
+
+    /**
+     * Makes messages written to the broadcast ring visible to the workers, unless a drain is collecting them.
+     */
+    FORCEINLINE void PublishToWorkers()
+    {
+        if (FanOut && !bHoldFanOutPublish)
+        {
+            FanOut->Publish();
+        }
+    }
+
+    /**
+     * Collects a dispatched message for the batch handlers of a table, or delivers it at once if batching is disabled.
+     */
+    void BatchMessage(const FDispatchSnapshot& Snapshot, const FWindowsMessageRecord& Record);
+
+    /**
+     * Forwards a batch to every batch handler of a table that has not been removed.
+     */
+    void DeliverBatch(const FDispatchSnapshot& Snapshot, const FWindowsMessageBatchView& Batch);
+
+    /**
+     * Forwards a copied message to the deferred ring, or to handlers if deferred processing is disabled.
+     */
+    void ForwardMessage(const FWindowsMessageRecord& Record);
+
+    /**
+     * Flushes coalesced messages, drains the deferred message ring, delivers the message batch and resets the frame arena from the core ticker.
+     */
+    bool Tick(float DeltaTime);
+
+    /**
+     * Registers or unregisters the core ticker depending on whether any per-tick work is configured.
+     */
+    void UpdateTicker();
+
+    /**
+     * Finds the index at which a subscription with the given priority keeps Subscriptions sorted.
+     * The caller must hold RegistrationLock.
+     */
+    int32 FindSubscriptionInsertIndex(int32 Priority) const;
+
+    /**
+     * Compiles the subscriptions into new dispatch tables and publishes them, retiring the previous ones.
+     * The caller must hold RegistrationLock.
+     */
+    void PublishDispatchSnapshot();
+
+    /**
+     * Compiles the subscriptions of every window, and of one window, into a dispatch table. The caller must hold RegistrationLock.
+     * @param OutTable - The table to fill.
+     * @param Hwnd - The window whose bound handlers are included; 0 to include only handlers of every window.
+     * @param Lane - The thread whose handlers are included: 0 for the dispatching thread, 1 + the worker index for a worker.
+     */
+    void BuildDispatchTable(FDispatchTable& OutTable, uint64 Hwnd, int32 Lane) const;
+
+    /**
+     * Finds the lane whose dispatch tables hold a subscription. The caller must hold RegistrationLock.
+     */
+    int32 GetSubscriptionLane(const FHandlerSubscription& Subscription) const;
+
+    /**
+     * Marks a registration removed and retires it. The caller must hold RegistrationLock.
+     */
+    void RetireRegistration(FHandlerRegistration* Registration);
+
+    /**
+     * Blocks until worker lanes have left every dispatch that started before state retired in an epoch was replaced.
+     * Lanes of the calling thread are skipped. Must not be called with RegistrationLock held.
+     * @param WorkerLanes - Bit mask of the lanes to wait for.
+     * @param RetiredEpoch - The epoch the state was retired in.
+     */
+    void WaitForWorkerLanes(uint32 WorkerLanes, uint64 RetiredEpoch) const;
+
+    /**
+     * Frees the retired tables and registrations that no dispatch in progress can reach. The caller must hold RegistrationLock.
+     */
+    void ReclaimRetiredState();
+
+    /**
+     * Frees retired state without blocking, if RegistrationLock is free.
+     */
+    void TryReclaimRetiredState();
+};
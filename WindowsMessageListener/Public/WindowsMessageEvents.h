@@ -0,0 +1,291 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares the typed input events decoded from raw messages, their decoders and the router that delivers them.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageRecord.h"
+#include "WindowsMessageBatch.h"
+#include "HAL/CriticalSection.h"
+
+class FWindowsMessageFrameArena;
+
+/**
+ * Kinds of decoded input events, as flags so handlers can subscribe to several at once.
+ */
+enum class EWindowsInputEventTypes : uint8
+{
+    None = 0,
+    MouseMove = 1 << 0,   // WM_MOUSEMOVE
+    MouseButton = 1 << 1, // WM_LBUTTONDOWN through WM_XBUTTONDBLCLK
+    MouseWheel = 1 << 2,  // WM_MOUSEWHEEL and WM_MOUSEHWHEEL
+    Key = 1 << 3,         // WM_KEYDOWN, WM_KEYUP, WM_SYSKEYDOWN and WM_SYSKEYUP
+    Char = 1 << 4,        // WM_CHAR and WM_SYSCHAR
+    All = MouseMove | MouseButton | MouseWheel | Key | Char
+};
+ENUM_CLASS_FLAGS(EWindowsInputEventTypes)
+
+/**
+ * Mouse buttons reported by FWindowsMouseButtonEvent.
+ */
+enum class EWindowsMouseButton : uint8
+{
+    None,
+    Left,
+    Right,
+    Middle,
+    X1,
+    X2
+};
+
+/**
+ * A decoded WM_MOUSEMOVE.
+ */
+struct FWindowsMouseMoveEvent
+{
+    uint64 Hwnd = 0;      // Handle to the window, stored as an integer
+    uint64 Timestamp = 0; // FPlatformTime::Cycles64() when the message arrived
+    int16 X = 0;          // Cursor x in client coordinates
+    int16 Y = 0;          // Cursor y in client coordinates
+    uint16 Modifiers = 0; // MK_* flags of the buttons and modifier keys held down
+};
+
+/**
+ * A decoded mouse button press, release or double click.
+ */
+struct FWindowsMouseButtonEvent
+{
+    uint64 Hwnd = 0;                                         // Handle to the window, stored as an integer
+    uint64 Timestamp = 0;                                    // FPlatformTime::Cycles64() when the message arrived
+    int16 X = 0;                                             // Cursor x in client coordinates
+    int16 Y = 0;                                             // Cursor y in client coordinates
+    uint16 Modifiers = 0;                                    // MK_* flags of the buttons and modifier keys held down
+    EWindowsMouseButton Button = EWindowsMouseButton::None;  // The button that changed
+    bool bDown = false;                                      // True for presses and double clicks
+    bool bDoubleClick = false;                               // True for WM_*BUTTONDBLCLK
+};
+
+/**
+ * A decoded WM_MOUSEWHEEL or WM_MOUSEHWHEEL.
+ */
+struct FWindowsWheelEvent
+{
+    uint64 Hwnd = 0;          // Handle to the window, stored as an integer
+    uint64 Timestamp = 0;     // FPlatformTime::Cycles64() when the message arrived
+    int16 X = 0;              // Cursor x in screen coordinates
+    int16 Y = 0;              // Cursor y in screen coordinates
+    int16 Delta = 0;          // Wheel rotation in multiples of WHEEL_DELTA (120)
+    uint16 Modifiers = 0;     // MK_* flags of the buttons and modifier keys held down
+    bool bHorizontal = false; // True for WM_MOUSEHWHEEL
+};
+
+/**
+ * A decoded key press or release.
+ */
+struct FWindowsKeyEvent
+{
+    uint64 Hwnd = 0;        // Handle to the window, stored as an integer
+    uint64 Timestamp = 0;   // FPlatformTime::Cycles64() when the message arrived
+    uint16 VirtualKey = 0;  // VK_* code of the key
+    uint16 RepeatCount = 0; // Number of auto-repeats folded into the message
+    uint8 ScanCode = 0;     // OEM scan code of the key
+    bool bExtended = false; // True for extended keys such as the right-hand Alt and Ctrl
+    bool bDown = false;     // True for presses
+    bool bRepeat = false;   // True if the key was already down before this press
+    bool bSystem = false;   // True for WM_SYSKEYDOWN and WM_SYSKEYUP
+};
+
+/**
+ * A decoded WM_CHAR or WM_SYSCHAR.
+ */
+struct FWindowsCharEvent
+{
+    uint64 Hwnd = 0;        // Handle to the window, stored as an integer
+    uint64 Timestamp = 0;   // FPlatformTime::Cycles64() when the message arrived
+    uint32 Character = 0;   // UTF-16 code unit of the character
+    uint16 RepeatCount = 0; // Number of auto-repeats folded into the message
+    bool bSystem = false;   // True for WM_SYSCHAR
+};
+
+/**
+ * Decoded events of one batch, one contiguous array per event type.
+ */
+struct FWindowsInputEventFrame
+{
+    TArray<FWindowsMouseMoveEvent> MouseMoves;
+    TArray<FWindowsMouseButtonEvent> MouseButtons;
+    TArray<FWindowsWheelEvent> Wheels;
+    TArray<FWindowsKeyEvent> Keys;
+    TArray<FWindowsCharEvent> Chars;
+
+    /** Removes every event, keeping the storage. */
+    void Reset()
+    {
+        MouseMoves.Reset();
+        MouseButtons.Reset();
+        Wheels.Reset();
+        Keys.Reset();
+        Chars.Reset();
+    }
+
+    /** @return The number of events of every type. */
+    int32 Num() const
+    {
+        return MouseMoves.Num() + MouseButtons.Num() + Wheels.Num() + Keys.Num() + Chars.Num();
+    }
+};
+
+/**
+ * Decoded events of one batch as seen by handlers, whether they are stored in a frame arena or in an FWindowsInputEventFrame.
+ */
+struct FWindowsInputEventViews
+{
+    TArrayView<const FWindowsMouseMoveEvent> MouseMoves;
+    TArrayView<const FWindowsMouseButtonEvent> MouseButtons;
+    TArrayView<const FWindowsWheelEvent> Wheels;
+    TArrayView<const FWindowsKeyEvent> Keys;
+    TArrayView<const FWindowsCharEvent> Chars;
+
+    /** @return The number of events of every type. */
+    int32 Num() const
+    {
+        return MouseMoves.Num() + MouseButtons.Num() + Wheels.Num() + Keys.Num() + Chars.Num();
+    }
+};
+
+/**
+ * FWindowsInputEventDecoder
+ * Pure, table-driven decoders from raw messages to typed input events. They use plain message codes
+ * and bit layouts, so they behave the same on every platform.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsInputEventDecoder
+{
+public:
+    /**
+     * Retrieves the event type a message decodes to.
+     * @param MsgCode - The message code.
+     * @return The event type, or None if the message is not a decoded input message.
+     */
+    static EWindowsInputEventTypes GetEventType(uint32 MsgCode);
+
+    /** Decodes a WM_MOUSEMOVE. @return False if the message is not a mouse move. */
+    static bool DecodeMouseMove(const FWindowsMessageRecord& Record, FWindowsMouseMoveEvent& OutEvent);
+
+    /** Decodes a mouse button message. @return False if the message is not a mouse button message. */
+    static bool DecodeMouseButton(const FWindowsMessageRecord& Record, FWindowsMouseButtonEvent& OutEvent);
+
+    /** Decodes a mouse wheel message. @return False if the message is not a mouse wheel message. */
+    static bool DecodeWheel(const FWindowsMessageRecord& Record, FWindowsWheelEvent& OutEvent);
+
+    /** Decodes a key message. @return False if the message is not a key message. */
+    static bool DecodeKey(const FWindowsMessageRecord& Record, FWindowsKeyEvent& OutEvent);
+
+    /** Decodes a character message. @return False if the message is not a character message. */
+    static bool DecodeChar(const FWindowsMessageRecord& Record, FWindowsCharEvent& OutEvent);
+
+    /**
+     * Decodes a message into the array of its event type, if that type is wanted.
+     * @param Record - The message.
+     * @param Types - The event types to decode; others are skipped.
+     * @param Frame - The frame to append to.
+     * @return The type of the appended event, or None if nothing was appended.
+     */
+    static EWindowsInputEventTypes Decode(const FWindowsMessageRecord& Record, EWindowsInputEventTypes Types, FWindowsInputEventFrame& Frame);
+};
+
+/**
+ * IWindowsInputEventHandler
+ * Interface for handlers of decoded input events. Each function receives every event of its type
+ * from one batch at once, and is only called for the types the handler subscribed to.
+ */
+class IWindowsInputEventHandler
+{
+public:
+    virtual ~IWindowsInputEventHandler() {}
+
+    virtual void OnMouseMoveEvents(TArrayView<const FWindowsMouseMoveEvent> Events) {}
+    virtual void OnMouseButtonEvents(TArrayView<const FWindowsMouseButtonEvent> Events) {}
+    virtual void OnWheelEvents(TArrayView<const FWindowsWheelEvent> Events) {}
+    virtual void OnKeyEvents(TArrayView<const FWindowsKeyEvent> Events) {}
+    virtual void OnCharEvents(TArrayView<const FWindowsCharEvent> Events) {}
+};
+
+/**
+ * FWindowsInputEventRouter
+ * A batch handler that decodes each input message once into per-type event arrays and delivers
+ * each array to the handlers subscribed to its type. Register it with
+ * FWindowsMessageDispatcher::AddBatchHandler; with message batching enabled, events arrive once per frame.
+ * Given a frame arena, the event arrays are carved from it at their exact size instead of living in reused heap arrays.
+ *
+ * Handlers may be added or removed from any thread, including from inside a handler; removal from
+ * another thread waits for a delivery in progress to finish.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsInputEventRouter
+{
+public:
+    /**
+     * Adds a handler, or replaces the event types of an existing one.
+     * @param Handler - The handler to add.
+     * @param Types - The event types the handler subscribes to.
+     */
+    void AddHandler(IWindowsInputEventHandler* Handler, EWindowsInputEventTypes Types);
+
+    /**
+     * Removes a handler.
+     * @param Handler - The handler to remove.
+     * @return True if the handler was registered.
+     */
+    bool RemoveHandler(IWindowsInputEventHandler* Handler);
+
+    /**
+     * Removes all handlers.
+     */
+    void RemoveAllHandlers();
+
+    /**
+     * Sets the frame arena decoded events are allocated from. Must be called from the thread that dispatches messages.
+     * @param InFrameArena - The arena, which must outlive its use here, or nullptr to decode into arrays owned by the router.
+     */
+    void SetFrameArena(FWindowsMessageFrameArena* InFrameArena);
+
+    /**
+     * Decodes a batch of messages and delivers the events.
+     * @param Batch - The messages.
+     */
+    void ProcessMessages(const FWindowsMessageBatchView& Batch);
+
+    /**
+     * Retrieves the events decoded from the most recent batch. Only valid on the thread that dispatches messages,
+     * and, with a frame arena, only until the arena is reset.
+     */
+    const FWindowsInputEventViews& GetEvents() const { return EventViews; }
+
+private:
+
+    struct FSubscriber
+    {
+        IWindowsInputEventHandler* Handler = nullptr; // The handler; nullptr once removed during a delivery
+        EWindowsInputEventTypes Types = EWindowsInputEventTypes::None; // The event types it receives
+    };
+
+    /**
+     * Recomputes SubscribedTypes and, outside of a delivery, drops removed subscribers. The caller must hold Lock.
+     */
+    void UpdateSubscriptions();
+
+    /**
+     * Decodes a batch into exactly-sized arrays allocated from FrameArena. The caller must hold Lock.
+     */
+    void DecodeIntoArena(const FWindowsMessageBatchView& Batch);
+
+    TArray<FSubscriber> Subscribers;                                     // Registered handlers, in registration order; guarded by Lock
+    EWindowsInputEventTypes SubscribedTypes = EWindowsInputEventTypes::None; // Union of the subscribed types, so unwanted messages are never decoded
+    bool bDelivering = false;                                            // Whether Subscribers is being iterated
+    FCriticalSection Lock;                                               // Held for registration changes and for each delivery
+    FWindowsInputEventFrame Events;                                      // Events of the most recent batch, when there is no frame arena
+    FWindowsInputEventViews EventViews;                                  // Events of the most recent batch, in Events or in FrameArena
+    FWindowsMessageFrameArena* FrameArena = nullptr;                     // Arena the events are allocated from, if any; guarded by Lock
+};
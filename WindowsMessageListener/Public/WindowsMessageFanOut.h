@@ -0,0 +1,158 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares FWindowsMessageFanOut, a broadcast ring that hands every message to several worker threads.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageRecord.h"
+#include "HAL/Runnable.h"
+
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+
+/**
+ * The thread that calls a handler.
+ */
+enum class EWindowsMessageHandlerThread : uint8
+{
+    Pump,  // The thread that dispatches messages; the handler may consume messages. The default
+    Worker // A parallel dispatch worker; the handler must be thread-safe, and its return value is ignored
+};
+
+/**
+ * Snapshot of a fan-out's counters.
+ */
+struct FWindowsMessageFanOutCounters
+{
+    uint64 Published = 0;     // Messages written to the ring
+    uint64 Dropped = 0;       // Messages lost because the ring was full and the producer does not wait
+    uint64 Waits = 0;         // Times the producer found the ring full and waited for the slowest worker
+    uint32 HighWaterMark = 0; // Largest number of messages published but not yet consumed by every worker
+    TArray<uint64> Consumed;  // Messages each worker has finished with
+};
+
+/**
+ * Receives a run of consecutive messages on a worker thread.
+ */
+using FWindowsMessageFanOutConsumer = TFunction<void(int32 WorkerIndex, TArrayView<const FWindowsMessageRecord> Records)>;
+
+/**
+ * FWindowsMessageFanOut
+ * A single-producer broadcast ring in the style of the LMAX Disruptor. The producer copies each message into
+ * the ring once and publishes a cursor; every worker thread follows the cursor with its own sequence and hands
+ * each run of new messages to the consumer, so every worker sees every message, in order, at its own pace.
+ * The producer only reads the workers' sequences when its cached view of the slowest one says the ring is full.
+ *
+ * Idle workers spin briefly, then sleep until the producer publishes. Write, Publish, WaitUntilConsumed and
+ * Stop must be called from the producer thread.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageFanOut
+{
+public:
+    static constexpr int32 MaxWorkers = 16;
+
+    /**
+     * Allocates the ring and starts the worker threads.
+     * @param NumWorkers - Number of worker threads; clamped to 1..MaxWorkers.
+     * @param Capacity - Number of messages the ring can hold; rounded up to a power of two.
+     * @param bInWaitWhenFull - True to wait for the slowest worker when the ring is full; false to drop the message.
+     * @param InConsumer - Called on each worker thread with every run of messages it has not seen yet.
+     */
+    FWindowsMessageFanOut(int32 NumWorkers, uint32 Capacity, bool bInWaitWhenFull, FWindowsMessageFanOutConsumer InConsumer);
+    ~FWindowsMessageFanOut();
+
+    FWindowsMessageFanOut(const FWindowsMessageFanOut&) = delete;
+    FWindowsMessageFanOut& operator=(const FWindowsMessageFanOut&) = delete;
+
+    /**
+     * Copies a message into the ring. Workers do not see it until the next Publish.
+     * @param Record - The message.
+     * @return False if the ring was full and the message was dropped.
+     */
+    FORCEINLINE bool Write(const FWindowsMessageRecord& Record)
+    {
+        if (NextSequence - CachedGatingSequence > IndexMask && !WaitForSlot())
+        {
+            return false;
+        }
+        Slots[NextSequence & IndexMask] = Record;
+        ++NextSequence;
+        return true;
+    }
+
+    /**
+     * Makes every written message visible to the workers, waking those that sleep.
+     */
+    void Publish();
+
+    /**
+     * Publishes, then blocks until every worker has finished with every published message.
+     */
+    void WaitUntilConsumed();
+
+    /**
+     * Publishes, lets the workers finish every published message, and joins them. Called by the destructor.
+     */
+    void Stop();
+
+    /** @return The number of worker threads. */
+    int32 GetNumWorkers() const { return Workers.Num(); }
+
+    /**
+     * @return A snapshot of the counters; safe to call from any thread.
+     */
+    FWindowsMessageFanOutCounters GetCounters() const;
+
+private:
+
+    /**
+     * A worker thread and the sequence it has consumed up to.
+     */
+    class FWorker : public FRunnable
+    {
+    public:
+        FWorker(FWindowsMessageFanOut& InOwner, int32 InIndex) : Owner(InOwner), Index(InIndex) {}
+
+        virtual uint32 Run() override;
+
+        alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> Sequence{0}; // Next message to consume; everything before it may be overwritten
+        std::atomic<bool> bSleeping{false};                                 // Set while waiting on WakeEvent, so the producer knows to trigger it
+        FWindowsMessageFanOut& Owner;
+        int32 Index = 0;
+        FEvent* WakeEvent = nullptr;                                        // Triggered by Publish and Stop
+        FRunnableThread* Thread = nullptr;
+    };
+
+    /**
+     * Refreshes the cached gating sequence and, if the ring is still full, waits or drops.
+     * @return True once a slot is free.
+     */
+    bool WaitForSlot();
+
+    /**
+     * @return The sequence of the slowest worker.
+     */
+    uint64 GetGatingSequence() const;
+
+    TArray<FWindowsMessageRecord> Slots;              // Message storage, a power of two in size
+    uint64 IndexMask = 0;                             // Capacity - 1
+    bool bWaitWhenFull = true;                        // Whether a full ring blocks the producer
+    FWindowsMessageFanOutConsumer Consumer;           // Called by the workers
+    TArray<TUniquePtr<FWorker>> Workers;              // One per worker thread
+
+    uint64 NextSequence = 0;                          // Producer only: next slot to write
+    uint64 CachedGatingSequence = 0;                  // Producer only: the slowest worker's sequence, when last read
+    uint64 PublishedSequence = 0;                     // Producer only: the last value stored in Cursor
+
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> Cursor{0}; // Messages before this sequence are visible to workers
+    std::atomic<bool> bStopping{false};               // Asks the workers to exit once they have caught up
+
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> Dropped{0};
+    std::atomic<uint64> Waits{0};
+    std::atomic<uint32> HighWaterMark{0};
+};
@@ -0,0 +1,123 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares the FWindowsMessageFilter class, which stores the set of allowed message codes.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * FWindowsMessageFilter
+ * Allow-list of message codes backed by a flat bitmap covering the 16-bit message space.
+ * Codes above 0xFFFF never come from the OS, so they fall back to a hashed set.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageFilter
+{
+public:
+    static constexpr uint32 NumBitmapCodes = 0x10000;          // Codes covered by the bitmap
+    static constexpr uint32 NumBitmapWords = NumBitmapCodes / 64; // 8 KB of 64-bit words
+
+    FWindowsMessageFilter();
+
+    /**
+     * Checks if a message code is allowed.
+     * @param MsgCode - The message code to check.
+     * @return True if the message code is allowed.
+     */
+    FORCEINLINE bool IsAllowed(uint32 MsgCode) const
+    {
+        if (MsgCode < NumBitmapCodes)
+        {
+            return ((Words[MsgCode >> 6] >> (MsgCode & 63)) & 1) != 0;
+        }
+        return OverflowCodes.Contains(MsgCode);
+    }
+
+    /**
+     * Allows a single message code.
+     * @param MsgCode - The message code to allow.
+     */
+    void Allow(uint32 MsgCode);
+
+    /**
+     * Disallows a single message code.
+     * @param MsgCode - The message code to disallow.
+     */
+    void Disallow(uint32 MsgCode);
+
+    /**
+     * Allows an inclusive range of message codes within the 16-bit message space.
+     * @param FirstMsgCode - The first message code of the range.
+     * @param LastMsgCode - The last message code of the range; clamped to 0xFFFF.
+     */
+    void AllowRange(uint32 FirstMsgCode, uint32 LastMsgCode);
+
+    /**
+     * Disallows an inclusive range of message codes within the 16-bit message space.
+     * @param FirstMsgCode - The first message code of the range.
+     * @param LastMsgCode - The last message code of the range; clamped to 0xFFFF.
+     */
+    void DisallowRange(uint32 FirstMsgCode, uint32 LastMsgCode);
+
+    /**
+     * Allows every message code that another filter allows.
+     * @param Other - The filter to merge into this one.
+     */
+    void Merge(const FWindowsMessageFilter& Other);
+
+    /**
+     * Disallows every message code.
+     */
+    void Reset();
+
+    /**
+     * Checks if no message code is allowed.
+     * @return True if the filter blocks every message.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * Counts the allowed message codes.
+     * @return The number of allowed codes.
+     */
+    int32 Num() const;
+
+    /**
+     * Calls a function for every allowed message code, bitmap codes first in ascending order.
+     * @param Visit - Callable taking a uint32 message code.
+     */
+    template<typename FuncType>
+    void ForEachAllowed(FuncType&& Visit) const
+    {
+        for (uint32 WordIndex = 0; WordIndex < NumBitmapWords; ++WordIndex)
+        {
+            for (uint64 Word = Words[WordIndex]; Word != 0; Word &= Word - 1)
+            {
+                Visit((WordIndex << 6) | static_cast<uint32>(FMath::CountTrailingZeros64(Word)));
+            }
+        }
+        for (uint32 MsgCode : OverflowCodes)
+        {
+            Visit(MsgCode);
+        }
+    }
+
+    /**
+     * Saves or loads the filter: only the non-zero bitmap words are stored, so a typical filter takes a few dozen bytes.
+     * A load replaces the filter and sets the archive's error flag if the data is malformed.
+     * @param Ar - The archive to save to or load from.
+     */
+    void Serialize(FArchive& Ar);
+
+private:
+
+    /**
+     * Sets or clears the bits of an inclusive code range, a whole word at a time.
+     */
+    void SetRangeBits(uint32 FirstMsgCode, uint32 LastMsgCode, bool bAllowed);
+
+    uint64 Words[NumBitmapWords]; // One bit per code in [0, 0xFFFF]
+    TSet<uint32> OverflowCodes;   // Allowed codes above 0xFFFF
+};
@@ -0,0 +1,245 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares FWindowsMessageLatencyTracker, which measures how long messages take from arrival to handler completion.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageRecord.h"
+
+#include <atomic>
+
+/**
+ * A span of a message's path through the dispatcher.
+ */
+enum class EWindowsMessageLatencyStage : uint8
+{
+    Queue,    // Arrival to the start of dispatch: coalescing and deferred queueing
+    Handlers, // Start of dispatch to the return of the last handler
+    Total,    // Arrival to the return of the last handler
+    System,   // GetMessageTime() to the return of the last handler; millisecond resolution, only with a system clock
+    Num
+};
+
+/**
+ * FWindowsMessageLatencyHistogram
+ * A log-linear histogram of cycle counts in fixed storage, in the style of HdrHistogram: values are bucketed
+ * by power of two and then into 16 linear sub-buckets, so every recorded value is known to within 1/16th.
+ * Safe to add to from any thread.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageLatencyHistogram
+{
+public:
+    static constexpr int32 SubBucketBits = 4;
+    static constexpr int32 NumSubBuckets = 1 << SubBucketBits;
+    static constexpr int32 MaxExponent = 40; // Values of 2^41 cycles and above share the last bucket
+    static constexpr int32 NumBuckets = NumSubBuckets + (MaxExponent - SubBucketBits + 1) * NumSubBuckets;
+
+    FORCEINLINE void Add(uint64 Value)
+    {
+        Buckets[GetBucketIndex(Value)].fetch_add(1, std::memory_order_relaxed);
+        Count.fetch_add(1, std::memory_order_relaxed);
+        uint64 Previous = Max.load(std::memory_order_relaxed);
+        while (Value > Previous && !Max.compare_exchange_weak(Previous, Value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /**
+     * Adds every value of another histogram to this one.
+     */
+    void Merge(const FWindowsMessageLatencyHistogram& Other);
+
+    /**
+     * Finds the value below which a share of the recorded values fall.
+     * @param Percentile - The share, from 0 to 100.
+     * @return The highest value of the bucket holding the percentile, capped to the largest value recorded; 0 if empty.
+     */
+    uint64 GetValueAtPercentile(double Percentile) const;
+
+    /** @return The number of values recorded. */
+    uint64 GetCount() const { return Count.load(std::memory_order_relaxed); }
+
+    /** @return The largest value recorded. */
+    uint64 GetMax() const { return Max.load(std::memory_order_relaxed); }
+
+    /** Zeroes every bucket. */
+    void Reset();
+
+    static FORCEINLINE int32 GetBucketIndex(uint64 Value)
+    {
+        if (Value < NumSubBuckets)
+        {
+            return static_cast<int32>(Value);
+        }
+        const int32 Exponent = FMath::Min<int32>(FMath::FloorLog2_64(Value), MaxExponent);
+        const int32 Shift = Exponent - SubBucketBits;
+        const uint64 SubBucket = FMath::Min<uint64>((Value >> Shift) - NumSubBuckets, NumSubBuckets - 1);
+        return NumSubBuckets + Shift * NumSubBuckets + static_cast<int32>(SubBucket);
+    }
+
+    /** @return The highest value that falls into a bucket. */
+    static uint64 GetBucketUpperBound(int32 BucketIndex);
+
+private:
+    std::atomic<uint64> Buckets[NumBuckets] = {};
+    std::atomic<uint64> Count{0};
+    std::atomic<uint64> Max{0};
+};
+
+/**
+ * The path of one message through the dispatcher, kept for spike reports.
+ */
+struct FWindowsMessageLatencyTimeline
+{
+    uint64 Hwnd = 0;           // Handle to the window, stored as an integer
+    uint32 Msg = 0;            // The message identifier
+    uint32 MessageTime = 0;    // GetMessageTime() when the message arrived; 0 if unknown
+    uint64 ArrivalCycles = 0;  // FPlatformTime::Cycles64() when the message arrived
+    uint64 DispatchCycles = 0; // When dispatch started
+    uint64 CompleteCycles = 0; // When the last handler returned
+    uint32 SystemAgeMs = 0;    // Milliseconds from MessageTime to completion, on the system clock; 0 if unknown
+};
+
+/**
+ * Latency percentiles of one stage, in seconds.
+ */
+struct FWindowsMessageLatencyPercentiles
+{
+    uint64 Count = 0; // Messages measured
+    double P50 = 0.0;
+    double P99 = 0.0;
+    double P999 = 0.0;
+    double Max = 0.0;
+};
+
+/**
+ * Latency of one message code, or of every code.
+ */
+struct FWindowsMessageLatencyCodeStats
+{
+    uint32 MsgCode = 0;    // The message code
+    bool bOther = false;   // True for codes measured together once every tracked slot was taken, and for the all-codes entry
+    FWindowsMessageLatencyPercentiles Stages[static_cast<int32>(EWindowsMessageLatencyStage::Num)]; // Indexed by EWindowsMessageLatencyStage
+
+    const FWindowsMessageLatencyPercentiles& operator[](EWindowsMessageLatencyStage Stage) const { return Stages[static_cast<int32>(Stage)]; }
+};
+
+/**
+ * Snapshot of a latency tracker.
+ */
+struct FWindowsMessageLatencyStats
+{
+    FWindowsMessageLatencyCodeStats AllCodes;            // Every measured message
+    TArray<FWindowsMessageLatencyCodeStats> MessageCodes; // Tracked codes with at least one message, in ascending code order, then the shared slot
+    uint64 Spikes = 0;                                   // Messages whose total latency crossed the spike threshold
+    uint64 Reports = 0;                                  // Spikes reported to the sink; others fell within a report's quiet period
+};
+
+/**
+ * Receives the recent timelines, oldest first, when a message crosses the spike threshold; the last one is the spike.
+ */
+using FWindowsMessageLatencySpikeSink = TFunction<void(TArrayView<const FWindowsMessageLatencyTimeline> Timelines)>;
+
+/**
+ * FWindowsMessageLatencyTracker
+ * Measures every dispatched message from its arrival timestamp, and optionally from its GetMessageTime(),
+ * to the return of its last handler. Per-code percentiles are kept in lock-free histograms preallocated for
+ * a fixed number of codes, and the most recent timelines are kept in a ring. When a message's total latency
+ * crosses the spike threshold, the ring is reported so the messages leading up to the spike can be inspected.
+ *
+ * Add must be called from the thread that dispatches messages; GetStats may be called from any thread.
+ * Messages without an arrival timestamp are ignored.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageLatencyTracker
+{
+public:
+    static constexpr int32 MaxTrackedCodesLimit = 254;
+
+    /**
+     * Preallocates every histogram and the timeline ring, so measuring never allocates.
+     * @param MaxTrackedCodes - Codes that get their own histograms, in order of first arrival; later codes share one slot.
+     * @param TimelineCapacity - Number of recent timelines kept for spike reports.
+     */
+    FWindowsMessageLatencyTracker(int32 MaxTrackedCodes = 32, int32 TimelineCapacity = 256);
+    ~FWindowsMessageLatencyTracker();
+
+    /**
+     * Measures a dispatched message.
+     * @param Record - The message; its Timestamp is the arrival time.
+     * @param DispatchCycles - FPlatformTime::Cycles64() when dispatch started.
+     * @param CompleteCycles - FPlatformTime::Cycles64() when the last handler returned.
+     */
+    void Add(const FWindowsMessageRecord& Record, uint64 DispatchCycles, uint64 CompleteCycles);
+
+    /**
+     * Sets the total latency that triggers a spike report.
+     * @param Seconds - The threshold; 0 disables spike reports.
+     * @param MinSecondsBetweenReports - Spikes closer together than this are counted but not reported.
+     */
+    void SetSpikeThreshold(double Seconds, double MinSecondsBetweenReports = 1.0);
+
+    /**
+     * Sets where spike reports go. Must not be called while messages are being dispatched.
+     * @param InSink - The sink, or an unbound function to write reports to the output log.
+     */
+    void SetSpikeSink(FWindowsMessageLatencySpikeSink InSink);
+
+    /**
+     * Sets the clock GetMessageTime() values are read against, enabling the System stage.
+     * @param InClock - Returns the current time in milliseconds on the same clock, such as GetTickCount; nullptr to disable.
+     */
+    void SetSystemClock(uint32 (*InClock)());
+
+    /**
+     * Computes the percentiles of every stage.
+     */
+    FWindowsMessageLatencyStats GetStats() const;
+
+    /**
+     * Zeroes every histogram and forgets the tracked codes. Must be called from the thread that dispatches messages.
+     */
+    void Reset();
+
+    /**
+     * Formats a timeline as one log line.
+     */
+    static FString FormatTimeline(const FWindowsMessageLatencyTimeline& Timeline);
+
+private:
+    static constexpr int32 NumStages = static_cast<int32>(EWindowsMessageLatencyStage::Num);
+    static constexpr int32 NumCodeSlots = 0x10000; // Codes above 0xFFFF always share the Other slot
+
+    struct FCodeHistograms
+    {
+        std::atomic<uint32> MsgCode{0};
+        FWindowsMessageLatencyHistogram Stages[NumStages];
+    };
+
+    /**
+     * Finds or claims the histograms of a code.
+     */
+    FCodeHistograms& FindHistograms(uint32 MsgCode);
+
+    /**
+     * Copies the timeline ring, oldest first, and hands it to the sink.
+     */
+    void ReportSpike();
+
+    TArray<uint8> CodeSlots;                      // Index into Histograms per code; 0 if the code has no histograms of its own yet
+    TArray<TUniquePtr<FCodeHistograms>> Histograms; // Index 0 is the Other slot, shared once every other slot is taken
+    std::atomic<int32> NumClaimedCodes{0};        // Histograms after the Other slot that have been handed to a code
+    TArray<FWindowsMessageLatencyTimeline> Timelines; // Ring of the most recent timelines
+    TArray<FWindowsMessageLatencyTimeline> Report; // Preallocated copy of Timelines, oldest first, handed to the sink
+    uint64 NumTimelines = 0;                      // Timelines written; the next goes to NumTimelines % Timelines.Num()
+    uint64 SpikeThresholdCycles = 0;              // Total latency that triggers a report; 0 for never
+    uint64 MinCyclesBetweenReports = 0;           // Quiet period after a report
+    uint64 LastReportCycles = 0;                  // When the last report was made
+    double CyclesPerMillisecond = 0.0;            // Scale of the System stage
+    uint32 (*SystemClock)() = nullptr;            // Clock MessageTime is read against
+    FWindowsMessageLatencySpikeSink Sink;         // Where reports go; the output log if unbound
+    std::atomic<uint64> NumSpikes{0};
+    std::atomic<uint64> NumReported{0};
+};
@@ -7,12 +7,38 @@
 #pragma once
 
 #include "CoreMinimal.h"
+
+#if PLATFORM_WINDOWS
+
 #include "Windows/WindowsApplication.h"
 #include "Framework/Application/SlateApplication.h"
+#include "WindowsMessageDispatcher.h"
+#include "WindowsMessageListenerState.h"
+#include "WindowsMessageEvents.h"
+#include "WindowsRawInput.h"
+
+#include <initializer_list>
+
+class FWindowsMessageListenerHub;
+
+/**
+ * How a listener registers with FWindowsApplication.
+ */
+enum class EWindowsMessageListenerRegistration : uint8
+{
+    Shared, // Attach to the module's hub, which is registered once for every shared listener and filters each message once
+    Direct  // Register this listener as its own message handler, so it sees every message FWindowsApplication receives
+};
 
 /**
  * FWindowsMessageListener
  * Handles Windows messages and forwards them to registered message processors.
+ * Filtering, coalescing, queuing and fan-out are done by a platform-independent FWindowsMessageDispatcher;
+ * this class adapts it to FWindowsApplication and IWindowsMessageHandler.
+ *
+ * Handlers may be added or removed from any thread, including from inside a handler.
+ * RemoveMessageHandler waits for a worker thread that may still be inside a removed worker handler, but not for
+ * a call running on the thread that pumps messages.
  */
 class WINDOWSMESSAGELISTENER_API FWindowsMessageListener : public IWindowsMessageHandler
 {
@@ -46,21 +72,162 @@ public:
     void AddMessageHandler(IWindowsMessageHandler* handler);
 
     /**
-     * Removes a message handler.
+     * Adds a message handler that only receives the given message codes.
+     * Adding the same handler again merges the new codes into its subscription.
+     * @param handler - The message handler to add.
+     * @param MsgCodes - The message codes the handler subscribes to.
+     */
+    void AddMessageHandler(IWindowsMessageHandler* handler, std::initializer_list<uint32> MsgCodes);
+
+    /**
+     * Adds a message handler that only receives the given message codes.
+     * @param handler - The message handler to add.
+     * @param MsgCodes - The message codes the handler subscribes to.
+     */
+    void AddMessageHandler(IWindowsMessageHandler* handler, TArrayView<const uint32> MsgCodes);
+
+    /**
+     * Adds a message handler that only receives message codes in an inclusive range.
+     * @param handler - The message handler to add.
+     * @param FirstMsgCode - The first message code of the range.
+     * @param LastMsgCode - The last message code of the range.
+     */
+    void AddMessageHandlerForRange(IWindowsMessageHandler* handler, uint32 FirstMsgCode, uint32 LastMsgCode);
+
+    /**
+     * Adds a message handler that only receives messages for one window.
+     * Bindings are dropped automatically when the window sends WM_DESTROY, or when a new window reuses the handle.
+     * @param handler - The message handler to add.
+     * @param hwnd - The window the handler is bound to.
+     */
+    void AddWindowMessageHandler(IWindowsMessageHandler* handler, HWND hwnd);
+
+    /**
+     * Adds a message handler that only receives the given message codes for one window.
+     * @param handler - The message handler to add.
+     * @param hwnd - The window the handler is bound to.
+     * @param MsgCodes - The message codes the handler subscribes to.
+     */
+    void AddWindowMessageHandler(IWindowsMessageHandler* handler, HWND hwnd, std::initializer_list<uint32> MsgCodes);
+
+    /**
+     * Adds a message handler that only receives messages for the native window of a Slate window.
+     * @param handler - The message handler to add.
+     * @param Window - The Slate window; its native window must already exist.
+     * @return True if the handler was bound to the native window.
+     */
+    bool AddWindowMessageHandler(IWindowsMessageHandler* handler, const TSharedRef<SWindow>& Window);
+
+    /**
+     * Removes every handler bound to a window. Handlers that receive messages for all windows are kept.
+     * @param hwnd - The window handle.
+     */
+    void RemoveWindowMessageHandlers(HWND hwnd);
+
+    /**
+     * Sets the priority of a registered handler. Handlers with a higher priority receive messages first;
+     * handlers with equal priority keep their registration order. Handlers are registered with priority 0.
+     * @param handler - The registered message handler.
+     * @param Priority - The new priority.
+     * @return True if the handler is registered.
+     */
+    bool SetMessageHandlerPriority(IWindowsMessageHandler* handler, int32 Priority);
+
+    /**
+     * Replaces the rule set that handlers bind to with SetMessageHandlerRule. Safe to call while messages
+     * are being dispatched; the new rules apply from the next message.
+     * @param Rules - The compiled rules, or nullptr to remove them.
+     */
+    void SetMessageRules(TSharedPtr<const FWindowsMessageRuleSet> Rules);
+
+    /**
+     * Compiles the rules of a config section and makes them the current rule set. Rules that fail to
+     * compile are logged and left out, so handlers bound to them receive nothing.
+     * @param Section - The config section, holding "+Rule=Name: expression" entries.
+     * @param Filename - The config file, such as GGameIni.
+     * @return The number of rules compiled.
+     */
+    int32 LoadMessageRules(const TCHAR* Section, const FString& Filename);
+
+    /**
+     * Binds a registered handler to a rule of the current rule set, so it only receives messages the rule accepts.
+     * @param handler - The registered message handler.
+     * @param RuleName - The rule, or NAME_None to remove the binding.
+     * @return True if the handler is registered.
+     */
+    bool SetMessageHandlerRule(IWindowsMessageHandler* handler, FName RuleName);
+
+    /**
+     * Moves a registered handler to a parallel dispatch worker, or back to the thread that pumps Windows messages.
+     * A worker handler must be thread-safe; it sees every message no pump handler consumed, in order, and cannot consume messages.
+     * Must be called from the thread that pumps Windows messages.
+     * @param handler - The registered message handler.
+     * @param Thread - The thread that calls the handler.
+     * @param PreferredWorker - The worker to pin the handler to; INDEX_NONE to give each handler the next worker in turn.
+     * @return True if the handler is registered.
+     */
+    bool SetMessageHandlerThread(IWindowsMessageHandler* handler, EWindowsMessageHandlerThread Thread, int32 PreferredWorker = INDEX_NONE);
+
+    /**
+     * Sets what happens when a handler returns true from ProcessMessage.
+     * Messages that are coalesced or deferred are never reported as handled, since the window procedure has already returned.
+     * @param Policy - The consumption policy; Ignore by default.
+     */
+    void SetConsumptionPolicy(EWindowsMessageConsumptionPolicy Policy);
+
+    /**
+     * Retrieves the consumption policy.
+     * @return The current consumption policy.
+     */
+    EWindowsMessageConsumptionPolicy GetConsumptionPolicy() const;
+
+    /**
+     * Removes a message handler. If it ran on a parallel dispatch worker, waits until that worker has left it, unless
+     * called from that worker, so the handler can be deleted once this returns.
      * @param handler - The message handler to remove.
      */
     void RemoveMessageHandler(IWindowsMessageHandler* handler);
 
     /**
-     * Removes all message handlers.
+     * Adds a batch handler, which receives every dispatched message that no handler consumed through
+     * a single ProcessMessages call per batch. See EnableMessageBatching.
+     * @param handler - The batch handler to add.
+     */
+    void AddBatchMessageHandler(IWindowsMessageBatchHandler* handler);
+
+    /**
+     * Removes a batch handler.
+     * @param handler - The batch handler to remove.
+     */
+    void RemoveBatchMessageHandler(IWindowsMessageBatchHandler* handler);
+
+    /**
+     * Adds a handler of decoded input events. Each allowed input message is decoded once into compact event
+     * structs, and the handler receives every event of a subscribed type in one call per batch; see EnableMessageBatching.
+     * @param handler - The input event handler to add.
+     * @param EventTypes - The event types the handler subscribes to.
+     */
+    void AddInputEventHandler(IWindowsInputEventHandler* handler, EWindowsInputEventTypes EventTypes = EWindowsInputEventTypes::All);
+
+    /**
+     * Removes a handler of decoded input events.
+     * @param handler - The input event handler to remove.
+     */
+    void RemoveInputEventHandler(IWindowsInputEventHandler* handler);
+
+    /**
+     * Removes all message handlers, batch handlers and input event handlers.
      */
     void RemoveAllMessageHandlers();
 
     /**
      * Starts the message listener.
-     * Use this to begin processing Windows messages.
+     * Use this to begin processing Windows messages. Shared listeners only receive the messages their own allow-list
+     * accepts: the hub filters on their behalf, so other messages are not captured, logged or counted as rejected,
+     * and ShouldProcessMessage is not called. Subclasses that override ShouldProcessMessage should register directly.
+     * @param Registration - Whether to attach to the module's shared hub or register directly.
      */
-    void StartListening();
+    void StartListening(EWindowsMessageListenerRegistration Registration = EWindowsMessageListenerRegistration::Shared);
 
     /**
      * Stops the message listener.
@@ -74,6 +241,12 @@ public:
      */
     bool IsListening() const;
 
+    /**
+     * Checks if the listener is attached to the module's shared hub.
+     * @return True if the listener receives messages through the hub.
+     */
+    bool IsAttachedToHub() const { return Hub != nullptr; }
+
     /**
      * Adds a message type to the allowed list.
      * @param MsgCode - The message code to allow.
@@ -86,6 +259,34 @@ public:
      */
     void RemoveAllowedMessageType(uint32 MsgCode);
 
+    /**
+     * Adds an inclusive range of message types to the allowed list.
+     * Example: AddAllowedMessageRange(WM_KEYFIRST, WM_KEYLAST).
+     * @param FirstMsgCode - The first message code to allow.
+     * @param LastMsgCode - The last message code to allow.
+     */
+    void AddAllowedMessageRange(uint32 FirstMsgCode, uint32 LastMsgCode);
+
+    /**
+     * Removes an inclusive range of message types from the allowed list.
+     * @param FirstMsgCode - The first message code to disallow.
+     * @param LastMsgCode - The last message code to disallow.
+     */
+    void RemoveAllowedMessageRange(uint32 FirstMsgCode, uint32 LastMsgCode);
+
+    /**
+     * Adds several message types to the allowed list, updating the shared filter once.
+     * Example: AddAllowedMessageTypes({ WM_KEYDOWN, WM_KEYUP, WM_CHAR }).
+     * @param MsgCodes - The message codes to allow.
+     */
+    void AddAllowedMessageTypes(TArrayView<const uint32> MsgCodes);
+
+    /**
+     * Removes several message types from the allowed list, updating the shared filter once.
+     * @param MsgCodes - The message codes to disallow.
+     */
+    void RemoveAllowedMessageTypes(TArrayView<const uint32> MsgCodes);
+
     /**
      * Clears all allowed message types.
      */
@@ -110,6 +311,320 @@ public:
      */
     bool IsVerboseLoggingEnabled() const;
 
+    /**
+     * Enables deferred processing. Allowed messages are copied into a lock-free ring instead of
+     * being forwarded to handlers inside the window procedure, and are dispatched when the ring is drained.
+     * Must be called from the thread that pumps Windows messages.
+     * @param Capacity - Number of messages the ring can hold; rounded up to a power of two.
+     * @param OverflowPolicy - What to do with new messages while the ring is full.
+     * @param bDrainOnTick - True to drain the ring from the core ticker on every engine tick.
+     */
+    void EnableDeferredProcessing(uint32 Capacity, EWindowsMessageOverflowPolicy OverflowPolicy, bool bDrainOnTick = true);
+
+    /**
+     * Disables deferred processing, dispatching any messages still queued.
+     * Must be called from the thread that pumps Windows messages.
+     */
+    void DisableDeferredProcessing();
+
+    /**
+     * Checks if deferred processing is enabled.
+     * @return True if allowed messages are queued instead of dispatched immediately.
+     */
+    bool IsDeferredProcessingEnabled() const;
+
+    /**
+     * Dispatches queued messages to handlers. Must only be called from one consumer thread at a time.
+     * @param MaxMessages - Maximum number of messages to dispatch.
+     * @return The number of messages dispatched.
+     */
+    int32 DrainDeferredMessages(int32 MaxMessages = MAX_int32);
+
+    /**
+     * Retrieves the counters of the deferred message ring.
+     * @return The ring counters, or zeroed counters if deferred processing is disabled.
+     */
+    FWindowsMessageRingCounters GetDeferredMessageCounters() const;
+
+    /**
+     * Coalesces a message type: only the newest message per window is kept, and it is forwarded
+     * when pending messages are flushed (once per engine tick, or before a key or mouse button message).
+     * Example: AddCoalescedMessageType(WM_MOUSEMOVE).
+     * @param MsgCode - The message code to coalesce.
+     */
+    void AddCoalescedMessageType(uint32 MsgCode);
+
+    /**
+     * Stops coalescing a message type.
+     * @param MsgCode - The message code to forward immediately again.
+     */
+    void RemoveCoalescedMessageType(uint32 MsgCode);
+
+    /**
+     * Forwards pending coalesced messages to handlers, or to the deferred ring if deferred processing is enabled.
+     * Must be called from the thread that pumps Windows messages.
+     * @return The number of messages forwarded.
+     */
+    int32 FlushCoalescedMessages();
+
+    /**
+     * Retrieves the counters of the coalescing stage.
+     * @return Messages received versus messages delivered for coalesced types.
+     */
+    FWindowsMessageCoalescerCounters GetCoalescerCounters() const;
+
+    /**
+     * Enables message batching. Dispatched messages are collected into a preallocated structure-of-arrays batch
+     * and delivered to batch handlers in one call each, once MaxMessages are collected or once per engine tick.
+     * While batching is disabled, batch handlers receive each message as a batch of one.
+     * Must be called from the thread that dispatches messages.
+     * @param MaxMessages - Number of messages that triggers delivery.
+     * @param bFlushOnTick - True to also deliver a partial batch from the core ticker on every engine tick.
+     */
+    void EnableMessageBatching(int32 MaxMessages, bool bFlushOnTick = true);
+
+    /**
+     * Disables message batching, delivering any messages still collected.
+     */
+    void DisableMessageBatching();
+
+    /**
+     * Checks if message batching is enabled.
+     * @return True if dispatched messages are collected for batch handlers.
+     */
+    bool IsMessageBatchingEnabled() const;
+
+    /**
+     * Delivers the collected messages to batch handlers. Must be called from the thread that dispatches messages.
+     * @return The number of messages delivered.
+     */
+    int32 FlushMessageBatch();
+
+    /**
+     * Enables the frame arena, a bump allocator reset once per engine tick. Handlers can allocate copies of
+     * message records, decoded events, scratch buffers and debug strings from it without touching the heap.
+     * Must be called from the thread that pumps Windows messages.
+     * @param BlockBytes - Size of each arena block; the first block is allocated immediately.
+     */
+    void EnableFrameArena(int32 BlockBytes = 65536);
+
+    /**
+     * Disables the frame arena, freeing its blocks.
+     */
+    void DisableFrameArena();
+
+    /**
+     * Retrieves the frame arena. Only usable from the thread that pumps Windows messages.
+     * @return The frame arena, or nullptr if it is disabled.
+     */
+    FWindowsMessageFrameArena* GetFrameArena();
+
+    /**
+     * Retrieves the counters of the frame arena.
+     * @return Bytes used this frame and heap allocations since the arena was enabled, or zeroed counters if it is disabled.
+     */
+    FWindowsMessageArenaCounters GetFrameArenaCounters() const;
+
+    /**
+     * Enables the message log, a structured log cheap enough for live builds. Messages are picked by a per-code
+     * filter, sampled and rate limited per code, and written by a background thread, so the message pump never
+     * formats a string. Must be called from the thread that pumps Windows messages.
+     * @param Capacity - Number of records buffered for the writer thread; records beyond it are dropped and counted.
+     */
+    void EnableMessageLogging(int32 Capacity = 4096);
+
+    /**
+     * Disables the message log, writing every record still buffered.
+     */
+    void DisableMessageLogging();
+
+    /**
+     * Retrieves the message log, to set its filter and rules. Only usable from the thread that pumps Windows messages.
+     * @return The message log, or nullptr if it is disabled.
+     */
+    FWindowsMessageLogger* GetMessageLogger();
+
+    /**
+     * Retrieves the counters of the message log.
+     * @return Messages considered, sampled out, rate limited, dropped and written, or zeroed counters if it is disabled.
+     */
+    FWindowsMessageLogCounters GetMessageLogCounters() const;
+
+    /**
+     * Enables latency tracking from each message's arrival, and from its GetMessageTime(), to the return of its
+     * last handler, with p50/p99/p999 per code. Must be called from the thread that pumps Windows messages.
+     * @param MaxTrackedCodes - Codes that get their own histograms; later codes share one.
+     * @param TimelineCapacity - Number of recent message timelines reported when a spike occurs.
+     */
+    void EnableLatencyTracking(int32 MaxTrackedCodes = 32, int32 TimelineCapacity = 256);
+
+    /**
+     * Disables latency tracking and discards its histograms.
+     */
+    void DisableLatencyTracking();
+
+    /**
+     * Retrieves the latency tracker, to set its spike threshold and sink. Only usable from the thread that pumps Windows messages.
+     * @return The latency tracker, or nullptr if it is disabled.
+     */
+    FWindowsMessageLatencyTracker* GetLatencyTracker();
+
+    /**
+     * Retrieves latency percentiles per code and per stage, or empty stats if tracking is disabled.
+     */
+    FWindowsMessageLatencyStats GetLatencyStats() const;
+
+    /**
+     * Enables parallel dispatch: each message is copied once into a broadcast ring that worker threads read, and
+     * handlers moved to a worker with SetMessageHandlerThread run there, so their cost is taken off the message pump.
+     * Must be called from the thread that pumps Windows messages.
+     * @param NumWorkers - Number of worker threads.
+     * @param Capacity - Number of messages the ring can hold.
+     * @param bWaitWhenFull - True to make the pump wait for the slowest worker when the ring is full; false to drop the message and count it.
+     */
+    void EnableParallelDispatch(int32 NumWorkers, uint32 Capacity = 4096, bool bWaitWhenFull = true);
+
+    /**
+     * Disables parallel dispatch once the workers have finished every queued message.
+     */
+    void DisableParallelDispatch();
+
+    /**
+     * Retrieves the counters of the broadcast ring.
+     * @return Messages published, dropped and consumed per worker, or zeroed counters if parallel dispatch is disabled.
+     */
+    FWindowsMessageFanOutCounters GetParallelDispatchCounters() const;
+
+    /**
+     * Saves the allow-list, coalesced types, consumption policy and the subscriptions of named handlers to a
+     * compact binary blob, which can be cooked into a project and restored with RestoreState.
+     * Handlers bound to a window, and handlers without a name, are left out.
+     * @param HandlerNames - The name to save each handler under.
+     * @return The saved state.
+     */
+    TArray<uint8> SaveState(const TMap<IWindowsMessageHandler*, FName>& HandlerNames) const;
+
+    /**
+     * Restores a state saved by SaveState in one step: the filter is installed as saved and the dispatch
+     * tables are rebuilt once, without logging each entry. Must be called from the thread that pumps Windows messages.
+     * @param Bytes - The saved state.
+     * @param Handlers - The handler to restore each saved name to; subscriptions of names not in the map are skipped.
+     * @return True if the bytes hold a valid state.
+     */
+    bool RestoreState(TArrayView<const uint8> Bytes, const TMap<FName, IWindowsMessageHandler*>& Handlers);
+
+    /**
+     * Retrieves per-code counters and per-handler timings.
+     * Stats are compiled out when WINDOWS_MESSAGE_LISTENER_STATS is 0 (shipping builds by default); the snapshot is then empty.
+     * @return A snapshot of the stats.
+     */
+    FWindowsMessageStatsSnapshot GetMessageStats() const;
+
+    /**
+     * Zeroes every per-code counter and per-handler timing.
+     */
+    void ResetMessageStats();
+
+    /**
+     * Starts appending every message the listener receives, before filtering, to a compact binary capture file.
+     * Records go through two preallocated buffers written by a background thread, so the message pump never waits on disk.
+     * @param Filename - The capture file; replaced if it exists.
+     * @param BufferRecords - Number of records in each of the two capture buffers.
+     * @return True if the capture file was created.
+     */
+    bool StartCapture(const FString& Filename, int32 BufferRecords = 16384);
+
+    /**
+     * Stops capturing, blocking until buffered records are written.
+     */
+    void StopCapture();
+
+    /**
+     * Checks if messages are being captured.
+     * @return True if a capture is in progress.
+     */
+    bool IsCapturing() const;
+
+    /**
+     * Retrieves the capture counters.
+     * @return Records captured and dropped, or zeroed counters if not capturing.
+     */
+    FWindowsMessageCaptureCounters GetCaptureCounters() const;
+
+    /**
+     * Memory-maps a capture file and feeds it back through the filter and dispatch path of ProcessMessage.
+     * Window handles are replaced by the capture's window ids. Replayed messages are not captured again, their
+     * raw input is not read and they do not unbind window handlers, since those ids are stale.
+     * @param Filename - The capture file.
+     * @param Timing - Whether to reproduce the recorded gaps between messages.
+     * @return The number of messages replayed, or INDEX_NONE if the file is not a valid capture.
+     */
+    int32 ReplayCapture(const FString& Filename, EWindowsMessageReplayTiming Timing);
+
+    /**
+     * Enables raw input ingestion. WM_INPUT payloads are read into a preallocated arena, decoded into
+     * FWindowsRawInputRecords and queued for a consumer, before and regardless of message filtering.
+     * Devices must be registered for raw input, for example with RegisterRawInputDevice.
+     * Buffered reads remove the WM_INPUT messages they drain from the queue, so FWindowsApplication and other
+     * listeners never see them. They only run while this listener is the only one reading buffered raw input and
+     * every device class registered for raw input in the process was registered through its RegisterRawInputDevice;
+     * otherwise payloads are read per message, and a warning is logged.
+     * Must be called from the thread that pumps Windows messages, while no consumer is draining.
+     * @param QueueCapacity - Number of records the queue can hold; rounded up to a power of two.
+     * @param ArenaBytes - Size of the arena payloads are read into.
+     * @param ReadMode - Whether to read one payload per WM_INPUT or drain every pending payload at once.
+     * @param OverflowPolicy - What to do with new records while the queue is full.
+     */
+    void EnableRawInput(uint32 QueueCapacity = 8192, int32 ArenaBytes = 65536, EWindowsRawInputReadMode ReadMode = EWindowsRawInputReadMode::PerMessage,
+        EWindowsMessageOverflowPolicy OverflowPolicy = EWindowsMessageOverflowPolicy::DropNewest);
+
+    /**
+     * Disables raw input ingestion, discarding any records still queued.
+     * Must be called from the thread that pumps Windows messages, while no consumer is draining.
+     */
+    void DisableRawInput();
+
+    /**
+     * Checks if raw input ingestion is enabled.
+     * @return True if WM_INPUT payloads are being queued.
+     */
+    bool IsRawInputEnabled() const;
+
+    /**
+     * Registers a device class for raw input, so its WM_INPUT messages reach the listener. Device classes registered
+     * here are owned by this listener for buffered reads; RIDEV_REMOVE releases one.
+     * @param UsagePage - The HID usage page, for example 0x01 for generic desktop controls.
+     * @param Usage - The HID usage, for example 0x02 for mice or 0x06 for keyboards.
+     * @param Flags - RIDEV_* flags.
+     * @param hwndTarget - The window receiving the input, or nullptr for the window with keyboard focus.
+     * @return True if the device class was registered.
+     */
+    bool RegisterRawInputDevice(uint16 UsagePage, uint16 Usage, uint32 Flags = 0, HWND hwndTarget = nullptr);
+
+    /**
+     * Pops queued raw input records and passes each one to a function. Must only be called from one consumer thread at a time.
+     * @param Func - Callable taking a const FWindowsRawInputRecord&.
+     * @param MaxRecords - Maximum number of records to drain.
+     * @return The number of records drained, or 0 if raw input is disabled.
+     */
+    template<typename FuncType>
+    int32 DrainRawInput(FuncType&& Func, int32 MaxRecords = MAX_int32)
+    {
+        return RawInput ? RawInput->DrainRecords(Forward<FuncType>(Func), MaxRecords) : 0;
+    }
+
+    /**
+     * Retrieves the raw input counters.
+     * @return Payloads read, rejected and dropped, or zeroed counters if raw input is disabled.
+     */
+    FWindowsRawInputCounters GetRawInputCounters() const;
+
+    /**
+     * Retrieves the platform-independent dispatch core.
+     * @return The dispatcher that filters and forwards this listener's messages.
+     */
+    FWindowsMessageDispatcher& GetDispatcher() { return Dispatcher; }
+
 protected:
 
     /**
@@ -120,10 +635,16 @@ protected:
 
 private:
 
-    TArray<IWindowsMessageHandler*> MessageHandlers; // List of registered message handlers
-    bool bIsListening = false;                      // Tracks whether the listener is active
-    TSet<uint32> AllowedMessageTypes;               // Set of allowed message types
-    bool bEnableVerboseLogging = false;             // Debug flag to control verbose logging
+    friend class FWindowsMessageListenerHub;
+
+    FWindowsInputEventRouter InputEvents; // Decodes input messages for input event handlers; outlives Dispatcher
+    FWindowsMessageDispatcher Dispatcher; // Filters, coalesces, queues and forwards messages to handlers
+    TUniquePtr<FWindowsRawInputReader> RawInput; // Reads and queues WM_INPUT payloads, when raw input is enabled
+    EWindowsRawInputReadMode RawInputReadMode = EWindowsRawInputReadMode::PerMessage; // How payloads are read
+    TArray<uint32> OwnedRawInputDevices;  // Device classes registered through RegisterRawInputDevice, as usage page << 16 | usage
+    bool bReadBufferedRawInput = false;   // Whether buffered reads run: Buffered was requested and this listener owns every registered device class
+    FWindowsMessageListenerHub* Hub = nullptr; // The shared hub this listener is attached to, if any
+    bool bIsListening = false;            // Tracks whether the listener is active
 
     /**
      * Logs detailed information about a Windows message for debugging purposes.
@@ -131,5 +652,87 @@ private:
      * @param msg - The message identifier.
      * @param Context - Contextual information for the log.
      */
-    void LogMessageDetails(HWND hwnd, uint32 msg, const TCHAR* Context) const;
-};
\ No newline at end of file
+    void LogMessageDetails(HWND hwnd, uint32 msg, const TCHAR* Context);
+
+    /**
+     * Adds a handler subscription, merging it with an existing one for the same handler and window.
+     * @param handler - The message handler to add.
+     * @param Ranges - Inclusive code ranges to subscribe to; empty subscribes to all codes.
+     * @param hwnd - The window to bind the handler to, or nullptr for every window.
+     */
+    void AddMessageHandlerSubscription(IWindowsMessageHandler* handler, TArray<TPair<uint32, uint32>>&& Ranges, HWND hwnd = nullptr);
+
+    /**
+     * Logs, captures and reads the raw input of a timestamped message, before it is filtered.
+     * @param Record - The message.
+     */
+    void ObserveRecord(const FWindowsMessageRecord& Record);
+
+    /**
+     * Filters and forwards a timestamped message received as a directly registered handler.
+     * @param Record - The message.
+     * @param OutResult - The result of the message processing.
+     * @return True if the message was handled.
+     */
+    bool ProcessRecord(const FWindowsMessageRecord& Record, int32& OutResult);
+
+    /**
+     * Forwards a message the hub already matched against this listener's shared filter, without filtering it
+     * again or counting it as rejected.
+     * @param Record - The message.
+     * @param OutResult - The result of the message processing.
+     * @return True if the message was handled.
+     */
+    bool AcceptSharedRecord(const FWindowsMessageRecord& Record, int32& OutResult);
+
+    /**
+     * Filters and forwards a replayed message, skipping the capture, raw input and window lifetime tracking of ProcessRecord.
+     * @param Record - The message.
+     * @param OutResult - The result of the message processing.
+     * @return True if the message was handled.
+     */
+    bool ReplayRecord(const FWindowsMessageRecord& Record, int32& OutResult);
+
+    /**
+     * Unbinds the handlers of a created or destroyed window, for a lifetime message the hub forwards although this
+     * listener's filter rejects it. Unlike ProcessRecord, the message is not captured, counted or logged as rejected.
+     * @param Record - The WM_CREATE or WM_DESTROY message.
+     */
+    void TrackWindowLifetime(const FWindowsMessageRecord& Record);
+
+    /**
+     * Checks if every device class registered for raw input in the process was registered through this listener,
+     * so a buffered read cannot take WM_INPUT messages meant for FWindowsApplication.
+     */
+    bool OwnsAllRawInputDevices() const;
+
+    /**
+     * Starts or stops buffered raw input reads after the read mode or the registered device classes changed.
+     * At most one listener reads buffered raw input at a time.
+     */
+    void UpdateBufferedRawInput();
+
+    /**
+     * Adds the message types this listener needs from the hub to a combined filter.
+     * @param Combined - The hub's combined filter.
+     */
+    void MergeSharedFilter(FWindowsMessageFilter& Combined) const;
+
+    /**
+     * Checks if this listener needs a message type from the hub; the same test as MergeSharedFilter, for one code.
+     * @param MsgCode - The message code.
+     */
+    bool NeedsSharedMessage(uint32 MsgCode) const;
+
+    /**
+     * Asks the hub to rebuild its combined filter after this listener's needs changed.
+     */
+    void RefreshSharedFilter();
+
+    /**
+     * Called by a hub that is being destroyed; the listener stops listening.
+     */
+    void DetachFromHub();
+};
+
+#endif // PLATFORM_WINDOWS
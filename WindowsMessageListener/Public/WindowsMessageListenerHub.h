@@ -0,0 +1,134 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares the FWindowsMessageListenerHub class, which shares one FWindowsApplication registration between listeners.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if PLATFORM_WINDOWS
+
+#include "Windows/WindowsApplication.h"
+#include "WindowsMessageFilter.h"
+
+class FWindowsMessageListener;
+
+/**
+ * FWindowsMessageListenerHub
+ * The single message handler registered with FWindowsApplication on behalf of every shared listener.
+ * The hub merges the allow-lists of its subscribers into one combined filter, so a message nobody wants
+ * costs one bitmap test instead of one call per listener. Messages that pass are timestamped once and
+ * handed only to the subscribers that want their code, looked up in a per-code subscriber bitmask, so the
+ * subscribers do not filter them again or count the messages meant for others as rejected.
+ *
+ * The module owns one hub, created in StartupModule; listeners attach to it in StartListening.
+ * Subscribers must be added, removed and refreshed from the thread that pumps Windows messages.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageListenerHub : public IWindowsMessageHandler
+{
+public:
+    FWindowsMessageListenerHub();
+    virtual ~FWindowsMessageListenerHub();
+
+    /**
+     * Retrieves the hub owned by the WindowsMessageListener module.
+     * @return The hub, or nullptr if the module is not loaded.
+     */
+    static FWindowsMessageListenerHub* Get();
+
+    /**
+     * Forwards a message to every subscriber whose filter accepts it.
+     * @param hwnd - Handle to the window.
+     * @param msg - The message identifier.
+     * @param wParam - Additional message information.
+     * @param lParam - Additional message information.
+     * @param outResult - The result of the first subscriber that handled the message.
+     * @return True if any subscriber handled the message.
+     */
+    virtual bool ProcessMessage(HWND hwnd, uint32 msg, WPARAM wParam, LPARAM lParam, int32& outResult) override;
+
+    /**
+     * Attaches a listener, registering the hub with FWindowsApplication if it is the first one.
+     * @param Listener - The listener to attach.
+     * @return False if the hub could not register with FWindowsApplication.
+     */
+    bool AddSubscriber(FWindowsMessageListener* Listener);
+
+    /**
+     * Detaches a listener, unregistering the hub from FWindowsApplication if it was the last one.
+     * Safe to call from inside a handler of the message being forwarded.
+     * @param Listener - The listener to detach.
+     */
+    void RemoveSubscriber(FWindowsMessageListener* Listener);
+
+    /**
+     * Rebuilds the combined filter and the subscriber bitmasks after a subscriber's allow-list changed.
+     */
+    void RefreshFilter();
+
+    /**
+     * Checks if any subscriber might accept a message type.
+     * @param MsgCode - The message code to check.
+     * @return True if the message type passes the combined filter.
+     */
+    FORCEINLINE bool IsMessageForwarded(uint32 MsgCode) const
+    {
+        return ForwardedMessageTypes.IsAllowed(MsgCode);
+    }
+
+    /**
+     * @return The number of attached listeners.
+     */
+    int32 NumSubscribers() const { return NumLiveSubscribers; }
+
+    /**
+     * Checks if the hub is registered with FWindowsApplication.
+     */
+    bool IsRegistered() const { return bIsRegistered; }
+
+private:
+
+    static constexpr int32 MaxMaskedSubscribers = 64; // Subscribers with a bit in the per-code masks; later ones are asked one by one
+    static constexpr uint32 MaskPageCodes = 256;      // Codes per page of SubscriberMasks
+    static constexpr uint32 NumMaskPages = FWindowsMessageFilter::NumBitmapCodes / MaskPageCodes;
+
+    /**
+     * Retrieves the subscribers that want a message code.
+     * @param MsgCode - The message code.
+     * @return A mask with bit N set if Subscribers[N] wants the code.
+     */
+    FORCEINLINE uint64 GetSubscriberMask(uint32 MsgCode) const
+    {
+        if (MsgCode < FWindowsMessageFilter::NumBitmapCodes)
+        {
+            const int32 PageOffset = MaskPageOffsets[MsgCode / MaskPageCodes];
+            return PageOffset != INDEX_NONE ? SubscriberMasks[PageOffset + MsgCode % MaskPageCodes] : 0;
+        }
+        const uint64* Mask = OverflowSubscriberMasks.Find(MsgCode);
+        return Mask ? *Mask : 0;
+    }
+
+    /**
+     * Marks a subscriber as wanting a message code, allocating the code's mask page if needed.
+     */
+    void AddSubscriberMaskBit(uint32 MsgCode, int32 SubscriberIndex);
+
+    /**
+     * Retrieves the FWindowsApplication instance if available.
+     */
+    FWindowsApplication* GetApplication() const;
+
+    TArray<FWindowsMessageListener*> Subscribers;  // Attached listeners; entries removed during a forward are nulled until it ends
+    FWindowsMessageFilter ForwardedMessageTypes;    // Union of the subscribers' allow-lists and the codes they always observe
+    int32 MaskPageOffsets[NumMaskPages];            // Offset of each page of codes in SubscriberMasks, or INDEX_NONE if no subscriber wants one
+    TArray<uint64> SubscriberMasks;                 // Per-code subscriber bitmasks, allocated a page at a time
+    TMap<uint32, uint64> OverflowSubscriberMasks;   // Per-code subscriber bitmasks of codes above 0xFFFF
+    int32 NumLiveSubscribers = 0;                   // Non-null entries of Subscribers
+    int32 ForwardDepth = 0;                         // Nesting depth of ProcessMessage, for removal during a forward
+    bool bHasRemovedSubscribers = false;            // Subscribers holds nulled entries to compact
+    bool bIsRegistered = false;                     // Tracks whether the hub is registered with FWindowsApplication
+};
+
+#endif // PLATFORM_WINDOWS
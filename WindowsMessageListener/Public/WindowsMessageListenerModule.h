@@ -8,22 +8,40 @@
 
 #include "Modules/ModuleManager.h"
 
+class FWindowsMessageListenerHub;
+
 /**
  * FWindowsMessageListenerModule
- * Handles the startup and shutdown of the WindowsMessageListener module.
+ * Handles the startup and shutdown of the WindowsMessageListener module, and owns the hub that
+ * shared listeners attach to.
  */
-class FWindowsMessageListenerModule : public IModuleInterface
+class WINDOWSMESSAGELISTENER_API FWindowsMessageListenerModule : public IModuleInterface
 {
 public:
+    FWindowsMessageListenerModule();
+    virtual ~FWindowsMessageListenerModule();
+
     /**
      * Called when the module is starting up.
-     * Use this to initialize resources or register components.
+     * Creates the shared listener hub; it registers with FWindowsApplication once the first listener attaches.
      */
     virtual void StartupModule() override;
 
     /**
      * Called when the module is shutting down.
-     * Use this to clean up resources or unregister components.
+     * Destroys the shared listener hub, detaching any listener still attached.
      */
     virtual void ShutdownModule() override;
-};
\ No newline at end of file
+
+    /**
+     * Retrieves the shared listener hub.
+     * @return The hub, or nullptr outside Windows or while the module is shut down.
+     */
+    FWindowsMessageListenerHub* GetHub() const;
+
+private:
+
+#if PLATFORM_WINDOWS
+    TUniquePtr<FWindowsMessageListenerHub> Hub; // One FWindowsApplication registration shared by every shared listener
+#endif
+};
@@ -0,0 +1,61 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares FWindowsMessageListenerState, a listener's filter and subscription state in a form that can be saved and restored.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageDispatcher.h"
+
+/**
+ * A saved subscription of a handler to the messages of every window.
+ */
+struct FWindowsMessageSubscriptionState
+{
+    FName Handler;                        // Name the caller gave the handler; objects are looked up by it on restore
+    int32 Priority = 0;                   // Higher priorities are dispatched first
+    TArray<TPair<uint32, uint32>> Ranges; // Inclusive code ranges, sorted and disjoint; empty means all codes
+    FName Rule;                           // The rule the handler is bound to; None for no rule
+    EWindowsMessageHandlerThread Thread = EWindowsMessageHandlerThread::Pump; // The thread that calls the handler
+    int32 Worker = 0;                     // The worker the handler is pinned to, when Thread is Worker
+};
+
+/**
+ * FWindowsMessageListenerState
+ * The allow-list, coalesced types, consumption policy and named handler subscriptions of a dispatcher.
+ * Subscriptions bound to a window are not included, since window handles do not outlive the process.
+ *
+ * The binary form starts with a magic number and version, stores each filter as its non-zero bitmap words,
+ * and names handlers rather than pointing at them, so it can be built once and cooked into a project.
+ */
+struct WINDOWSMESSAGELISTENER_API FWindowsMessageListenerState
+{
+    static constexpr uint32 ExpectedMagic = 0x534C4D57; // "WMLS"
+    static constexpr uint16 CurrentVersion = 1;
+
+    FWindowsMessageFilter AllowedMessageTypes;   // Message types the dispatcher accepts
+    FWindowsMessageFilter CoalescedMessageTypes; // Message types of which only the newest message per window is kept
+    EWindowsMessageConsumptionPolicy ConsumptionPolicy = EWindowsMessageConsumptionPolicy::Ignore; // What a handler returning true does
+    TArray<FWindowsMessageSubscriptionState> Subscriptions; // In dispatch order
+
+    /**
+     * Saves or loads the state. A load sets the archive's error flag if the data is not a valid state of a known version.
+     * @param Ar - The archive to save to or load from.
+     */
+    void Serialize(FArchive& Ar);
+
+    /**
+     * Writes the binary form of the state.
+     * @return The bytes.
+     */
+    TArray<uint8> SaveToBytes() const;
+
+    /**
+     * Replaces the state with one read from its binary form.
+     * @param Bytes - Bytes written by SaveToBytes.
+     * @return True if the bytes hold a valid state; false leaves the state empty.
+     */
+    bool LoadFromBytes(TArrayView<const uint8> Bytes);
+};
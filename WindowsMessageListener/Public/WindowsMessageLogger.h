@@ -0,0 +1,226 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares FWindowsMessageLogger, a sampled, rate-limited and asynchronous message log.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageRecord.h"
+#include "WindowsMessageRing.h"
+#include "WindowsMessageFilter.h"
+#include "HAL/Runnable.h"
+
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+
+/**
+ * What happened to a logged message.
+ */
+enum class EWindowsMessageLogEvent : uint8
+{
+    Accepted, // The message passed the filter and was coalesced, queued or dispatched
+    Rejected  // The message was rejected by the filter
+};
+
+/**
+ * A message picked for the log, queued for the background thread to format.
+ */
+struct FWindowsMessageLogRecord
+{
+    uint64 Timestamp = 0;  // FPlatformTime::Cycles64() when the message arrived
+    uint64 Hwnd = 0;       // Handle to the window, stored as an integer
+    uint64 WParam = 0;     // Additional message information
+    int64 LParam = 0;      // Additional message information
+    uint32 Msg = 0;        // The message identifier
+    uint32 Suppressed = 0; // Messages under the same rule skipped by sampling or rate limiting since the previous record
+    EWindowsMessageLogEvent Event = EWindowsMessageLogEvent::Accepted; // What happened to the message
+};
+
+/** Log records are never merged; a full log buffer drops the newest record instead. */
+FORCEINLINE bool AreWindowsMessagesCoalescable(const FWindowsMessageLogRecord& A, const FWindowsMessageLogRecord& B)
+{
+    return false;
+}
+
+/**
+ * How often messages under a rule are logged.
+ */
+struct FWindowsMessageLogRule
+{
+    uint32 SampleRate = 1;     // Log one message in SampleRate; 1 logs every message
+    double MaxPerSecond = 0.0; // Sustained rate of a token bucket applied after sampling; 0 for no limit
+    double Burst = 10.0;       // Size of the token bucket, the most messages logged back to back
+
+    FWindowsMessageLogRule() {}
+    FWindowsMessageLogRule(uint32 InSampleRate, double InMaxPerSecond = 0.0, double InBurst = 10.0)
+        : SampleRate(InSampleRate), MaxPerSecond(InMaxPerSecond), Burst(InBurst) {}
+};
+
+/**
+ * Snapshot of a logger's counters.
+ */
+struct FWindowsMessageLogCounters
+{
+    uint64 Considered = 0;  // Messages of logged types seen by the logger
+    uint64 SampledOut = 0;  // Messages skipped by sampling
+    uint64 RateLimited = 0; // Messages skipped by a token bucket
+    uint64 Written = 0;     // Records formatted and written
+    FWindowsMessageRingCounters Buffer; // Counters of the record buffer; records lost to a full buffer are DroppedNewest
+};
+
+/**
+ * Receives formatted log lines instead of the output log.
+ */
+using FWindowsMessageLogSink = TFunction<void(const FWindowsMessageLogRecord& Record, FStringView Line)>;
+
+/**
+ * FWindowsMessageLogger
+ * A message log cheap enough to leave on in live builds. Messages are picked by a per-code filter, then
+ * thinned by per-code sampling (1 in N) and token-bucket rate limits, and the survivors are copied into a
+ * lock-free buffer. A background thread formats and writes them, so the message path never formats a string.
+ *
+ * Codes without their own rule share the default rule, including its sample counter and token bucket.
+ * Log, and every function that changes the filter or the rules, must be called from the thread that feeds messages.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageLogger : private FRunnable
+{
+public:
+    static constexpr int32 MaxRules = 255; // Codes with their own rule
+
+    FWindowsMessageLogger();
+    virtual ~FWindowsMessageLogger();
+
+    /**
+     * Allocates the record buffer and, optionally, starts the background thread.
+     * @param Capacity - Number of records the buffer can hold; rounded up to a power of two.
+     * @param bBackgroundThread - True to format records on a background thread; false to format them in Flush.
+     * @param FlushIntervalSeconds - How long the background thread sleeps between batches.
+     */
+    void Start(int32 Capacity = 4096, bool bBackgroundThread = true, float FlushIntervalSeconds = 0.05f);
+
+    /**
+     * Stops the background thread and writes every record still buffered.
+     */
+    void Stop();
+
+    /**
+     * Checks if the logger has been started.
+     */
+    bool IsRunning() const { return Records.IsValid(); }
+
+    /**
+     * Sets where formatted lines go. Must only be called while the logger is stopped.
+     * @param InSink - The sink, or an unbound function for the output log.
+     */
+    void SetSink(FWindowsMessageLogSink InSink);
+
+    /**
+     * Includes or excludes a message type. Every type is logged by default.
+     * @param MsgCode - The message code.
+     * @param bLogged - True to log the type.
+     */
+    void SetMessageTypeLogged(uint32 MsgCode, bool bLogged);
+
+    /**
+     * Includes or excludes an inclusive range of message types.
+     * @param FirstMsgCode - The first message code of the range.
+     * @param LastMsgCode - The last message code of the range.
+     * @param bLogged - True to log the types.
+     */
+    void SetMessageRangeLogged(uint32 FirstMsgCode, uint32 LastMsgCode, bool bLogged);
+
+    /**
+     * Sets the rule of every message type without its own rule.
+     * @param Rule - The sampling rate and rate limit.
+     */
+    void SetDefaultRule(const FWindowsMessageLogRule& Rule);
+
+    /**
+     * Gives a message type its own sample counter and token bucket.
+     * Example: SetRule(WM_MOUSEMOVE, FWindowsMessageLogRule(100, 5.0)) logs at most 5 mouse moves per second, 1 in 100.
+     * @param MsgCode - The message code, below 0x10000.
+     * @param Rule - The sampling rate and rate limit.
+     * @return False if the code is out of range or MaxRules codes already have rules.
+     */
+    bool SetRule(uint32 MsgCode, const FWindowsMessageLogRule& Rule);
+
+    /**
+     * Removes every per-code rule, so all types fall back to the default rule.
+     */
+    void ClearRules();
+
+    /**
+     * Picks or skips a message for the log. Only a filter test when the type is not logged.
+     * @param Event - What happened to the message.
+     * @param Record - The message.
+     */
+    FORCEINLINE void Log(EWindowsMessageLogEvent Event, const FWindowsMessageRecord& Record)
+    {
+        if (LoggedMessageTypes.IsAllowed(Record.Msg))
+        {
+            LogAllowed(Event, Record);
+        }
+    }
+
+    /**
+     * Formats and writes every buffered record on the calling thread. Only for loggers started without a background thread.
+     * @return The number of records written.
+     */
+    int32 Flush();
+
+    /**
+     * @return A snapshot of the counters; safe to call from any thread.
+     */
+    FWindowsMessageLogCounters GetCounters() const;
+
+    /**
+     * Formats a log record into one line.
+     * @param Builder - The builder to append to.
+     * @param Record - The record.
+     */
+    static void FormatRecord(FStringBuilderBase& Builder, const FWindowsMessageLogRecord& Record);
+
+private:
+
+    struct FRuleState
+    {
+        FWindowsMessageLogRule Rule;
+        uint32 SampleCounter = 0; // Messages seen under the rule, for 1-in-N sampling
+        uint32 Suppressed = 0;    // Messages skipped since the last record under the rule
+        double Tokens = 0.0;      // Tokens left in the bucket
+        uint64 LastRefill = 0;    // Cycles64 timestamp of the last refill
+    };
+
+    virtual uint32 Run() override;
+
+    /**
+     * Applies the message's rule and queues a record if it survives.
+     */
+    void LogAllowed(EWindowsMessageLogEvent Event, const FWindowsMessageRecord& Record);
+
+    /**
+     * Formats and writes buffered records. Must only be called from the consumer.
+     */
+    int32 WriteBufferedRecords();
+
+    FWindowsMessageFilter LoggedMessageTypes;       // Types that reach the rules
+    TArray<FRuleState> Rules;                       // Rules[0] is the default rule
+    TArray<uint8> RuleIndices;                      // Index into Rules per code below 0x10000; empty until a per-code rule is set
+    double SecondsPerCycle = 0.0;                   // Converts timestamps to seconds for the token buckets
+
+    TUniquePtr<TWindowsMessageRing<FWindowsMessageLogRecord>> Records; // Records awaiting formatting, while running
+    FWindowsMessageLogSink Sink;                    // Where lines go; the output log if unbound
+    FRunnableThread* WriterThread = nullptr;        // Formats and writes records, if started with a background thread
+    FEvent* WakeEvent = nullptr;                    // Wakes the writer thread early when stopping
+    float FlushInterval = 0.05f;                    // Seconds the writer thread sleeps between batches
+    std::atomic<bool> bStopping{false};             // Asks the writer thread to exit
+
+    std::atomic<uint64> Considered{0};
+    std::atomic<uint64> SampledOut{0};
+    std::atomic<uint64> RateLimited{0};
+    std::atomic<uint64> Written{0};
+};
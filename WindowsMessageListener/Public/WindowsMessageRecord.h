@@ -0,0 +1,36 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares FWindowsMessageRecord, a platform-independent copy of a Windows message.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Struct holding a copy of a Windows message, using plain integer types so it can be
+ * stored, queued and replayed outside of the window procedure.
+ */
+struct FWindowsMessageRecord
+{
+    uint64 Hwnd = 0;        // Handle to the window, stored as an integer
+    uint32 Msg = 0;         // The message identifier
+    uint32 MessageTime = 0; // GetMessageTime() when the message arrived, in milliseconds; 0 if unknown
+    uint64 WParam = 0;      // Additional message information
+    int64 LParam = 0;       // Additional message information
+    uint64 Timestamp = 0;   // FPlatformTime::Cycles64() when the message arrived
+
+    FWindowsMessageRecord() {}
+    FWindowsMessageRecord(uint64 InHwnd, uint32 InMsg, uint64 InWParam, int64 InLParam, uint64 InTimestamp)
+        : Hwnd(InHwnd), Msg(InMsg), WParam(InWParam), LParam(InLParam), Timestamp(InTimestamp) {}
+};
+
+/**
+ * Checks if two message records can be merged into one, keeping only the newest.
+ * @return True if both records are the same message for the same window.
+ */
+FORCEINLINE bool AreWindowsMessagesCoalescable(const FWindowsMessageRecord& A, const FWindowsMessageRecord& B)
+{
+    return A.Hwnd == B.Hwnd && A.Msg == B.Msg;
+}
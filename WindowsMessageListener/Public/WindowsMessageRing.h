@@ -0,0 +1,279 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares TWindowsMessageRing, a lock-free single-producer/single-consumer ring buffer.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+#include "WindowsMessageRecord.h"
+
+#include <atomic>
+
+/**
+ * What a ring does when a record is pushed while it is full.
+ */
+enum class EWindowsMessageOverflowPolicy : uint8
+{
+    DropNewest, // Reject the incoming record
+    DropOldest, // Discard the oldest queued record to make room
+    Coalesce,   // Replace the newest queued record if it is coalescable with the incoming one, otherwise drop the incoming record
+};
+
+/**
+ * Snapshot of a ring's counters.
+ */
+struct FWindowsMessageRingCounters
+{
+    uint64 Pushed = 0;        // Records accepted by Push, including coalesced ones
+    uint64 Popped = 0;        // Records handed to the consumer
+    uint64 DroppedNewest = 0; // Incoming records rejected because the ring was full
+    uint64 DroppedOldest = 0; // Queued records discarded to make room for newer ones
+    uint64 Coalesced = 0;     // Incoming records merged into the newest queued record
+    uint32 HighWaterMark = 0; // Largest number of records queued at once
+};
+
+/**
+ * TWindowsMessageRing
+ * Fixed-capacity lock-free ring buffer with one producer thread and one consumer thread.
+ *
+ * The read index and a modification sequence share one atomic word. The producer only
+ * writes it when it has to touch a queued record (drop-oldest, coalesce), and the consumer
+ * commits every batch with a compare-exchange, so a batch the producer changed while it
+ * was being copied is discarded and read again.
+ *
+ * Records are found coalescable through an AreWindowsMessagesCoalescable(A, B) overload.
+ */
+template<typename RecordType>
+class TWindowsMessageRing
+{
+public:
+    static constexpr int32 DrainBatchSize = 64; // Records copied out per batch by Drain
+
+    /**
+     * @param InCapacity - Number of records the ring can hold; rounded up to a power of two.
+     * @param InOverflowPolicy - What to do when a record is pushed while the ring is full.
+     */
+    explicit TWindowsMessageRing(uint32 InCapacity, EWindowsMessageOverflowPolicy InOverflowPolicy = EWindowsMessageOverflowPolicy::DropNewest)
+        : OverflowPolicy(InOverflowPolicy)
+    {
+        const uint32 Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(InCapacity, 2));
+        Slots.SetNum(Capacity);
+        IndexMask = Capacity - 1;
+    }
+
+    TWindowsMessageRing(const TWindowsMessageRing&) = delete;
+    TWindowsMessageRing& operator=(const TWindowsMessageRing&) = delete;
+
+    /**
+     * Queues a record. Must only be called from the producer thread.
+     * @param Record - The record to queue.
+     * @return True if the record was queued or coalesced, false if it was dropped.
+     */
+    bool Push(const RecordType& Record)
+    {
+        const uint32 Write = WriteIndex.load(std::memory_order_relaxed);
+        uint64 State = ReadState.load(std::memory_order_acquire);
+
+        for (;;)
+        {
+            const uint32 Read = GetReadIndex(State);
+            if (Write - Read <= IndexMask)
+            {
+                Publish(Write, Record, Write - Read + 1);
+                return true;
+            }
+
+            switch (OverflowPolicy)
+            {
+            case EWindowsMessageOverflowPolicy::DropOldest:
+                // Take the oldest record away from the consumer, then reuse its slot
+                if (ReadState.compare_exchange_weak(State, MakeReadState(Read + 1, GetSequence(State)), std::memory_order_acq_rel))
+                {
+                    DroppedOldest.fetch_add(1, std::memory_order_relaxed);
+                    Publish(Write, Record, IndexMask + 1);
+                    return true;
+                }
+                continue;
+
+            case EWindowsMessageOverflowPolicy::Coalesce:
+            {
+                RecordType& Newest = Slots[(Write - 1) & IndexMask];
+                if (!AreWindowsMessagesCoalescable(Newest, Record))
+                {
+                    break;
+                }
+
+                // An odd sequence tells the consumer the newest record is being rewritten
+                if (ReadState.compare_exchange_weak(State, MakeReadState(Read, GetSequence(State) + 1), std::memory_order_acq_rel))
+                {
+                    Newest = Record;
+                    ReadState.fetch_add(uint64(1) << 32, std::memory_order_release);
+                    Pushed.fetch_add(1, std::memory_order_relaxed);
+                    Coalesced.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                continue;
+            }
+
+            default:
+                break;
+            }
+
+            DroppedNewest.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    /**
+     * Copies up to MaxRecords of the oldest queued records out of the ring. Must only be called from the consumer thread.
+     * @param OutRecords - Buffer receiving the records.
+     * @param MaxRecords - Capacity of OutRecords.
+     * @return The number of records copied.
+     */
+    int32 PopBatch(RecordType* OutRecords, int32 MaxRecords)
+    {
+        if (MaxRecords <= 0)
+        {
+            return 0;
+        }
+
+        for (;;)
+        {
+            uint64 State = ReadState.load(std::memory_order_acquire);
+            if (GetSequence(State) & 1)
+            {
+                FPlatformProcess::YieldThread(); // The producer is rewriting the newest record
+                continue;
+            }
+
+            const uint32 Read = GetReadIndex(State);
+            const uint32 Write = WriteIndex.load(std::memory_order_acquire);
+            const uint32 Count = FMath::Min3(Write - Read, IndexMask + 1, static_cast<uint32>(MaxRecords));
+            if (Count == 0)
+            {
+                return 0;
+            }
+
+            for (uint32 Index = 0; Index < Count; ++Index)
+            {
+                OutRecords[Index] = Slots[(Read + Index) & IndexMask];
+            }
+
+            if (ReadState.compare_exchange_strong(State, MakeReadState(Read + Count, GetSequence(State)), std::memory_order_acq_rel))
+            {
+                Popped.fetch_add(Count, std::memory_order_relaxed);
+                return static_cast<int32>(Count);
+            }
+        }
+    }
+
+    /**
+     * Pops queued records in batches and passes each one to a function. Must only be called from the consumer thread.
+     * @param Func - Callable taking a const RecordType&.
+     * @param MaxRecords - Maximum number of records to drain.
+     * @return The number of records drained.
+     */
+    template<typename FuncType>
+    int32 Drain(FuncType&& Func, int32 MaxRecords = MAX_int32)
+    {
+        RecordType Batch[DrainBatchSize];
+        int32 Total = 0;
+        while (Total < MaxRecords)
+        {
+            const int32 Count = PopBatch(Batch, FMath::Min(DrainBatchSize, MaxRecords - Total));
+            if (Count == 0)
+            {
+                break;
+            }
+            for (int32 Index = 0; Index < Count; ++Index)
+            {
+                Func(static_cast<const RecordType&>(Batch[Index]));
+            }
+            Total += Count;
+        }
+        return Total;
+    }
+
+    /**
+     * @return The approximate number of queued records.
+     */
+    uint32 Num() const
+    {
+        const uint32 Write = WriteIndex.load(std::memory_order_acquire);
+        const uint32 Read = GetReadIndex(ReadState.load(std::memory_order_acquire));
+        return FMath::Min(Write - Read, IndexMask + 1);
+    }
+
+    /**
+     * @return The number of records the ring can hold.
+     */
+    uint32 GetCapacity() const
+    {
+        return IndexMask + 1;
+    }
+
+    /**
+     * Changes the overflow policy. Must only be called from the producer thread.
+     */
+    void SetOverflowPolicy(EWindowsMessageOverflowPolicy InOverflowPolicy)
+    {
+        OverflowPolicy = InOverflowPolicy;
+    }
+
+    EWindowsMessageOverflowPolicy GetOverflowPolicy() const
+    {
+        return OverflowPolicy;
+    }
+
+    /**
+     * @return A snapshot of the ring's counters; safe to call from any thread.
+     */
+    FWindowsMessageRingCounters GetCounters() const
+    {
+        FWindowsMessageRingCounters Counters;
+        Counters.Pushed = Pushed.load(std::memory_order_relaxed);
+        Counters.Popped = Popped.load(std::memory_order_relaxed);
+        Counters.DroppedNewest = DroppedNewest.load(std::memory_order_relaxed);
+        Counters.DroppedOldest = DroppedOldest.load(std::memory_order_relaxed);
+        Counters.Coalesced = Coalesced.load(std::memory_order_relaxed);
+        Counters.HighWaterMark = HighWaterMark.load(std::memory_order_relaxed);
+        return Counters;
+    }
+
+private:
+
+    static uint32 GetReadIndex(uint64 State) { return static_cast<uint32>(State); }
+    static uint32 GetSequence(uint64 State) { return static_cast<uint32>(State >> 32); }
+    static uint64 MakeReadState(uint32 Read, uint32 Sequence) { return (uint64(Sequence) << 32) | Read; }
+
+    void Publish(uint32 Write, const RecordType& Record, uint32 QueuedCount)
+    {
+        Slots[Write & IndexMask] = Record;
+        WriteIndex.store(Write + 1, std::memory_order_release);
+        Pushed.fetch_add(1, std::memory_order_relaxed);
+        if (QueuedCount > HighWaterMark.load(std::memory_order_relaxed))
+        {
+            HighWaterMark.store(QueuedCount, std::memory_order_relaxed);
+        }
+    }
+
+    TArray<RecordType> Slots;                              // Record storage, a power of two in size
+    uint32 IndexMask = 0;                                  // Capacity - 1
+    EWindowsMessageOverflowPolicy OverflowPolicy;          // Producer-owned overflow behavior
+
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> WriteIndex{0}; // Next slot to write; only the producer stores it
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> ReadState{0};  // Low 32 bits: next slot to read. High 32 bits: modification sequence
+
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> Pushed{0};
+    std::atomic<uint64> DroppedNewest{0};
+    std::atomic<uint64> DroppedOldest{0};
+    std::atomic<uint64> Coalesced{0};
+    std::atomic<uint32> HighWaterMark{0};
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> Popped{0};
+};
+
+/** Ring of raw Windows message records. */
+using FWindowsMessageRing = TWindowsMessageRing<FWindowsMessageRecord>;
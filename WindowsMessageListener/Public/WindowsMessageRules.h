@@ -0,0 +1,218 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares FWindowsMessageRuleSet, a set of message predicates compiled into a flat program.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageRecord.h"
+#include "Containers/StringView.h"
+
+/**
+ * A value a rule instruction reads from a message. Comparisons are unsigned.
+ */
+enum class EWindowsMessageRuleField : uint8
+{
+    Msg,        // msg
+    WParam,     // wParam
+    LParam,     // lParam, as its 64-bit two's complement pattern
+    LowWParam,  // loword(wParam)
+    HighWParam, // hiword(wParam)
+    LowLParam,  // loword(lParam)
+    HighLParam, // hiword(lParam)
+    Hwnd        // hwnd
+};
+
+/**
+ * The test a rule instruction applies to its field.
+ */
+enum class EWindowsMessageRuleOp : uint8
+{
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    AnyBits, // field & Value is non-zero
+    InSet    // field lies in one of SetCount ranges starting at SetRanges[Value]
+};
+
+/**
+ * One test of a compiled rule. A rule is a chain of tests; each names the instruction to run next
+ * depending on its outcome, so && and || short-circuit without a stack.
+ */
+struct FWindowsMessageRuleInstruction
+{
+    static constexpr int32 Accept = -1; // Target meaning the rule matched
+    static constexpr int32 Reject = -2; // Target meaning the rule did not match
+
+    EWindowsMessageRuleField Field = EWindowsMessageRuleField::Msg;
+    EWindowsMessageRuleOp Op = EWindowsMessageRuleOp::Equal;
+    uint16 SetCount = 0;    // Number of ranges, for InSet
+    int32 OnTrue = Accept;  // Next instruction if the test passes
+    int32 OnFalse = Reject; // Next instruction if the test fails
+    uint64 Value = 0;       // Operand, or the first range for InSet
+};
+
+/**
+ * FWindowsMessageRuleSet
+ * Named predicates over a message's code, wParam and lParam, written as expressions and compiled into
+ * one flat array of tests. Handlers bound to a rule are only woken for messages the rule accepts, and
+ * each rule is evaluated at most once per message no matter how many handlers use it.
+ *
+ * Expressions combine comparisons with &&, || and !, and parentheses:
+ *     msg == WM_KEYDOWN && wParam in {VK_F1..VK_F12}
+ *     msg == WM_DEVICECHANGE && wParam == DBT_DEVICEARRIVAL
+ *     msg in {WM_MOUSEMOVE..WM_MOUSEWHEEL} && wParam & MK_LBUTTON
+ * Fields are msg, wParam, lParam, hwnd, and loword()/hiword() of wParam or lParam. Operators are ==, !=,
+ * <, <=, >, >=, & (any bit set) and in {values and low..high ranges}. Values are numbers, 'A' style
+ * characters, message names resolved by FWindowsMessageCodeHelper, or named constants (VK_*, DBT_*, MK_*,
+ * and any added with DefineConstant).
+ *
+ * A compiled set is immutable once handed to a dispatcher; to reload rules, compile a new set and swap it in.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageRuleSet
+{
+public:
+    static constexpr int32 MaxRules = 64; // Rules per set, so the rules matched by a message fit one 64-bit mask
+
+    /**
+     * Defines a named constant for rules compiled afterwards.
+     * @param Name - The name, matched ignoring case.
+     * @param Value - The value.
+     */
+    void DefineConstant(FStringView Name, uint64 Value);
+
+    /**
+     * Compiles a rule and adds it to the set.
+     * @param Name - The name handlers bind to; must be unique within the set.
+     * @param Expression - The rule expression.
+     * @param OutError - Receives a description of the first error, if any.
+     * @return True if the rule compiled.
+     */
+    bool AddRule(FName Name, FStringView Expression, FString* OutError = nullptr);
+
+    /**
+     * Compiles the rules of a config section, one per "Rule" entry written as "Name: expression":
+     *     [WindowsMessageListener.Rules]
+     *     +Rule=FunctionKeys: msg == WM_KEYDOWN && wParam in {VK_F1..VK_F12}
+     * @param Section - The config section.
+     * @param Filename - The config file, such as GGameIni.
+     * @param OutErrors - Receives one line per rule that failed to compile.
+     * @return The number of rules compiled.
+     */
+    int32 AddRulesFromConfig(const TCHAR* Section, const FString& Filename, TArray<FString>* OutErrors = nullptr);
+
+    /**
+     * Finds a rule by name.
+     * @return The index of the rule, or INDEX_NONE.
+     */
+    int32 FindRule(FName Name) const;
+
+    /**
+     * @return The number of rules.
+     */
+    int32 Num() const { return Rules.Num(); }
+
+    /**
+     * @return The name of a rule.
+     */
+    FName GetRuleName(int32 RuleIndex) const { return Rules[RuleIndex].Name; }
+
+    /**
+     * Retrieves the message codes a rule can accept, found when it was compiled.
+     * @param RuleIndex - The rule.
+     * @param OutRanges - Receives sorted, disjoint inclusive code ranges; empty if no code can match.
+     * @return False if the rule does not constrain the code, in which case OutRanges is untouched.
+     */
+    bool GetRuleCodeRanges(int32 RuleIndex, TArray<TPair<uint32, uint32>>& OutRanges) const;
+
+    /**
+     * Runs one rule against a message.
+     * @param RuleIndex - The rule.
+     * @param Record - The message.
+     * @return True if the rule accepts the message.
+     */
+    FORCEINLINE bool Evaluate(int32 RuleIndex, const FWindowsMessageRecord& Record) const
+    {
+        int32 Pc = Rules[RuleIndex].Entry;
+        while (Pc >= 0)
+        {
+            const FWindowsMessageRuleInstruction& Instruction = Program[Pc];
+            Pc = Test(Instruction, ReadField(Instruction.Field, Record)) ? Instruction.OnTrue : Instruction.OnFalse;
+        }
+        return Pc == FWindowsMessageRuleInstruction::Accept;
+    }
+
+    /**
+     * Runs every rule against a message.
+     * @param Record - The message.
+     * @return A mask with bit N set if rule N accepts the message.
+     */
+    uint64 EvaluateAll(const FWindowsMessageRecord& Record) const;
+
+    /**
+     * @return The compiled program shared by every rule.
+     */
+    TArrayView<const FWindowsMessageRuleInstruction> GetProgram() const { return Program; }
+
+private:
+
+    struct FRule
+    {
+        FName Name;                               // The name handlers bind to
+        int32 Entry = 0;                          // First instruction
+        bool bAnyCode = true;                     // Whether the rule can match any code
+        TArray<TPair<uint32, uint32>> CodeRanges; // Codes the rule can match, when bAnyCode is false
+    };
+
+    static FORCEINLINE uint64 ReadField(EWindowsMessageRuleField Field, const FWindowsMessageRecord& Record)
+    {
+        switch (Field)
+        {
+        case EWindowsMessageRuleField::Msg:        return Record.Msg;
+        case EWindowsMessageRuleField::WParam:     return Record.WParam;
+        case EWindowsMessageRuleField::LParam:     return static_cast<uint64>(Record.LParam);
+        case EWindowsMessageRuleField::LowWParam:  return Record.WParam & 0xFFFF;
+        case EWindowsMessageRuleField::HighWParam: return (Record.WParam >> 16) & 0xFFFF;
+        case EWindowsMessageRuleField::LowLParam:  return static_cast<uint64>(Record.LParam) & 0xFFFF;
+        case EWindowsMessageRuleField::HighLParam: return (static_cast<uint64>(Record.LParam) >> 16) & 0xFFFF;
+        default:                                   return Record.Hwnd;
+        }
+    }
+
+    FORCEINLINE bool Test(const FWindowsMessageRuleInstruction& Instruction, uint64 Value) const
+    {
+        switch (Instruction.Op)
+        {
+        case EWindowsMessageRuleOp::Equal:        return Value == Instruction.Value;
+        case EWindowsMessageRuleOp::NotEqual:     return Value != Instruction.Value;
+        case EWindowsMessageRuleOp::Less:         return Value < Instruction.Value;
+        case EWindowsMessageRuleOp::LessEqual:    return Value <= Instruction.Value;
+        case EWindowsMessageRuleOp::Greater:      return Value > Instruction.Value;
+        case EWindowsMessageRuleOp::GreaterEqual: return Value >= Instruction.Value;
+        case EWindowsMessageRuleOp::AnyBits:      return (Value & Instruction.Value) != 0;
+        default:
+        {
+            // Sets are short and sorted, so a linear scan beats a binary search
+            const TPair<uint64, uint64>* Range = SetRanges.GetData() + Instruction.Value;
+            for (const TPair<uint64, uint64>* End = Range + Instruction.SetCount; Range < End && Value >= Range->Key; ++Range)
+            {
+                if (Value <= Range->Value)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+        }
+    }
+
+    TArray<FRule> Rules;                              // Compiled rules, in the order they were added
+    TArray<FWindowsMessageRuleInstruction> Program;   // Instructions of every rule
+    TArray<TPair<uint64, uint64>> SetRanges;          // Sorted, merged inclusive ranges of every set, referenced by InSet instructions
+    TMap<FString, uint64> Constants;                  // Named constants, keyed by upper-case name
+};
@@ -0,0 +1,145 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares the counters the FWindowsMessageListener keeps per message code and per handler.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+// Stats are compiled out of shipping builds unless the build rules say otherwise
+#ifndef WINDOWS_MESSAGE_LISTENER_STATS
+#define WINDOWS_MESSAGE_LISTENER_STATS !UE_BUILD_SHIPPING
+#endif
+
+/**
+ * Counters of a single message code, or of a range of codes above WM_USER.
+ */
+struct FWindowsMessageCodeStats
+{
+    uint32 FirstMsgCode = 0; // The first message code counted
+    uint32 LastMsgCode = 0;  // The last message code counted; equal to FirstMsgCode for system messages
+    uint64 Received = 0;     // Messages that reached the listener
+    uint64 Filtered = 0;     // Messages rejected by the allowed message types
+    uint64 Dispatched = 0;   // Messages forwarded to handlers
+};
+
+/**
+ * Call counts and timings of a single handler.
+ */
+struct FWindowsMessageHandlerStats
+{
+    static constexpr int32 NumCycleBuckets = 32;
+
+    const void* Handler = nullptr;             // The object of the registered handler
+    uint64 Calls = 0;                          // Number of ProcessMessage calls, or of batches for a batch handler
+    uint64 TotalCycles = 0;                    // Cycles spent in ProcessMessage, in FPlatformTime::Cycles64 units
+    uint64 CycleHistogram[NumCycleBuckets] = {}; // Bucket N counts calls that took [2^N, 2^(N+1)) cycles; the last bucket is open-ended
+};
+
+/**
+ * Snapshot of the listener's stats.
+ */
+struct FWindowsMessageStatsSnapshot
+{
+    TArray<FWindowsMessageCodeStats> MessageCodes;    // Codes with at least one non-zero counter, in ascending code order
+    TArray<FWindowsMessageHandlerStats> Handlers;     // Registered handlers, in dispatch order, followed by batch handlers
+};
+
+#if WINDOWS_MESSAGE_LISTENER_STATS
+
+/**
+ * FWindowsMessageCodeCounters
+ * Received, filtered and dispatched counters for every message code, in fixed storage.
+ * System messages below WM_USER are counted individually; higher codes are counted per range
+ * (WM_USER, WM_APP, registered messages and anything above 0xFFFF). Safe to update from any thread.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageCodeCounters
+{
+public:
+    FORCEINLINE void AddReceived(uint32 MsgCode)
+    {
+        Slots[GetSlotIndex(MsgCode)].Received.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    FORCEINLINE void AddFiltered(uint32 MsgCode)
+    {
+        Slots[GetSlotIndex(MsgCode)].Filtered.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    FORCEINLINE void AddDispatched(uint32 MsgCode)
+    {
+        Slots[GetSlotIndex(MsgCode)].Dispatched.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Appends the codes with at least one non-zero counter.
+     * @param OutStats - Array to append to.
+     */
+    void Gather(TArray<FWindowsMessageCodeStats>& OutStats) const;
+
+    /**
+     * Zeroes every counter.
+     */
+    void Reset();
+
+private:
+    static constexpr uint32 NumSystemCodes = 0x0400; // Codes below WM_USER get a slot each
+    static constexpr int32 NumRangeSlots = 4;
+
+    struct FSlot
+    {
+        std::atomic<uint64> Received{0};
+        std::atomic<uint64> Filtered{0};
+        std::atomic<uint64> Dispatched{0};
+    };
+
+    static FORCEINLINE int32 GetSlotIndex(uint32 MsgCode)
+    {
+        if (MsgCode < NumSystemCodes)
+        {
+            return static_cast<int32>(MsgCode);
+        }
+        // WM_USER-0x7FFF, WM_APP-0xBFFF, registered messages 0xC000-0xFFFF, then everything else
+        return NumSystemCodes + (MsgCode < 0x8000 ? 0 : MsgCode < 0xC000 ? 1 : MsgCode <= 0xFFFF ? 2 : 3);
+    }
+
+    FSlot Slots[NumSystemCodes + NumRangeSlots];
+};
+
+/**
+ * FWindowsMessageHandlerCounters
+ * Call count and log2 cycle histogram of a single handler. Safe to update from any thread.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsMessageHandlerCounters
+{
+public:
+    FORCEINLINE void AddCall(uint64 Cycles)
+    {
+        const int32 Bucket = FMath::Min<int32>(FMath::FloorLog2_64(Cycles), FWindowsMessageHandlerStats::NumCycleBuckets - 1);
+        Calls.fetch_add(1, std::memory_order_relaxed);
+        TotalCycles.fetch_add(Cycles, std::memory_order_relaxed);
+        CycleHistogram[Bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Copies the counters into a stats entry.
+     * @param OutStats - The entry to fill; the handler pointer is left untouched.
+     */
+    void Gather(FWindowsMessageHandlerStats& OutStats) const;
+
+    /**
+     * Zeroes every counter.
+     */
+    void Reset();
+
+private:
+    std::atomic<uint64> Calls{0};
+    std::atomic<uint64> TotalCycles{0};
+    std::atomic<uint64> CycleHistogram[FWindowsMessageHandlerStats::NumCycleBuckets] = {};
+};
+
+#endif // WINDOWS_MESSAGE_LISTENER_STATS
@@ -0,0 +1,200 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares UWindowsMessageSubsystem, which broadcasts filtered Windows messages to Blueprint and
+ * C++ delegates once per frame on the game thread.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Containers/Ticker.h"
+#include "WindowsMessageFilter.h"
+#include "WindowsMessageBatch.h"
+#include "WindowsMessageSubsystem.generated.h"
+
+class FWindowsMessageSubsystemListener;
+
+/**
+ * A Windows message, as seen by Blueprint.
+ */
+USTRUCT(BlueprintType)
+struct WINDOWSMESSAGELISTENER_API FWindowsMessageEntry
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Windows Message")
+    int64 Window = 0;  // Handle to the window, stored as an integer
+
+    UPROPERTY(BlueprintReadOnly, Category = "Windows Message")
+    int32 Message = 0; // The message identifier
+
+    UPROPERTY(BlueprintReadOnly, Category = "Windows Message")
+    int64 WParam = 0;  // Additional message information
+
+    UPROPERTY(BlueprintReadOnly, Category = "Windows Message")
+    int64 LParam = 0;  // Additional message information
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnWindowsMessagesReceived, const TArray<FWindowsMessageEntry>&, Messages);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FWindowsMessagesDelegate, const TArray<FWindowsMessageEntry>&, Messages);
+DECLARE_DELEGATE_OneParam(FWindowsMessagesNativeDelegate, TArrayView<const FWindowsMessageEntry> /* Messages */);
+
+/**
+ * UWindowsMessageSubsystem
+ * Bridges Windows messages to gameplay code without subclassing IWindowsMessageHandler. A shared listener
+ * gathers every allowed message into one preallocated batch, and the core ticker broadcasts that batch once
+ * per frame on the game thread, so delivery costs one broadcast per frame rather than one task per message.
+ *
+ * OnMessagesReceived receives the whole batch. Bindings made with BindMessages receive only the codes they
+ * subscribed to, and only while their object is alive: delegates bound to a destroyed object are dropped at
+ * the next broadcast. The codes of every binding are added to the listener's allow-list.
+ *
+ * Messages are gathered on the thread that pumps Windows messages, which is the game thread. On other
+ * platforms the subsystem exists but receives nothing, so Blueprints that use it still load.
+ */
+UCLASS()
+class WINDOWSMESSAGELISTENER_API UWindowsMessageSubsystem : public UEngineSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UWindowsMessageSubsystem();
+    virtual ~UWindowsMessageSubsystem();
+
+    /**
+     * Starts the listener and the per-frame broadcast.
+     */
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+    /**
+     * Stops the listener and the per-frame broadcast, dropping messages not yet broadcast.
+     */
+    virtual void Deinitialize() override;
+
+    /**
+     * Adds message codes to the listener's allow-list, for OnMessagesReceived and C++ callers of GatherMessages.
+     * @param MessageCodes - The message codes to allow.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Windows Message")
+    void AddAllowedMessageCodes(const TArray<int32>& MessageCodes);
+
+    /**
+     * Removes message codes added with AddAllowedMessageCodes. Codes a binding subscribed to stay allowed.
+     * @param MessageCodes - The message codes to remove.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Windows Message")
+    void RemoveAllowedMessageCodes(const TArray<int32>& MessageCodes);
+
+    /**
+     * Binds a delegate to the messages of some codes. It is called at most once per frame, with the messages
+     * of those codes gathered since the last broadcast, in arrival order.
+     * @param Delegate - The delegate; held weakly, so the binding ends when its object is destroyed.
+     * @param MessageCodes - The message codes to receive, which are also allowed; empty to receive every allowed message.
+     * @return The id of the binding, for UnbindMessages.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Windows Message")
+    int32 BindMessages(FWindowsMessagesDelegate Delegate, const TArray<int32>& MessageCodes);
+
+    /**
+     * Binds a native delegate to the messages of some codes. Bind it with CreateUObject or CreateWeakLambda
+     * to end the binding when the object is destroyed.
+     * @param Delegate - The delegate.
+     * @param MessageCodes - The message codes to receive, which are also allowed; empty to receive every allowed message.
+     * @return The id of the binding, for UnbindMessages.
+     */
+    int32 BindNativeMessages(FWindowsMessagesNativeDelegate Delegate, TArrayView<const uint32> MessageCodes);
+
+    /**
+     * Removes a binding.
+     * @param BindingId - The id returned by BindMessages or BindNativeMessages.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Windows Message")
+    void UnbindMessages(int32 BindingId);
+
+    /**
+     * Removes every binding of an object.
+     * @param Object - The object the delegates are bound to.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Windows Message")
+    void UnbindAllMessages(const UObject* Object);
+
+    /**
+     * Retrieves the name of a message code, such as "WM_KEYDOWN".
+     */
+    UFUNCTION(BlueprintPure, Category = "Windows Message")
+    static FString GetMessageName(int32 MessageCode);
+
+    /**
+     * Retrieves a message code by its name, such as "WM_KEYDOWN" or "WM_USER + 0x12".
+     * @return The message code, or 0 if the name is not known.
+     */
+    UFUNCTION(BlueprintPure, Category = "Windows Message")
+    static int32 GetMessageCode(const FString& MessageName);
+
+    /**
+     * Appends messages to the batch broadcast at the end of the frame. Called by the listener; also lets tests
+     * and other message sources feed the subsystem. Must be called from the game thread.
+     * @param Batch - The messages.
+     */
+    void GatherMessages(const FWindowsMessageBatchView& Batch);
+
+    /**
+     * Broadcasts the gathered messages to OnMessagesReceived and to every binding, then clears them.
+     * Called by the core ticker once per frame.
+     * @return The number of messages broadcast.
+     */
+    int32 BroadcastMessages();
+
+    /**
+     * Receives every gathered message, once per frame.
+     */
+    UPROPERTY(BlueprintAssignable, Category = "Windows Message")
+    FOnWindowsMessagesReceived OnMessagesReceived;
+
+    /**
+     * Receives every gathered message, once per frame. Bind with AddUObject or AddWeakLambda to end the binding
+     * when the object is destroyed.
+     */
+    DECLARE_MULTICAST_DELEGATE_OneParam(FOnWindowsMessagesReceivedNative, TArrayView<const FWindowsMessageEntry> /* Messages */);
+    FOnWindowsMessagesReceivedNative OnMessagesReceivedNative;
+
+private:
+
+    /**
+     * A delegate and the codes it subscribed to.
+     */
+    struct FMessageBinding
+    {
+        int32 Id = 0;                                  // Returned by BindMessages
+        FWindowsMessagesDelegate Delegate;             // The Blueprint delegate, if bound through Blueprint
+        FWindowsMessagesNativeDelegate NativeDelegate; // The native delegate, otherwise
+        TArray<uint32> MessageCodes;                   // Subscribed codes, as passed to BindMessages; empty for every code
+        FWindowsMessageFilter CodeMask;                // Bitmap of MessageCodes, tested once per gathered message
+    };
+
+    /**
+     * Adds a binding and allows its codes.
+     */
+    int32 AddBinding(FMessageBinding&& Binding);
+
+    /**
+     * Sets the listener's allow-list to the explicitly allowed codes plus the codes of every binding.
+     */
+    void RefreshAllowedMessageCodes();
+
+    /**
+     * Broadcasts the gathered messages from the core ticker.
+     */
+    bool Tick(float DeltaTime);
+
+    TArray<FWindowsMessageEntry> PendingMessages;          // Messages gathered since the last broadcast
+    TArray<FWindowsMessageEntry> BroadcastingMessages;     // Messages being broadcast; swapped with PendingMessages so delegates may feed new ones
+    TArray<FWindowsMessageEntry> FilteredMessages;         // Scratch batch holding the messages of one binding's codes
+    TArray<FMessageBinding> Bindings;                      // Bindings, in the order they were made
+    TArray<uint32> AllowedMessageCodes;                    // Codes added with AddAllowedMessageCodes
+    int32 NextBindingId = 1;                               // Id of the next binding
+    TUniquePtr<FWindowsMessageSubsystemListener> Listener; // The shared listener feeding GatherMessages; null outside Windows
+    FTSTicker::FDelegateHandle TickerHandle;               // Ticker broadcasting the gathered messages once per frame
+};
@@ -0,0 +1,248 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares the raw input (WM_INPUT) ingestion path: device records, their decoder and the reader that queues them.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageRing.h"
+
+#include <atomic>
+
+/**
+ * Device types reported by raw input, with the values of RIM_TYPEMOUSE, RIM_TYPEKEYBOARD and RIM_TYPEHID.
+ */
+enum class EWindowsRawInputDeviceType : uint8
+{
+    Mouse = 0,
+    Keyboard = 1,
+    Hid = 2
+};
+
+/**
+ * How the listener reads raw input when a WM_INPUT arrives.
+ */
+enum class EWindowsRawInputReadMode : uint8
+{
+    PerMessage, // Read the payload of each WM_INPUT with GetRawInputData
+    Buffered    // Also drain every other pending payload with GetRawInputBuffer, removing their WM_INPUT messages from the queue so no one else sees them; only while the listener owns every registered device class
+};
+
+/**
+ * A decoded raw input payload. HID payloads produce one record per report.
+ */
+struct FWindowsRawInputRecord
+{
+    static constexpr int32 MaxHidReportBytes = 64; // Longer HID reports are truncated and counted
+
+    uint64 Device = 0;                                                   // Handle to the device, stored as an integer
+    uint64 Timestamp = 0;                                                // FPlatformTime::Cycles64() when the payload was read
+    EWindowsRawInputDeviceType Type = EWindowsRawInputDeviceType::Mouse; // The device type
+    uint16 Flags = 0;                                                    // MOUSE_MOVE_* flags for mice, RI_KEY_* flags for keyboards
+    uint16 ButtonFlags = 0;                                              // RI_MOUSE_* button transitions
+    int16 ButtonData = 0;                                                // Wheel delta when ButtonFlags has RI_MOUSE_WHEEL or RI_MOUSE_HWHEEL
+    int32 LastX = 0;                                                     // Relative or absolute x motion, see Flags
+    int32 LastY = 0;                                                     // Relative or absolute y motion, see Flags
+    uint16 MakeCode = 0;                                                 // Keyboard scan code
+    uint16 VirtualKey = 0;                                               // Keyboard VK_* code
+    uint32 Message = 0;                                                  // Keyboard window message, such as WM_KEYDOWN
+    uint8 HidReportSize = 0;                                             // Bytes used in HidReport
+    uint8 HidReport[MaxHidReportBytes] = {};                             // HID report bytes
+};
+
+/**
+ * Checks if two raw input records can be merged into one, keeping only the newest.
+ * Only absolute pointer positions without button transitions qualify; relative motion must never be dropped.
+ * @return True if both records are absolute moves of the same device.
+ */
+FORCEINLINE bool AreWindowsMessagesCoalescable(const FWindowsRawInputRecord& A, const FWindowsRawInputRecord& B)
+{
+    constexpr uint16 MouseMoveAbsolute = 0x0001; // MOUSE_MOVE_ABSOLUTE
+    return A.Type == EWindowsRawInputDeviceType::Mouse && B.Type == EWindowsRawInputDeviceType::Mouse && A.Device == B.Device
+        && (A.Flags & B.Flags & MouseMoveAbsolute) && A.ButtonFlags == 0 && B.ButtonFlags == 0;
+}
+
+/**
+ * Snapshot of a raw input reader's counters.
+ */
+struct FWindowsRawInputCounters
+{
+    uint64 PayloadsRead = 0;     // RAWINPUT payloads decoded
+    uint64 Malformed = 0;        // Payloads rejected because their sizes did not add up
+    uint64 Oversized = 0;        // Payloads that did not fit the arena and were skipped
+    uint64 TruncatedReports = 0; // HID reports longer than FWindowsRawInputRecord::MaxHidReportBytes
+    FWindowsMessageRingCounters Queue; // Counters of the record queue; drops are counted here
+};
+
+/**
+ * FWindowsRawInputDecoder
+ * Pure decoders for RAWINPUT payloads. They read the 64-bit layout of the Windows structures from plain
+ * bytes, so they behave the same on every platform and can be fed synthetic payloads.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsRawInputDecoder
+{
+public:
+    static constexpr int32 HeaderSize = 24;   // sizeof(RAWINPUTHEADER)
+    static constexpr int32 MouseSize = 24;    // sizeof(RAWMOUSE)
+    static constexpr int32 KeyboardSize = 16; // sizeof(RAWKEYBOARD)
+    static constexpr int32 HidHeaderSize = 8; // Offset of RAWHID::bRawData
+    static constexpr int32 BlockAlignment = 8; // Alignment of consecutive payloads returned by GetRawInputBuffer
+
+    /**
+     * Reads the header of a payload.
+     * @param Data - The payload.
+     * @param Size - Number of readable bytes at Data.
+     * @param OutType - Receives the device type.
+     * @param OutPayloadSize - Receives the payload size from the header, header included.
+     * @param OutDevice - Receives the device handle.
+     * @return False if the header is truncated, of an unknown type, or claims more bytes than are readable.
+     */
+    static bool DecodeHeader(const uint8* Data, int32 Size, EWindowsRawInputDeviceType& OutType, int32& OutPayloadSize, uint64& OutDevice);
+
+    /**
+     * Decodes a mouse payload.
+     * @return False if the payload is not a well-formed mouse payload.
+     */
+    static bool DecodeMouse(const uint8* Data, int32 Size, uint64 Timestamp, FWindowsRawInputRecord& OutRecord);
+
+    /**
+     * Decodes a keyboard payload.
+     * @return False if the payload is not a well-formed keyboard payload.
+     */
+    static bool DecodeKeyboard(const uint8* Data, int32 Size, uint64 Timestamp, FWindowsRawInputRecord& OutRecord);
+
+    /**
+     * Retrieves the report layout of a HID payload.
+     * @param OutReportSize - Receives the size of each report.
+     * @param OutReportCount - Receives the number of reports.
+     * @return False if the payload is not a well-formed HID payload.
+     */
+    static bool DecodeHidLayout(const uint8* Data, int32 Size, int32& OutReportSize, int32& OutReportCount);
+
+    /**
+     * Decodes one report of a HID payload. Reports longer than MaxHidReportBytes are truncated.
+     * @param ReportIndex - Index of the report, below the count from DecodeHidLayout.
+     * @return False if the payload is not a well-formed HID payload or has no such report.
+     */
+    static bool DecodeHidReport(const uint8* Data, int32 Size, int32 ReportIndex, uint64 Timestamp, FWindowsRawInputRecord& OutRecord);
+};
+
+/**
+ * FWindowsRawInputReader
+ * Ingests raw input for 1000-8000 Hz mice and custom HID hardware. Payloads are read into a preallocated
+ * arena, decoded into fixed-size records and pushed to a lock-free single-producer/single-consumer ring,
+ * so no heap allocation happens per payload.
+ *
+ * Ingest functions take plain bytes and run on any platform; the Read functions fetch payloads from
+ * Windows into the arena and ingest them. All of them must be called from one producer thread, and
+ * records must be popped from one consumer thread.
+ */
+class WINDOWSMESSAGELISTENER_API FWindowsRawInputReader
+{
+public:
+    /**
+     * @param QueueCapacity - Number of records the queue can hold; rounded up to a power of two.
+     * @param ArenaBytes - Size of the arena payloads are read into; bounds the data of one buffered read.
+     * @param OverflowPolicy - What to do with new records while the queue is full.
+     */
+    FWindowsRawInputReader(uint32 QueueCapacity, int32 ArenaBytes, EWindowsMessageOverflowPolicy OverflowPolicy = EWindowsMessageOverflowPolicy::DropNewest);
+
+    FWindowsRawInputReader(const FWindowsRawInputReader&) = delete;
+    FWindowsRawInputReader& operator=(const FWindowsRawInputReader&) = delete;
+
+    /**
+     * Decodes one RAWINPUT payload and queues its records.
+     * @param Data - The payload.
+     * @param Size - Number of bytes at Data.
+     * @param Timestamp - FPlatformTime::Cycles64() when the payload was read.
+     * @return The number of records queued.
+     */
+    int32 IngestRawInput(const uint8* Data, int32 Size, uint64 Timestamp);
+
+    /**
+     * Decodes consecutive RAWINPUT payloads as returned by GetRawInputBuffer, each aligned to BlockAlignment.
+     * @param Data - The first payload.
+     * @param Size - Number of bytes at Data.
+     * @param Count - Number of payloads.
+     * @param Timestamp - FPlatformTime::Cycles64() when the payloads were read.
+     * @return The number of records queued.
+     */
+    int32 IngestRawInputBuffer(const uint8* Data, int32 Size, int32 Count, uint64 Timestamp);
+
+#if PLATFORM_WINDOWS
+    /**
+     * Reads the payload of a WM_INPUT into the arena and ingests it.
+     * @param RawInputHandle - The lParam of the WM_INPUT.
+     * @param Timestamp - FPlatformTime::Cycles64() when the message arrived.
+     * @return The number of records queued.
+     */
+    int32 ReadRawInput(int64 RawInputHandle, uint64 Timestamp);
+
+    /**
+     * Reads every pending payload with GetRawInputBuffer, one arena-full at a time, and ingests them.
+     * @param Timestamp - FPlatformTime::Cycles64() of the read.
+     * @return The number of records queued.
+     */
+    int32 ReadBufferedRawInput(uint64 Timestamp);
+#endif
+
+    /**
+     * Copies up to MaxRecords of the oldest queued records out of the queue. Must only be called from the consumer thread.
+     * @return The number of records copied.
+     */
+    int32 PopRecords(FWindowsRawInputRecord* OutRecords, int32 MaxRecords)
+    {
+        return Records.PopBatch(OutRecords, MaxRecords);
+    }
+
+    /**
+     * Pops queued records in batches and passes each one to a function. Must only be called from the consumer thread.
+     * @param Func - Callable taking a const FWindowsRawInputRecord&.
+     * @param MaxRecords - Maximum number of records to drain.
+     * @return The number of records drained.
+     */
+    template<typename FuncType>
+    int32 DrainRecords(FuncType&& Func, int32 MaxRecords = MAX_int32)
+    {
+        return Records.Drain(Forward<FuncType>(Func), MaxRecords);
+    }
+
+    /**
+     * @return The approximate number of queued records.
+     */
+    uint32 NumQueuedRecords() const
+    {
+        return Records.Num();
+    }
+
+    /**
+     * @return The size of the arena in bytes.
+     */
+    int32 GetArenaSize() const
+    {
+        return Arena.Num() * static_cast<int32>(sizeof(uint64));
+    }
+
+    /**
+     * @return A snapshot of the counters; safe to call from any thread.
+     */
+    FWindowsRawInputCounters GetCounters() const;
+
+private:
+
+    /**
+     * Queues a record, counting it as dropped if the queue is full.
+     * @return 1 if the record was queued, 0 otherwise.
+     */
+    int32 QueueRecord(const FWindowsRawInputRecord& Record);
+
+    TArray<uint64> Arena;                          // Payload storage, in words so it meets the alignment GetRawInputBuffer requires
+    TWindowsMessageRing<FWindowsRawInputRecord> Records; // Decoded records awaiting the consumer
+
+    std::atomic<uint64> PayloadsRead{0};
+    std::atomic<uint64> Malformed{0};
+    std::atomic<uint64> Oversized{0};
+    std::atomic<uint64> TruncatedReports{0};
+};
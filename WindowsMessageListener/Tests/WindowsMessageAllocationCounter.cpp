@@ -0,0 +1,148 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This file implements the FMalloc proxy behind FWindowsMessageAllocationCounter.
+ */
+
+#include "WindowsMessageAllocationCounter.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "Misc/Parse.h"
+
+#include <atomic>
+
+thread_local FWindowsMessageAllocationCounter* FWindowsMessageAllocationCounter::ActiveCounter = nullptr;
+
+namespace
+{
+    std::atomic<bool> bCountingMallocInstalled{false};
+
+    /**
+     * Forwards every call to the allocator it wraps, counting allocations on threads with a counter in scope.
+     * Installed once and never removed, since other threads may be inside it or hold memory it handed out.
+     */
+    class FCountingMalloc final : public FMalloc
+    {
+    public:
+        explicit FCountingMalloc(FMalloc* InInnerMalloc)
+            : InnerMalloc(InInnerMalloc)
+        {
+        }
+
+        virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+        {
+            FWindowsMessageAllocationCounter::CountAllocation();
+            return InnerMalloc->Malloc(Count, Alignment);
+        }
+
+        virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+        {
+            FWindowsMessageAllocationCounter::CountAllocation();
+            return InnerMalloc->Realloc(Original, Count, Alignment);
+        }
+
+        virtual void Free(void* Original) override
+        {
+            InnerMalloc->Free(Original);
+        }
+
+        virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+        {
+            return InnerMalloc->GetAllocationSize(Original, SizeOut);
+        }
+
+        virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+        {
+            return InnerMalloc->QuantizeSize(Count, Alignment);
+        }
+
+        virtual void Trim(bool bTrimThreadCaches) override
+        {
+            InnerMalloc->Trim(bTrimThreadCaches);
+        }
+
+        virtual void SetupTLSCachesOnCurrentThread() override
+        {
+            InnerMalloc->SetupTLSCachesOnCurrentThread();
+        }
+
+        virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+        {
+            InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+        }
+
+        virtual void InitializeStatsMetadata() override
+        {
+            InnerMalloc->InitializeStatsMetadata();
+        }
+
+        virtual void UpdateStats() override
+        {
+            InnerMalloc->UpdateStats();
+        }
+
+        virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+        {
+            InnerMalloc->GetAllocatorStats(OutStats);
+        }
+
+        virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+        {
+            InnerMalloc->DumpAllocatorStats(Ar);
+        }
+
+        virtual bool ValidateHeap() override
+        {
+            return InnerMalloc->ValidateHeap();
+        }
+
+        virtual bool IsInternallyThreadSafe() const override
+        {
+            return InnerMalloc->IsInternallyThreadSafe();
+        }
+
+        virtual const TCHAR* GetDescriptiveName() override
+        {
+            return InnerMalloc->GetDescriptiveName();
+        }
+
+    private:
+
+        FMalloc* InnerMalloc; // The allocator that was installed before this one
+    };
+
+#if WITH_DEV_AUTOMATION_TESTS
+    // Wraps GMalloc once the engine is up, before any test can run, and only when the process was started with the
+    // switch; loading the plugin alone never replaces the engine's allocator
+    FDelayedAutoRegisterHelper GInstallCountingMalloc(EDelayedRegisterRunPhase::EndOfEngineInit, []
+    {
+        if (!FParse::Param(FCommandLine::Get(), FWindowsMessageAllocationCounter::CommandLineSwitch))
+        {
+            return;
+        }
+        if (GMalloc && !bCountingMallocInstalled.exchange(true))
+        {
+            GMalloc = new FCountingMalloc(GMalloc); // Intentionally leaked, see FCountingMalloc
+        }
+    });
+#endif
+}
+
+bool FWindowsMessageAllocationCounter::IsInstalled()
+{
+    return bCountingMallocInstalled.load(std::memory_order_relaxed);
+}
+
+void FWindowsMessageAllocationCounter::TestNoAllocations(FAutomationTestBase& Test, const TCHAR* What, uint64 NumAllocations)
+{
+    if (IsInstalled())
+    {
+        Test.TestEqual(What, NumAllocations, uint64(0));
+    }
+    else
+    {
+        Test.AddInfo(FString::Printf(TEXT("Skipped \"%s\": run with -%s to count allocations."), What, CommandLineSwitch));
+    }
+}
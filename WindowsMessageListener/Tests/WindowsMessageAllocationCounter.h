@@ -0,0 +1,78 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares a scoped allocation counter used by the benchmarks.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAutomationTestBase;
+
+/**
+ * FWindowsMessageAllocationCounter
+ * Counts the heap allocations made by the calling thread while the counter is in scope.
+ * Counting goes through an FMalloc proxy that wraps GMalloc once, at the end of engine init, and is never
+ * removed; it only counts on threads with a counter in scope, so other allocations are forwarded untouched.
+ * The proxy is opt-in: it is only installed when the process is started with -WindowsMessageCountAllocations.
+ * Without it counters stay at zero and TestNoAllocations skips its check.
+ */
+class FWindowsMessageAllocationCounter
+{
+public:
+    UE_NONCOPYABLE(FWindowsMessageAllocationCounter);
+
+    /** Command-line switch, without the leading dash, that installs the counting proxy. */
+    static constexpr const TCHAR* CommandLineSwitch = TEXT("WindowsMessageCountAllocations");
+
+    FWindowsMessageAllocationCounter()
+        : OuterCounter(ActiveCounter)
+    {
+        ActiveCounter = this;
+    }
+
+    ~FWindowsMessageAllocationCounter()
+    {
+        ActiveCounter = OuterCounter;
+    }
+
+    /**
+     * @return The number of allocations and reallocations made by this thread since the counter was created.
+     */
+    uint64 GetNumAllocations() const
+    {
+        return NumAllocations;
+    }
+
+    /**
+     * Counts an allocation against every counter in scope on the calling thread. Called by the proxy.
+     */
+    static void CountAllocation()
+    {
+        for (FWindowsMessageAllocationCounter* Counter = ActiveCounter; Counter; Counter = Counter->OuterCounter)
+        {
+            ++Counter->NumAllocations;
+        }
+    }
+
+    /**
+     * @return True once the counting proxy wraps GMalloc, which requires the command-line switch.
+     */
+    static bool IsInstalled();
+
+    /**
+     * Checks that no allocation was counted, or notes that the check was skipped when the proxy is not installed.
+     * @param Test - The running automation test.
+     * @param What - Description of the check.
+     * @param NumAllocations - The number of allocations counted.
+     */
+    static void TestNoAllocations(FAutomationTestBase& Test, const TCHAR* What, uint64 NumAllocations);
+
+private:
+
+    static thread_local FWindowsMessageAllocationCounter* ActiveCounter; // Innermost counter in scope on this thread
+
+    FWindowsMessageAllocationCounter* OuterCounter; // The counter this one is nested in, restored when it goes out of scope
+    uint64 NumAllocations = 0;                      // Only touched by the thread that created the counter
+};
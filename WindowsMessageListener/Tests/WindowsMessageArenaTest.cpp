@@ -0,0 +1,158 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageArena.h"
+#include "WindowsMessageDispatcher.h"
+#include "WindowsMessageEvents.h"
+#include "WindowsMessageCodeHelper.h"
+#include "WindowsMessageAllocationCounter.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+namespace
+{
+    /** Handler that keeps frame-scoped copies of what it sees, the way a recording or debug overlay would. */
+    struct FArenaRecordingHandler : public IWindowsInputEventHandler
+    {
+        bool HandleMessage(const FWindowsMessageRecord& Record, int32& OutResult)
+        {
+            Records.Add(Arena->New<FWindowsMessageRecord>(Record));
+            LastLine = FWindowsMessageCodeHelper::FormatMessageDetails(*Arena, TEXT("Frame"), Record.Hwnd, Record.Msg);
+            LastName = FWindowsMessageCodeHelper::GetMessageInfoView(Record.Msg, *Arena).Name;
+            return false;
+        }
+
+        virtual void OnMouseMoveEvents(TArrayView<const FWindowsMouseMoveEvent> Events) override
+        {
+            MouseMoves = Arena->CopyArray(Events);
+        }
+
+        FWindowsMessageFrameArena* Arena = nullptr;
+        TArray<FWindowsMessageRecord*, TInlineAllocator<256>> Records; // Reset every frame; inline, so it never grows on the heap
+        TArrayView<FWindowsMouseMoveEvent> MouseMoves;
+        FStringView LastLine;
+        FStringView LastName;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageFrameArenaTest, "WindowsMessageListener.Arena.FrameArena", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageFrameArenaTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageFrameArena Arena(1024);
+
+    uint8* Byte = static_cast<uint8*>(Arena.Allocate(1, 1));
+    uint64* Aligned = static_cast<uint64*>(Arena.Allocate(sizeof(uint64), 64));
+    TestTrue("Allocations should be aligned", Byte != nullptr && reinterpret_cast<UPTRINT>(Aligned) % 64 == 0);
+
+    const FStringView Copy = Arena.CopyString(TEXT("WM_USER + 0x12"));
+    TestTrue("Strings should be copied and null-terminated", Copy == TEXT("WM_USER + 0x12") && Copy.GetData()[Copy.Len()] == TEXT('\0'));
+
+    TArrayView<FWindowsMessageRecord> Records = Arena.NewArray<FWindowsMessageRecord>(100); // Larger than one block
+    TestEqual("Arrays should hold every element", Records.Num(), 100);
+    TestEqual("Arrays should be value-initialized", Records[99].Msg, uint32(0));
+    TestEqual("Oversized requests should add a block", Arena.GetCounters().HeapAllocations, uint64(2));
+
+    // Once grown, the same frame again is served entirely from kept blocks
+    Arena.Reset();
+    uint64 NumAllocations = 0;
+    {
+        FWindowsMessageAllocationCounter Counter;
+        for (int32 Frame = 0; Frame < 100; ++Frame)
+        {
+            Arena.Allocate(1, 1);
+            Arena.Allocate(sizeof(uint64), 64);
+            Arena.CopyString(TEXT("WM_USER + 0x12"));
+            Arena.NewArray<FWindowsMessageRecord>(100);
+            Arena.Reset();
+        }
+        NumAllocations = Counter.GetNumAllocations();
+    }
+    FWindowsMessageAllocationCounter::TestNoAllocations(*this, TEXT("Resets should keep every block"), NumAllocations);
+
+    const FWindowsMessageArenaCounters Counters = Arena.GetCounters();
+    TestEqual("Heap allocations should stay constant", Counters.HeapAllocations, uint64(2));
+    TestTrue("Peak frame bytes should cover a frame", Counters.PeakFrameBytes >= 100 * sizeof(FWindowsMessageRecord) && Counters.FrameBytes == 0);
+    TestEqual("Resets should be counted", Counters.Resets, uint64(101));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageSlabPoolTest, "WindowsMessageListener.Arena.SlabPool", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageSlabPoolTest::RunTest(const FString& Parameters)
+{
+    TWindowsMessageSlabPool<FWindowsMessageRecord, 4> Pool;
+    TArray<FWindowsMessageRecord*> Live;
+    for (uint32 Index = 0; Index < 6; ++Index)
+    {
+        Live.Add(Pool.Acquire(1, SyntheticKeyDown, Index, 0, 0));
+    }
+    TestEqual("Slabs should be added on demand", Pool.NumSlabs(), 2);
+    TestEqual("Objects should be constructed", Live[5]->WParam, uint64(5));
+
+    FWindowsMessageRecord* Released = Live.Pop();
+    Pool.Release(Released);
+    TestTrue("Released slots should be reused first", Pool.Acquire() == Released);
+    Live.Add(Released);
+    TestEqual("Live objects", Pool.NumLiveObjects(), 6);
+
+    for (FWindowsMessageRecord* Record : Live)
+    {
+        Pool.Release(Record);
+    }
+    TestEqual("Every object should be released", Pool.NumLiveObjects(), 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageSteadyStateAllocationTest, "WindowsMessageListener.Arena.SteadyStateAllocations", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageSteadyStateAllocationTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageRange(SyntheticKeyDown, SyntheticKeyDown);
+    Dispatcher.AllowMessageRange(SyntheticMouseMove, SyntheticButtonDown);
+    Dispatcher.AllowMessageType(SyntheticUser + 5);
+    Dispatcher.AddCoalescedMessageType(SyntheticMouseMove);
+    Dispatcher.EnableMessageBatching(64, false);
+    Dispatcher.EnableFrameArena(4096);
+
+    FArenaRecordingHandler Handler;
+    Handler.Arena = Dispatcher.GetFrameArena();
+    FWindowsInputEventRouter Router;
+    Router.SetFrameArena(Dispatcher.GetFrameArena());
+    Router.AddHandler(&Handler, EWindowsInputEventTypes::MouseMove);
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&Handler), {});
+    Dispatcher.AddBatchHandler(FWindowsMessageBatchHandlerRef::Create(&Router));
+
+    // One simulated engine tick: the arena reset of the previous tick, messages, then the work the core ticker does
+    auto RunFrame = [&Dispatcher, &Handler]()
+    {
+        Handler.Records.Reset();
+        Dispatcher.ResetFrameArena();
+        int32 Result = 0;
+        for (int32 Index = 0; Index < 48; ++Index)
+        {
+            const uint32 Msg = Index % 16 == 0 ? SyntheticButtonDown : Index % 16 == 1 ? SyntheticUser + 5 : Index % 8 == 2 ? SyntheticKeyDown : SyntheticMouseMove;
+            Dispatcher.ProcessMessage(FWindowsMessageRecord(1 + Index % 2, Msg, 0, Index, 0), Result);
+        }
+        Dispatcher.FlushCoalescedMessages();
+        Dispatcher.FlushMessageBatch();
+    };
+
+    RunFrame(); // Warm up: every container and arena block reaches its steady-state size
+    TestTrue("Frame data should be readable until the next reset", Handler.Records.Num() > 0 && Handler.MouseMoves.Num() > 0 && Handler.LastName.StartsWith(TEXT("WM_")) && Handler.LastLine.Contains(TEXT("hwnd=")));
+    const uint64 WarmHeapAllocations = Dispatcher.GetFrameArenaCounters().HeapAllocations;
+    uint64 NumAllocations = 0;
+    {
+        FWindowsMessageAllocationCounter Counter;
+        for (int32 Frame = 0; Frame < 1000; ++Frame)
+        {
+            RunFrame();
+        }
+        NumAllocations = Counter.GetNumAllocations();
+    }
+
+    FWindowsMessageAllocationCounter::TestNoAllocations(*this, TEXT("The steady-state message path should not touch the global heap"), NumAllocations);
+    TestTrue("Handlers should have allocated from the arena", Dispatcher.GetFrameArenaCounters().PeakFrameBytes > 0);
+    TestEqual("The arena should not have grown after warm-up", Dispatcher.GetFrameArenaCounters().HeapAllocations, WarmHeapAllocations);
+
+    Dispatcher.RemoveAllHandlers();
+    return true;
+}
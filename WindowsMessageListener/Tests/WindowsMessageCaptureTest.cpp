@@ -0,0 +1,79 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageDispatcher.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageCaptureTest, "WindowsMessageListener.CaptureAndReplay", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageCaptureTest::RunTest(const FString& Parameters)
+{
+    const FString Filename = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("WindowsMessageCaptureTest.wmcap"));
+    constexpr int32 NumMessages = 1000;
+
+    // Capture everything the dispatcher sees, including messages the filter rejects
+    {
+        FWindowsMessageDispatcher Dispatcher;
+        Dispatcher.AllowMessageType(SyntheticKeyDown);
+        Dispatcher.AllowMessageType(SyntheticMouseMove);
+        if (!TestTrue("Capture file should be created", Dispatcher.StartCapture(Filename, 128)))
+        {
+            return false;
+        }
+
+        int32 Result = 0;
+        for (int32 Index = 0; Index < NumMessages; ++Index)
+        {
+            const uint32 Msg = Index % 10 == 0 ? SyntheticSetCursor : Index % 3 == 0 ? SyntheticKeyDown : SyntheticMouseMove;
+            Dispatcher.ProcessMessage(FWindowsMessageRecord(0xABC0 + Index % 2, Msg, Index, -Index, FPlatformTime::Cycles64()), Result);
+            if (Index % 100 == 99)
+            {
+                FPlatformProcess::Sleep(0.001f); // Give the flush thread time so no buffer is dropped
+            }
+        }
+        Dispatcher.StopCapture();
+    }
+
+    FWindowsMessageCaptureReader Reader;
+    if (!TestTrue("Capture file should be readable", Reader.Open(*Filename)))
+    {
+        return false;
+    }
+    const TArrayView<const FWindowsMessageCaptureRecord> Records = Reader.GetRecords();
+    if (TestEqual("Every message should be captured", Records.Num(), NumMessages))
+    {
+        TestEqual("Windows should get ids in order of appearance", Records[0].HwndId, 1u);
+        TestEqual("Second window id", Records[1].HwndId, 2u);
+        TestEqual("Rejected messages should be captured", Records[0].Msg, SyntheticSetCursor);
+        TestEqual("Parameters should round-trip", Records[7].WParam, uint64(7));
+        TestEqual("Signed parameters should round-trip", Records[7].LParam, int64(-7));
+    }
+
+    // Replaying through a dispatcher with the same filter delivers the same sequence
+    FWindowsMessageDispatcher Replayer;
+    Replayer.AllowMessageType(SyntheticKeyDown);
+    Replayer.AllowMessageType(SyntheticMouseMove);
+    FWindowsMessageTestHandler Handler;
+    Replayer.AddHandler(FWindowsMessageHandlerRef::Create(&Handler), {});
+    Reader.Close();
+
+    // A replay is not captured again, so replaying while capturing never records the replayed stream
+    const FString RecaptureFilename = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("WindowsMessageRecaptureTest.wmcap"));
+    TestTrue("A second capture file should be created", Replayer.StartCapture(RecaptureFilename, 128));
+    TestEqual("Replay should feed every record", Replayer.ReplayCapture(Filename, EWindowsMessageReplayTiming::AsFastAsPossible), NumMessages);
+    TestEqual("Replayed messages should not be captured", Replayer.GetCaptureCounters().RecordsCaptured, uint64(0));
+    Replayer.StopCapture();
+    TestEqual("Replay should apply the filter", Handler.Received.Num(), NumMessages - NumMessages / 10);
+    if (Handler.Received.Num() > 0)
+    {
+        TestEqual("Replayed messages should carry the window id", Handler.Received[0].Hwnd, uint64(2));
+        TestEqual("Replayed message parameters", Handler.Received[0].WParam, uint64(1));
+    }
+
+    TestEqual("Invalid files should not replay", Replayer.ReplayCapture(FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("Missing.wmcap")), EWindowsMessageReplayTiming::AsFastAsPossible), INDEX_NONE);
+
+    FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*Filename);
+    FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*RecaptureFilename);
+    return true;
+}
@@ -0,0 +1,78 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageCodeHelper.h"
+#include "WindowsMessageCodeTable.h"
+#include "WindowsMessageArena.h"
+
+// The table is checked when this file compiles, so a bad entry fails the build rather than a test run
+static_assert(IsWindowsMessageCodeTableSortedAndUnique(), "WindowsMessageCodeTable must be sorted by code with no duplicates.");
+static_assert(NumWindowsMessageCodes >= 200, "WindowsMessageCodeTable should cover the winuser.h message set.");
+static_assert(FindWindowsMessageCodeEntry(0x0100) != nullptr && FindWindowsMessageCodeEntry(0x0100)->Code == 0x0100, "WM_KEYDOWN should be found at compile time.");
+static_assert(FindWindowsMessageCodeEntry(0x0004) == nullptr, "Unused codes should not be found.");
+static_assert(WindowsMessageNameIndex.Find(TEXT("wm_keydown"), 10) == FindWindowsMessageCodeEntry(0x0100), "The name index should ignore case at compile time.");
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageCodeTableTest, "WindowsMessageListener.CodeHelper.Table", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageCodeTableTest::RunTest(const FString& Parameters)
+{
+    // Every entry should be reachable through the binary search
+    for (const FWindowsMessageCodeEntry& Entry : WindowsMessageCodeTable)
+    {
+        const FWindowsMessageCodeEntry* Found = FindWindowsMessageCodeEntry(Entry.Code);
+        if (!TestTrue(FString::Printf(TEXT("%s should be found"), Entry.Name), Found == &Entry))
+        {
+            break;
+        }
+    }
+
+    TestEqual("Known message name", FWindowsMessageCodeHelper::GetMessageName(0x0200), FString(TEXT("WM_MOUSEMOVE")));
+    TestEqual("Known message description view", FString(FWindowsMessageCodeHelper::GetMessageDescriptionView(0x00FF)), FString(TEXT("Sent when a window receives raw input.")));
+    TestEqual("WM_USER range name", FWindowsMessageCodeHelper::GetMessageName(0x0412), FString(TEXT("WM_USER + 0x12")));
+    TestEqual("WM_APP range name", FWindowsMessageCodeHelper::GetMessageName(0x8003), FString(TEXT("WM_APP + 0x3")));
+    TestEqual("Unknown message name", FWindowsMessageCodeHelper::GetMessageName(0x0004), FString(TEXT("Unknown")));
+
+    // Arena views of formatted names must survive later lookups that reuse the per-thread cache
+    FWindowsMessageFrameArena Arena;
+    const FWindowsMessageInfoView UserInfo = FWindowsMessageCodeHelper::GetMessageInfoView(0x0412, Arena);
+    for (uint32 MsgCode = 0x0400; MsgCode < 0x0500; ++MsgCode)
+    {
+        FWindowsMessageCodeHelper::GetMessageNameView(MsgCode);
+    }
+    TestTrue("WM_USER info view", UserInfo.Name == TEXT("WM_USER + 0x12") && UserInfo.Description.Len() > 0);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageCodeByNameTest, "WindowsMessageListener.CodeHelper.CodeByName", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageCodeByNameTest::RunTest(const FString& Parameters)
+{
+    // Every name in the table should resolve to its own code
+    for (const FWindowsMessageCodeEntry& Entry : WindowsMessageCodeTable)
+    {
+        if (!TestEqual(FString::Printf(TEXT("%s should resolve"), Entry.Name), FWindowsMessageCodeHelper::GetMessageCodeByName(Entry.Name), Entry.Code))
+        {
+            break;
+        }
+    }
+
+    uint32 MsgCode = 0;
+    TestEqual("Names should be case-insensitive", FWindowsMessageCodeHelper::GetMessageCodeByName(TEXT("wm_MouseMove")), 0x0200u);
+    TestTrue("WM_USER offset should resolve", FWindowsMessageCodeHelper::TryGetMessageCodeByName(TEXT("WM_USER + 0x12"), MsgCode));
+    TestEqual("WM_USER offset code", MsgCode, 0x0412u);
+    TestTrue("WM_APP offset without spaces should resolve", FWindowsMessageCodeHelper::TryGetMessageCodeByName(TEXT("wm_app+3"), MsgCode));
+    TestEqual("WM_APP offset code", MsgCode, 0x8003u);
+    TestTrue("Plain numbers should resolve", FWindowsMessageCodeHelper::TryGetMessageCodeByName(TEXT(" 0x0100 "), MsgCode));
+    TestEqual("Plain number code", MsgCode, 0x0100u);
+
+    // Names produced by GetMessageName for custom ranges should round-trip
+    const uint32 CustomCodes[] = { 0x0400, 0x0401, 0x7FFF, 0x8000, 0xBFFF };
+    for (uint32 CustomCode : CustomCodes)
+    {
+        TestEqual(FString::Printf(TEXT("0x%X should round-trip"), CustomCode), FWindowsMessageCodeHelper::GetMessageCodeByName(FWindowsMessageCodeHelper::GetMessageName(CustomCode)), CustomCode);
+    }
+
+    TestFalse("Unknown names should not resolve", FWindowsMessageCodeHelper::TryGetMessageCodeByName(TEXT("WM_NOT_A_MESSAGE"), MsgCode));
+    TestFalse("Malformed offsets should not resolve", FWindowsMessageCodeHelper::TryGetMessageCodeByName(TEXT("WM_USER + 0xZZ"), MsgCode));
+    TestFalse("Offsets from unknown names should not resolve", FWindowsMessageCodeHelper::TryGetMessageCodeByName(TEXT("12 + 3"), MsgCode));
+    TestEqual("Unknown names should return 0", FWindowsMessageCodeHelper::GetMessageCodeByName(TEXT("WM_NOT_A_MESSAGE")), 0u);
+
+    return true;
+}
@@ -0,0 +1,339 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageDispatcher.h"
+#include "WindowsMessageAllocationCounter.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+namespace
+{
+    // Messages between two simulated engine ticks, which flush coalesced messages
+    constexpr int32 MessagesPerFrame = 64;
+
+    /** Handler that only counts the messages it receives. */
+    struct FBenchmarkMessageHandler
+    {
+        bool HandleMessage(const FWindowsMessageRecord& Record, int32& OutResult)
+        {
+            ++MessageCount;
+            return false;
+        }
+
+        int32 MessageCount = 0;
+    };
+
+    /** Batch handler that scans the message column of every batch. */
+    struct FBenchmarkBatchHandler
+    {
+        void ProcessMessages(const FWindowsMessageBatchView& Batch)
+        {
+            for (uint32 Msg : Batch.Msgs)
+            {
+                MouseMoveCount += Msg == SyntheticMouseMove;
+            }
+        }
+
+        int32 MouseMoveCount = 0;
+    };
+
+    /** Thread-safe handler that spins for a fixed time per message, standing in for telemetry or a hardware bridge. */
+    struct FExpensiveMessageHandler
+    {
+        bool HandleMessage(const FWindowsMessageRecord& Record, int32& OutResult)
+        {
+            const uint64 End = FPlatformTime::Cycles64() + Cycles;
+            while (FPlatformTime::Cycles64() < End)
+            {
+            }
+            ++MessageCount;
+            return false;
+        }
+
+        uint64 Cycles = 0;
+        int32 MessageCount = 0;
+    };
+
+    /** A mouse storm: continuous moves over two windows with a click every few hundred messages. */
+    TArray<FWindowsMessageRecord> MakeMouseStorm(int32 NumMessages)
+    {
+        TArray<FWindowsMessageRecord> Stream;
+        Stream.Reserve(NumMessages);
+        for (int32 Index = 0; Index < NumMessages; ++Index)
+        {
+            const uint64 Hwnd = 1 + (Index / 1000) % 2;
+            const uint32 Msg = Index % 500 == 0 ? SyntheticButtonDown : Index % 500 == 1 ? SyntheticButtonUp : SyntheticMouseMove;
+            Stream.Emplace(Hwnd, Msg, 0, static_cast<int64>(Index), 0);
+        }
+        return Stream;
+    }
+
+    /** Key bursts: down, char and up triples typed in quick succession. */
+    TArray<FWindowsMessageRecord> MakeKeyBursts(int32 NumMessages)
+    {
+        static constexpr uint32 KeySequence[] = { SyntheticKeyDown, SyntheticChar, SyntheticKeyUp };
+        TArray<FWindowsMessageRecord> Stream;
+        Stream.Reserve(NumMessages);
+        for (int32 Index = 0; Index < NumMessages; ++Index)
+        {
+            Stream.Emplace(1, KeySequence[Index % UE_ARRAY_COUNT(KeySequence)], 0x41 + (Index / 3) % 26, 0, 0);
+        }
+        return Stream;
+    }
+
+    /** Mixed traffic: mostly mouse moves, some keys, user messages and codes the filter rejects. */
+    TArray<FWindowsMessageRecord> MakeMixedTraffic(int32 NumMessages)
+    {
+        static constexpr uint32 MixedCodes[] = { SyntheticMouseMove, SyntheticMouseMove, SyntheticMouseMove, SyntheticHitTest, SyntheticSetCursor, SyntheticKeyDown, SyntheticKeyUp, SyntheticUser + 7 };
+        FRandomStream Random(0x5EED);
+        TArray<FWindowsMessageRecord> Stream;
+        Stream.Reserve(NumMessages);
+        for (int32 Index = 0; Index < NumMessages; ++Index)
+        {
+            Stream.Emplace(1 + Random.RandHelper(4), MixedCodes[Random.RandHelper(UE_ARRAY_COUNT(MixedCodes))], 0, static_cast<int64>(Index), 0);
+        }
+        return Stream;
+    }
+
+    /** Subscribes handlers the way a typical project would: a few input handlers and many unrelated user message handlers. */
+    void AddBenchmarkHandlers(FWindowsMessageDispatcher& Dispatcher, TArray<FBenchmarkMessageHandler>& Handlers)
+    {
+        Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&Handlers[0]), {});
+        Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&Handlers[1]), { TPair<uint32, uint32>(SyntheticKeyDown, SyntheticChar) });
+        Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&Handlers[2]), { TPair<uint32, uint32>(SyntheticMouseMove, SyntheticButtonUp) });
+        for (int32 Index = 3; Index < Handlers.Num(); ++Index)
+        {
+            const uint32 MsgCode = SyntheticUser + static_cast<uint32>(Index);
+            Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&Handlers[Index]), { TPair<uint32, uint32>(MsgCode, MsgCode) });
+        }
+    }
+
+    struct FStreamResult
+    {
+        double MessagesPerSecond = 0.0;
+        double NanosecondsPerMessage = 0.0;
+        double AllocationsPerMessage = 0.0;
+        uint64 NumAllocations = 0;
+    };
+
+    /** Feeds a stream through the dispatcher, ticking every MessagesPerFrame messages. */
+    void FeedStream(FWindowsMessageDispatcher& Dispatcher, const TArray<FWindowsMessageRecord>& Stream)
+    {
+        int32 Result = 0;
+        for (int32 Index = 0; Index < Stream.Num(); ++Index)
+        {
+            Dispatcher.ProcessMessage(Stream[Index], Result);
+            if ((Index + 1) % MessagesPerFrame == 0)
+            {
+                Dispatcher.FlushCoalescedMessages();
+                Dispatcher.DrainDeferredMessages();
+                Dispatcher.FlushMessageBatch();
+            }
+        }
+        Dispatcher.FlushCoalescedMessages();
+        Dispatcher.DrainDeferredMessages();
+        Dispatcher.FlushMessageBatch();
+    }
+
+    FStreamResult MeasureStream(FWindowsMessageDispatcher& Dispatcher, const TArray<FWindowsMessageRecord>& Stream)
+    {
+        FeedStream(Dispatcher, Stream); // Warm up caches and let containers reach their steady-state size
+
+        FStreamResult StreamResult;
+        FWindowsMessageAllocationCounter Counter;
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        FeedStream(Dispatcher, Stream);
+        const double Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+        StreamResult.MessagesPerSecond = Seconds > 0.0 ? Stream.Num() / Seconds : 0.0;
+        StreamResult.NanosecondsPerMessage = Seconds * 1e9 / Stream.Num();
+        StreamResult.NumAllocations = Counter.GetNumAllocations();
+        StreamResult.AllocationsPerMessage = static_cast<double>(StreamResult.NumAllocations) / Stream.Num();
+        return StreamResult;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageSyntheticStreamBenchmark, "WindowsMessageListener.Benchmark.SyntheticStreams", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FWindowsMessageSyntheticStreamBenchmark::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumMessages = 250000;
+    constexpr int32 NumHandlers = 64;
+
+    struct FScenario
+    {
+        const TCHAR* Name;
+        TArray<FWindowsMessageRecord> Stream;
+    };
+    FScenario Scenarios[] =
+    {
+        { TEXT("MouseStorm"), MakeMouseStorm(NumMessages) },
+        { TEXT("KeyBursts"), MakeKeyBursts(NumMessages) },
+        { TEXT("MixedTraffic"), MakeMixedTraffic(NumMessages) },
+    };
+
+    for (const FScenario& Scenario : Scenarios)
+    {
+        for (int32 Mode = 0; Mode < 4; ++Mode)
+        {
+            static const TCHAR* ModeNames[] = { TEXT("Immediate"), TEXT("Coalesced"), TEXT("Deferred"), TEXT("Batched") };
+            const TCHAR* ModeName = ModeNames[Mode];
+
+            FWindowsMessageDispatcher Dispatcher;
+            Dispatcher.AllowMessageRange(SyntheticKeyDown, SyntheticChar);
+            Dispatcher.AllowMessageRange(SyntheticMouseMove, SyntheticButtonUp);
+            Dispatcher.AllowMessageRange(SyntheticUser, SyntheticUser + NumHandlers);
+            if (Mode >= 1)
+            {
+                Dispatcher.AddCoalescedMessageType(SyntheticMouseMove);
+            }
+            if (Mode == 2)
+            {
+                Dispatcher.EnableDeferredProcessing(4096, EWindowsMessageOverflowPolicy::DropNewest, false);
+            }
+
+            TArray<FBenchmarkMessageHandler> Handlers;
+            Handlers.SetNum(NumHandlers);
+            AddBenchmarkHandlers(Dispatcher, Handlers);
+
+            // Batched mode adds a recording-style handler that receives one call per frame instead of one per message
+            FBenchmarkBatchHandler BatchHandler;
+            if (Mode == 3)
+            {
+                Dispatcher.EnableMessageBatching(MessagesPerFrame, false);
+                Dispatcher.AddBatchHandler(FWindowsMessageBatchHandlerRef::Create(&BatchHandler));
+            }
+
+            const FStreamResult StreamResult = MeasureStream(Dispatcher, Scenario.Stream);
+
+            // One CSV-style line per run so CI can scrape and chart the numbers
+            AddInfo(FString::Printf(TEXT("WindowsMessageBenchmark,%s,%s,%.0f msg/s,%.1f ns/msg,%.4f allocs/msg"),
+                Scenario.Name, ModeName, StreamResult.MessagesPerSecond, StreamResult.NanosecondsPerMessage, StreamResult.AllocationsPerMessage));
+            FWindowsMessageAllocationCounter::TestNoAllocations(*this, *FString::Printf(TEXT("%s/%s should not allocate in steady state"), Scenario.Name, ModeName), StreamResult.NumAllocations);
+            TestTrue(FString::Printf(TEXT("%s/%s should deliver messages"), Scenario.Name, ModeName), Handlers[0].MessageCount > 0);
+        }
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageInputLatencyBenchmark, "WindowsMessageListener.Benchmark.InputLatency", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FWindowsMessageInputLatencyBenchmark::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumFrames = 100;
+    constexpr double FrameWorkSeconds = 0.004; // Game thread work between message pumps, on top of the messages themselves
+    constexpr int32 NumHandlers = 64;
+    const TArray<FWindowsMessageRecord> Stream = MakeMixedTraffic(NumFrames * MessagesPerFrame);
+
+    for (int32 Mode = 0; Mode < 3; ++Mode)
+    {
+        static const TCHAR* ModeNames[] = { TEXT("Immediate"), TEXT("Coalesced"), TEXT("Deferred") };
+        const TCHAR* ModeName = ModeNames[Mode];
+
+        FWindowsMessageDispatcher Dispatcher;
+        Dispatcher.AllowMessageRange(SyntheticKeyDown, SyntheticChar);
+        Dispatcher.AllowMessageRange(SyntheticMouseMove, SyntheticButtonUp);
+        Dispatcher.AllowMessageRange(SyntheticUser, SyntheticUser + NumHandlers);
+        if (Mode >= 1)
+        {
+            Dispatcher.AddCoalescedMessageType(SyntheticMouseMove);
+        }
+        if (Mode == 2)
+        {
+            Dispatcher.EnableDeferredProcessing(4096, EWindowsMessageOverflowPolicy::DropNewest, false);
+        }
+
+        TArray<FBenchmarkMessageHandler> Handlers;
+        Handlers.SetNum(NumHandlers);
+        AddBenchmarkHandlers(Dispatcher, Handlers);
+        Dispatcher.EnableLatencyTracking();
+
+        // Each frame pumps its messages as they arrive, then does heavy work before the engine tick
+        int32 Result = 0;
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            for (int32 Index = Frame * MessagesPerFrame; Index < (Frame + 1) * MessagesPerFrame; ++Index)
+            {
+                FWindowsMessageRecord Record = Stream[Index];
+                Record.Timestamp = FPlatformTime::Cycles64();
+                Dispatcher.ProcessMessage(Record, Result);
+            }
+
+            const double WorkEnd = FPlatformTime::Seconds() + FrameWorkSeconds;
+            while (FPlatformTime::Seconds() < WorkEnd)
+            {
+            }
+
+            Dispatcher.FlushCoalescedMessages();
+            Dispatcher.DrainDeferredMessages();
+        }
+
+        const FWindowsMessageLatencyPercentiles Total = Dispatcher.GetLatencyStats().AllCodes[EWindowsMessageLatencyStage::Total];
+        AddInfo(FString::Printf(TEXT("WindowsMessageLatency,%s,%llu msgs,p50 %.1f us,p99 %.1f us,p999 %.1f us,max %.1f us"),
+            ModeName, Total.Count, Total.P50 * 1e6, Total.P99 * 1e6, Total.P999 * 1e6, Total.Max * 1e6));
+
+        // Deferred and coalesced messages wait for the tick by design; messages dispatched from the pump must not
+        if (Mode == 0)
+        {
+            TestTrue(TEXT("Immediate dispatch should stay under a millisecond at p99 during heavy frames"), Total.Count > 0 && Total.P99 < 0.001);
+        }
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageParallelDispatchBenchmark, "WindowsMessageListener.Benchmark.ParallelDispatch", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+bool FWindowsMessageParallelDispatchBenchmark::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumMessages = 2000; // Fits the ring, so the pump never waits for the workers
+    constexpr double HandlerSeconds = 0.000002;
+    const TArray<FWindowsMessageRecord> Stream = MakeMixedTraffic(NumMessages);
+
+    double SerialNanoseconds = 0.0;
+    for (const int32 NumHandlers : { 1, 4, 8 })
+    {
+        for (const bool bParallel : { false, true })
+        {
+            FWindowsMessageDispatcher Dispatcher;
+            Dispatcher.AllowMessageRange(0, 0xFFFF);
+
+            TArray<FExpensiveMessageHandler> Handlers;
+            Handlers.SetNum(NumHandlers);
+            for (FExpensiveMessageHandler& Handler : Handlers)
+            {
+                Handler.Cycles = static_cast<uint64>(HandlerSeconds / FPlatformTime::GetSecondsPerCycle64());
+                Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&Handler), {});
+                Dispatcher.SetHandlerThread(&Handler, EWindowsMessageHandlerThread::Worker);
+            }
+            if (bParallel)
+            {
+                Dispatcher.EnableParallelDispatch(NumHandlers, 4096);
+            }
+
+            // Only the pump's time counts; the workers catch up afterwards
+            int32 Result = 0;
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            for (const FWindowsMessageRecord& Record : Stream)
+            {
+                Dispatcher.ProcessMessage(Record, Result);
+            }
+            const double PumpNanoseconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles) * 1e9 / NumMessages;
+            Dispatcher.WaitForParallelDispatch();
+
+            const TCHAR* ModeName = bParallel ? TEXT("Parallel") : TEXT("Serial");
+            AddInfo(FString::Printf(TEXT("WindowsMessageParallelDispatch,%d handlers,%s,%.0f pump ns/msg"), NumHandlers, ModeName, PumpNanoseconds));
+            TestTrue(FString::Printf(TEXT("%d handlers/%s should deliver every message"), NumHandlers, ModeName), Handlers.Last().MessageCount == NumMessages);
+
+            if (!bParallel)
+            {
+                SerialNanoseconds = PumpNanoseconds;
+            }
+            else if (NumHandlers == 8)
+            {
+                TestTrue(TEXT("The pump should not pay for handlers moved to workers"), PumpNanoseconds < SerialNanoseconds / 4.0);
+            }
+        }
+    }
+
+    return true;
+}
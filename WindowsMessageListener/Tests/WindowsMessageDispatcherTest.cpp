@@ -0,0 +1,300 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageDispatcher.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+namespace
+{
+    /** Batch handler that records the size of every batch and the messages it receives. */
+    struct FSyntheticBatchHandler
+    {
+        void ProcessMessages(const FWindowsMessageBatchView& Batch)
+        {
+            BatchSizes.Add(Batch.Num());
+            for (int32 Index = 0; Index < Batch.Num(); ++Index)
+            {
+                Received.Add(Batch.GetRecord(Index));
+            }
+        }
+
+        TArray<int32> BatchSizes;
+        TArray<FWindowsMessageRecord> Received;
+    };
+
+    /** Handler that feeds and flushes a coalesced message the first time it sees one, as a synthetic input injector would. */
+    struct FReentrantFlushHandler
+    {
+        bool HandleMessage(const FWindowsMessageRecord& Record, int32& OutResult)
+        {
+            Received.Add(Record);
+            if (!bFed)
+            {
+                bFed = true;
+                Dispatcher->ProcessMessage(FWindowsMessageRecord(FedWindow, Record.Msg, 0, 0, 0), OutResult);
+                Dispatcher->FlushCoalescedMessages();
+            }
+            return false;
+        }
+
+        FWindowsMessageDispatcher* Dispatcher = nullptr;
+        uint64 FedWindow = 0;
+        bool bFed = false;
+        TArray<FWindowsMessageRecord> Received;
+    };
+
+    /** Handler that binds another handler to every window it sees created, the way a per-window UI would. */
+    struct FWindowCreateBindingHandler
+    {
+        bool HandleMessage(const FWindowsMessageRecord& Record, int32& OutResult)
+        {
+            if (Record.Msg == FWindowsMessageDispatcher::WindowCreateMsg)
+            {
+                Dispatcher->AddHandler(FWindowsMessageHandlerRef::Create(WindowHandler), {}, Record.Hwnd);
+            }
+            return false;
+        }
+
+        FWindowsMessageDispatcher* Dispatcher = nullptr;
+        FWindowsMessageTestHandler* WindowHandler = nullptr;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageDispatcherTest, "WindowsMessageListener.Dispatcher", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageDispatcherTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageRange(SyntheticKeyDown, SyntheticKeyUp);
+    Dispatcher.AllowMessageRange(SyntheticMouseMove, SyntheticButtonDown);
+    Dispatcher.AddCoalescedMessageType(SyntheticMouseMove);
+
+    FWindowsMessageTestHandler KeyHandler;
+    FWindowsMessageTestHandler AllHandler;
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&KeyHandler), { TPair<uint32, uint32>(SyntheticKeyDown, SyntheticKeyUp) });
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&AllHandler), {});
+
+    int32 Result = 0;
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyDown, 0, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, 0x0020, 0, 0, 0), Result); // Not allowed
+    for (int64 Position = 0; Position < 10; ++Position)
+    {
+        Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 0, Position, 0), Result);
+    }
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticButtonDown, 0, 9, 0), Result);
+
+    TestEqual("Key handler should only see its subscribed codes", KeyHandler.Received.Num(), 1);
+    if (TestEqual("Unrestricted handler should see the key, the newest move and the button", AllHandler.Received.Num(), 3))
+    {
+        TestEqual("The pending move should precede the button", AllHandler.Received[1].Msg, SyntheticMouseMove);
+        TestEqual("Only the newest move should be delivered", AllHandler.Received[1].LParam, int64(9));
+        TestEqual("The button should follow the move", AllHandler.Received[2].Msg, SyntheticButtonDown);
+    }
+
+    // A higher priority handler consuming the message stops the fan-out
+    KeyHandler.bConsume = true;
+    Dispatcher.SetHandlerPriority(&KeyHandler, 1);
+    Dispatcher.SetConsumptionPolicy(EWindowsMessageConsumptionPolicy::Consume);
+    TestTrue("Consumed messages should be reported as handled", Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyUp, 0, 0, 0), Result));
+    TestEqual("Lower priority handlers should not see consumed messages", AllHandler.Received.Num(), 3);
+
+    TestTrue("Registered handlers can be removed", Dispatcher.RemoveHandler(&KeyHandler));
+    TestFalse("Removed handlers are no longer registered", Dispatcher.RemoveHandler(&KeyHandler));
+    TestFalse("Messages nobody consumes are not reported as handled", Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyUp, 0, 0, 0), Result));
+    TestEqual("Remaining handlers should see the message", AllHandler.Received.Num(), 4);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageDispatcherBatchingTest, "WindowsMessageListener.Dispatcher.Batching", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageDispatcherBatchingTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageRange(SyntheticKeyDown, SyntheticKeyUp);
+    Dispatcher.AllowMessageType(SyntheticMouseMove);
+
+    FWindowsMessageTestHandler KeyHandler;
+    FSyntheticBatchHandler BatchHandler;
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&KeyHandler), { TPair<uint32, uint32>(SyntheticKeyDown, SyntheticKeyUp) });
+    Dispatcher.AddBatchHandler(FWindowsMessageBatchHandlerRef::Create(&BatchHandler));
+
+    // Without batching, every message arrives as a batch of one
+    int32 Result = 0;
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 0, 0, 0), Result);
+    TestEqual("Unbatched messages should be delivered at once", BatchHandler.BatchSizes.Num(), 1);
+
+    Dispatcher.EnableMessageBatching(4, false);
+    for (int64 Position = 1; Position <= 10; ++Position)
+    {
+        Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 0, Position, Position), Result);
+    }
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, 0x0020, 0, 0, 0), Result); // Not allowed
+    TestEqual("Full batches should be delivered as they fill", BatchHandler.BatchSizes.Num(), 3);
+    TestEqual("A partial batch should wait for a flush", Dispatcher.FlushMessageBatch(), 2);
+    if (TestEqual("Every allowed message should be delivered once", BatchHandler.Received.Num(), 11))
+    {
+        TestEqual("Batches should keep the dispatch order", BatchHandler.Received[10].LParam, int64(10));
+        TestEqual("Batches should carry timestamps", BatchHandler.Received[10].Timestamp, uint64(10));
+    }
+    TestEqual("Filtered messages should never be batched", BatchHandler.BatchSizes.Last(), 2);
+
+    // Messages a handler consumes never reach the batch
+    KeyHandler.bConsume = true;
+    Dispatcher.SetConsumptionPolicy(EWindowsMessageConsumptionPolicy::StopFanOut);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyDown, 0, 0, 0), Result);
+    TestEqual("Consumed messages should not be collected", Dispatcher.FlushMessageBatch(), 0);
+
+    // Removed batch handlers stop receiving collected messages
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 0, 0, 0), Result);
+    TestTrue("Batch handlers can be removed", Dispatcher.RemoveHandler(&BatchHandler));
+    Dispatcher.DisableMessageBatching();
+    TestEqual("Removed batch handlers should not be called", BatchHandler.Received.Num(), 11);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageDispatcherWindowRoutingTest, "WindowsMessageListener.Dispatcher.WindowRouting", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageDispatcherWindowRoutingTest::RunTest(const FString& Parameters)
+{
+    constexpr uint64 MainWindow = 0x1000;
+    constexpr uint64 PopupWindow = 0x2000;
+
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageRange(SyntheticKeyDown, SyntheticKeyUp);
+    Dispatcher.AllowMessageType(FWindowsMessageDispatcher::WindowDestroyMsg);
+
+    FWindowsMessageTestHandler GlobalHandler;
+    FWindowsMessageTestHandler MainHandler;
+    FWindowsMessageTestHandler PopupHandler;
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&GlobalHandler), {});
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&MainHandler), {}, MainWindow);
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&PopupHandler), { TPair<uint32, uint32>(SyntheticKeyDown, SyntheticKeyDown) }, PopupWindow);
+    Dispatcher.SetHandlerPriority(&PopupHandler, 1);
+
+    int32 Result = 0;
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(MainWindow, SyntheticKeyDown, 0, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(PopupWindow, SyntheticKeyDown, 0, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(PopupWindow, SyntheticKeyUp, 0, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(0x3000, SyntheticKeyDown, 0, 0, 0), Result);
+
+    TestEqual("Unbound handlers should see every window", GlobalHandler.Received.Num(), 4);
+    TestEqual("Bound handlers should only see their window", MainHandler.Received.Num(), 1);
+    TestEqual("Bound handlers should only see their codes", PopupHandler.Received.Num(), 1);
+
+    // Priorities apply across bound and unbound handlers
+    PopupHandler.bConsume = true;
+    Dispatcher.SetConsumptionPolicy(EWindowsMessageConsumptionPolicy::StopFanOut);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(PopupWindow, SyntheticKeyDown, 0, 0, 0), Result);
+    TestEqual("A higher priority bound handler should run first", GlobalHandler.Received.Num(), 4);
+    PopupHandler.bConsume = false;
+
+    // A destroyed window's handlers see its WM_DESTROY, then are unbound
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(MainWindow, FWindowsMessageDispatcher::WindowDestroyMsg, 0, 0, 0), Result);
+    TestEqual("Bound handlers should see their window's destruction", MainHandler.Received.Num(), 2);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(MainWindow, SyntheticKeyDown, 0, 0, 0), Result);
+    TestEqual("Handlers of a destroyed window should be unbound", MainHandler.Received.Num(), 2);
+    TestTrue("Unbinding should not affect other handlers", Dispatcher.RemoveHandler(&GlobalHandler));
+
+    // A new window reusing a handle does not inherit stale bindings, even if the destruction was filtered out
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(PopupWindow, FWindowsMessageDispatcher::WindowCreateMsg, 0, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(PopupWindow, SyntheticKeyDown, 0, 0, 0), Result);
+    TestEqual("Bindings should be dropped when a handle is reused", PopupHandler.Received.Num(), 2);
+    TestEqual("No bound handlers should remain", Dispatcher.RemoveWindowHandlers(PopupWindow), 0);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageDispatcherReentrantFlushTest, "WindowsMessageListener.Dispatcher.ReentrantFlush", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageDispatcherReentrantFlushTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageType(SyntheticMouseMove);
+    Dispatcher.AddCoalescedMessageType(SyntheticMouseMove);
+
+    FReentrantFlushHandler Handler;
+    Handler.Dispatcher = &Dispatcher;
+    Handler.FedWindow = 0x2000;
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&Handler), {});
+
+    int32 Result = 0;
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(0x1000, SyntheticMouseMove, 0, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(0x3000, SyntheticMouseMove, 0, 0, 0), Result);
+    TestEqual("The outer flush should count only its own messages", Dispatcher.FlushCoalescedMessages(), 2);
+
+    // The nested flush delivers only the message fed during delivery, before the outer flush resumes
+    TestTrue("Every message should be delivered once, in order", Handler.Received.Num() == 3 && Handler.Received[0].Hwnd == 0x1000
+        && Handler.Received[1].Hwnd == 0x2000 && Handler.Received[2].Hwnd == 0x3000);
+    TestEqual("Nothing should be left pending", Dispatcher.FlushCoalescedMessages(), 0);
+    TestEqual("Delivered messages should be counted once", Dispatcher.GetCoalescerCounters().MessagesDelivered, uint64(3));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageDispatcherDeferredWindowLifetimeTest, "WindowsMessageListener.Dispatcher.DeferredWindowLifetime", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageDispatcherDeferredWindowLifetimeTest::RunTest(const FString& Parameters)
+{
+    constexpr uint64 MainWindow = 0x1000;
+    constexpr uint64 PopupWindow = 0x2000;
+
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageType(SyntheticKeyDown);
+    Dispatcher.AllowMessageType(SyntheticMouseMove);
+    Dispatcher.AllowMessageType(FWindowsMessageDispatcher::WindowDestroyMsg);
+    Dispatcher.AddCoalescedMessageType(SyntheticMouseMove);
+    Dispatcher.EnableDeferredProcessing(64, EWindowsMessageOverflowPolicy::DropNewest, false);
+
+    FWindowsMessageTestHandler MainHandler;
+    FWindowsMessageTestHandler PopupHandler;
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&MainHandler), {}, MainWindow);
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&PopupHandler), {}, PopupWindow);
+
+    // A destroyed window's handlers see its queued and coalesced messages, then its WM_DESTROY, before they are unbound
+    int32 Result = 0;
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(MainWindow, SyntheticKeyDown, 1, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(MainWindow, SyntheticMouseMove, 2, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(MainWindow, FWindowsMessageDispatcher::WindowDestroyMsg, 3, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(MainWindow, SyntheticKeyDown, 4, 0, 0), Result);
+
+    // A rejected WM_CREATE for a reused handle is tracked in order too
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(PopupWindow, SyntheticKeyDown, 5, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(PopupWindow, FWindowsMessageDispatcher::WindowCreateMsg, 6, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(PopupWindow, SyntheticKeyDown, 7, 0, 0), Result);
+    TestTrue("Nothing should be dispatched before the ring is drained", MainHandler.Received.Num() == 0 && PopupHandler.Received.Num() == 0);
+
+    Dispatcher.DrainDeferredMessages();
+    TestTrue("The destroyed window's handlers should see every message up to its WM_DESTROY, in order", MainHandler.Received.Num() == 3
+        && MainHandler.Received[0].WParam == 1 && MainHandler.Received[1].WParam == 2 && MainHandler.Received[2].Msg == FWindowsMessageDispatcher::WindowDestroyMsg);
+    TestTrue("Stale handlers should see the messages queued before the handle was reused", PopupHandler.Received.Num() == 1 && PopupHandler.Received[0].WParam == 5);
+    TestEqual("No bound handlers should remain", Dispatcher.RemoveWindowHandlers(MainWindow) + Dispatcher.RemoveWindowHandlers(PopupWindow), 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageDispatcherBindOnCreateTest, "WindowsMessageListener.Dispatcher.BindOnCreate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageDispatcherBindOnCreateTest::RunTest(const FString& Parameters)
+{
+    constexpr uint64 Window = 0x1000;
+
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageType(SyntheticKeyDown);
+    Dispatcher.AllowMessageType(FWindowsMessageDispatcher::WindowCreateMsg);
+
+    FWindowsMessageTestHandler StaleHandler;
+    FWindowsMessageTestHandler WindowHandler;
+    FWindowCreateBindingHandler CreateHandler;
+    CreateHandler.Dispatcher = &Dispatcher;
+    CreateHandler.WindowHandler = &WindowHandler;
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&StaleHandler), {}, Window); // Left over from a window that reused the handle
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&CreateHandler), {});
+
+    int32 Result = 0;
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(Window, FWindowsMessageDispatcher::WindowCreateMsg, 0, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(Window, SyntheticKeyDown, 0, 0, 0), Result);
+    TestEqual("Stale bindings should be dropped before WM_CREATE is dispatched", StaleHandler.Received.Num(), 0);
+    TestTrue("Bindings made while handling WM_CREATE should be kept", WindowHandler.Received.Num() == 1 && WindowHandler.Received[0].Msg == SyntheticKeyDown);
+
+    // The same holds when WM_CREATE is dispatched from the deferred ring
+    Dispatcher.EnableDeferredProcessing(64, EWindowsMessageOverflowPolicy::DropNewest, false);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(Window, FWindowsMessageDispatcher::WindowCreateMsg, 0, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(Window, SyntheticKeyDown, 1, 0, 0), Result);
+    Dispatcher.DrainDeferredMessages();
+    TestTrue("Bindings made while handling a deferred WM_CREATE should be kept", WindowHandler.Received.Num() == 2 && WindowHandler.Received[1].WParam == 1);
+    return true;
+}
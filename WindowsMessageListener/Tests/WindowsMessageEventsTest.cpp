@@ -0,0 +1,144 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageEvents.h"
+#include "WindowsMessageDispatcher.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+namespace
+{
+    /** Packs two signed 16-bit coordinates the way MAKELPARAM does. */
+    int64 MakePointLParam(int16 X, int16 Y)
+    {
+        return static_cast<int64>((static_cast<uint32>(static_cast<uint16>(Y)) << 16) | static_cast<uint16>(X));
+    }
+
+    /** Input event handler that keeps a copy of every event and counts its calls. */
+    struct FRecordingInputEventHandler : public IWindowsInputEventHandler
+    {
+        virtual void OnMouseMoveEvents(TArrayView<const FWindowsMouseMoveEvent> Events) override
+        {
+            ++NumCalls;
+            MouseMoves.Append(Events.GetData(), Events.Num());
+        }
+
+        virtual void OnKeyEvents(TArrayView<const FWindowsKeyEvent> Events) override
+        {
+            ++NumCalls;
+            Keys.Append(Events.GetData(), Events.Num());
+        }
+
+        int32 NumCalls = 0;
+        TArray<FWindowsMouseMoveEvent> MouseMoves;
+        TArray<FWindowsKeyEvent> Keys;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsInputEventDecoderTest, "WindowsMessageListener.InputEvents.Decoders", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsInputEventDecoderTest::RunTest(const FString& Parameters)
+{
+    TestTrue("Mouse moves should decode to MouseMove", FWindowsInputEventDecoder::GetEventType(SyntheticMouseMove) == EWindowsInputEventTypes::MouseMove);
+    TestTrue("Dead characters should not decode", FWindowsInputEventDecoder::GetEventType(0x0103) == EWindowsInputEventTypes::None);
+    TestTrue("Non-input messages should not decode", FWindowsInputEventDecoder::GetEventType(0x0020) == EWindowsInputEventTypes::None);
+
+    FWindowsMouseMoveEvent Move;
+    TestTrue("Mouse moves should decode", FWindowsInputEventDecoder::DecodeMouseMove(FWindowsMessageRecord(7, SyntheticMouseMove, 0x0001, MakePointLParam(-5, 300), 42), Move));
+    TestEqual("Client x should be signed", Move.X, int16(-5));
+    TestEqual("Client y", Move.Y, int16(300));
+    TestEqual("Modifiers come from wParam", Move.Modifiers, uint16(0x0001));
+    TestEqual("Timestamps are kept", Move.Timestamp, uint64(42));
+    TestFalse("Decoders reject other messages", FWindowsInputEventDecoder::DecodeMouseMove(FWindowsMessageRecord(7, SyntheticKeyDown, 0, 0, 0), Move));
+
+    FWindowsMouseButtonEvent ButtonEvent;
+    FWindowsInputEventDecoder::DecodeMouseButton(FWindowsMessageRecord(7, SyntheticRButtonDblClk, 0, MakePointLParam(10, 20), 0), ButtonEvent);
+    TestTrue("Double clicks should be right-button double-click presses", ButtonEvent.Button == EWindowsMouseButton::Right && ButtonEvent.bDown && ButtonEvent.bDoubleClick);
+    FWindowsInputEventDecoder::DecodeMouseButton(FWindowsMessageRecord(7, SyntheticXButtonUp, 0x00020000, 0, 0), ButtonEvent);
+    TestTrue("XBUTTON2 should be read from the high word of wParam", ButtonEvent.Button == EWindowsMouseButton::X2 && !ButtonEvent.bDown);
+
+    FWindowsWheelEvent Wheel;
+    FWindowsInputEventDecoder::DecodeWheel(FWindowsMessageRecord(7, SyntheticMouseWheel, 0xFF880008, MakePointLParam(1000, -20), 0), Wheel);
+    TestEqual("Wheel delta should be the signed high word of wParam", Wheel.Delta, int16(-120));
+    TestEqual("Wheel modifiers should be the low word of wParam", Wheel.Modifiers, uint16(0x0008));
+    TestEqual("Wheel screen y should be signed", Wheel.Y, int16(-20));
+    FWindowsInputEventDecoder::DecodeWheel(FWindowsMessageRecord(7, SyntheticMouseHWheel, 0x00780000, 0, 0), Wheel);
+    TestTrue("Horizontal wheels should be flagged", Wheel.bHorizontal && Wheel.Delta == 120);
+
+    // Repeat count 3, scan code 0x1E, extended, previously down
+    FWindowsKeyEvent Key;
+    FWindowsInputEventDecoder::DecodeKey(FWindowsMessageRecord(7, SyntheticSysKeyDown, 0x41, 0x411E0003, 0), Key);
+    TestEqual("Virtual key comes from wParam", Key.VirtualKey, uint16(0x41));
+    TestEqual("Repeat count", Key.RepeatCount, uint16(3));
+    TestEqual("Scan code", Key.ScanCode, uint8(0x1E));
+    TestTrue("Extended, repeated system key press", Key.bExtended && Key.bRepeat && Key.bSystem && Key.bDown);
+    FWindowsInputEventDecoder::DecodeKey(FWindowsMessageRecord(7, SyntheticKeyUp, 0x41, 0xC01E0001, 0), Key);
+    TestTrue("Releases are never repeats", !Key.bDown && !Key.bRepeat && !Key.bSystem);
+
+    FWindowsCharEvent Char;
+    FWindowsInputEventDecoder::DecodeChar(FWindowsMessageRecord(7, SyntheticChar, 0x00E9, 1, 0), Char);
+    TestEqual("Characters come from wParam", Char.Character, uint32(0x00E9));
+
+    FWindowsInputEventFrame Frame;
+    TestTrue("Unwanted types should be skipped", FWindowsInputEventDecoder::Decode(FWindowsMessageRecord(7, SyntheticChar, 0x41, 1, 0), EWindowsInputEventTypes::Key, Frame) == EWindowsInputEventTypes::None);
+    TestTrue("Wanted types should be appended", FWindowsInputEventDecoder::Decode(FWindowsMessageRecord(7, SyntheticChar, 0x41, 1, 0), EWindowsInputEventTypes::All, Frame) == EWindowsInputEventTypes::Char);
+    TestEqual("Events should land in the array of their type", Frame.Chars.Num(), 1);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsInputEventRouterTest, "WindowsMessageListener.InputEvents.Router", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsInputEventRouterTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageRange(SyntheticKeyDown, SyntheticChar);
+    Dispatcher.AllowMessageType(SyntheticMouseMove);
+
+    FWindowsInputEventRouter Router;
+    FRecordingInputEventHandler MoveHandler;
+    FRecordingInputEventHandler KeyHandler;
+    Router.AddHandler(&MoveHandler, EWindowsInputEventTypes::MouseMove);
+    Router.AddHandler(&KeyHandler, EWindowsInputEventTypes::Key);
+    Dispatcher.AddBatchHandler(FWindowsMessageBatchHandlerRef::Create(&Router));
+    Dispatcher.EnableMessageBatching(64, false);
+
+    int32 Result = 0;
+    for (int16 Position = 0; Position < 10; ++Position)
+    {
+        Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 0, MakePointLParam(Position, 0), 0), Result);
+    }
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyDown, 0x41, 1, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticChar, 0x41, 1, 0), Result);
+    Dispatcher.FlushMessageBatch();
+
+    TestEqual("Each handler should be called once per batch", MoveHandler.NumCalls, 1);
+    TestEqual("Every move should arrive in one array", MoveHandler.MouseMoves.Num(), 10);
+    TestEqual("Moves should keep their order", MoveHandler.MouseMoves.Last().X, int16(9));
+    TestEqual("Handlers should only receive subscribed types", MoveHandler.Keys.Num(), 0);
+    TestEqual("Key handlers should receive keys", KeyHandler.Keys.Num(), 1);
+    TestEqual("Types nobody subscribed to should not be decoded", Router.GetEvents().Chars.Num(), 0);
+
+    TestTrue("Handlers can be removed", Router.RemoveHandler(&KeyHandler));
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyDown, 0x41, 1, 0), Result);
+    Dispatcher.FlushMessageBatch();
+    TestEqual("Removed handlers should not be called", KeyHandler.NumCalls, 1);
+
+    // With a frame arena, each decoded type gets one array of its exact size from the arena
+    Dispatcher.EnableFrameArena(4096);
+    Router.SetFrameArena(Dispatcher.GetFrameArena());
+    Router.AddHandler(&KeyHandler, EWindowsInputEventTypes::Key);
+    const uint64 FrameAllocations = Dispatcher.GetFrameArenaCounters().FrameAllocations;
+    for (int16 Position = 20; Position < 25; ++Position)
+    {
+        Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 0, MakePointLParam(Position, 0), 0), Result);
+    }
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyDown, 0x42, 1, 0), Result);
+    Dispatcher.FlushMessageBatch();
+    TestEqual("Decoded events should be allocated from the arena", Dispatcher.GetFrameArenaCounters().FrameAllocations - FrameAllocations, uint64(2));
+    TestEqual("Arena-backed events should hold the whole batch", Router.GetEvents().MouseMoves.Num(), 5);
+    TestEqual("Arena-backed events should be delivered", MoveHandler.MouseMoves.Last().X, int16(24));
+    TestEqual("Arena-backed keys should be delivered", KeyHandler.Keys.Last().VirtualKey, uint16(0x42));
+    Router.SetFrameArena(nullptr);
+    Dispatcher.DisableFrameArena();
+
+    Dispatcher.RemoveAllHandlers();
+    return true;
+}
@@ -0,0 +1,256 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageFanOut.h"
+#include "WindowsMessageDispatcher.h"
+#include "HAL/PlatformTLS.h"
+#include "WindowsMessageTestHelpers.h"
+
+#include <atomic>
+
+using namespace WindowsMessageTest;
+
+namespace
+{
+    /** Checks that a handler received the given WParams, in order. */
+    bool ReceivedInOrder(const FWindowsMessageTestHandler& Handler, int32 First, int32 Count)
+    {
+        if (Handler.Received.Num() != Count)
+        {
+            return false;
+        }
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            if (Handler.Received[Index].WParam != static_cast<uint64>(First + Index))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * What a removed worker handler leaves behind, so it can be checked after the handler is deleted.
+     */
+    struct FRemovedHandlerState
+    {
+        std::atomic<int32> Calls{0};
+        std::atomic<int32> CallsAfterRemoval{0}; // Calls still running, or started, once removal returned
+        std::atomic<bool> bRemoved{false};
+    };
+
+    /**
+     * Worker handler that is slow enough to be mid-call when it is removed, and can remove itself.
+     */
+    struct FSlowWorkerHandler
+    {
+        FSlowWorkerHandler(FRemovedHandlerState& InState, FWindowsMessageDispatcher* InSelfRemovingDispatcher = nullptr)
+            : State(InState)
+            , SelfRemovingDispatcher(InSelfRemovingDispatcher)
+        {
+        }
+
+        bool HandleMessage(const FWindowsMessageRecord& Record, int32& OutResult)
+        {
+            State.Calls.fetch_add(1);
+            if (SelfRemovingDispatcher)
+            {
+                SelfRemovingDispatcher->RemoveHandler(this); // Must not wait for its own worker
+                return false;
+            }
+            FPlatformProcess::SleepNoStats(0.001f);
+            if (State.bRemoved.load())
+            {
+                State.CallsAfterRemoval.fetch_add(1);
+            }
+            return false;
+        }
+
+        FRemovedHandlerState& State;
+        FWindowsMessageDispatcher* SelfRemovingDispatcher;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageFanOutRingTest, "WindowsMessageListener.FanOut.Ring", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageFanOutRingTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumWorkers = 3;
+    constexpr int32 NumMessages = 10000;
+
+    // Each worker checks its own order; the ring is small so it wraps and the producer has to wait
+    std::atomic<uint64> NextExpected[NumWorkers] = {};
+    std::atomic<int32> OutOfOrder{0};
+    FWindowsMessageFanOut FanOut(NumWorkers, 16, true, [&NextExpected, &OutOfOrder](int32 WorkerIndex, TArrayView<const FWindowsMessageRecord> Records)
+    {
+        for (const FWindowsMessageRecord& Record : Records)
+        {
+            OutOfOrder += Record.WParam != NextExpected[WorkerIndex].load();
+            NextExpected[WorkerIndex].store(Record.WParam + 1);
+        }
+    });
+
+    for (int32 Index = 0; Index < NumMessages; ++Index)
+    {
+        FanOut.Write(FWindowsMessageRecord(1, SyntheticMouseMove, Index, 0, 0));
+        if (Index % 7 == 0)
+        {
+            FanOut.Publish();
+        }
+    }
+    FanOut.WaitUntilConsumed();
+
+    const FWindowsMessageFanOutCounters Counters = FanOut.GetCounters();
+    TestEqual("Every message should be published", Counters.Published, uint64(NumMessages));
+    TestTrue("Every worker should consume every message", Counters.Consumed.Num() == NumWorkers && Counters.Consumed[0] == NumMessages && Counters.Consumed[2] == NumMessages);
+    TestEqual("Every worker should see the messages in order", OutOfOrder.load(), 0);
+    TestTrue("The backlog should never exceed the ring", Counters.HighWaterMark <= 16);
+    TestEqual("Nothing should be dropped while waiting", Counters.Dropped, uint64(0));
+
+    // Stop drains what is left before joining
+    FanOut.Write(FWindowsMessageRecord(1, SyntheticMouseMove, NumMessages, 0, 0));
+    FanOut.Stop();
+    TestEqual("Stopping should finish published messages", NextExpected[1].load(), uint64(NumMessages + 1));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageFanOutDispatcherTest, "WindowsMessageListener.FanOut.Dispatcher", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageFanOutDispatcherTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageType(SyntheticKeyDown);
+    Dispatcher.AllowMessageType(SyntheticMouseMove);
+    Dispatcher.SetConsumptionPolicy(EWindowsMessageConsumptionPolicy::StopFanOut);
+
+    FWindowsMessageTestHandler PumpHandler;
+    FWindowsMessageTestHandler FirstWorkerHandler;
+    FWindowsMessageTestHandler SecondWorkerHandler;
+    FWindowsMessageTestHandler KeyWorkerHandler;
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&PumpHandler), {});
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&FirstWorkerHandler), {});
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&SecondWorkerHandler), {});
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&KeyWorkerHandler), { TPair<uint32, uint32>(SyntheticKeyDown, SyntheticKeyDown) });
+    TestTrue("Moving a registered handler to a worker", Dispatcher.SetHandlerThread(&FirstWorkerHandler, EWindowsMessageHandlerThread::Worker));
+    Dispatcher.SetHandlerThread(&SecondWorkerHandler, EWindowsMessageHandlerThread::Worker);
+    Dispatcher.SetHandlerThread(&KeyWorkerHandler, EWindowsMessageHandlerThread::Worker, 0);
+    TestFalse("Moving an unknown handler", Dispatcher.SetHandlerThread(&Dispatcher, EWindowsMessageHandlerThread::Worker));
+
+    // Before parallel dispatch is enabled, worker handlers run on the dispatching thread
+    int32 Result = 0;
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 0, 0, 0), Result);
+    TestTrue("Worker handlers should run inline without workers", FirstWorkerHandler.Received.Num() == 1 && FirstWorkerHandler.ThreadIds[0] == FPlatformTLS::GetCurrentThreadId());
+
+    Dispatcher.EnableParallelDispatch(2, 64);
+    constexpr int32 NumMessages = 1000;
+    for (int32 Index = 1; Index <= NumMessages; ++Index)
+    {
+        Dispatcher.ProcessMessage(FWindowsMessageRecord(1, Index % 10 ? SyntheticMouseMove : SyntheticKeyDown, Index, 0, 0), Result);
+    }
+    Dispatcher.WaitForParallelDispatch();
+
+    TestTrue("Pump handlers should see every message", ReceivedInOrder(PumpHandler, 0, NumMessages + 1));
+    TestTrue("Worker handlers should see every message in order", ReceivedInOrder(FirstWorkerHandler, 0, NumMessages + 1) && ReceivedInOrder(SecondWorkerHandler, 0, NumMessages + 1));
+    TestTrue("Worker handlers should only see their subscribed codes", KeyWorkerHandler.Received.Num() == NumMessages / 10 && KeyWorkerHandler.Received.Last().Msg == SyntheticKeyDown);
+    TestTrue("Handlers given the next worker in turn should run on different threads",
+        FirstWorkerHandler.ThreadIds.Num() == 2 && SecondWorkerHandler.ThreadIds.Num() == 2 && FirstWorkerHandler.ThreadIds[1] != SecondWorkerHandler.ThreadIds[1]);
+    TestTrue("A pinned handler should share its worker", KeyWorkerHandler.ThreadIds.Num() == 1 && KeyWorkerHandler.ThreadIds[0] == FirstWorkerHandler.ThreadIds[1]);
+
+    const FWindowsMessageFanOutCounters Counters = Dispatcher.GetParallelDispatchCounters();
+    TestEqual("Each message should be published once", Counters.Published, uint64(NumMessages));
+
+    // Messages consumed on the pump never reach the workers
+    PumpHandler.bConsume = true;
+    PumpHandler.ConsumedMsg = SyntheticKeyDown;
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyDown, NumMessages + 1, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, NumMessages + 2, 0, 0), Result);
+    Dispatcher.WaitForParallelDispatch();
+    TestTrue("Consumed messages should not be published", FirstWorkerHandler.Received.Num() == NumMessages + 2 && FirstWorkerHandler.Received.Last().WParam == NumMessages + 2);
+
+    // Moving a handler back waits for its queued messages, so it is never called from two threads at once
+    Dispatcher.SetHandlerThread(&SecondWorkerHandler, EWindowsMessageHandlerThread::Pump);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, NumMessages + 3, 0, 0), Result);
+    TestTrue("A handler moved back should run on the dispatching thread", SecondWorkerHandler.Received.Num() == NumMessages + 3 && SecondWorkerHandler.LastThreadId == FPlatformTLS::GetCurrentThreadId());
+
+    Dispatcher.DisableParallelDispatch();
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, NumMessages + 4, 0, 0), Result);
+    TestEqual("Disabling should bring worker handlers back inline", FirstWorkerHandler.Received.Last().WParam, uint64(NumMessages + 4));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageFanOutReclaimTest, "WindowsMessageListener.FanOut.Reclaim", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageFanOutReclaimTest::RunTest(const FString& Parameters)
+{
+    constexpr uint32 Capacity = 64;
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageType(SyntheticMouseMove);
+
+    FWindowsMessageTestHandler PumpHandler;
+    FWindowsMessageTestHandler FirstWorkerHandler;
+    FWindowsMessageTestHandler SecondWorkerHandler;
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&PumpHandler), {});
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&FirstWorkerHandler), {});
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&SecondWorkerHandler), {});
+    Dispatcher.SetHandlerThread(&FirstWorkerHandler, EWindowsMessageHandlerThread::Worker);
+    Dispatcher.SetHandlerThread(&SecondWorkerHandler, EWindowsMessageHandlerThread::Worker);
+    Dispatcher.EnableParallelDispatch(2, Capacity);
+
+    // Every priority change replaces the table while the workers are busy, so they are rarely both idle
+    constexpr int32 NumMessages = 5000;
+    int32 MaxRetired = 0;
+    int32 Result = 0;
+    for (int32 Index = 0; Index < NumMessages; ++Index)
+    {
+        Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, Index, 0, 0), Result);
+        Dispatcher.SetHandlerPriority(&PumpHandler, Index);
+        MaxRetired = FMath::Max(MaxRetired, Dispatcher.GetNumRetiredEntries());
+    }
+
+    // A worker holds back at most the tables replaced during its current run, and a run never exceeds the ring
+    TestTrue("Retired tables should be freed while the workers are busy", MaxRetired <= static_cast<int32>(Capacity) * 2);
+
+    Dispatcher.WaitForParallelDispatch();
+    Dispatcher.SetHandlerPriority(&PumpHandler, 0);
+    TestEqual("Every retired table should be freed once the workers are idle", Dispatcher.GetNumRetiredEntries(), 0);
+    TestTrue("Worker handlers should see every message in order", ReceivedInOrder(FirstWorkerHandler, 0, NumMessages) && ReceivedInOrder(SecondWorkerHandler, 0, NumMessages));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageFanOutRemoveHandlerTest, "WindowsMessageListener.FanOut.RemoveHandler", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageFanOutRemoveHandlerTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageType(SyntheticMouseMove);
+    Dispatcher.EnableParallelDispatch(2, 256);
+
+    FRemovedHandlerState SlowState;
+    FRemovedHandlerState SelfRemovingState;
+    FSlowWorkerHandler* SlowHandler = new FSlowWorkerHandler(SlowState);
+    FSlowWorkerHandler SelfRemovingHandler(SelfRemovingState, &Dispatcher);
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(SlowHandler), {});
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&SelfRemovingHandler), {});
+    Dispatcher.SetHandlerThread(SlowHandler, EWindowsMessageHandlerThread::Worker, 0);
+    Dispatcher.SetHandlerThread(&SelfRemovingHandler, EWindowsMessageHandlerThread::Worker, 1);
+
+    // Queue far more work than the slow handler can finish, then remove and delete it while its worker is inside it
+    int32 Result = 0;
+    constexpr int32 NumMessages = 200;
+    for (int32 Index = 0; Index < NumMessages; ++Index)
+    {
+        Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, Index, 0, 0), Result);
+    }
+    while (SlowState.Calls.load() == 0)
+    {
+        FPlatformProcess::YieldThread();
+    }
+    TestTrue("Removing a worker handler", Dispatcher.RemoveHandler(SlowHandler));
+    SlowState.bRemoved.store(true);
+    delete SlowHandler;
+
+    for (int32 Index = 0; Index < NumMessages; ++Index)
+    {
+        Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, NumMessages + Index, 0, 0), Result);
+    }
+    Dispatcher.WaitForParallelDispatch();
+
+    TestTrue("The removed handler should have been mid-queue when it was removed", SlowState.Calls.load() < NumMessages);
+    TestEqual("A removed worker handler should never run once removal returns", SlowState.CallsAfterRemoval.load(), 0);
+    TestEqual("A worker handler removing itself should not wait for its own worker", SelfRemovingState.Calls.load(), 1);
+    return true;
+}
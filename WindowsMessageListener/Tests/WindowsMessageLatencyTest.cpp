@@ -0,0 +1,116 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageLatency.h"
+#include "WindowsMessageDispatcher.h"
+#include "HAL/PlatformTime.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageLatencyHistogramTest, "WindowsMessageListener.Latency.Histogram", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageLatencyHistogramTest::RunTest(const FString& Parameters)
+{
+    TUniquePtr<FWindowsMessageLatencyHistogram> Histogram = MakeUnique<FWindowsMessageLatencyHistogram>();
+    for (uint64 Value = 1; Value <= 100000; ++Value)
+    {
+        Histogram->Add(Value);
+    }
+
+    // Buckets are 1/16th of a power of two wide, so percentiles are within that of the exact value
+    const auto IsNear = [](uint64 Actual, uint64 Expected) { return Actual >= Expected && Actual <= Expected + Expected / 16; };
+    TestTrue("p50", IsNear(Histogram->GetValueAtPercentile(50.0), 50000));
+    TestTrue("p99", IsNear(Histogram->GetValueAtPercentile(99.0), 99000));
+    TestEqual("p100 should be the exact maximum", Histogram->GetValueAtPercentile(100.0), uint64(100000));
+    TestEqual("Count", Histogram->GetCount(), uint64(100000));
+
+    bool bBoundsIncrease = true;
+    for (int32 BucketIndex = 1; BucketIndex < FWindowsMessageLatencyHistogram::NumBuckets; ++BucketIndex)
+    {
+        const uint64 Bound = FWindowsMessageLatencyHistogram::GetBucketUpperBound(BucketIndex);
+        bBoundsIncrease &= Bound > FWindowsMessageLatencyHistogram::GetBucketUpperBound(BucketIndex - 1);
+        bBoundsIncrease &= BucketIndex == FWindowsMessageLatencyHistogram::NumBuckets - 1 || FWindowsMessageLatencyHistogram::GetBucketIndex(Bound) == BucketIndex;
+    }
+    TestTrue("Every bucket should end where the next one starts", bBoundsIncrease);
+    TestEqual("Huge values should land in the last bucket", FWindowsMessageLatencyHistogram::GetBucketIndex(MAX_uint64), FWindowsMessageLatencyHistogram::NumBuckets - 1);
+
+    TUniquePtr<FWindowsMessageLatencyHistogram> Merged = MakeUnique<FWindowsMessageLatencyHistogram>();
+    Merged->Add(200000);
+    Merged->Merge(*Histogram);
+    TestTrue("Merging should add counts and keep the larger maximum", Merged->GetCount() == 100001 && Merged->GetMax() == 200000);
+
+    Histogram->Reset();
+    TestEqual("Reset should empty the histogram", Histogram->GetValueAtPercentile(50.0), uint64(0));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageLatencySpikeTest, "WindowsMessageListener.Latency.Spikes", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageLatencySpikeTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageLatencyTracker Tracker(1, 8);
+    Tracker.SetSpikeThreshold(0.001, 10.0);
+
+    TArray<FWindowsMessageLatencyTimeline> Reported;
+    int32 NumReports = 0;
+    Tracker.SetSpikeSink([&Reported, &NumReports](TArrayView<const FWindowsMessageLatencyTimeline> Timelines)
+    {
+        Reported = Timelines;
+        ++NumReports;
+    });
+
+    // Twenty quick messages, then one that waited 5 ms in a queue
+    const uint64 Start = SecondsToCycles(100.0);
+    const uint64 Step = SecondsToCycles(0.00001);
+    uint64 Now = Start;
+    for (int32 Index = 0; Index < 20; ++Index, Now += Step)
+    {
+        Tracker.Add(FWindowsMessageRecord(1, Index % 2 ? SyntheticMouseMove : SyntheticKeyDown, Index, 0, Now), Now + Step / 2, Now + Step);
+    }
+    Tracker.Add(FWindowsMessageRecord(1, SyntheticTimer, 99, 0, Now), Now + SecondsToCycles(0.005), Now + SecondsToCycles(0.0051));
+    Tracker.Add(FWindowsMessageRecord(1, SyntheticTimer, 100, 0, Now), Now + SecondsToCycles(0.005), Now + SecondsToCycles(0.0052));
+    Tracker.Add(FWindowsMessageRecord(1, SyntheticTimer, 101, 0, 0), Now, Now); // No arrival time
+
+    TestEqual("A spike should be reported once within the quiet period", NumReports, 1);
+    TestTrue("The report should hold the most recent timelines, oldest first", Reported.Num() == 8 && Reported[0].ArrivalCycles == Start + 13 * Step);
+    TestTrue("The report should end with the spike", Reported.Num() == 8 && Reported.Last().Msg == SyntheticTimer);
+
+    const FWindowsMessageLatencyStats Stats = Tracker.GetStats();
+    TestEqual("Spikes in the quiet period should still be counted", Stats.Spikes, uint64(2));
+    TestEqual("Reports", Stats.Reports, uint64(1));
+    TestEqual("Messages without an arrival time should be ignored", Stats.AllCodes[EWindowsMessageLatencyStage::Total].Count, uint64(22));
+    TestTrue("The first code should get the only tracked slot, the rest should share one",
+        Stats.MessageCodes.Num() == 2 && Stats.MessageCodes[0].MsgCode == SyntheticKeyDown && !Stats.MessageCodes[0].bOther && Stats.MessageCodes[1].bOther);
+    TestTrue("The maximum should be the spike", FMath::IsNearlyEqual(Stats.AllCodes[EWindowsMessageLatencyStage::Total].Max, 0.0052, 0.0001));
+    TestTrue("Queue time should be separated from handler time", FMath::IsNearlyEqual(Stats.AllCodes[EWindowsMessageLatencyStage::Queue].Max, 0.005, 0.0001));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageLatencyDispatcherTest, "WindowsMessageListener.Latency.Dispatcher", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageLatencyDispatcherTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageType(SyntheticKeyDown);
+    Dispatcher.AllowMessageType(SyntheticMouseMove);
+    Dispatcher.EnableDeferredProcessing(64, EWindowsMessageOverflowPolicy::DropNewest, false);
+
+    FWindowsMessageTestHandler Handler;
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&Handler), {});
+    Dispatcher.EnableLatencyTracking();
+
+    // Arrival stamps in the past stand in for time spent waiting in the deferred queue
+    int32 Result = 0;
+    const uint64 Now = FPlatformTime::Cycles64();
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyDown, 0, 0, Now - SecondsToCycles(0.002)), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 0, 0, Now - SecondsToCycles(0.003)), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 0, 0, 0), Result);
+    Dispatcher.DrainDeferredMessages();
+
+    const FWindowsMessageLatencyStats Stats = Dispatcher.GetLatencyStats();
+    TestEqual("Every timestamped message should be measured", Stats.AllCodes[EWindowsMessageLatencyStage::Total].Count, uint64(2));
+    TestTrue("Time in the queue should be measured", Stats.MessageCodes.Num() == 2 && Stats.MessageCodes[0].MsgCode == SyntheticKeyDown
+        && Stats.MessageCodes[0][EWindowsMessageLatencyStage::Queue].P50 >= 0.002 && Stats.MessageCodes[1][EWindowsMessageLatencyStage::Queue].P50 >= 0.003);
+    TestTrue("Totals should cover the queue", Stats.AllCodes[EWindowsMessageLatencyStage::Total].Max >= Stats.AllCodes[EWindowsMessageLatencyStage::Queue].Max);
+    TestEqual("Without a system clock, the System stage should be empty", Stats.AllCodes[EWindowsMessageLatencyStage::System].Count, uint64(0));
+
+    Dispatcher.DisableLatencyTracking();
+    TestEqual("Disabling should discard the histograms", Dispatcher.GetLatencyStats().AllCodes[EWindowsMessageLatencyStage::Total].Count, uint64(0));
+    return true;
+}
@@ -0,0 +1,194 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageListener.h"
+#include "WindowsMessageCodeHelper.h"
+#include "WindowsMessageCodeTable.h"
+#include "WindowsMessageAllocationCounter.h"
+#include "HAL/PlatformTime.h"
+
+#if PLATFORM_WINDOWS
+namespace
+{
+    /** Handler that only counts the messages it receives. */
+    class FListenerBenchmarkHandler : public IWindowsMessageHandler
+    {
+    public:
+        virtual bool ProcessMessage(HWND hwnd, uint32 msg, WPARAM wParam, LPARAM lParam, int32& OutResult) override
+        {
+            ++MessageCount;
+            return false;
+        }
+
+        int32 MessageCount = 0;
+    };
+
+    /**
+     * Feeds a synthetic stream of one message code through the listener.
+     * @return The average cost of a message in nanoseconds.
+     */
+    double MeasureNanosecondsPerMessage(FWindowsMessageListener& Listener, uint32 MsgCode, int32 NumMessages)
+    {
+        int32 Result = 0;
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        for (int32 Index = 0; Index < NumMessages; ++Index)
+        {
+            Listener.ProcessMessage(nullptr, MsgCode, Index, Index, Result);
+        }
+        const uint64 EndCycles = FPlatformTime::Cycles64();
+        return FPlatformTime::ToSeconds64(EndCycles - StartCycles) * 1e9 / NumMessages;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageDispatchScalingBenchmark, "WindowsMessageListener.Benchmark.DispatchScaling", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FWindowsMessageDispatchScalingBenchmark::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumMessages = 200000;
+    constexpr int32 NumRuns = 3;             // Best of several runs, so one preempted run does not fail the check
+    constexpr double MaxCostGrowth = 3.0;    // Allowed per-message cost over the single-handler run; a handler scan would grow ~1000x
+    const int32 HandlerCounts[] = { 1, 16, 256, 1024 };
+
+    double BaselineNanosecondsPerMessage = 0.0;
+    for (int32 HandlerCount : HandlerCounts)
+    {
+        FWindowsMessageListener Listener;
+        Listener.AddAllowedMessageType(WM_MOUSEMOVE);
+
+        // One handler cares about the storm, the others subscribe to unrelated WM_USER codes
+        TArray<FListenerBenchmarkHandler> Handlers;
+        Handlers.SetNum(HandlerCount);
+        Listener.AddMessageHandler(&Handlers[0], { WM_MOUSEMOVE });
+        for (int32 Index = 1; Index < HandlerCount; ++Index)
+        {
+            Listener.AddMessageHandler(&Handlers[Index], { WM_USER + static_cast<uint32>(Index) });
+        }
+
+        double NanosecondsPerMessage = MAX_dbl;
+        for (int32 Run = 0; Run < NumRuns; ++Run)
+        {
+            NanosecondsPerMessage = FMath::Min(NanosecondsPerMessage, MeasureNanosecondsPerMessage(Listener, WM_MOUSEMOVE, NumMessages));
+        }
+        AddInfo(FString::Printf(TEXT("%4d handlers: %.1f ns/message"), HandlerCount, NanosecondsPerMessage));
+
+        if (BaselineNanosecondsPerMessage == 0.0)
+        {
+            BaselineNanosecondsPerMessage = NanosecondsPerMessage;
+        }
+        else
+        {
+            TestTrue(FString::Printf(TEXT("Per-message cost should stay flat with %d handlers (%.1f ns vs %.1f ns)"), HandlerCount, NanosecondsPerMessage, BaselineNanosecondsPerMessage),
+                NanosecondsPerMessage <= BaselineNanosecondsPerMessage * MaxCostGrowth);
+        }
+
+        TestEqual(FString::Printf(TEXT("Subscribed handler should see every message with %d handlers"), HandlerCount), Handlers[0].MessageCount, NumMessages * NumRuns);
+        if (HandlerCount > 1)
+        {
+            TestEqual(FString::Printf(TEXT("Unsubscribed handlers should see no messages with %d handlers"), HandlerCount), Handlers[1].MessageCount, 0);
+        }
+
+        Listener.RemoveAllMessageHandlers();
+    }
+
+    return true;
+}
+
+#endif // PLATFORM_WINDOWS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageLoggingAllocationBenchmark, "WindowsMessageListener.Benchmark.VerboseLoggingAllocations", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FWindowsMessageLoggingAllocationBenchmark::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumMessages = 10000;
+    const uint32 MessageCodes[] = { 0x0200 /* WM_MOUSEMOVE */, 0x0100 /* WM_KEYDOWN */, WM_USER_START + 0x12, WM_APP_START + 0x3, 0x7FFF0 };
+    const uint64 Hwnd = 0x1234;
+
+    // The FString-based path used before: two FWindowsMessageInfo copies and a formatted line per message
+    uint64 StringAllocations = 0;
+    {
+        FWindowsMessageAllocationCounter Counter;
+        for (int32 Index = 0; Index < NumMessages; ++Index)
+        {
+            const uint32 MsgCode = MessageCodes[Index % UE_ARRAY_COUNT(MessageCodes)];
+            FString MessageName = FWindowsMessageCodeHelper::GetMessageName(MsgCode);
+            FString MessageDescription = FWindowsMessageCodeHelper::GetMessageDescription(MsgCode);
+            FString Line = FString::Printf(TEXT("%s: hwnd=0x%llx, msg=%u, name=%s, description=%s"), TEXT("Processing message"), Hwnd, MsgCode, *MessageName, *MessageDescription);
+        }
+        StringAllocations = Counter.GetNumAllocations();
+    }
+
+    // The path used by LogMessageDetails: static name views formatted into a stack buffer
+    uint64 ViewAllocations = 0;
+    {
+        FWindowsMessageAllocationCounter Counter;
+        for (int32 Index = 0; Index < NumMessages; ++Index)
+        {
+            const uint32 MsgCode = MessageCodes[Index % UE_ARRAY_COUNT(MessageCodes)];
+            TStringBuilder<256> Line;
+            FWindowsMessageCodeHelper::FormatMessageDetails(Line, TEXT("Processing message"), Hwnd, MsgCode);
+        }
+        ViewAllocations = Counter.GetNumAllocations();
+    }
+
+    AddInfo(FString::Printf(TEXT("FString path: %.2f allocations/message"), static_cast<double>(StringAllocations) / NumMessages));
+    AddInfo(FString::Printf(TEXT("View path: %.2f allocations/message"), static_cast<double>(ViewAllocations) / NumMessages));
+    FWindowsMessageAllocationCounter::TestNoAllocations(*this, TEXT("Formatting message details should not allocate"), ViewAllocations);
+
+    return true;
+}
+
+namespace
+{
+    /** The linear, case-insensitive scan GetMessageCodeByName used before the hash index. */
+    uint32 FindMessageCodeByLinearScan(const TCHAR* MessageName)
+    {
+        for (const FWindowsMessageCodeEntry& Entry : WindowsMessageCodeTable)
+        {
+            if (FCString::Stricmp(Entry.Name, MessageName) == 0)
+            {
+                return Entry.Code;
+            }
+        }
+        return 0;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageCodeByNameBenchmark, "WindowsMessageListener.Benchmark.CodeByName", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FWindowsMessageCodeByNameBenchmark::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumPasses = 200;
+
+    // Resolve every known name, as a config loader resolving the full table would
+    TArray<FString> Names;
+    for (const FWindowsMessageCodeEntry& Entry : WindowsMessageCodeTable)
+    {
+        Names.Add(FString(Entry.Name).ToLower());
+    }
+    const int32 NumLookups = NumPasses * Names.Num();
+
+    uint64 ScanChecksum = 0;
+    const uint64 ScanStart = FPlatformTime::Cycles64();
+    for (int32 Pass = 0; Pass < NumPasses; ++Pass)
+    {
+        for (const FString& Name : Names)
+        {
+            ScanChecksum += FindMessageCodeByLinearScan(*Name);
+        }
+    }
+    const double ScanNanoseconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - ScanStart) * 1e9 / NumLookups;
+
+    uint64 IndexChecksum = 0;
+    const uint64 IndexStart = FPlatformTime::Cycles64();
+    for (int32 Pass = 0; Pass < NumPasses; ++Pass)
+    {
+        for (const FString& Name : Names)
+        {
+            uint32 MsgCode = 0;
+            FWindowsMessageCodeHelper::TryGetMessageCodeByName(Name, MsgCode);
+            IndexChecksum += MsgCode;
+        }
+    }
+    const double IndexNanoseconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - IndexStart) * 1e9 / NumLookups;
+
+    AddInfo(FString::Printf(TEXT("Linear scan: %.1f ns/lookup"), ScanNanoseconds));
+    AddInfo(FString::Printf(TEXT("Hash index: %.1f ns/lookup"), IndexNanoseconds));
+    TestEqual("Both lookups should resolve the same codes", IndexChecksum, ScanChecksum);
+
+    return true;
+}
@@ -0,0 +1,111 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageListenerState.h"
+#include "WindowsMessageDispatcher.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+namespace
+{
+    constexpr uint32 SyntheticRegisteredMsg = 0xC123;
+    constexpr uint32 SyntheticAppMsg = 0x12345;
+
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageListenerStateRoundTripTest, "WindowsMessageListener.State.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageListenerStateRoundTripTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageListenerState State;
+    State.AllowedMessageTypes.AllowRange(SyntheticKeyDown, SyntheticChar);
+    State.AllowedMessageTypes.Allow(SyntheticRegisteredMsg);
+    State.AllowedMessageTypes.Allow(SyntheticAppMsg);
+    State.CoalescedMessageTypes.Allow(SyntheticMouseMove);
+    State.ConsumptionPolicy = EWindowsMessageConsumptionPolicy::StopFanOut;
+    FWindowsMessageSubscriptionState& Subscription = State.Subscriptions.AddDefaulted_GetRef();
+    Subscription.Handler = TEXT("Keys");
+    Subscription.Priority = 5;
+    Subscription.Ranges = { TPair<uint32, uint32>(SyntheticKeyDown, SyntheticKeyUp), TPair<uint32, uint32>(SyntheticMouseMove, SyntheticMouseMove) };
+    Subscription.Rule = TEXT("FunctionKeys");
+    Subscription.Thread = EWindowsMessageHandlerThread::Worker;
+    Subscription.Worker = 2;
+
+    const TArray<uint8> Bytes = State.SaveToBytes();
+    TestTrue("Only the non-zero bitmap words should be stored", Bytes.Num() < 256);
+
+    FWindowsMessageListenerState Loaded;
+    TestTrue("A saved state should load", Loaded.LoadFromBytes(Bytes));
+    TestEqual("Allowed types should survive", Loaded.AllowedMessageTypes.Num(), 5);
+    TestTrue("Bitmap and overflow codes should survive", Loaded.AllowedMessageTypes.IsAllowed(SyntheticChar) && Loaded.AllowedMessageTypes.IsAllowed(SyntheticRegisteredMsg) && Loaded.AllowedMessageTypes.IsAllowed(SyntheticAppMsg));
+    TestFalse("Disallowed types should stay disallowed", Loaded.AllowedMessageTypes.IsAllowed(SyntheticMouseMove));
+    TestTrue("Coalesced types should survive", Loaded.CoalescedMessageTypes.IsAllowed(SyntheticMouseMove) && Loaded.CoalescedMessageTypes.Num() == 1);
+    TestTrue("The consumption policy should survive", Loaded.ConsumptionPolicy == EWindowsMessageConsumptionPolicy::StopFanOut);
+    TestTrue("Subscriptions should survive", Loaded.Subscriptions.Num() == 1 && Loaded.Subscriptions[0].Handler == TEXT("Keys") && Loaded.Subscriptions[0].Priority == 5
+        && Loaded.Subscriptions[0].Ranges == Subscription.Ranges && Loaded.Subscriptions[0].Rule == TEXT("FunctionKeys")
+        && Loaded.Subscriptions[0].Thread == EWindowsMessageHandlerThread::Worker && Loaded.Subscriptions[0].Worker == 2);
+
+    TArray<uint8> Corrupt = Bytes;
+    Corrupt[0] ^= 0xFF;
+    TestFalse("A bad magic number should be rejected", Loaded.LoadFromBytes(Corrupt));
+    TestTrue("A rejected load should leave the state empty", Loaded.AllowedMessageTypes.IsEmpty() && Loaded.Subscriptions.Num() == 0);
+    TestFalse("A truncated state should be rejected", Loaded.LoadFromBytes(MakeArrayView(Bytes.GetData(), Bytes.Num() - 4)));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageListenerStateRestoreTest, "WindowsMessageListener.State.Restore", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageListenerStateRestoreTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageTestHandler KeyHandler;
+    FWindowsMessageTestHandler MouseHandler;
+    FWindowsMessageTestHandler UnnamedHandler;
+    TMap<const void*, FName> Names;
+    Names.Add(&KeyHandler, TEXT("Keys"));
+    Names.Add(&MouseHandler, TEXT("Mouse"));
+
+    FWindowsMessageListenerState State;
+    {
+        FWindowsMessageDispatcher Source;
+        const uint32 KeyCodes[] = { SyntheticKeyDown, SyntheticKeyUp, SyntheticChar };
+        Source.AllowMessageTypes(KeyCodes);
+        Source.AllowMessageType(SyntheticMouseMove);
+        Source.AddCoalescedMessageType(SyntheticMouseMove);
+        Source.AddHandler(FWindowsMessageHandlerRef::Create(&KeyHandler), { TPair<uint32, uint32>(SyntheticKeyDown, SyntheticChar) });
+        Source.AddHandler(FWindowsMessageHandlerRef::Create(&MouseHandler), {});
+        Source.AddHandler(FWindowsMessageHandlerRef::Create(&MouseHandler), {}, 7);
+        Source.AddHandler(FWindowsMessageHandlerRef::Create(&UnnamedHandler), {});
+        Source.SetHandlerPriority(&MouseHandler, 10);
+        TestEqual("Only named subscriptions to every window should be saved", Source.SaveState(State, [&Names](const void* Object) { return Names.FindRef(Object); }), 2);
+    }
+    TestTrue("Subscriptions should be saved in dispatch order", State.Subscriptions.Num() == 2 && State.Subscriptions[0].Handler == TEXT("Mouse") && State.Subscriptions[1].Handler == TEXT("Keys"));
+
+    FWindowsMessageListenerState Loaded;
+    TestTrue("The saved state should load", Loaded.LoadFromBytes(State.SaveToBytes()));
+
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageType(SyntheticRegisteredMsg);
+    const int32 NumRestored = Dispatcher.RestoreState(Loaded, [&KeyHandler, &MouseHandler](FName HandlerName)
+    {
+        return HandlerName == TEXT("Keys") ? FWindowsMessageHandlerRef::Create(&KeyHandler) : HandlerName == TEXT("Mouse") ? FWindowsMessageHandlerRef::Create(&MouseHandler) : FWindowsMessageHandlerRef();
+    });
+    TestEqual("Both named handlers should be restored", NumRestored, 2);
+    TestFalse("The allow-list should be replaced", Dispatcher.IsMessageAllowed(SyntheticRegisteredMsg));
+    TestTrue("The saved allow-list should be installed", Dispatcher.IsMessageAllowed(SyntheticKeyUp) && Dispatcher.IsMessageAllowed(SyntheticMouseMove));
+
+    int32 Result = 0;
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyDown, 0, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 1, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 2, 0, 0), Result);
+    TestEqual("Restored coalesced types should hold messages back", MouseHandler.Received.Num(), 1);
+    Dispatcher.FlushCoalescedMessages();
+    TestTrue("Only the newest coalesced message should be flushed", MouseHandler.Received.Num() == 2 && MouseHandler.Received.Last().WParam == 2);
+    TestTrue("Restored ranges should apply", KeyHandler.Received.Num() == 1 && KeyHandler.Received[0].Msg == SyntheticKeyDown);
+
+    // Restoring again replaces the subscriptions rather than adding to them
+    Dispatcher.RestoreState(Loaded, [&KeyHandler](FName HandlerName) { return HandlerName == TEXT("Keys") ? FWindowsMessageHandlerRef::Create(&KeyHandler) : FWindowsMessageHandlerRef(); });
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyUp, 3, 0, 0), Result);
+    TestEqual("A restored handler should be called once per message", KeyHandler.Received.Num(), 2);
+
+    FWindowsMessageListenerState Resaved;
+    Dispatcher.SaveState(Resaved, [&Names](const void* Object) { return Names.FindRef(Object); });
+    TestTrue("Restored priorities should keep the saved order", Resaved.Subscriptions.Num() == 2 && Resaved.Subscriptions[0].Handler == TEXT("Mouse") && Resaved.Subscriptions[0].Priority == 10);
+    return true;
+}
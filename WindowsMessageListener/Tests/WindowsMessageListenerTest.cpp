@@ -1,6 +1,11 @@
 #include "Misc/AutomationTest.h"
 #include "WindowsMessageListener.h"
+#include "WindowsMessageListenerHub.h"
 #include "WindowsMessageCodeHelper.h"
+#include "WindowsMessageFilter.h"
+#include "Async/Async.h"
+
+#if PLATFORM_WINDOWS
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageListenerTest, "WindowsMessageListener.BasicFunctionality", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
 bool FWindowsMessageListenerTest::RunTest(const FString& Parameters)
@@ -60,4 +65,504 @@ bool FWindowsMessageListenerTest::RunTest(const FString& Parameters)
     TestFalse("Verbose logging should be disabled", Listener.IsVerboseLoggingEnabled());
 
     return true;
-}
\ No newline at end of file
+}
+
+namespace
+{
+    /** Handler that counts the messages it receives, per message code. */
+    class FCountingMessageHandler : public IWindowsMessageHandler
+    {
+    public:
+        virtual bool ProcessMessage(HWND hwnd, uint32 msg, WPARAM wParam, LPARAM lParam, int32& OutResult) override
+        {
+            ReceivedCounts.FindOrAdd(msg)++;
+            return false;
+        }
+
+        int32 GetReceivedCount(uint32 msg) const
+        {
+            const int32* Count = ReceivedCounts.Find(msg);
+            return Count ? *Count : 0;
+        }
+
+        TMap<uint32, int32> ReceivedCounts;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageListenerSubscriptionTest, "WindowsMessageListener.HandlerSubscriptions", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageListenerSubscriptionTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageListener Listener;
+    Listener.AddAllowedMessageType(WM_KEYDOWN);
+    Listener.AddAllowedMessageType(WM_KEYUP);
+    Listener.AddAllowedMessageType(WM_MOUSEMOVE);
+
+    FCountingMessageHandler AllHandler;
+    FCountingMessageHandler KeyHandler;
+    FCountingMessageHandler MouseHandler;
+    Listener.AddMessageHandler(&AllHandler);
+    Listener.AddMessageHandler(&KeyHandler, { WM_KEYDOWN, WM_KEYUP });
+    Listener.AddMessageHandlerForRange(&MouseHandler, WM_MOUSEFIRST, WM_MOUSELAST);
+
+    int32 Result = 0;
+    Listener.ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result);
+    Listener.ProcessMessage(nullptr, WM_KEYUP, 0, 0, Result);
+    Listener.ProcessMessage(nullptr, WM_MOUSEMOVE, 0, 0, Result);
+    Listener.ProcessMessage(nullptr, WM_CHAR, 0, 0, Result); // Filtered out before dispatch
+
+    TestEqual("Unrestricted handler should receive every allowed message", AllHandler.ReceivedCounts.Num(), 3);
+    TestEqual("Key handler should receive WM_KEYDOWN", KeyHandler.GetReceivedCount(WM_KEYDOWN), 1);
+    TestEqual("Key handler should receive WM_KEYUP", KeyHandler.GetReceivedCount(WM_KEYUP), 1);
+    TestEqual("Key handler should not receive WM_MOUSEMOVE", KeyHandler.GetReceivedCount(WM_MOUSEMOVE), 0);
+    TestEqual("Mouse handler should receive WM_MOUSEMOVE", MouseHandler.GetReceivedCount(WM_MOUSEMOVE), 1);
+    TestEqual("Mouse handler should not receive WM_KEYDOWN", MouseHandler.GetReceivedCount(WM_KEYDOWN), 0);
+    TestEqual("Filtered messages should not be dispatched", AllHandler.GetReceivedCount(WM_CHAR), 0);
+
+    // Subscribing again merges codes into the existing subscription
+    Listener.AddMessageHandler(&KeyHandler, { WM_MOUSEMOVE });
+    Listener.ProcessMessage(nullptr, WM_MOUSEMOVE, 0, 0, Result);
+    TestEqual("Merged subscription should receive WM_MOUSEMOVE", KeyHandler.GetReceivedCount(WM_MOUSEMOVE), 1);
+    TestEqual("Each handler should be invoked once per message", AllHandler.GetReceivedCount(WM_MOUSEMOVE), 2);
+
+    Listener.RemoveMessageHandler(&MouseHandler);
+    Listener.ProcessMessage(nullptr, WM_MOUSEMOVE, 0, 0, Result);
+    TestEqual("Removed handler should not receive messages", MouseHandler.GetReceivedCount(WM_MOUSEMOVE), 1);
+
+    Listener.RemoveAllMessageHandlers();
+    Listener.ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result);
+    TestEqual("No handler should receive messages after removing all", AllHandler.GetReceivedCount(WM_KEYDOWN), 1);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageListenerHubTest, "WindowsMessageListener.SharedHub", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageListenerHubTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageListenerHub* Hub = FWindowsMessageListenerHub::Get();
+    if (!TestNotNull("The module should own a hub", Hub))
+    {
+        return false;
+    }
+    const int32 NumBefore = Hub->NumSubscribers();
+
+    FWindowsMessageListener KeyListener;
+    FWindowsMessageListener MouseListener;
+    FWindowsMessageListener DirectListener;
+    FCountingMessageHandler KeyHandler;
+    FCountingMessageHandler MouseHandler;
+    KeyListener.AddAllowedMessageType(WM_KEYDOWN);
+    KeyListener.AddMessageHandler(&KeyHandler);
+    MouseListener.AddAllowedMessageType(WM_MOUSEMOVE);
+    MouseListener.AddMessageHandler(&MouseHandler);
+
+    KeyListener.StartListening();
+    MouseListener.StartListening();
+    DirectListener.StartListening(EWindowsMessageListenerRegistration::Direct);
+    TestTrue("Shared listeners should attach to the hub", KeyListener.IsAttachedToHub() && MouseListener.IsAttachedToHub());
+    TestFalse("Direct listeners should not attach to the hub", DirectListener.IsAttachedToHub());
+    TestEqual("The hub should count its subscribers", Hub->NumSubscribers(), NumBefore + 2);
+    TestTrue("The hub should be registered once for all of them", Hub->IsRegistered());
+    TestTrue("The combined filter should allow every subscriber's types", Hub->IsMessageForwarded(WM_KEYDOWN) && Hub->IsMessageForwarded(WM_MOUSEMOVE));
+
+    // Allow-list changes reach the combined filter
+    MouseListener.AddAllowedMessageType(WM_CHAR);
+    TestTrue("Newly allowed types should be forwarded", Hub->IsMessageForwarded(WM_CHAR));
+
+    int32 Result = 0;
+    KeyListener.ResetMessageStats();
+    MouseListener.ResetMessageStats();
+    Hub->ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result);
+    Hub->ProcessMessage(nullptr, WM_MOUSEMOVE, 0, 0, Result);
+    Hub->ProcessMessage(nullptr, WM_CHAR, 0, 0, Result);
+    TestEqual("Key subscriber should receive its type", KeyHandler.GetReceivedCount(WM_KEYDOWN), 1);
+    TestEqual("Key subscriber should only receive the types it allows", KeyHandler.GetReceivedCount(WM_MOUSEMOVE), 0);
+    TestEqual("Mouse subscriber should receive its types", MouseHandler.GetReceivedCount(WM_MOUSEMOVE) + MouseHandler.GetReceivedCount(WM_CHAR), 2);
+
+    // Each message only reaches the subscribers that allow it, so none of them counts another's messages as rejected
+    auto HasRejections = [](const FWindowsMessageStatsSnapshot& Stats)
+    {
+        return Stats.MessageCodes.ContainsByPredicate([](const FWindowsMessageCodeStats& CodeStats) { return CodeStats.Filtered > 0; });
+    };
+    TestFalse("Key subscriber should not reject the mouse subscriber's messages", HasRejections(KeyListener.GetMessageStats()));
+    TestFalse("Mouse subscriber should not reject the key subscriber's messages", HasRejections(MouseListener.GetMessageStats()));
+
+    // Allow-list changes move the subscriber's bit in the per-code masks
+    KeyListener.RemoveAllowedMessageType(WM_KEYDOWN);
+    Hub->ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result);
+    TestEqual("Subscribers should stop receiving types they no longer allow", KeyHandler.GetReceivedCount(WM_KEYDOWN), 1);
+    KeyListener.AddAllowedMessageType(WM_KEYDOWN);
+
+    // Lifetime messages release every subscriber's window bindings, without counting as rejected by those that filter them out
+    const HWND Window = reinterpret_cast<HWND>(0x1000);
+    FCountingMessageHandler WindowHandler;
+    KeyListener.AddWindowMessageHandler(&WindowHandler, Window);
+    KeyListener.ResetMessageStats();
+    Hub->ProcessMessage(Window, WM_DESTROY, 0, 0, Result);
+    Hub->ProcessMessage(Window, WM_KEYDOWN, 0, 0, Result);
+    TestEqual("Window handlers should be unbound when their window is destroyed", WindowHandler.GetReceivedCount(WM_KEYDOWN), 0);
+    const FWindowsMessageStatsSnapshot Stats = KeyListener.GetMessageStats();
+    TestFalse("Forwarded lifetime messages should not count as rejected", Stats.MessageCodes.ContainsByPredicate([](const FWindowsMessageCodeStats& CodeStats)
+    {
+        return CodeStats.FirstMsgCode == WM_DESTROY && CodeStats.Filtered > 0;
+    }));
+
+    MouseListener.StopListening();
+    KeyListener.StopListening();
+    DirectListener.StopListening();
+    TestEqual("Stopped listeners should detach", Hub->NumSubscribers(), NumBefore);
+    TestEqual("The hub should unregister with its last subscriber", Hub->IsRegistered(), NumBefore > 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageFilterTest, "WindowsMessageListener.MessageFilter", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageFilterTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageFilter Filter;
+    TestTrue("Filter should be empty initially", Filter.IsEmpty());
+    TestFalse("No code should be allowed initially", Filter.IsAllowed(WM_KEYDOWN));
+
+    // Ranges that start and end inside the same word
+    Filter.AllowRange(WM_KEYFIRST, WM_KEYLAST);
+    TestTrue("First code of the range should be allowed", Filter.IsAllowed(WM_KEYFIRST));
+    TestTrue("Last code of the range should be allowed", Filter.IsAllowed(WM_KEYLAST));
+    TestFalse("Code before the range should not be allowed", Filter.IsAllowed(WM_KEYFIRST - 1));
+    TestFalse("Code after the range should not be allowed", Filter.IsAllowed(WM_KEYLAST + 1));
+
+    // Ranges that span several words
+    Filter.AllowRange(WM_APP_START + 5, WM_APP_START + 300);
+    TestTrue("Code inside a multi-word range should be allowed", Filter.IsAllowed(WM_APP_START + 128));
+    TestTrue("Last code of a multi-word range should be allowed", Filter.IsAllowed(WM_APP_START + 300));
+    TestFalse("Code before a multi-word range should not be allowed", Filter.IsAllowed(WM_APP_START + 4));
+    TestFalse("Code after a multi-word range should not be allowed", Filter.IsAllowed(WM_APP_START + 301));
+
+    Filter.DisallowRange(WM_APP_START + 64, WM_APP_START + 200);
+    TestFalse("Code inside a removed range should not be allowed", Filter.IsAllowed(WM_APP_START + 100));
+    TestTrue("Code before a removed range should remain allowed", Filter.IsAllowed(WM_APP_START + 63));
+    TestTrue("Code after a removed range should remain allowed", Filter.IsAllowed(WM_APP_START + 201));
+
+    // Registered messages live at the top of the bitmap, larger codes use the hashed fallback
+    Filter.Allow(0xFFFF);
+    Filter.Allow(0x12345);
+    TestTrue("Registered message code should be allowed", Filter.IsAllowed(0xFFFF));
+    TestTrue("Overflow code should be allowed", Filter.IsAllowed(0x12345));
+    TestFalse("Unrelated overflow code should not be allowed", Filter.IsAllowed(0x12346));
+    Filter.Disallow(0x12345);
+    TestFalse("Removed overflow code should not be allowed", Filter.IsAllowed(0x12345));
+
+    // Merging keeps both filters' codes, as the shared hub does for its subscribers
+    FWindowsMessageFilter Other;
+    Other.Allow(WM_CHAR);
+    Other.Allow(0x12347);
+    Filter.Merge(Other);
+    TestTrue("Merged codes should be allowed", Filter.IsAllowed(WM_CHAR) && Filter.IsAllowed(0x12347));
+    TestTrue("Existing codes should survive a merge", Filter.IsAllowed(0xFFFF));
+
+    // Enumeration visits exactly the allowed codes, as the shared hub does to build its subscriber masks
+    int32 NumVisited = 0;
+    bool bVisitedOnlyAllowed = true;
+    Filter.ForEachAllowed([&Filter, &NumVisited, &bVisitedOnlyAllowed](uint32 MsgCode)
+    {
+        ++NumVisited;
+        bVisitedOnlyAllowed &= Filter.IsAllowed(MsgCode);
+    });
+    TestTrue("Enumeration should visit every allowed code once", NumVisited == Filter.Num() && bVisitedOnlyAllowed);
+
+    Filter.Reset();
+    TestTrue("Filter should be empty after reset", Filter.IsEmpty());
+    TestFalse("No code should be allowed after reset", Filter.IsAllowed(WM_KEYDOWN));
+
+    return true;
+}
+
+namespace
+{
+    /** Handler that records every message it receives, in order. */
+    class FRecordingMessageHandler : public IWindowsMessageHandler
+    {
+    public:
+        virtual bool ProcessMessage(HWND hwnd, uint32 msg, WPARAM wParam, LPARAM lParam, int32& OutResult) override
+        {
+            Received.Emplace(msg, lParam);
+            return false;
+        }
+
+        TArray<TPair<uint32, LPARAM>> Received;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageListenerCoalescingTest, "WindowsMessageListener.Coalescing", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageListenerCoalescingTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageListener Listener;
+    Listener.AddAllowedMessageType(WM_MOUSEMOVE);
+    Listener.AddAllowedMessageType(WM_LBUTTONDOWN);
+    Listener.AddCoalescedMessageType(WM_MOUSEMOVE);
+
+    FRecordingMessageHandler Handler;
+    Listener.AddMessageHandler(&Handler);
+
+    int32 Result = 0;
+    for (LPARAM Position = 0; Position < 100; ++Position)
+    {
+        Listener.ProcessMessage(nullptr, WM_MOUSEMOVE, 0, Position, Result);
+    }
+    TestEqual("Coalesced messages should be held until a flush", Handler.Received.Num(), 0);
+
+    // A button press flushes the pending move first so handlers see the position it happened at
+    Listener.ProcessMessage(nullptr, WM_LBUTTONDOWN, 0, 99, Result);
+    if (TestEqual("The newest move and the button press should be delivered", Handler.Received.Num(), 2))
+    {
+        TestEqual("The pending move should be delivered first", Handler.Received[0].Key, static_cast<uint32>(WM_MOUSEMOVE));
+        TestEqual("Only the newest move should be delivered", Handler.Received[0].Value, static_cast<LPARAM>(99));
+        TestEqual("The button press should follow the move", Handler.Received[1].Key, static_cast<uint32>(WM_LBUTTONDOWN));
+    }
+
+    for (LPARAM Position = 100; Position < 150; ++Position)
+    {
+        Listener.ProcessMessage(nullptr, WM_MOUSEMOVE, 0, Position, Result);
+    }
+    TestEqual("Flush should deliver one message per window and code", Listener.FlushCoalescedMessages(), 1);
+    TestEqual("The flushed move should be the newest one", Handler.Received.Last().Value, static_cast<LPARAM>(149));
+
+    const FWindowsMessageCoalescerCounters Counters = Listener.GetCoalescerCounters();
+    TestEqual("Messages in", Counters.MessagesIn, uint64(150));
+    TestEqual("Messages delivered", Counters.MessagesDelivered, uint64(2));
+    TestEqual("Messages coalesced", Counters.MessagesCoalesced, uint64(148));
+
+    return true;
+}
+
+namespace
+{
+    /** Handler that changes the listener's registrations from inside ProcessMessage. */
+    class FReentrantMessageHandler : public IWindowsMessageHandler
+    {
+    public:
+        FReentrantMessageHandler(FWindowsMessageListener& InListener)
+            : Listener(InListener)
+        {
+        }
+
+        virtual bool ProcessMessage(HWND hwnd, uint32 msg, WPARAM wParam, LPARAM lParam, int32& OutResult) override
+        {
+            ++ReceivedCount;
+            Listener.RemoveMessageHandler(this);
+            if (HandlerToRemove)
+            {
+                Listener.RemoveMessageHandler(HandlerToRemove);
+            }
+            if (HandlerToAdd)
+            {
+                Listener.AddMessageHandler(HandlerToAdd);
+            }
+            return false;
+        }
+
+        FWindowsMessageListener& Listener;
+        IWindowsMessageHandler* HandlerToRemove = nullptr;
+        IWindowsMessageHandler* HandlerToAdd = nullptr;
+        int32 ReceivedCount = 0;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageListenerRegistrationTest, "WindowsMessageListener.RegistrationDuringDispatch", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageListenerRegistrationTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageListener Listener;
+    Listener.AddAllowedMessageType(WM_KEYDOWN);
+
+    FReentrantMessageHandler ReentrantHandler(Listener);
+    FCountingMessageHandler RemovedHandler;
+    FCountingMessageHandler AddedHandler;
+    ReentrantHandler.HandlerToRemove = &RemovedHandler;
+    ReentrantHandler.HandlerToAdd = &AddedHandler;
+    Listener.AddMessageHandler(&ReentrantHandler);
+    Listener.AddMessageHandler(&RemovedHandler);
+
+    int32 Result = 0;
+    Listener.ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result);
+    TestEqual("Reentrant handler should receive the message", ReentrantHandler.ReceivedCount, 1);
+    TestEqual("A handler removed during dispatch should be skipped", RemovedHandler.GetReceivedCount(WM_KEYDOWN), 0);
+    TestEqual("A handler added during dispatch should wait for the next message", AddedHandler.GetReceivedCount(WM_KEYDOWN), 0);
+
+    Listener.ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result);
+    TestEqual("A handler that removed itself should not receive further messages", ReentrantHandler.ReceivedCount, 1);
+    TestEqual("A handler added during dispatch should receive the next message", AddedHandler.GetReceivedCount(WM_KEYDOWN), 1);
+
+    // Registration changes on another thread must not disturb a dispatch loop running concurrently
+    Listener.RemoveAllMessageHandlers();
+    FCountingMessageHandler StableHandler;
+    Listener.AddMessageHandler(&StableHandler);
+
+    constexpr int32 NumMessages = 100000;
+    std::atomic<bool> bDispatching{true};
+    TFuture<void> Registrar = Async(EAsyncExecution::Thread, [&Listener, &bDispatching]()
+    {
+        TArray<FCountingMessageHandler> TransientHandlers;
+        TransientHandlers.SetNum(8);
+        while (bDispatching.load())
+        {
+            for (FCountingMessageHandler& Handler : TransientHandlers)
+            {
+                Listener.AddMessageHandler(&Handler, { WM_KEYDOWN });
+            }
+            for (FCountingMessageHandler& Handler : TransientHandlers)
+            {
+                Listener.RemoveMessageHandler(&Handler);
+            }
+        }
+    });
+
+    for (int32 Index = 0; Index < NumMessages; ++Index)
+    {
+        Listener.ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result);
+    }
+    bDispatching.store(false);
+    Registrar.Wait();
+
+    TestEqual("A handler registered throughout should receive every message", StableHandler.GetReceivedCount(WM_KEYDOWN), NumMessages);
+
+    return true;
+}
+
+namespace
+{
+    /** Handler that appends its tag to a shared log and optionally consumes the message. */
+    class FOrderedMessageHandler : public IWindowsMessageHandler
+    {
+    public:
+        FOrderedMessageHandler(TArray<int32>& InCallLog, int32 InTag, bool bInConsume = false)
+            : CallLog(InCallLog)
+            , Tag(InTag)
+            , bConsume(bInConsume)
+        {
+        }
+
+        virtual bool ProcessMessage(HWND hwnd, uint32 msg, WPARAM wParam, LPARAM lParam, int32& OutResult) override
+        {
+            CallLog.Add(Tag);
+            if (bConsume)
+            {
+                OutResult = Tag;
+            }
+            return bConsume;
+        }
+
+        TArray<int32>& CallLog;
+        int32 Tag;
+        bool bConsume;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageListenerPriorityTest, "WindowsMessageListener.PriorityAndConsumption", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageListenerPriorityTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageListener Listener;
+    Listener.AddAllowedMessageType(WM_KEYDOWN);
+
+    TArray<int32> CallLog;
+    FOrderedMessageHandler First(CallLog, 1);
+    FOrderedMessageHandler Second(CallLog, 2);
+    FOrderedMessageHandler Overlay(CallLog, 3, true);
+    Listener.AddMessageHandler(&First);
+    Listener.AddMessageHandler(&Second);
+    Listener.AddMessageHandler(&Overlay);
+    TestFalse("Unregistered handlers have no priority to set", Listener.SetMessageHandlerPriority(&Listener, 10));
+
+    // By default every handler runs in registration order and nothing is reported as handled
+    int32 Result = 0;
+    TestFalse("Messages should not be reported as handled by default", Listener.ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result));
+    TestEqual("Handlers should run in registration order", CallLog, TArray<int32>({ 1, 2, 3 }));
+
+    TestTrue("Priority of a registered handler can be set", Listener.SetMessageHandlerPriority(&Overlay, 100));
+    Listener.SetMessageHandlerPriority(&First, -1);
+    CallLog.Reset();
+    Listener.ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result);
+    TestEqual("Handlers should run by descending priority", CallLog, TArray<int32>({ 3, 2, 1 }));
+
+    Listener.SetConsumptionPolicy(EWindowsMessageConsumptionPolicy::StopFanOut);
+    CallLog.Reset();
+    TestFalse("StopFanOut should not report the message as handled", Listener.ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result));
+    TestEqual("A consumed message should not reach lower priority handlers", CallLog, TArray<int32>({ 3 }));
+
+    Listener.SetConsumptionPolicy(EWindowsMessageConsumptionPolicy::Consume);
+    CallLog.Reset();
+    Result = 0;
+    TestTrue("Consume should report the message as handled", Listener.ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result));
+    TestEqual("The consuming handler's result should be propagated", Result, 3);
+
+    // Handlers added later with the default priority go after the overlay but before lower priorities
+    FOrderedMessageHandler Late(CallLog, 4);
+    Listener.SetMessageHandlerPriority(&Overlay, 0);
+    Listener.SetConsumptionPolicy(EWindowsMessageConsumptionPolicy::Ignore);
+    Listener.AddMessageHandler(&Late);
+    CallLog.Reset();
+    Listener.ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result);
+    TestEqual("Equal priorities should keep registration order", CallLog, TArray<int32>({ 2, 3, 4, 1 }));
+
+    return true;
+}
+
+#if WINDOWS_MESSAGE_LISTENER_STATS
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageListenerStatsTest, "WindowsMessageListener.Stats", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageListenerStatsTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageListener Listener;
+    Listener.AddAllowedMessageType(WM_KEYDOWN);
+    Listener.AddAllowedMessageRange(WM_APP, WM_APP + 10);
+
+    FCountingMessageHandler Handler;
+    Listener.AddMessageHandler(&Handler);
+
+    int32 Result = 0;
+    for (int32 Index = 0; Index < 3; ++Index)
+    {
+        Listener.ProcessMessage(nullptr, WM_KEYDOWN, 0, 0, Result);
+    }
+    Listener.ProcessMessage(nullptr, WM_KEYUP, 0, 0, Result);
+    Listener.ProcessMessage(nullptr, WM_APP + 1, 0, 0, Result);
+    Listener.ProcessMessage(nullptr, WM_APP + 2, 0, 0, Result);
+
+    const FWindowsMessageStatsSnapshot Stats = Listener.GetMessageStats();
+    const FWindowsMessageCodeStats* KeyDown = Stats.MessageCodes.FindByPredicate([](const FWindowsMessageCodeStats& Entry) { return Entry.FirstMsgCode == WM_KEYDOWN; });
+    const FWindowsMessageCodeStats* KeyUp = Stats.MessageCodes.FindByPredicate([](const FWindowsMessageCodeStats& Entry) { return Entry.FirstMsgCode == WM_KEYUP; });
+    const FWindowsMessageCodeStats* AppRange = Stats.MessageCodes.FindByPredicate([](const FWindowsMessageCodeStats& Entry) { return Entry.FirstMsgCode <= WM_APP && Entry.LastMsgCode >= WM_APP; });
+    if (TestNotNull("WM_KEYDOWN should be counted", KeyDown))
+    {
+        TestEqual("WM_KEYDOWN received", KeyDown->Received, uint64(3));
+        TestEqual("WM_KEYDOWN dispatched", KeyDown->Dispatched, uint64(3));
+        TestEqual("WM_KEYDOWN filtered", KeyDown->Filtered, uint64(0));
+    }
+    if (TestNotNull("WM_KEYUP should be counted", KeyUp))
+    {
+        TestEqual("WM_KEYUP filtered", KeyUp->Filtered, uint64(1));
+        TestEqual("WM_KEYUP dispatched", KeyUp->Dispatched, uint64(0));
+    }
+    if (TestNotNull("WM_APP messages should be counted as one range", AppRange))
+    {
+        TestEqual("WM_APP range dispatched", AppRange->Dispatched, uint64(2));
+    }
+
+    if (TestEqual("Every registered handler should be reported", Stats.Handlers.Num(), 1))
+    {
+        const FWindowsMessageHandlerStats& HandlerStats = Stats.Handlers[0];
+        TestEqual("Handler pointer", HandlerStats.Handler, static_cast<const void*>(static_cast<IWindowsMessageHandler*>(&Handler)));
+        TestEqual("Handler calls", HandlerStats.Calls, uint64(5));
+        uint64 HistogramTotal = 0;
+        for (uint64 BucketCount : HandlerStats.CycleHistogram)
+        {
+            HistogramTotal += BucketCount;
+        }
+        TestEqual("Every call should land in one histogram bucket", HistogramTotal, uint64(5));
+    }
+
+    Listener.ResetMessageStats();
+    const FWindowsMessageStatsSnapshot ResetStats = Listener.GetMessageStats();
+    TestEqual("Reset should clear the code counters", ResetStats.MessageCodes.Num(), 0);
+    TestEqual("Reset should clear the handler counters", ResetStats.Handlers[0].Calls, uint64(0));
+
+    return true;
+}
+#endif // WINDOWS_MESSAGE_LISTENER_STATS
+
+#endif // PLATFORM_WINDOWS
@@ -0,0 +1,122 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageLogger.h"
+#include "WindowsMessageDispatcher.h"
+#include "WindowsMessageAllocationCounter.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageLoggerSamplingTest, "WindowsMessageListener.Logger.Sampling", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageLoggerSamplingTest::RunTest(const FString& Parameters)
+{
+    TArray<FWindowsMessageLogRecord> Written;
+    FString LastLine;
+    FWindowsMessageLogger Logger;
+    Logger.SetSink([&Written, &LastLine](const FWindowsMessageLogRecord& Record, FStringView Line)
+    {
+        Written.Add(Record);
+        LastLine = FString(Line);
+    });
+    Logger.SetRule(SyntheticMouseMove, FWindowsMessageLogRule(10));
+    Logger.SetMessageTypeLogged(SyntheticTimer, false);
+    Logger.Start(128, false);
+
+    for (uint32 Index = 0; Index < 100; ++Index)
+    {
+        Logger.Log(EWindowsMessageLogEvent::Accepted, FWindowsMessageRecord(1, SyntheticMouseMove, Index, 0, 1));
+        Logger.Log(EWindowsMessageLogEvent::Accepted, FWindowsMessageRecord(1, SyntheticTimer, Index, 0, 1));
+    }
+    Logger.Log(EWindowsMessageLogEvent::Rejected, FWindowsMessageRecord(1, SyntheticKeyDown, 0, 0, 1));
+    TestEqual("Nothing should be written before a flush", Written.Num(), 0);
+    TestEqual("Every sampled record should be written", Logger.Flush(), 11);
+
+    TestTrue("One mouse move in ten should be logged, starting with the first", Written.Num() == 11 && Written[0].WParam == 0 && Written[1].WParam == 10);
+    TestTrue("Skipped messages should be reported on the next record", Written.Num() == 11 && Written[0].Suppressed == 0 && Written[1].Suppressed == 9);
+    TestTrue("Codes without a rule should log every message", Written.Num() == 11 && Written[10].Msg == SyntheticKeyDown && Written[10].Event == EWindowsMessageLogEvent::Rejected);
+    TestTrue("Lines should name the event and the message", LastLine.StartsWith(TEXT("Rejected")) && LastLine.Contains(TEXT("WM_")));
+
+    const FWindowsMessageLogCounters Counters = Logger.GetCounters();
+    TestEqual("Filtered codes should not be considered", Counters.Considered, uint64(101));
+    TestEqual("Sampled-out messages", Counters.SampledOut, uint64(90));
+    TestEqual("Written records", Counters.Written, uint64(11));
+
+    // The message path only copies records into the preallocated buffer
+    Logger.SetDefaultRule(FWindowsMessageLogRule(4));
+    uint64 NumAllocations = 0;
+    {
+        FWindowsMessageAllocationCounter Counter;
+        for (uint32 Index = 0; Index < 1000; ++Index)
+        {
+            Logger.Log(EWindowsMessageLogEvent::Accepted, FWindowsMessageRecord(1, SyntheticKeyDown, Index, 0, 1));
+        }
+        NumAllocations = Counter.GetNumAllocations();
+    }
+    FWindowsMessageAllocationCounter::TestNoAllocations(*this, TEXT("Logging should not allocate"), NumAllocations);
+    TestEqual("A full buffer should drop and count records", Logger.GetCounters().Buffer.DroppedNewest, uint64(250 - 128));
+
+    Logger.Stop();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageLoggerRateLimitTest, "WindowsMessageListener.Logger.RateLimit", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageLoggerRateLimitTest::RunTest(const FString& Parameters)
+{
+    int32 NumWritten = 0;
+    FWindowsMessageLogger Logger;
+    Logger.SetSink([&NumWritten](const FWindowsMessageLogRecord&, FStringView) { ++NumWritten; });
+    Logger.SetDefaultRule(FWindowsMessageLogRule(1, 10.0, 5.0));
+    Logger.Start(1024, false);
+
+    // A burst of 100 messages within one millisecond only gets the bucket's worth through
+    for (int32 Index = 0; Index < 100; ++Index)
+    {
+        Logger.Log(EWindowsMessageLogEvent::Accepted, FWindowsMessageRecord(1, SyntheticKeyDown, Index, 0, SecondsToCycles(100.0 + Index * 0.00001)));
+    }
+    Logger.Flush();
+    TestEqual("A burst should be limited to the bucket size", NumWritten, 5);
+
+    // One message every 10 ms for a second: the sustained rate refills 10 tokens
+    NumWritten = 0;
+    for (int32 Index = 1; Index <= 100; ++Index)
+    {
+        Logger.Log(EWindowsMessageLogEvent::Accepted, FWindowsMessageRecord(1, SyntheticKeyDown, Index, 0, SecondsToCycles(100.001 + Index * 0.01)));
+    }
+    Logger.Flush();
+    TestTrue("A steady stream should be limited to the sustained rate", NumWritten >= 9 && NumWritten <= 11);
+    TestEqual("Rate-limited messages should be counted", Logger.GetCounters().RateLimited, uint64(200 - 5 - NumWritten));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageLoggerAsyncTest, "WindowsMessageListener.Logger.Async", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageLoggerAsyncTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageType(SyntheticKeyDown);
+    Dispatcher.EnableMessageLogging(8192);
+
+    std::atomic<int32> NumRejected{0};
+    std::atomic<int32> NumWritten{0};
+    FWindowsMessageLogger* Logger = Dispatcher.GetMessageLogger();
+    Logger->Stop(); // The sink can only change while the writer thread is stopped
+    Logger->SetSink([&NumRejected, &NumWritten](const FWindowsMessageLogRecord& Record, FStringView)
+    {
+        NumRejected += Record.Event == EWindowsMessageLogEvent::Rejected ? 1 : 0;
+        ++NumWritten;
+    });
+    Logger->Start(8192);
+
+    int32 Result = 0;
+    for (int32 Index = 0; Index < 2000; ++Index)
+    {
+        Dispatcher.ProcessMessage(FWindowsMessageRecord(1, Index % 2 ? SyntheticKeyDown : SyntheticMouseMove, Index, 0, 0), Result);
+    }
+    const FWindowsMessageLogCounters Counters = Dispatcher.GetMessageLogCounters();
+    Dispatcher.DisableMessageLogging(); // Joins the writer thread and writes what is left
+
+    TestEqual("Every message should reach the log", Counters.Considered, uint64(2000));
+    TestEqual("Stopping should write every buffered record", NumWritten.load(), 2000);
+    TestEqual("Rejected messages should be logged as rejected", NumRejected.load(), 1000);
+    TestFalse("The log should be gone once disabled", Dispatcher.IsMessageLoggingEnabled());
+    return true;
+}
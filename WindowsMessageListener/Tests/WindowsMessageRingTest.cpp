@@ -0,0 +1,132 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageRing.h"
+#include "Async/Async.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+namespace
+{
+    FWindowsMessageRecord MakeSyntheticMessage(uint32 Msg, uint64 Sequence)
+    {
+        return FWindowsMessageRecord(1, Msg, Sequence, static_cast<int64>(Sequence), Sequence);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageRingOverflowTest, "WindowsMessageListener.Ring.OverflowPolicies", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageRingOverflowTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageRecord Batch[8];
+
+    // Drop newest: the incoming message is rejected
+    {
+        FWindowsMessageRing Ring(4, EWindowsMessageOverflowPolicy::DropNewest);
+        for (uint64 Index = 0; Index < 4; ++Index)
+        {
+            TestTrue("Push into a ring with space should succeed", Ring.Push(MakeSyntheticMessage(SyntheticUser, Index)));
+        }
+        TestFalse("Push into a full ring should fail", Ring.Push(MakeSyntheticMessage(SyntheticUser, 4)));
+        TestEqual("All queued messages should be popped", Ring.PopBatch(Batch, 8), 4);
+        TestEqual("Messages should be popped in order", Batch[3].WParam, uint64(3));
+        TestEqual("Dropped newest counter", Ring.GetCounters().DroppedNewest, uint64(1));
+    }
+
+    // Drop oldest: the oldest queued messages make room
+    {
+        FWindowsMessageRing Ring(4, EWindowsMessageOverflowPolicy::DropOldest);
+        for (uint64 Index = 0; Index < 6; ++Index)
+        {
+            Ring.Push(MakeSyntheticMessage(SyntheticUser, Index));
+        }
+        TestEqual("A full ring should keep its capacity", Ring.PopBatch(Batch, 8), 4);
+        TestEqual("The oldest messages should have been dropped", Batch[0].WParam, uint64(2));
+        TestEqual("The newest message should be kept", Batch[3].WParam, uint64(5));
+        TestEqual("Dropped oldest counter", Ring.GetCounters().DroppedOldest, uint64(2));
+    }
+
+    // Coalesce: a message for the same window and code replaces the newest queued one
+    {
+        FWindowsMessageRing Ring(4, EWindowsMessageOverflowPolicy::Coalesce);
+        for (uint64 Index = 0; Index < 4; ++Index)
+        {
+            Ring.Push(MakeSyntheticMessage(SyntheticUser + static_cast<uint32>(Index), Index));
+        }
+        TestTrue("Coalescable push into a full ring should succeed", Ring.Push(MakeSyntheticMessage(SyntheticUser + 3, 42)));
+        TestFalse("Non-coalescable push into a full ring should fail", Ring.Push(MakeSyntheticMessage(SyntheticUser, 43)));
+        TestEqual("A full ring should keep its capacity", Ring.PopBatch(Batch, 8), 4);
+        TestEqual("The newest message should hold the coalesced payload", Batch[3].WParam, uint64(42));
+        TestEqual("Coalesced counter", Ring.GetCounters().Coalesced, uint64(1));
+        TestEqual("Dropped newest counter", Ring.GetCounters().DroppedNewest, uint64(1));
+    }
+
+    // Indices keep working once they wrap around the buffer
+    {
+        FWindowsMessageRing Ring(4);
+        uint64 Expected = 0;
+        for (uint64 Index = 0; Index < 1000; ++Index)
+        {
+            Ring.Push(MakeSyntheticMessage(SyntheticUser, Index));
+            if (Index % 3 == 2)
+            {
+                Ring.Drain([this, &Expected](const FWindowsMessageRecord& Record)
+                {
+                    TestEqual("Messages should be drained in order", Record.WParam, Expected++);
+                });
+            }
+        }
+        TestEqual("The high water mark should not exceed the capacity", Ring.GetCounters().HighWaterMark, 3u);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageRingConcurrencyTest, "WindowsMessageListener.Ring.Concurrency", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageRingConcurrencyTest::RunTest(const FString& Parameters)
+{
+    constexpr uint64 NumMessages = 500000;
+    const EWindowsMessageOverflowPolicy Policies[] = { EWindowsMessageOverflowPolicy::DropNewest, EWindowsMessageOverflowPolicy::DropOldest, EWindowsMessageOverflowPolicy::Coalesce };
+
+    for (EWindowsMessageOverflowPolicy Policy : Policies)
+    {
+        FWindowsMessageRing Ring(256, Policy);
+        std::atomic<bool> bProducerDone{false};
+
+        // A single message code lets the coalesce policy merge every overflowing message
+        TFuture<void> Producer = Async(EAsyncExecution::Thread, [&Ring, &bProducerDone]()
+        {
+            for (uint64 Index = 1; Index <= NumMessages; ++Index)
+            {
+                Ring.Push(MakeSyntheticMessage(SyntheticMouseMove, Index));
+            }
+            bProducerDone = true;
+        });
+
+        uint64 LastSequence = 0;
+        uint64 NumReceived = 0;
+        bool bInOrder = true;
+        bool bIntact = true;
+        auto Consume = [&](const FWindowsMessageRecord& Record)
+        {
+            bInOrder &= Record.WParam > LastSequence;
+            bIntact &= Record.WParam == static_cast<uint64>(Record.LParam) && Record.WParam == Record.Timestamp;
+            LastSequence = Record.WParam;
+            ++NumReceived;
+        };
+
+        while (!bProducerDone)
+        {
+            Ring.Drain(Consume);
+        }
+        Producer.Wait();
+        Ring.Drain(Consume);
+
+        const FWindowsMessageRingCounters Counters = Ring.GetCounters();
+        TestTrue("Messages should arrive in the order they were pushed", bInOrder);
+        TestTrue("Messages should never be torn", bIntact);
+        TestEqual("Every popped message should be received", Counters.Popped, NumReceived);
+        TestEqual("Every message should be accounted for", Counters.Pushed + Counters.DroppedNewest, NumMessages);
+        TestEqual("Every accepted message should be popped, dropped or coalesced", Counters.Popped + Counters.DroppedOldest + Counters.Coalesced, Counters.Pushed);
+    }
+
+    return true;
+}
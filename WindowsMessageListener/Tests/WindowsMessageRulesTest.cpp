@@ -0,0 +1,110 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageRules.h"
+#include "WindowsMessageDispatcher.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+namespace
+{
+    constexpr uint64 SyntheticF1 = 0x70;
+    constexpr uint64 SyntheticF12 = 0x7B;
+
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageRulesCompileTest, "WindowsMessageListener.Rules.Compile", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageRulesCompileTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageRuleSet Rules;
+    Rules.DefineConstant(TEXT("Hotkey"), 'K');
+    TestTrue("Key ranges should compile", Rules.AddRule(TEXT("FunctionKeys"), TEXT("msg == WM_KEYDOWN && wParam in {VK_F1..VK_F12}")));
+    TestTrue("Device arrivals should compile", Rules.AddRule(TEXT("Arrival"), TEXT("msg == WM_DEVICECHANGE && (wParam == DBT_DEVICEARRIVAL || wParam == DBT_DEVICEREMOVECOMPLETE)")));
+    TestTrue("Negations and bit tests should compile", Rules.AddRule(TEXT("Drag"), TEXT("msg == 0x200 && wParam & MK_LBUTTON && !(hiword(lParam) > 100)")));
+    TestTrue("Constants and characters should compile", Rules.AddRule(TEXT("Hotkey"), TEXT("msg in {WM_KEYDOWN, WM_KEYUP} && wParam == hotkey || wParam == 'Q'")));
+
+    const int32 FunctionKeys = Rules.FindRule(TEXT("FunctionKeys"));
+    TestTrue("F1 key down", Rules.Evaluate(FunctionKeys, FWindowsMessageRecord(1, SyntheticKeyDown, SyntheticF1, 0, 0)));
+    TestTrue("F12 key down", Rules.Evaluate(FunctionKeys, FWindowsMessageRecord(1, SyntheticKeyDown, SyntheticF12, 0, 0)));
+    TestFalse("F13 key down", Rules.Evaluate(FunctionKeys, FWindowsMessageRecord(1, SyntheticKeyDown, SyntheticF12 + 1, 0, 0)));
+    TestFalse("F1 key up", Rules.Evaluate(FunctionKeys, FWindowsMessageRecord(1, SyntheticKeyUp, SyntheticF1, 0, 0)));
+
+    const int32 Arrival = Rules.FindRule(TEXT("Arrival"));
+    TestTrue("Device arrival", Rules.Evaluate(Arrival, FWindowsMessageRecord(1, SyntheticDeviceChange, 0x8000, 0, 0)));
+    TestTrue("Device removal", Rules.Evaluate(Arrival, FWindowsMessageRecord(1, SyntheticDeviceChange, 0x8004, 0, 0)));
+    TestFalse("Other device events", Rules.Evaluate(Arrival, FWindowsMessageRecord(1, SyntheticDeviceChange, 0x0007, 0, 0)));
+
+    const int32 Drag = Rules.FindRule(TEXT("Drag"));
+    TestTrue("Left button drag near the top", Rules.Evaluate(Drag, FWindowsMessageRecord(1, SyntheticMouseMove, 0x0001, (50 << 16) | 10, 0)));
+    TestFalse("Left button drag further down", Rules.Evaluate(Drag, FWindowsMessageRecord(1, SyntheticMouseMove, 0x0001, (150 << 16) | 10, 0)));
+    TestFalse("Move without buttons", Rules.Evaluate(Drag, FWindowsMessageRecord(1, SyntheticMouseMove, 0x0002, 0, 0)));
+
+    const int32 Hotkey = Rules.FindRule(TEXT("Hotkey"));
+    TestTrue("&& binds tighter than ||", Rules.Evaluate(Hotkey, FWindowsMessageRecord(1, SyntheticMouseMove, 'Q', 0, 0)));
+    TestTrue("Defined constants ignore case", Rules.Evaluate(Hotkey, FWindowsMessageRecord(1, SyntheticKeyUp, 'K', 0, 0)));
+    TestFalse("Constant on another message", Rules.Evaluate(Hotkey, FWindowsMessageRecord(1, SyntheticMouseMove, 'K', 0, 0)));
+    TestEqual("Every rule should be evaluated into one mask", Rules.EvaluateAll(FWindowsMessageRecord(1, SyntheticKeyDown, SyntheticF1, 0, 0)), uint64(1) << FunctionKeys);
+
+    // Code ranges let the dispatch table skip handlers without running their rule
+    TArray<TPair<uint32, uint32>> Ranges;
+    TestTrue("A code test should constrain the codes", Rules.GetRuleCodeRanges(FunctionKeys, Ranges) && Ranges.Num() == 1 && Ranges[0].Key == SyntheticKeyDown && Ranges[0].Value == SyntheticKeyDown);
+    TestFalse("An || with a code-free test should not constrain the codes", Rules.GetRuleCodeRanges(Hotkey, Ranges));
+
+    FString Error;
+    TestFalse("Unknown names should fail", Rules.AddRule(TEXT("Bad"), TEXT("msg == WM_NOT_A_MESSAGE"), &Error));
+    TestTrue("Errors should give the column", Error.Contains(TEXT("column 8")));
+    TestFalse("Unbalanced parentheses should fail", Rules.AddRule(TEXT("Bad"), TEXT("(msg == 1"), &Error));
+    TestFalse("Reversed ranges should fail", Rules.AddRule(TEXT("Bad"), TEXT("wParam in {5..1}"), &Error));
+    TestFalse("Stray characters should fail", Rules.AddRule(TEXT("Bad"), TEXT("msg == 1 $"), &Error));
+    TestFalse("Duplicate names should fail", Rules.AddRule(TEXT("Drag"), TEXT("msg == 1"), &Error));
+    TestEqual("Failed rules should not be added", Rules.Num(), 4);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageRulesDispatchTest, "WindowsMessageListener.Rules.Dispatch", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageRulesDispatchTest::RunTest(const FString& Parameters)
+{
+    FWindowsMessageDispatcher Dispatcher;
+    Dispatcher.AllowMessageRange(SyntheticKeyDown, SyntheticKeyUp);
+    Dispatcher.AllowMessageType(SyntheticMouseMove);
+
+    TSharedPtr<FWindowsMessageRuleSet> Rules = MakeShared<FWindowsMessageRuleSet>();
+    Rules->AddRule(TEXT("FunctionKeys"), TEXT("msg == WM_KEYDOWN && wParam in {VK_F1..VK_F12}"));
+    Dispatcher.SetMessageRules(Rules);
+
+    FWindowsMessageTestHandler FirstHandler;
+    FWindowsMessageTestHandler SecondHandler;
+    FWindowsMessageTestHandler PlainHandler;
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&FirstHandler), {});
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&SecondHandler), {});
+    Dispatcher.AddHandler(FWindowsMessageHandlerRef::Create(&PlainHandler), {});
+    TestTrue("Binding a registered handler", Dispatcher.SetHandlerRule(&FirstHandler, TEXT("FunctionKeys")));
+    TestTrue("Binding a second handler to the same rule", Dispatcher.SetHandlerRule(&SecondHandler, TEXT("FunctionKeys")));
+    TestFalse("Binding an unknown handler", Dispatcher.SetHandlerRule(&Dispatcher, TEXT("FunctionKeys")));
+
+    int32 Result = 0;
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyDown, SyntheticF1, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyDown, 'A', 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, SyntheticF1, 0, 0), Result);
+    TestEqual("Bound handlers should only see accepted messages", FirstHandler.Received.Num(), 1);
+    TestEqual("Handlers sharing a rule should see the same messages", SecondHandler.Received.Num(), 1);
+    TestEqual("Unbound handlers should see every message", PlainHandler.Received.Num(), 3);
+
+    // Reloading swaps the whole set; bindings are resolved by name again
+    TSharedPtr<FWindowsMessageRuleSet> Reloaded = MakeShared<FWindowsMessageRuleSet>();
+    Reloaded->AddRule(TEXT("Unrelated"), TEXT("msg == 1"));
+    Reloaded->AddRule(TEXT("FunctionKeys"), TEXT("msg == WM_KEYUP && wParam == VK_F1"));
+    Dispatcher.SetMessageRules(Reloaded);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyDown, SyntheticF1, 0, 0), Result);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyUp, SyntheticF1, 0, 0), Result);
+    TestTrue("Reloaded rules should apply to the next message", FirstHandler.Received.Num() == 2 && FirstHandler.Received[1].Msg == SyntheticKeyUp);
+
+    AddExpectedError(TEXT("is not defined"), EAutomationExpectedErrorFlags::Contains, 1);
+    Dispatcher.SetMessageRules(nullptr);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticKeyUp, SyntheticF1, 0, 0), Result);
+    TestEqual("Handlers bound to a missing rule should receive nothing", FirstHandler.Received.Num(), 2);
+
+    Dispatcher.SetHandlerRule(&FirstHandler, NAME_None);
+    Dispatcher.ProcessMessage(FWindowsMessageRecord(1, SyntheticMouseMove, 0, 0, 0), Result);
+    TestEqual("Unbinding should restore every subscribed message", FirstHandler.Received.Num(), 3);
+    return true;
+}
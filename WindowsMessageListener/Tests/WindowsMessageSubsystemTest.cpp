@@ -0,0 +1,74 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsMessageSubsystem.h"
+#include "UObject/Package.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+namespace
+{
+    /** Feeds one message to a subsystem, as its listener would. */
+    void GatherSyntheticMessage(UWindowsMessageSubsystem& Subsystem, uint32 Msg, uint64 WParam)
+    {
+        const FWindowsMessageRecord Record(1, Msg, WParam, 0, 0);
+        Subsystem.GatherMessages(FWindowsMessageBatchView::FromRecord(Record));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsMessageSubsystemBroadcastTest, "WindowsMessageListener.Subsystem.Broadcast", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsMessageSubsystemBroadcastTest::RunTest(const FString& Parameters)
+{
+    // Not initialized, so no listener or ticker: messages are fed and broadcast by hand
+    UWindowsMessageSubsystem* Subsystem = NewObject<UWindowsMessageSubsystem>(GetTransientPackage());
+    UWindowsMessageSubsystem* Owner = NewObject<UWindowsMessageSubsystem>(GetTransientPackage());
+
+    int32 NumBroadcasts = 0;
+    TArray<FWindowsMessageEntry> AllMessages;
+    Subsystem->OnMessagesReceivedNative.AddLambda([&NumBroadcasts, &AllMessages](TArrayView<const FWindowsMessageEntry> Messages)
+    {
+        ++NumBroadcasts;
+        AllMessages.Append(Messages.GetData(), Messages.Num());
+    });
+
+    TArray<FWindowsMessageEntry> KeyMessages;
+    const uint32 KeyCodes[] = { SyntheticKeyDown, SyntheticKeyUp };
+    const int32 KeyBinding = Subsystem->BindNativeMessages(FWindowsMessagesNativeDelegate::CreateWeakLambda(Owner, [&KeyMessages](TArrayView<const FWindowsMessageEntry> Messages)
+    {
+        KeyMessages.Append(Messages.GetData(), Messages.Num());
+    }), KeyCodes);
+    TestTrue("Binding a delegate should return an id", KeyBinding != INDEX_NONE);
+
+    int32 NumMouseCalls = 0;
+    const uint32 MouseCodes[] = { SyntheticMouseMove };
+    Subsystem->BindNativeMessages(FWindowsMessagesNativeDelegate::CreateLambda([&NumMouseCalls](TArrayView<const FWindowsMessageEntry> Messages) { ++NumMouseCalls; }), MouseCodes);
+
+    for (int32 Index = 0; Index < 100; ++Index)
+    {
+        GatherSyntheticMessage(*Subsystem, Index % 4 == 0 ? SyntheticKeyDown : SyntheticMouseMove, Index);
+    }
+    GatherSyntheticMessage(*Subsystem, SyntheticKeyUp, 100);
+    TestEqual("Every gathered message should be broadcast", Subsystem->BroadcastMessages(), 101);
+    TestEqual("The whole frame should be broadcast once", NumBroadcasts, 1);
+    TestTrue("Messages should arrive in order", AllMessages.Num() == 101 && AllMessages[0].WParam == 0 && AllMessages.Last().WParam == 100);
+    TestTrue("A binding should only see its codes", KeyMessages.Num() == 26 && KeyMessages.Last().Message == SyntheticKeyUp);
+    TestEqual("A binding should be called once per frame", NumMouseCalls, 1);
+
+    TestEqual("An empty frame should broadcast nothing", Subsystem->BroadcastMessages(), 0);
+    TestEqual("An empty frame should not call delegates", NumBroadcasts, 1);
+
+    // Bindings to destroyed objects are dropped rather than called
+    Owner->MarkAsGarbage();
+    GatherSyntheticMessage(*Subsystem, SyntheticKeyDown, 101);
+    Subsystem->BroadcastMessages();
+    TestEqual("A binding whose object was destroyed should not be called", KeyMessages.Num(), 26);
+
+    Subsystem->UnbindMessages(KeyBinding);
+    Subsystem->UnbindAllMessages(Subsystem);
+    GatherSyntheticMessage(*Subsystem, SyntheticMouseMove, 102);
+    Subsystem->BroadcastMessages();
+    TestEqual("Unrelated bindings should survive UnbindAllMessages", NumMouseCalls, 2);
+
+    TestEqual("Message names should resolve", UWindowsMessageSubsystem::GetMessageCode(TEXT("WM_KEYDOWN")), static_cast<int32>(SyntheticKeyDown));
+    TestEqual("Message codes should resolve", UWindowsMessageSubsystem::GetMessageName(SyntheticKeyDown), FString(TEXT("WM_KEYDOWN")));
+    return true;
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2025, Michael Golembewski. All rights reserved.
+
+/**
+ * This header file declares the message codes and handlers shared by the automation tests and benchmarks.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WindowsMessageRecord.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
+
+namespace WindowsMessageTest
+{
+    // Plain message codes, so the tests run headless on any platform
+    constexpr uint32 SyntheticSetCursor = 0x0020;
+    constexpr uint32 SyntheticHitTest = 0x0084;
+    constexpr uint32 SyntheticKeyDown = 0x0100;
+    constexpr uint32 SyntheticKeyUp = 0x0101;
+    constexpr uint32 SyntheticChar = 0x0102;
+    constexpr uint32 SyntheticSysKeyDown = 0x0104;
+    constexpr uint32 SyntheticTimer = 0x0113;
+    constexpr uint32 SyntheticMouseMove = 0x0200;
+    constexpr uint32 SyntheticButtonDown = 0x0201;
+    constexpr uint32 SyntheticButtonUp = 0x0202;
+    constexpr uint32 SyntheticRButtonDblClk = 0x0206;
+    constexpr uint32 SyntheticMouseWheel = 0x020A;
+    constexpr uint32 SyntheticXButtonUp = 0x020C;
+    constexpr uint32 SyntheticMouseHWheel = 0x020E;
+    constexpr uint32 SyntheticDeviceChange = 0x0219;
+    constexpr uint32 SyntheticUser = 0x0400;
+
+    /**
+     * Converts seconds to a Cycles64 duration, for synthetic timestamps.
+     */
+    inline uint64 SecondsToCycles(double Seconds)
+    {
+        return static_cast<uint64>(Seconds / FPlatformTime::GetSecondsPerCycle64());
+    }
+
+    /**
+     * FWindowsMessageTestHandler
+     * Handler that records the messages it receives and the threads it was called on, and optionally consumes them.
+     */
+    struct FWindowsMessageTestHandler
+    {
+        bool HandleMessage(const FWindowsMessageRecord& Record, int32& OutResult)
+        {
+            Received.Add(Record);
+            LastThreadId = FPlatformTLS::GetCurrentThreadId();
+            ThreadIds.AddUnique(LastThreadId);
+            return bConsume && (ConsumedMsg == 0 || Record.Msg == ConsumedMsg);
+        }
+
+        TArray<FWindowsMessageRecord> Received; // Every message received, in order
+        TArray<uint32> ThreadIds;               // Every thread the handler was called on
+        uint32 LastThreadId = 0;                // The thread of the latest call
+        uint32 ConsumedMsg = 0;                 // The only code consumed while bConsume is set; 0 for every code
+        bool bConsume = false;                  // Whether received messages are consumed
+    };
+}
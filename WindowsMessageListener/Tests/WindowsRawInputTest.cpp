@@ -0,0 +1,186 @@
+#include "Misc/AutomationTest.h"
+#include "WindowsRawInput.h"
+#include "WindowsMessageAllocationCounter.h"
+#include "WindowsMessageTestHelpers.h"
+
+using namespace WindowsMessageTest;
+
+namespace
+{
+    // Plain raw input constants, so payloads can be built without Windows headers
+    constexpr uint16 SyntheticRawMouseMoveAbsolute = 0x0001;
+    constexpr uint16 SyntheticRawLeftButtonDown = 0x0001;
+    constexpr uint16 SyntheticRawMouseWheel = 0x0400;
+
+    /** Appends a value to a synthetic payload. */
+    template<typename ValueType>
+    void AppendRawInputField(TArray<uint8>& Payload, ValueType Value)
+    {
+        Payload.Append(reinterpret_cast<const uint8*>(&Value), sizeof(ValueType));
+    }
+
+    /** Appends a RAWINPUTHEADER whose size covers BodySize bytes of device data. */
+    void AppendRawInputHeader(TArray<uint8>& Payload, EWindowsRawInputDeviceType Type, int32 BodySize, uint64 Device)
+    {
+        AppendRawInputField<uint32>(Payload, static_cast<uint32>(Type));
+        AppendRawInputField<uint32>(Payload, static_cast<uint32>(FWindowsRawInputDecoder::HeaderSize + BodySize));
+        AppendRawInputField<uint64>(Payload, Device);
+        AppendRawInputField<uint64>(Payload, 0); // wParam
+    }
+
+    /** Builds a RAWINPUT payload with a RAWMOUSE. */
+    TArray<uint8> MakeMousePayload(uint64 Device, uint16 Flags, uint16 ButtonFlags, int16 ButtonData, int32 LastX, int32 LastY)
+    {
+        TArray<uint8> Payload;
+        AppendRawInputHeader(Payload, EWindowsRawInputDeviceType::Mouse, FWindowsRawInputDecoder::MouseSize, Device);
+        AppendRawInputField<uint16>(Payload, Flags);
+        AppendRawInputField<uint16>(Payload, 0); // Padding
+        AppendRawInputField<uint16>(Payload, ButtonFlags);
+        AppendRawInputField<int16>(Payload, ButtonData);
+        AppendRawInputField<uint32>(Payload, 0); // ulRawButtons
+        AppendRawInputField<int32>(Payload, LastX);
+        AppendRawInputField<int32>(Payload, LastY);
+        AppendRawInputField<uint32>(Payload, 0); // ulExtraInformation
+        return Payload;
+    }
+
+    /** Builds a RAWINPUT payload with a RAWKEYBOARD. */
+    TArray<uint8> MakeKeyboardPayload(uint64 Device, uint16 MakeCode, uint16 Flags, uint16 VirtualKey, uint32 Message)
+    {
+        TArray<uint8> Payload;
+        AppendRawInputHeader(Payload, EWindowsRawInputDeviceType::Keyboard, FWindowsRawInputDecoder::KeyboardSize, Device);
+        AppendRawInputField<uint16>(Payload, MakeCode);
+        AppendRawInputField<uint16>(Payload, Flags);
+        AppendRawInputField<uint16>(Payload, 0); // Reserved
+        AppendRawInputField<uint16>(Payload, VirtualKey);
+        AppendRawInputField<uint32>(Payload, Message);
+        AppendRawInputField<uint32>(Payload, 0); // ExtraInformation
+        return Payload;
+    }
+
+    /** Builds a RAWINPUT payload with a RAWHID holding Count reports of ReportSize bytes, each filled with its 1-based index. */
+    TArray<uint8> MakeHidPayload(uint64 Device, uint32 ReportSize, uint32 Count)
+    {
+        TArray<uint8> Payload;
+        AppendRawInputHeader(Payload, EWindowsRawInputDeviceType::Hid, FWindowsRawInputDecoder::HidHeaderSize + ReportSize * Count, Device);
+        AppendRawInputField<uint32>(Payload, ReportSize);
+        AppendRawInputField<uint32>(Payload, Count);
+        for (uint32 Report = 0; Report < Count; ++Report)
+        {
+            Payload.AddUninitialized(ReportSize);
+            FMemory::Memset(Payload.GetData() + Payload.Num() - ReportSize, static_cast<uint8>(Report + 1), ReportSize);
+        }
+        return Payload;
+    }
+
+    /** Packs payloads the way GetRawInputBuffer does, each starting on an 8-byte boundary. */
+    TArray<uint8> MakeRawInputBuffer(std::initializer_list<TArray<uint8>> Payloads)
+    {
+        TArray<uint8> Buffer;
+        for (const TArray<uint8>& Payload : Payloads)
+        {
+            Buffer.Append(Payload);
+            Buffer.AddZeroed(Align(Buffer.Num(), FWindowsRawInputDecoder::BlockAlignment) - Buffer.Num());
+        }
+        return Buffer;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsRawInputDecoderTest, "WindowsMessageListener.RawInput.Decoders", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsRawInputDecoderTest::RunTest(const FString& Parameters)
+{
+    FWindowsRawInputRecord Record;
+    const TArray<uint8> Mouse = MakeMousePayload(0xABCD, 0, SyntheticRawMouseWheel, -120, -3, 7);
+    TestTrue("Mouse payloads should decode", FWindowsRawInputDecoder::DecodeMouse(Mouse.GetData(), Mouse.Num(), 99, Record));
+    TestTrue("Device type", Record.Type == EWindowsRawInputDeviceType::Mouse);
+    TestEqual("Device handle", Record.Device, uint64(0xABCD));
+    TestEqual("Relative x should be signed", Record.LastX, -3);
+    TestEqual("Relative y", Record.LastY, 7);
+    TestEqual("Wheel delta should be signed", Record.ButtonData, int16(-120));
+    TestEqual("Button flags", Record.ButtonFlags, SyntheticRawMouseWheel);
+    TestFalse("Mouse decoders should reject keyboards", FWindowsRawInputDecoder::DecodeKeyboard(Mouse.GetData(), Mouse.Num(), 0, Record));
+    TestFalse("Truncated payloads should be rejected", FWindowsRawInputDecoder::DecodeMouse(Mouse.GetData(), Mouse.Num() - 1, 0, Record));
+
+    const TArray<uint8> Keyboard = MakeKeyboardPayload(2, 0x1E, 0x0002, 0x41, SyntheticKeyDown);
+    TestTrue("Keyboard payloads should decode", FWindowsRawInputDecoder::DecodeKeyboard(Keyboard.GetData(), Keyboard.Num(), 0, Record));
+    TestTrue("Keyboard fields", Record.MakeCode == 0x1E && Record.Flags == 0x0002 && Record.VirtualKey == 0x41 && Record.Message == SyntheticKeyDown);
+
+    const TArray<uint8> Hid = MakeHidPayload(3, 5, 2);
+    int32 ReportSize = 0;
+    int32 ReportCount = 0;
+    TestTrue("HID layouts should decode", FWindowsRawInputDecoder::DecodeHidLayout(Hid.GetData(), Hid.Num(), ReportSize, ReportCount));
+    TestTrue("HID layout", ReportSize == 5 && ReportCount == 2);
+    TestTrue("HID reports should decode", FWindowsRawInputDecoder::DecodeHidReport(Hid.GetData(), Hid.Num(), 1, 0, Record));
+    TestTrue("HID report bytes", Record.HidReportSize == 5 && Record.HidReport[0] == 2 && Record.HidReport[4] == 2);
+    TestFalse("Reports past the count should be rejected", FWindowsRawInputDecoder::DecodeHidReport(Hid.GetData(), Hid.Num(), 2, 0, Record));
+
+    // A report size and count whose product wraps around 32 bits must not pass the bounds check
+    TArray<uint8> Hostile = MakeHidPayload(3, 0, 0);
+    FMemory::Memcpy(Hostile.GetData() + FWindowsRawInputDecoder::HeaderSize, "\x00\x00\x01\x00\x00\x00\x01\x00", 8);
+    TestFalse("Overflowing HID layouts should be rejected", FWindowsRawInputDecoder::DecodeHidLayout(Hostile.GetData(), Hostile.Num(), ReportSize, ReportCount));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWindowsRawInputReaderTest, "WindowsMessageListener.RawInput.Reader", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FWindowsRawInputReaderTest::RunTest(const FString& Parameters)
+{
+    FWindowsRawInputReader Reader(64, 4096);
+
+    // A buffered read mixing every device type, with a HID payload whose odd size needs realignment
+    const TArray<uint8> Buffer = MakeRawInputBuffer({
+        MakeMousePayload(1, 0, SyntheticRawLeftButtonDown, 0, 4, 4),
+        MakeHidPayload(2, 3, 3),
+        MakeKeyboardPayload(3, 0x1E, 0, 0x41, SyntheticKeyDown),
+    });
+    TestEqual("Every record of a buffered read should be queued", Reader.IngestRawInputBuffer(Buffer.GetData(), Buffer.Num(), 3, 10), 5);
+
+    TArray<FWindowsRawInputRecord> Popped;
+    Reader.DrainRecords([&Popped](const FWindowsRawInputRecord& Record) { Popped.Add(Record); });
+    TestEqual("Records should be drained", Popped.Num(), 5);
+    TestTrue("Records should keep their order", Popped.Num() == 5 && Popped[0].Type == EWindowsRawInputDeviceType::Mouse
+        && Popped[1].HidReport[0] == 1 && Popped[3].HidReport[0] == 3 && Popped[4].Type == EWindowsRawInputDeviceType::Keyboard);
+
+    const TArray<uint8> Truncated = MakeHidPayload(2, FWindowsRawInputRecord::MaxHidReportBytes + 8, 1);
+    Reader.IngestRawInput(Truncated.GetData(), Truncated.Num(), 0);
+    const uint8 Garbage[FWindowsRawInputDecoder::HeaderSize] = { 7 };
+    Reader.IngestRawInput(Garbage, sizeof(Garbage), 0);
+
+    FWindowsRawInputCounters Counters = Reader.GetCounters();
+    TestEqual("Payloads read", Counters.PayloadsRead, uint64(4));
+    TestEqual("Malformed payloads", Counters.Malformed, uint64(1));
+    TestEqual("Truncated reports", Counters.TruncatedReports, uint64(1));
+
+    // Steady state: a 1000-payload burst must not touch the heap on the producer side
+    Reader.DrainRecords([](const FWindowsRawInputRecord&) {});
+    const TArray<uint8> Move = MakeMousePayload(1, 0, 0, 0, 1, 0);
+    uint64 NumAllocations = 0;
+    {
+        FWindowsMessageAllocationCounter Counter;
+        for (int32 Index = 0; Index < 1000; ++Index)
+        {
+            Reader.IngestRawInput(Move.GetData(), Move.Num(), Index);
+            FWindowsRawInputRecord Record;
+            Reader.PopRecords(&Record, 1);
+        }
+        NumAllocations = Counter.GetNumAllocations();
+    }
+    FWindowsMessageAllocationCounter::TestNoAllocations(*this, TEXT("Ingestion should not allocate"), NumAllocations);
+
+    // Relative motion is never coalesced away, absolute positions are
+    FWindowsRawInputReader Coalescing(2, 4096, EWindowsMessageOverflowPolicy::Coalesce);
+    const TArray<uint8> Absolute = MakeMousePayload(1, SyntheticRawMouseMoveAbsolute, 0, 0, 100, 100);
+    for (int32 Index = 0; Index < 4; ++Index)
+    {
+        Coalescing.IngestRawInput(Absolute.GetData(), Absolute.Num(), Index);
+    }
+    TestEqual("Absolute moves should coalesce", Coalescing.GetCounters().Queue.Coalesced, uint64(2));
+    Coalescing.DrainRecords([](const FWindowsRawInputRecord&) {});
+    for (int32 Index = 0; Index < 4; ++Index)
+    {
+        Coalescing.IngestRawInput(Move.GetData(), Move.Num(), Index);
+    }
+    TestEqual("Relative moves should be dropped and counted, not merged", Coalescing.GetCounters().Queue.DroppedNewest, uint64(2));
+
+    return true;
+}